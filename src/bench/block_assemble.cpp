@@ -5,7 +5,12 @@
 #include <bench/bench.h>
 #include <consensus/consensus.h>
 #include <consensus/validation.h>
+#include <key_io.h>
+#include <llmq/chainlocks.h>
+#include <llmq/context.h>
+#include <masternode/sync.h>
 #include <script/standard.h>
+#include <spork.h>
 #include <test/util.h>
 #include <test/util/setup_common.h>
 #include <txmempool.h>
@@ -14,27 +19,22 @@
 
 #include <vector>
 
-static void AssembleBlock(benchmark::Bench& bench)
+// Collects some loose transactions that spend the coinbases of newly mined blocks and adds them to the mempool
+static std::vector<CTransactionRef> AddLooseTransactions(TestingSetup& test_setup, const CScript& SCRIPT_PUB)
 {
-    RegTestingSetup test_setup;
     const CScript redeemScript = CScript() << OP_DROP << OP_TRUE;
-    const CScript SCRIPT_PUB =
-        CScript() << OP_HASH160 << ToByteVector(CScriptID(redeemScript))
-                  << OP_EQUAL;
-
     const CScript scriptSig = CScript() << std::vector<uint8_t>(100, 0xff)
                                         << ToByteVector(redeemScript);
 
-    // Collect some loose transactions that spend the coinbases of our mined blocks
     constexpr size_t NUM_BLOCKS{200};
-    std::array<CTransactionRef, NUM_BLOCKS - COINBASE_MATURITY + 1> txs;
+    std::vector<CTransactionRef> txs;
     for (size_t b{0}; b < NUM_BLOCKS; ++b) {
         CMutableTransaction tx;
         tx.vin.push_back(MineBlock(test_setup.m_node, SCRIPT_PUB));
         tx.vin.back().scriptSig = scriptSig;
         tx.vout.emplace_back(1337, SCRIPT_PUB);
         if (NUM_BLOCKS - b >= COINBASE_MATURITY)
-            txs.at(b) = MakeTransactionRef(tx);
+            txs.emplace_back(MakeTransactionRef(tx));
     }
     {
         LOCK(::cs_main); // Required for ::AcceptToMemoryPool.
@@ -45,6 +45,51 @@ static void AssembleBlock(benchmark::Bench& bench)
             assert(ret);
         }
     }
+    return txs;
+}
+
+static CScript GetScriptPub()
+{
+    const CScript redeemScript = CScript() << OP_DROP << OP_TRUE;
+    return CScript() << OP_HASH160 << ToByteVector(CScriptID(redeemScript))
+                     << OP_EQUAL;
+}
+
+static void AssembleBlock(benchmark::Bench& bench)
+{
+    RegTestingSetup test_setup;
+    const CScript SCRIPT_PUB = GetScriptPub();
+    AddLooseTransactions(test_setup, SCRIPT_PUB);
+
+    bench.minEpochIterations(700).run([&] {
+        PrepareBlock(test_setup.m_node, SCRIPT_PUB);
+    });
+}
+
+// Same as AssembleBlock, but with InstantSend and ChainLocks enforced, so that every package transaction is checked for
+// being safe to mine. Half of the transactions are InstantSend locked, the other half is too young to be mined
+static void AssembleBlockInstantSend(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-dip8params=1"}};
+    const CScript SCRIPT_PUB = GetScriptPub();
+
+    CKey sporkKey;
+    sporkKey.MakeNewKey(false);
+    sporkManager->SetSporkAddress(EncodeDestination(sporkKey.GetPubKey().GetID()));
+    sporkManager->SetPrivKey(EncodeSecret(sporkKey));
+    for (const auto sporkId : {SPORK_2_INSTANTSEND_ENABLED, SPORK_3_INSTANTSEND_BLOCK_FILTERING, SPORK_19_CHAINLOCKS_ENABLED}) {
+        sporkManager->UpdateSpork(sporkId, 0, *test_setup.m_node.connman);
+    }
+    ::masternodeSync->SwitchToNextAsset();
+
+    const auto txs = AddLooseTransactions(test_setup, SCRIPT_PUB);
+    test_setup.m_node.llmq_ctx->clhandler->CheckActiveState();
+    {
+        LOCK(test_setup.m_node.mempool->cs);
+        for (size_t i{0}; i < txs.size(); i += 2) {
+            test_setup.m_node.mempool->SetInstantSendLocked(txs[i]->GetHash());
+        }
+    }
 
     bench.minEpochIterations(700).run([&] {
         PrepareBlock(test_setup.m_node, SCRIPT_PUB);
@@ -52,3 +97,4 @@ static void AssembleBlock(benchmark::Bench& bench)
 }
 
 BENCHMARK(AssembleBlock);
+BENCHMARK(AssembleBlockInstantSend);
@@ -4,6 +4,7 @@
 
 #include <bench/bench.h>
 #include <random.h>
+#include <bls/bls_batchverifier.h>
 #include <bls/bls_worker.h>
 #include <util/time.h>
 
@@ -357,6 +358,98 @@ static void BLS_Verify_BatchedParallel(benchmark::Bench& bench)
     blsWorker.Stop();
 }
 
+static void BLS_Verify_BatchVerifier(size_t invalidCount, bool parallel, benchmark::Bench& bench)
+{
+    BLSPublicKeyVector pubKeys;
+    BLSSecretKeyVector secKeys;
+    BLSSignatureVector sigs;
+    std::vector<uint256> msgHashes;
+    std::vector<bool> invalid;
+    BuildTestVectors(1000, invalidCount, pubKeys, secKeys, sigs, msgHashes, invalid);
+
+    // 1000 messages from 50 sources
+    const size_t sourceCount = 50;
+    std::set<size_t> expectedBadSources;
+    for (size_t i = 0; i < invalid.size(); i++) {
+        if (invalid[i]) {
+            expectedBadSources.emplace(i % sourceCount);
+        }
+    }
+
+    CBLSWorker blsWorker;
+    blsWorker.Start();
+
+    // Benchmark.
+    bench.minEpochIterations(1).run([&] {
+        CBLSBatchVerifier<size_t, size_t> batchVerifier(false, true, 0, parallel ? &blsWorker : nullptr);
+        for (size_t i = 0; i < pubKeys.size(); i++) {
+            batchVerifier.PushMessage(i % sourceCount, i, msgHashes[i], sigs[i], pubKeys[i]);
+        }
+        batchVerifier.Verify();
+        assert(batchVerifier.badSources == expectedBadSources);
+        assert(batchVerifier.badMessages.size() == invalidCount);
+    });
+
+    blsWorker.Stop();
+}
+
+static void BLS_Verify_BatchVerifier1000(benchmark::Bench& bench)
+{
+    BLS_Verify_BatchVerifier(0, false, bench);
+}
+
+static void BLS_Verify_BatchVerifier1000Parallel(benchmark::Bench& bench)
+{
+    BLS_Verify_BatchVerifier(0, true, bench);
+}
+
+static void BLS_Verify_BatchVerifier1000Invalid10(benchmark::Bench& bench)
+{
+    BLS_Verify_BatchVerifier(10, false, bench);
+}
+
+static void BLS_Verify_BatchVerifier1000Invalid10Parallel(benchmark::Bench& bench)
+{
+    BLS_Verify_BatchVerifier(10, true, bench);
+}
+
+// Recovery of a threshold signature from the shares of 60 members (threshold of LLMQ_100_67)
+static void BLS_Recover(bool reuseCoefficients, benchmark::Bench& bench)
+{
+    const size_t threshold = 60;
+    std::vector<CBLSSignature> sigShares(threshold);
+    std::vector<CBLSId> ids;
+    for (size_t i = 0; i < threshold; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        sigShares[i] = sk.Sign(GetRandHash());
+        ids.emplace_back(GetRandHash());
+    }
+
+    CBLSLagrangeCoefficients coefficients;
+    coefficients.Compute(ids);
+
+    // Benchmark.
+    bench.minEpochIterations(5).run([&] {
+        CBLSSignature recoveredSig;
+        if (reuseCoefficients) {
+            assert(recoveredSig.Recover(sigShares, coefficients));
+        } else {
+            assert(recoveredSig.Recover(sigShares, ids));
+        }
+    });
+}
+
+static void BLS_Recover_Ids(benchmark::Bench& bench)
+{
+    BLS_Recover(false, bench);
+}
+
+static void BLS_Recover_CachedCoefficients(benchmark::Bench& bench)
+{
+    BLS_Recover(true, bench);
+}
+
 BENCHMARK(BLS_PubKeyAggregate_Normal)
 BENCHMARK(BLS_SecKeyAggregate_Normal)
 BENCHMARK(BLS_SignatureAggregate_Normal)
@@ -371,3 +464,9 @@ BENCHMARK(BLS_Verify_LargeAggregatedBlock1000)
 BENCHMARK(BLS_Verify_LargeAggregatedBlock1000PreVerified)
 BENCHMARK(BLS_Verify_Batched)
 BENCHMARK(BLS_Verify_BatchedParallel)
+BENCHMARK(BLS_Verify_BatchVerifier1000)
+BENCHMARK(BLS_Verify_BatchVerifier1000Parallel)
+BENCHMARK(BLS_Verify_BatchVerifier1000Invalid10)
+BENCHMARK(BLS_Verify_BatchVerifier1000Invalid10Parallel)
+BENCHMARK(BLS_Recover_Ids)
+BENCHMARK(BLS_Recover_CachedCoefficients)
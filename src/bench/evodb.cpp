@@ -0,0 +1,97 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <evo/evodb.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Roughly what a block writes to the evodb: a DMN list diff, mined commitments and their indexes and the best block
+constexpr size_t WRITES_PER_BLOCK{32};
+constexpr size_t READS_PER_BLOCK{16};
+// How often the root transaction is flushed to the database, during sync it is rather done by memory usage
+constexpr int BLOCKS_PER_FLUSH{100};
+
+using EvoKey = std::pair<std::string, uint256>;
+
+struct BlockWrites {
+    std::vector<EvoKey> keys;
+    std::vector<std::vector<unsigned char>> values;
+};
+
+std::vector<BlockWrites> MakeBlocks(size_t count)
+{
+    FastRandomContext rand(true);
+    std::vector<BlockWrites> blocks(count);
+    for (auto& block : blocks) {
+        for (size_t i = 0; i < WRITES_PER_BLOCK; i++) {
+            block.keys.emplace_back(i % 4 == 0 ? "dmn_D3" : "q_mc", rand.rand256());
+            block.values.emplace_back(rand.randbytes(100 + rand.randrange(500)));
+        }
+    }
+    return blocks;
+}
+
+} // namespace
+
+static void EvoDB_BlockConnect(benchmark::Bench& bench)
+{
+    CEvoDB evoDb(1 << 20, true, true);
+    const auto blocks = MakeBlocks(BLOCKS_PER_FLUSH);
+
+    int height{0};
+    bench.batch(WRITES_PER_BLOCK).unit("write").run([&] {
+        const auto& block = blocks[height % blocks.size()];
+        {
+            auto dbTx = evoDb.BeginTransaction();
+            for (size_t i = 0; i < WRITES_PER_BLOCK; i++) {
+                evoDb.Write(block.keys[i], block.values[i]);
+            }
+            std::vector<unsigned char> value;
+            for (size_t i = 0; i < READS_PER_BLOCK; i++) {
+                evoDb.Read(block.keys[i * 2], value);
+            }
+            evoDb.WriteBestBlock(block.keys[0].second);
+            dbTx->Commit();
+        }
+        if (++height % BLOCKS_PER_FLUSH == 0) {
+            evoDb.CommitRootTransaction();
+        }
+    });
+}
+
+static void EvoDB_BlockDisconnect(benchmark::Bench& bench)
+{
+    CEvoDB evoDb(1 << 20, true, true);
+    const auto blocks = MakeBlocks(BLOCKS_PER_FLUSH);
+
+    int height{0};
+    bench.batch(WRITES_PER_BLOCK).unit("write").run([&] {
+        const auto& block = blocks[height % blocks.size()];
+        {
+            auto dbTx = evoDb.BeginTransaction();
+            std::vector<unsigned char> value;
+            for (size_t i = 0; i < READS_PER_BLOCK; i++) {
+                evoDb.Read(block.keys[i * 2], value);
+            }
+            for (size_t i = 0; i < WRITES_PER_BLOCK; i++) {
+                evoDb.Erase(block.keys[i]);
+            }
+            evoDb.WriteBestBlock(block.keys[1].second);
+            dbTx->Commit();
+        }
+        if (++height % BLOCKS_PER_FLUSH == 0) {
+            evoDb.CommitRootTransaction();
+        }
+    });
+}
+
+BENCHMARK(EvoDB_BlockConnect);
+BENCHMARK(EvoDB_BlockDisconnect);
@@ -0,0 +1,373 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bls/bls.h>
+#include <bls/bls_batchverifier.h>
+#include <chainparams.h>
+#include <evo/deterministicmns.h>
+#include <hash.h>
+#include <llmq/commitment.h>
+#include <llmq/context.h>
+#include <llmq/instantsend.h>
+#include <llmq/quorums.h>
+#include <llmq/signing.h>
+#include <llmq/signing_shares.h>
+#include <llmq/utils.h>
+#include <masternode/node.h>
+#include <primitives/transaction.h>
+#include <protocol.h>
+#include <random.h>
+#include <saltedhasher.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <util/irange.h>
+#include <version.h>
+
+using namespace llmq;
+
+namespace {
+
+// A message as it was put on the simulated wire by InstantSendSimulation::Run
+struct RecordedMessage {
+    std::string msgType;
+    std::vector<unsigned char> payload;
+};
+
+// In-memory model of the InstantSend signing pipeline of a single quorum. Every member creates its shares through the
+// node's CSigSharesManager and exchanges them as QSIGSHARE messages. A receiving node batch verifies the shares and
+// recovers every session as soon as a threshold of shares is known, using the quorum's public key shares and Lagrange
+// coefficients. The resulting ISDLOCKs are verified against the quorum public key. They are not handed to the node's
+// CInstantSendManager, as it could not verify them against a quorum which was never mined. All keys and transactions
+// are derived from a fixed seed, so every run signs the same messages.
+class InstantSendSimulation
+{
+private:
+    const NodeContext& node;
+    const Consensus::LLMQParams params;
+
+    FastRandomContext rng{true};
+    uint256 quorumHash;
+    CBLSPublicKey quorumPublicKey;
+    // one quorum object per member holding that member's secret key share, and one for the receiving node
+    std::vector<CQuorumCPtr> memberQuorums;
+    CQuorumCPtr receiverQuorum;
+
+    // Shares collected for a signing session, keyed by member
+    struct Session {
+        uint256 id;
+        uint256 msgHash;
+        std::map<uint16_t, CBLSSignature> sigShares;
+        bool recovered{false};
+    };
+    std::unordered_map<uint256, Session, StaticSaltedHasher> sessions;
+
+    std::vector<RecordedMessage>* recording{nullptr};
+
+    static Consensus::LLMQParams MakeParams(size_t quorumSize, size_t threshold)
+    {
+        auto params = GetLLMQParams(Params().GetConsensus().llmqTypeDIP0024InstantSend);
+        params.size = int(quorumSize);
+        params.minSize = int(threshold);
+        params.threshold = int(threshold);
+        return params;
+    }
+
+    CBLSSecretKey MakeSecretKey()
+    {
+        CBLSSecretKey sk;
+        while (!sk.IsValid()) {
+            sk.SetByteVector(rng.randbytes(CBLSSecretKey::SerSize));
+        }
+        return sk;
+    }
+
+    std::shared_ptr<CQuorum> MakeQuorum(const std::vector<CDeterministicMNCPtr>& members, const BLSVerificationVector& vvec)
+    {
+        auto qc = std::make_unique<CFinalCommitment>(params, quorumHash);
+        qc->validMembers.assign(members.size(), true);
+        qc->quorumPublicKey = quorumPublicKey;
+        qc->quorumVvecHash = ::SerializeHash(vvec);
+
+        auto quorum = std::make_shared<CQuorum>(params, *node.llmq_ctx->bls_worker);
+        quorum->Init(std::move(qc), nullptr, uint256(), members);
+        bool ok = quorum->SetVerificationVector(vvec);
+        assert(ok);
+        return quorum;
+    }
+
+    void Send(const std::string& msgType, const CDataStream& ds)
+    {
+        if (recording != nullptr) {
+            recording->push_back({msgType, std::vector<unsigned char>(ds.begin(), ds.end())});
+        }
+    }
+
+    // Member side: create the shares of all sessions and put them on the wire as one QSIGSHARE message
+    CDataStream SignShares(uint16_t member, const std::vector<std::pair<uint256, uint256>>& toSign)
+    {
+        const auto& quorum = memberQuorums[member];
+        WITH_LOCK(activeMasternodeInfoCs, activeMasternodeInfo.proTxHash = quorum->members[member]->proTxHash);
+
+        std::vector<CSigShare> sigShares;
+        sigShares.reserve(toSign.size());
+        for (const auto& [id, msgHash] : toSign) {
+            auto sigShare = node.llmq_ctx->shareman->CreateSigShare(quorum, id, msgHash);
+            assert(sigShare);
+            sigShares.emplace_back(std::move(*sigShare));
+        }
+        CDataStream ds(SER_NETWORK, PROTOCOL_VERSION);
+        ds << sigShares;
+        Send(NetMsgType::QSIGSHARE, ds);
+        return ds;
+    }
+
+    // Receiver side: verify the shares of one message in a batch and recover every session which reached the threshold
+    void ProcessSigShares(CDataStream& ds, std::vector<CRecoveredSig>& recoveredRet)
+    {
+        std::vector<CSigShare> sigShares;
+        ds >> sigShares;
+
+        CBLSBatchVerifier<uint16_t, SigShareKey> batchVerifier(false, true);
+        for (const auto& sigShare : sigShares) {
+            batchVerifier.PushMessage(sigShare.getQuorumMember(), sigShare.GetKey(), sigShare.GetSignHash(), sigShare.sigShare.Get(),
+                                      receiverQuorum->GetPubKeyShare(sigShare.getQuorumMember()));
+        }
+        batchVerifier.Verify();
+        assert(batchVerifier.badSources.empty());
+
+        std::vector<uint256> toRecover;
+        for (const auto& sigShare : sigShares) {
+            auto& session = sessions[sigShare.GetSignHash()];
+            if (session.recovered) {
+                continue;
+            }
+            session.id = sigShare.getId();
+            session.msgHash = sigShare.getMsgHash();
+            session.sigShares.emplace(sigShare.getQuorumMember(), sigShare.sigShare.Get());
+            if (session.sigShares.size() == size_t(params.threshold)) {
+                toRecover.emplace_back(sigShare.GetSignHash());
+            }
+        }
+
+        CBLSBatchVerifier<uint256, uint256> recSigVerifier(false, false);
+        for (const auto& signHash : toRecover) {
+            auto& session = sessions.at(signHash);
+            std::vector<uint16_t> members;
+            BLSSignatureVector sigs;
+            for (const auto& [member, sig] : session.sigShares) {
+                members.emplace_back(member);
+                sigs.emplace_back(sig);
+            }
+            const auto coefficients = receiverQuorum->GetLagrangeCoefficients(members);
+            assert(coefficients);
+            CBLSSignature recoveredSig;
+            bool ok = recoveredSig.Recover(sigs, *coefficients);
+            assert(ok);
+            session.recovered = true;
+            session.sigShares.clear();
+
+            recSigVerifier.PushMessage(signHash, signHash, signHash, recoveredSig, quorumPublicKey);
+            recoveredRet.emplace_back(params.type, quorumHash, session.id, session.msgHash, recoveredSig);
+        }
+        recSigVerifier.Verify();
+        assert(recSigVerifier.badMessages.empty());
+    }
+
+    // Runs one signing round: every member signs all sessions and the receiver processes the resulting messages
+    std::vector<CRecoveredSig> SigningRound(const std::vector<std::pair<uint256, uint256>>& toSign)
+    {
+        std::vector<CRecoveredSig> recovered;
+        if (toSign.empty()) {
+            return recovered;
+        }
+        for (const auto member : irange::range(memberQuorums.size())) {
+            auto ds = SignShares(uint16_t(member), toSign);
+            ProcessSigShares(ds, recovered);
+        }
+        return recovered;
+    }
+
+    // Receiver side: queue the verification of an ISDLOCK against the quorum public key
+    void VerifyInstantSendLock(CDataStream& ds, CBLSBatchVerifier<uint256, uint256>& verifier)
+    {
+        CInstantSendLock islock(CInstantSendLock::isdlock_version);
+        ds >> islock;
+        auto signHash = llmq::utils::BuildSignHash(params.type, quorumHash, islock.GetRequestId(), islock.txid);
+        verifier.PushMessage(islock.txid, islock.txid, signHash, islock.sig.Get(), quorumPublicKey);
+    }
+
+public:
+    InstantSendSimulation(const NodeContext& _node, size_t quorumSize, size_t threshold) :
+        node(_node),
+        params(MakeParams(quorumSize, threshold))
+    {
+        quorumHash = rng.rand256();
+
+        std::vector<CDeterministicMNCPtr> members;
+        std::vector<CBLSId> memberIds;
+        for (const auto i : irange::range(quorumSize)) {
+            auto dmn = std::make_shared<CDeterministicMN>(i);
+            dmn->proTxHash = rng.rand256();
+            memberIds.emplace_back(dmn->proTxHash);
+            members.emplace_back(dmn);
+        }
+
+        BLSSecretKeyVector msk;
+        BLSVerificationVector vvec;
+        for ([[maybe_unused]] const auto _ : irange::range(threshold)) {
+            msk.emplace_back(MakeSecretKey());
+            vvec.emplace_back(msk.back().GetPublicKey());
+        }
+        quorumPublicKey = vvec[0];
+
+        for (const auto i : irange::range(quorumSize)) {
+            auto quorum = MakeQuorum(members, vvec);
+            CBLSSecretKey skShare;
+            bool ok = skShare.SecretKeyShare(msk, memberIds[i]);
+            assert(ok);
+            WITH_LOCK(activeMasternodeInfoCs, activeMasternodeInfo.proTxHash = members[i]->proTxHash);
+            ok = quorum->SetSecretKeyShare(skShare);
+            assert(ok);
+            memberQuorums.emplace_back(quorum);
+        }
+        receiverQuorum = MakeQuorum(members, vvec);
+        WITH_LOCK(activeMasternodeInfoCs, activeMasternodeInfo.proTxHash = uint256());
+    }
+    ~InstantSendSimulation()
+    {
+        WITH_LOCK(activeMasternodeInfoCs, activeMasternodeInfo.proTxHash = uint256());
+    }
+
+    // Creates txCount transactions and signs their input locks and ISDLOCKs in rounds of batchSize transactions. Every
+    // ISDLOCK is verified, unless the run is only recorded for a later replay. Returns the number of ISDLOCKs
+    size_t Run(size_t txCount, size_t inputsPerTx, size_t batchSize, std::vector<RecordedMessage>* _recording = nullptr)
+    {
+        recording = _recording;
+        sessions.clear();
+
+        std::vector<CTransactionRef> txs;
+        txs.reserve(txCount);
+        for ([[maybe_unused]] const auto _ : irange::range(txCount)) {
+            CMutableTransaction tx;
+            for ([[maybe_unused]] const auto __ : irange::range(inputsPerTx)) {
+                tx.vin.emplace_back(COutPoint(rng.rand256(), 0));
+            }
+            tx.vout.emplace_back(1 * COIN, CScript());
+            txs.emplace_back(MakeTransactionRef(tx));
+        }
+
+        size_t locks{0};
+        CBLSBatchVerifier<uint256, uint256> islockVerifier(false, false);
+        for (size_t batchStart = 0; batchStart < txs.size(); batchStart += batchSize) {
+            const auto batchEnd = std::min(txs.size(), batchStart + batchSize);
+
+            // input locks
+            std::vector<std::pair<uint256, uint256>> toSign;
+            for (const auto i : irange::range(batchStart, batchEnd)) {
+                for (const auto& in : txs[i]->vin) {
+                    toSign.emplace_back(::SerializeHash(std::make_pair(INPUTLOCK_REQUESTID_PREFIX, in.prevout)), txs[i]->GetHash());
+                }
+            }
+            auto inputLocks = SigningRound(toSign);
+            assert(inputLocks.size() == toSign.size());
+
+            // ISDLOCKs
+            std::unordered_map<uint256, CInstantSendLock, StaticSaltedHasher> islocks;
+            toSign.clear();
+            for (const auto i : irange::range(batchStart, batchEnd)) {
+                CInstantSendLock islock(CInstantSendLock::isdlock_version);
+                islock.txid = txs[i]->GetHash();
+                islock.cycleHash = quorumHash;
+                for (const auto& in : txs[i]->vin) {
+                    islock.inputs.emplace_back(in.prevout);
+                }
+                toSign.emplace_back(islock.GetRequestId(), islock.txid);
+                islocks.emplace(islock.txid, std::move(islock));
+            }
+            for (const auto& recSig : SigningRound(toSign)) {
+                auto& islock = islocks.at(recSig.getMsgHash());
+                islock.sig = recSig.sig;
+
+                CDataStream ds(SER_NETWORK, PROTOCOL_VERSION);
+                ds << islock;
+                if (recording != nullptr) {
+                    Send(NetMsgType::ISDLOCK, ds);
+                } else {
+                    VerifyInstantSendLock(ds, islockVerifier);
+                }
+                locks++;
+            }
+        }
+        islockVerifier.Verify();
+        assert(islockVerifier.badMessages.empty());
+        recording = nullptr;
+        return locks;
+    }
+
+    // Processes messages recorded by Run the way a non-member node would: sig shares are verified and recovered,
+    // ISDLOCKs are verified. Returns the number of ISDLOCKs
+    size_t Replay(const std::vector<RecordedMessage>& messages)
+    {
+        sessions.clear();
+
+        size_t locks{0};
+        std::vector<CRecoveredSig> recovered;
+        CBLSBatchVerifier<uint256, uint256> islockVerifier(false, false);
+        for (const auto& msg : messages) {
+            CDataStream ds(msg.payload, SER_NETWORK, PROTOCOL_VERSION);
+            if (msg.msgType == NetMsgType::QSIGSHARE) {
+                ProcessSigShares(ds, recovered);
+            } else {
+                assert(msg.msgType == NetMsgType::ISDLOCK);
+                VerifyInstantSendLock(ds, islockVerifier);
+                locks++;
+            }
+        }
+        islockVerifier.Verify();
+        assert(islockVerifier.badMessages.empty());
+        return locks;
+    }
+};
+
+} // anonymous namespace
+
+// Signs and recovers the input locks and ISDLOCKs of txCount transactions with two inputs each, batchSize transactions
+// per signing round, and verifies the ISDLOCKs
+static void InstantSend_SignRecover(benchmark::Bench& bench, size_t quorumSize, size_t threshold, size_t txCount, size_t batchSize)
+{
+    RegTestingSetup test_setup;
+    InstantSendSimulation sim(test_setup.m_node, quorumSize, threshold);
+
+    bench.batch(txCount).unit("tx").run([&] {
+        auto locks = sim.Run(txCount, 2, batchSize);
+        assert(locks == txCount);
+    });
+}
+
+// Verifies and recovers the sig shares recorded by a single run and verifies the resulting ISDLOCKs, i.e. the work of a
+// node which is not a member of the quorum
+static void InstantSend_VerifyRecover(benchmark::Bench& bench, size_t quorumSize, size_t threshold, size_t txCount)
+{
+    RegTestingSetup test_setup;
+    InstantSendSimulation sim(test_setup.m_node, quorumSize, threshold);
+
+    std::vector<RecordedMessage> recording;
+    sim.Run(txCount, 2, txCount, &recording);
+
+    bench.batch(txCount).unit("tx").run([&] {
+        auto locks = sim.Replay(recording);
+        assert(locks == txCount);
+    });
+}
+
+static void InstantSend_SignRecover_10_1(benchmark::Bench& bench) { InstantSend_SignRecover(bench, 10, 6, 1, 1); }
+static void InstantSend_SignRecover_10_32(benchmark::Bench& bench) { InstantSend_SignRecover(bench, 10, 6, 32, 32); }
+static void InstantSend_SignRecover_10_128(benchmark::Bench& bench) { InstantSend_SignRecover(bench, 10, 6, 128, 32); }
+static void InstantSend_VerifyRecover_10_32(benchmark::Bench& bench) { InstantSend_VerifyRecover(bench, 10, 6, 32); }
+
+BENCHMARK(InstantSend_SignRecover_10_1)
+BENCHMARK(InstantSend_SignRecover_10_32)
+BENCHMARK(InstantSend_SignRecover_10_128)
+BENCHMARK(InstantSend_VerifyRecover_10_32)
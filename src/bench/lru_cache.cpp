@@ -0,0 +1,69 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <random.h>
+#include <saltedhasher.h>
+#include <uint256.h>
+#include <unordered_lru_cache.h>
+
+#include <vector>
+
+static constexpr size_t CACHE_SIZE{10000};
+
+static std::vector<uint256> MakeKeys(size_t count)
+{
+    FastRandomContext rng(true);
+    std::vector<uint256> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        keys.emplace_back(rng.rand256());
+    }
+    return keys;
+}
+
+// Every insert misses and evicts the least recently used entry once the cache is full
+static void LRUCacheInsertEvict(benchmark::Bench& bench)
+{
+    const auto keys = MakeKeys(CACHE_SIZE * 4);
+    unordered_lru_cache<uint256, bool, StaticSaltedHasher> cache(CACHE_SIZE);
+    size_t i = 0;
+    bench.run([&] {
+        cache.insert(keys[i++ % keys.size()], true);
+    });
+}
+
+// Lookups of keys which are all resident in the cache
+static void LRUCacheHit(benchmark::Bench& bench)
+{
+    const auto keys = MakeKeys(CACHE_SIZE);
+    unordered_lru_cache<uint256, bool, StaticSaltedHasher> cache(CACHE_SIZE);
+    for (const auto& key : keys) {
+        cache.insert(key, true);
+    }
+    size_t i = 0;
+    bool v;
+    bench.run([&] {
+        cache.get(keys[i++ % keys.size()], v);
+    });
+}
+
+// Lookups with a working set twice the cache size, half of which miss and get inserted
+static void LRUCacheMixed(benchmark::Bench& bench)
+{
+    const auto keys = MakeKeys(CACHE_SIZE * 2);
+    unordered_lru_cache<uint256, bool, StaticSaltedHasher> cache(CACHE_SIZE);
+    FastRandomContext rng(true);
+    bool v;
+    bench.run([&] {
+        const auto& key = keys[rng.randrange(keys.size())];
+        if (!cache.get(key, v)) {
+            cache.insert(key, true);
+        }
+    });
+}
+
+BENCHMARK(LRUCacheInsertEvict);
+BENCHMARK(LRUCacheHit);
+BENCHMARK(LRUCacheMixed);
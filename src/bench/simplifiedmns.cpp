@@ -0,0 +1,119 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bls/bls.h>
+#include <arith_uint256.h>
+#include <consensus/merkle.h>
+#include <crypto/sha256.h>
+#include <evo/deterministicmns.h>
+#include <evo/simplifiedmns.h>
+#include <netbase.h>
+#include <random.h>
+#include <tinyformat.h>
+
+static const CDeterministicMNList& GetTestMNList(size_t count)
+{
+    static std::map<size_t, CDeterministicMNList> lists;
+    auto it = lists.find(count);
+    if (it != lists.end()) {
+        return it->second;
+    }
+
+    FastRandomContext rng(true);
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    for (uint64_t i = 0; i < count; i++) {
+        auto dmn = std::make_shared<CDeterministicMN>(i);
+        dmn->proTxHash = rng.rand256();
+        dmn->collateralOutpoint = COutPoint(rng.rand256(), 0);
+        auto state = std::make_shared<CDeterministicMNState>();
+        state->confirmedHash = rng.rand256();
+        state->keyIDOwner = CKeyID(uint160(rng.randbytes(20)));
+        state->keyIDVoting = CKeyID(uint160(rng.randbytes(20)));
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        state->pubKeyOperator.Set(sk.GetPublicKey());
+        Lookup(strprintf("1.%d.%d.%d", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff).c_str(), state->addr, 9999, false);
+        dmn->pdmnState = state;
+        mnList.AddMN(dmn);
+    }
+    return lists.emplace(count, std::move(mnList)).first->second;
+}
+
+// Builds the SML and rehashes every entry, like CSimplifiedMNList did before entry hashes were memoized
+static void SimplifiedMNList_Uncached(benchmark::Bench& bench, size_t count)
+{
+    bls::bls_legacy_scheme.store(true);
+    const auto& mnList = GetTestMNList(count);
+
+    bench.batch(count).unit("mn").run([&] {
+        std::vector<std::unique_ptr<CSimplifiedMNListEntry>> entries;
+        entries.reserve(count);
+        mnList.ForEachMN(false, [&](const auto& dmn) {
+            auto sme = std::make_unique<CSimplifiedMNListEntry>(dmn);
+            sme->nVersion = CSimplifiedMNListEntry::LEGACY_BLS_VERSION;
+            entries.emplace_back(std::move(sme));
+        });
+        std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a->proRegTxHash.Compare(b->proRegTxHash) < 0;
+        });
+        std::vector<uint256> leaves;
+        leaves.reserve(entries.size());
+        for (const auto& e : entries) {
+            leaves.emplace_back(e->CalcHash());
+        }
+        ankerl::nanobench::doNotOptimizeAway(ComputeMerkleRoot(std::move(leaves)));
+    });
+}
+
+static void SimplifiedMNList_Cached(benchmark::Bench& bench, size_t count)
+{
+    bls::bls_legacy_scheme.store(true);
+    const auto& mnList = GetTestMNList(count);
+
+    bench.batch(count).unit("mn").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(CSimplifiedMNList(mnList, false).CalcMerkleRoot());
+    });
+}
+
+// Scores every MN with its own CSHA256 instance, like CDeterministicMNList::CalculateScores did before using SHA256S64
+static void MNScores_Single(benchmark::Bench& bench, size_t count)
+{
+    const auto& mnList = GetTestMNList(count);
+    const uint256 modifier = uint256S("0x1234");
+
+    bench.batch(count).unit("mn").run([&] {
+        std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
+        scores.reserve(count);
+        mnList.ForEachMNShared(true, [&](const CDeterministicMNCPtr& dmn) {
+            uint256 h;
+            CSHA256()
+                .Write(dmn->pdmnState->confirmedHashWithProRegTxHash.begin(), dmn->pdmnState->confirmedHashWithProRegTxHash.size())
+                .Write(modifier.begin(), modifier.size())
+                .Finalize(h.begin());
+            scores.emplace_back(UintToArith256(h), dmn);
+        });
+        ankerl::nanobench::doNotOptimizeAway(scores);
+    });
+}
+
+static void MNScores_Batched(benchmark::Bench& bench, size_t count)
+{
+    const auto& mnList = GetTestMNList(count);
+    const uint256 modifier = uint256S("0x1234");
+
+    bench.batch(count).unit("mn").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(mnList.CalculateScores(modifier));
+    });
+}
+
+static void SimplifiedMNList_Uncached_5000(benchmark::Bench& bench) { SimplifiedMNList_Uncached(bench, 5000); }
+static void SimplifiedMNList_Cached_5000(benchmark::Bench& bench) { SimplifiedMNList_Cached(bench, 5000); }
+static void MNScores_Single_10000(benchmark::Bench& bench) { MNScores_Single(bench, 10000); }
+static void MNScores_Batched_10000(benchmark::Bench& bench) { MNScores_Batched(bench, 10000); }
+
+BENCHMARK(SimplifiedMNList_Uncached_5000)
+BENCHMARK(SimplifiedMNList_Cached_5000)
+BENCHMARK(MNScores_Single_10000)
+BENCHMARK(MNScores_Batched_10000)
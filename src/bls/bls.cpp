@@ -4,6 +4,7 @@
 
 #include <bls/bls.h>
 
+#include <memusage.h>
 #include <random.h>
 
 #ifndef BUILD_BITCOIN_INTERNAL
@@ -349,6 +350,118 @@ bool CBLSSignature::Recover(const std::vector<CBLSSignature>& sigs, const std::v
     return true;
 }
 
+namespace {
+// Owns a relic bignum, so that all of them are freed on every return path
+struct CBLSBigNum {
+    bn_t n;
+    CBLSBigNum() { bn_new(n); }
+    ~CBLSBigNum() { bn_free(n); }
+    CBLSBigNum(const CBLSBigNum&) = delete;
+    CBLSBigNum& operator=(const CBLSBigNum&) = delete;
+};
+} // anonymous namespace
+
+bool CBLSSignature::Recover(const std::vector<CBLSSignature>& sigs, const CBLSLagrangeCoefficients& coefficients)
+{
+    fValid = false;
+    cachedHash.SetNull();
+
+    if (sigs.size() < 2 || sigs.size() != coefficients.size()) {
+        return false;
+    }
+
+    // f(0) = sum_i f(S[i]) * delta_{i,S}(0), same as bls::Threshold::SignatureRecover but with precomputed deltas
+    try {
+        CBLSBigNum delta;
+        bls::G2Element sum;
+        for (size_t i = 0; i < sigs.size(); i++) {
+            if (!sigs[i].IsValid()) {
+                return false;
+            }
+            bn_read_bin(delta.n, coefficients.coefficients[i].data(), coefficients.coefficients[i].size());
+            sum += sigs[i].impl * delta.n;
+        }
+        impl = sum;
+    } catch (...) {
+        return false;
+    }
+
+    fValid = true;
+    cachedHash.SetNull();
+    return true;
+}
+
+bool CBLSLagrangeCoefficients::Compute(const std::vector<CBLSId>& ids)
+{
+    coefficients.clear();
+
+    const size_t k = ids.size();
+    if (k < 2) {
+        return false;
+    }
+
+    /*
+        Same as the interpolation in bls::Threshold, kept here to not diverge from the upstream BLS library:
+        delta_{i,S}(0) = prod_{j != i} S[j] / (S[j] - S[i]) = a / b
+        where a = prod S[j], b = S[i] * prod_{j != i} (S[j] - S[i])
+    */
+    try {
+        CBLSBigNum order, a, b, v, iv;
+        gt_get_ord(order.n);
+
+        std::vector<CBLSBigNum> idNums(k);
+        for (size_t i = 0; i < k; i++) {
+            if (!ids[i].IsValid()) {
+                return false;
+            }
+            bn_read_bin(idNums[i].n, ids[i].impl.begin(), BLS_CURVE_ID_SIZE);
+            bn_mod(idNums[i].n, idNums[i].n, order.n);
+        }
+
+        bn_copy(a.n, idNums[0].n);
+        for (size_t i = 1; i < k; i++) {
+            bn_mul(a.n, a.n, idNums[i].n);
+            bn_mod(a.n, a.n, order.n);
+        }
+        if (bn_is_zero(a.n)) {
+            return false;
+        }
+
+        std::vector<std::vector<uint8_t>> vecDeltas(k, std::vector<uint8_t>(BLS_CURVE_ID_SIZE));
+        for (size_t i = 0; i < k; i++) {
+            bn_copy(b.n, idNums[i].n);
+            for (size_t j = 0; j < k; j++) {
+                if (j == i) continue;
+                bn_sub(v.n, idNums[j].n, idNums[i].n);
+                bn_mod(v.n, v.n, order.n);
+                if (bn_is_zero(v.n)) {
+                    // duplicate id
+                    return false;
+                }
+                bn_mul(b.n, b.n, v.n);
+                bn_mod(b.n, b.n, order.n);
+            }
+            bn_mod_inv(iv.n, b.n, order.n);
+            bn_mul(v.n, a.n, iv.n);
+            bn_mod(v.n, v.n, order.n);
+            bn_write_bin(vecDeltas[i].data(), vecDeltas[i].size(), v.n);
+        }
+        coefficients = std::move(vecDeltas);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+size_t CBLSLagrangeCoefficients::DynamicMemoryUsage() const
+{
+    size_t ret = memusage::DynamicUsage(coefficients);
+    for (const auto& c : coefficients) {
+        ret += memusage::DynamicUsage(c);
+    }
+    return ret;
+}
+
 #ifndef BUILD_BITCOIN_INTERNAL
 
 static std::once_flag init_flag;
@@ -40,6 +40,7 @@ constexpr int BLS_CURVE_SIG_SIZE{96};
 
 class CBLSSignature;
 class CBLSPublicKey;
+class CBLSLagrangeCoefficients;
 
 template <typename ImplType, size_t _SerSize, typename C>
 class CBLSWrapper
@@ -47,6 +48,7 @@ class CBLSWrapper
     friend class CBLSSecretKey;
     friend class CBLSPublicKey;
     friend class CBLSSignature;
+    friend class CBLSLagrangeCoefficients;
 
 protected:
     ImplType impl;
@@ -367,6 +369,25 @@ public:
     [[nodiscard]] bool VerifySecureAggregated(const std::vector<CBLSPublicKey>& pks, const uint256& hash) const;
 
     bool Recover(const std::vector<CBLSSignature>& sigs, const std::vector<CBLSId>& ids);
+    bool Recover(const std::vector<CBLSSignature>& sigs, const CBLSLagrangeCoefficients& coefficients);
+};
+
+// Lagrange coefficients to recover a threshold signature from the shares of a fixed set of ids. They only depend on the
+// ids and require one modular inversion per id, so they should be computed once and reused when recovering many
+// signatures from the shares of the same members
+class CBLSLagrangeCoefficients
+{
+    friend class CBLSSignature;
+
+private:
+    std::vector<std::vector<uint8_t>> coefficients;
+
+public:
+    bool Compute(const std::vector<CBLSId>& ids);
+
+    bool IsValid() const { return !coefficients.empty(); }
+    size_t size() const { return coefficients.size(); }
+    size_t DynamicMemoryUsage() const;
 };
 
 class CBLSSignatureVersionWrapper {
@@ -6,8 +6,13 @@
 #define DASH_CRYPTO_BLS_BATCHVERIFIER_H
 
 #include <bls/bls.h>
+#include <bls/bls_worker.h>
 
+#include <algorithm>
+#include <future>
 #include <map>
+#include <memory>
+#include <set>
 #include <vector>
 
 template<typename SourceId, typename MessageId>
@@ -25,9 +30,13 @@ private:
     using MessageMapIterator = typename MessageMap::iterator;
     using MessagesBySourceMap = std::map<SourceId, std::vector<MessageMapIterator>>;
 
+    // Sub-batches are only verified concurrently if each of them has at least this many messages
+    static constexpr size_t MIN_PARALLEL_SUB_BATCH_SIZE = 16;
+
     bool secureVerification;
     bool perMessageFallback;
     size_t subBatchSize;
+    CBLSWorker* blsWorker;
 
     MessageMap messages;
     MessagesBySourceMap messagesBySource;
@@ -37,10 +46,11 @@ public:
     std::set<MessageId> badMessages;
 
 public:
-    CBLSBatchVerifier(bool _secureVerification, bool _perMessageFallback, size_t _subBatchSize = 0) :
+    CBLSBatchVerifier(bool _secureVerification, bool _perMessageFallback, size_t _subBatchSize = 0, CBLSWorker* _blsWorker = nullptr) :
             secureVerification(_secureVerification),
             perMessageFallback(_perMessageFallback),
-            subBatchSize(_subBatchSize)
+            subBatchSize(_subBatchSize),
+            blsWorker(_blsWorker)
     {
     }
 
@@ -70,77 +80,177 @@ public:
 
     void Verify()
     {
-        std::map<uint256, std::vector<MessageMapIterator>> byMessageHash;
-
-        for (auto it = messages.begin(); it != messages.end(); ++it) {
-            byMessageHash[it->second.msgHash].emplace_back(it);
+        std::vector<const std::vector<MessageMapIterator>*> sources;
+        sources.reserve(messagesBySource.size());
+        for (const auto& p : messagesBySource) {
+            sources.emplace_back(&p.second);
         }
 
-        if (VerifyBatch(byMessageHash)) {
-            // full batch is valid
+        // verify per source, falling back to per-message verification for the messages of bad sources
+        auto badSourceIdxs = FindBadItems(sources);
+        if (badSourceIdxs.empty()) {
             return;
         }
 
-        // revert to per-source verification
+        std::vector<std::vector<MessageMapIterator>> msgsToVerify;
+        std::set<MessageId> seen;
+        size_t idx = 0;
         for (const auto& p : messagesBySource) {
-            bool batchValid = false;
+            if (!badSourceIdxs.count(idx++)) {
+                continue;
+            }
+            badSources.emplace(p.first);
 
-            // no need to verify it again if there was just one source
-            if (messagesBySource.size() != 1) {
-                byMessageHash.clear();
-                for (auto it = p.second.begin(); it != p.second.end(); ++it) {
-                    byMessageHash[(*it)->second.msgHash].emplace_back(*it);
-                }
-                batchValid = VerifyBatch(byMessageHash);
+            if (!perMessageFallback) {
+                continue;
+            }
+            if (p.second.size() == 1) {
+                // no need to re-verify a single message
+                badMessages.emplace(p.second[0]->second.msgId);
+                continue;
             }
-            if (!batchValid) {
-                badSources.emplace(p.first);
-
-                if (perMessageFallback) {
-                    // revert to per-message verification
-                    if (p.second.size() == 1) {
-                        // no need to re-verify a single message
-                        badMessages.emplace(p.second[0]->second.msgId);
-                    } else {
-                        for (const auto& msgIt : p.second) {
-                            if (badMessages.count(msgIt->first)) {
-                                // same message might be invalid from different source, so no need to re-verify it
-                                continue;
-                            }
-
-                            const auto& msg = msgIt->second;
-                            if (!msg.sig.VerifyInsecure(msg.pubKey, msg.msgHash)) {
-                                badMessages.emplace(msg.msgId);
-                            }
-                        }
-                    }
+            for (const auto& msgIt : p.second) {
+                // same message might be part of multiple bad sources, so only verify it once
+                if (seen.emplace(msgIt->first).second) {
+                    msgsToVerify.push_back({msgIt});
                 }
             }
         }
+
+        // drop messages that already turned out to be bad as the only message of a source
+        msgsToVerify.erase(std::remove_if(msgsToVerify.begin(), msgsToVerify.end(), [&](const auto& v) {
+            return badMessages.count(v[0]->first) != 0;
+        }), msgsToVerify.end());
+        if (msgsToVerify.empty()) {
+            return;
+        }
+
+        std::vector<const std::vector<MessageMapIterator>*> msgItems;
+        msgItems.reserve(msgsToVerify.size());
+        for (const auto& v : msgsToVerify) {
+            msgItems.emplace_back(&v);
+        }
+        for (const auto i : FindBadItems(msgItems)) {
+            badMessages.emplace(msgsToVerify[i][0]->second.msgId);
+        }
     }
 
 private:
-    // All Verify methods take ownership of the passed byMessageHash map and thus might modify the map. This is to avoid
-    // unnecessary copies
+    // Finds the items (the messages of a source or single messages) which fail verification. The items are verified in
+    // sub-batches, one per worker thread. Each failed sub-batch is split in halves which are verified again, until only
+    // single bad items remain. All sub-batches of a round are verified concurrently. Returns the indexes of bad items
+    std::set<size_t> FindBadItems(const std::vector<const std::vector<MessageMapIterator>*>& items)
+    {
+        std::set<size_t> ret;
+
+        // [begin, end) ranges of items
+        std::vector<std::pair<size_t, size_t>> ranges;
+        size_t msgCount = 0;
+        for (const auto* item : items) {
+            msgCount += item->size();
+        }
+        size_t subBatchCount = 1;
+        if (blsWorker != nullptr) {
+            subBatchCount = std::max<size_t>(1, std::min(blsWorker->GetWorkerCount(), msgCount / MIN_PARALLEL_SUB_BATCH_SIZE));
+        }
+        subBatchCount = std::min(subBatchCount, items.size());
+        for (size_t i = 0; i < subBatchCount; i++) {
+            ranges.emplace_back(items.size() * i / subBatchCount, items.size() * (i + 1) / subBatchCount);
+        }
+
+        while (!ranges.empty()) {
+            std::vector<std::vector<MessageMapIterator>> subBatches(ranges.size());
+            for (size_t i = 0; i < ranges.size(); i++) {
+                for (size_t j = ranges[i].first; j < ranges[i].second; j++) {
+                    subBatches[i].insert(subBatches[i].end(), items[j]->begin(), items[j]->end());
+                }
+            }
+
+            auto valid = VerifySubBatches(std::move(subBatches));
+
+            std::vector<std::pair<size_t, size_t>> nextRanges;
+            for (size_t i = 0; i < ranges.size(); i++) {
+                const auto [begin, end] = ranges[i];
+                if (valid[i]) {
+                    continue;
+                }
+                if (end - begin == 1) {
+                    ret.emplace(begin);
+                    continue;
+                }
+                const size_t mid = begin + (end - begin) / 2;
+                nextRanges.emplace_back(begin, mid);
+                nextRanges.emplace_back(mid, end);
+            }
+            ranges = std::move(nextRanges);
+        }
+
+        return ret;
+    }
+
+    std::vector<bool> VerifySubBatches(std::vector<std::vector<MessageMapIterator>>&& subBatches) const
+    {
+        std::vector<bool> ret(subBatches.size());
+        if (blsWorker == nullptr || subBatches.size() == 1) {
+            for (size_t i = 0; i < subBatches.size(); i++) {
+                ret[i] = VerifySubBatch(subBatches[i], secureVerification);
+            }
+            return ret;
+        }
 
-    bool VerifyBatch(std::map<uint256, std::vector<MessageMapIterator>>& byMessageHash)
+        // The jobs own their sub-batch, but the message iterators still point into this verifier. So every job that
+        // was pushed must be finished before we return, even if pushing or one of the jobs failed
+        std::vector<std::future<bool>> futures;
+        futures.reserve(subBatches.size());
+        const auto waitAll = [&futures]() {
+            for (const auto& f : futures) {
+                f.wait();
+            }
+        };
+        try {
+            for (auto& subBatch : subBatches) {
+                auto batch = std::make_shared<const std::vector<MessageMapIterator>>(std::move(subBatch));
+                futures.emplace_back(blsWorker->AsyncVerifyBatch([batch, secure = secureVerification]() {
+                    return VerifySubBatch(*batch, secure);
+                }));
+            }
+        } catch (...) {
+            waitAll();
+            throw;
+        }
+        waitAll();
+        for (size_t i = 0; i < futures.size(); i++) {
+            ret[i] = futures[i].get();
+        }
+        return ret;
+    }
+
+    // Only reads the messages, so it is safe to verify multiple sub-batches concurrently
+    static bool VerifySubBatch(const std::vector<MessageMapIterator>& subBatch, bool secure)
     {
-        if (secureVerification) {
+        std::map<uint256, std::vector<MessageMapIterator>> byMessageHash;
+        for (const auto& msgIt : subBatch) {
+            byMessageHash[msgIt->second.msgHash].emplace_back(msgIt);
+        }
+        if (secure) {
             return VerifyBatchSecure(byMessageHash);
         } else {
             return VerifyBatchInsecure(byMessageHash);
         }
     }
 
-    bool VerifyBatchInsecure(const std::map<uint256, std::vector<MessageMapIterator>>& byMessageHash)
+    // All Verify methods take ownership of the passed byMessageHash map and thus might modify the map. This is to avoid
+    // unnecessary copies
+
+    static bool VerifyBatchInsecure(const std::map<uint256, std::vector<MessageMapIterator>>& byMessageHash)
     {
         CBLSSignature aggSig;
         std::vector<uint256> msgHashes;
         std::vector<CBLSPublicKey> pubKeys;
         std::set<MessageId> dups;
 
-        msgHashes.reserve(messages.size());
-        pubKeys.reserve(messages.size());
+        msgHashes.reserve(byMessageHash.size());
+        pubKeys.reserve(byMessageHash.size());
 
         for (const auto& p : byMessageHash) {
             const auto& msgHash = p.first;
@@ -183,7 +293,7 @@ private:
         return aggSig.VerifyInsecureAggregated(pubKeys, msgHashes);
     }
 
-    bool VerifyBatchSecure(std::map<uint256, std::vector<MessageMapIterator>>& byMessageHash)
+    static bool VerifyBatchSecure(std::map<uint256, std::vector<MessageMapIterator>>& byMessageHash)
     {
         // Loop until the byMessageHash map is empty, which means that all messages were verified
         // The secure form of verification will only aggregate one message for the same message hash, even if multiple
@@ -197,15 +307,15 @@ private:
         return true;
     }
 
-    bool VerifyBatchSecureStep(std::map<uint256, std::vector<MessageMapIterator>>& byMessageHash)
+    static bool VerifyBatchSecureStep(std::map<uint256, std::vector<MessageMapIterator>>& byMessageHash)
     {
         CBLSSignature aggSig;
         std::vector<uint256> msgHashes;
         std::vector<CBLSPublicKey> pubKeys;
         std::set<MessageId> dups;
 
-        msgHashes.reserve(messages.size());
-        pubKeys.reserve(messages.size());
+        msgHashes.reserve(byMessageHash.size());
+        pubKeys.reserve(byMessageHash.size());
 
         for (auto it = byMessageHash.begin(); it != byMessageHash.end(); ) {
             const auto& msgHash = it->first;
@@ -9,6 +9,7 @@
 #include <util/ranges.h>
 #include <util/system.h>
 
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -66,6 +67,9 @@ void CBLSWorker::Start()
     workerCount = std::max(std::min(1, workerCount), 4);
     workerPool.resize(workerCount);
     RenameThreadPool(workerPool, "bls-work");
+    for (int i = 0; i < workerPool.size(); i++) {
+        workerThreadIds.emplace(workerPool.get_thread(i).get_id());
+    }
 }
 
 void CBLSWorker::Stop()
@@ -838,16 +842,59 @@ bool CBLSWorker::IsAsyncVerifyInProgress()
     return sigVerifyBatchesInProgress != 0;
 }
 
+std::future<bool> CBLSWorker::AsyncVerifyBatch(std::function<bool()> verifyFunc)
+{
+    if (workerPool.size() == 0 || IsWorkerThread()) {
+        std::promise<bool> p;
+        p.set_value(verifyFunc());
+        return p.get_future();
+    }
+    return workerPool.push([verifyFunc = std::move(verifyFunc)](int threadId) {
+        return verifyFunc();
+    });
+}
+
+size_t CBLSWorker::GetWorkerCount()
+{
+    return workerPool.size();
+}
+
+bool CBLSWorker::IsWorkerThread() const
+{
+    return workerThreadIds.count(std::this_thread::get_id()) != 0;
+}
+
+CBLSWorker::SigVerifyStats CBLSWorker::GetSigVerifyStats()
+{
+    SigVerifyStats ret;
+    {
+        std::unique_lock<std::mutex> l(sigVerifyMutex);
+        ret.queued = sigVerifyQueue.size();
+    }
+    ret.batches = sigVerifyBatches;
+    ret.sigs = sigVerifySigs;
+    ret.fallbacks = sigVerifyFallbacks;
+    ret.timeMs = sigVerifyTimeMs;
+    return ret;
+}
+
 // sigVerifyMutex must be held while calling
 void CBLSWorker::PushSigVerifyBatch()
 {
     auto f = [this](int threadId, const std::shared_ptr<std::vector<SigVerifyJob> >& _jobs) {
         auto& jobs = *_jobs;
+        const auto start = std::chrono::steady_clock::now();
+        const auto updateStats = [&](size_t sigCount) {
+            sigVerifyBatches++;
+            sigVerifySigs += sigCount;
+            sigVerifyTimeMs += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        };
         if (jobs.size() == 1) {
             const auto& job = jobs[0];
             if (!job.cancelCond()) {
                 bool valid = job.sig.VerifyInsecure(job.pubKey, job.msgHash);
                 job.doneCallback(valid);
+                updateStats(1);
             }
             std::unique_lock<std::mutex> l(sigVerifyMutex);
             sigVerifyBatchesInProgress--;
@@ -888,12 +935,14 @@ void CBLSWorker::PushSigVerifyBatch()
             } else {
                 // one or more sigs were not valid, revert to per-sig verification
                 // TODO this could be improved if we would cache pairing results in some way as the previous aggregated verification already calculated all the pairings for the hashes
+                sigVerifyFallbacks++;
                 for (size_t i = 0; i < pubKeys.size(); i++) {
                     const auto& job = jobs[indexes[i]];
                     bool valid = job.sig.VerifyInsecure(job.pubKey, job.msgHash);
                     job.doneCallback(valid);
                 }
             }
+            updateStats(pubKeys.size());
         }
 
         std::unique_lock<std::mutex> l(sigVerifyMutex);
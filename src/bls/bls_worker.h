@@ -9,8 +9,11 @@
 
 #include <ctpl_stl.h>
 
+#include <atomic>
 #include <future>
 #include <mutex>
+#include <set>
+#include <thread>
 #include <utility>
 
 // Low level BLS/DKG stuff. All very compute intensive and optimized for parallelization
@@ -24,8 +27,20 @@ public:
     using SigVerifyDoneCallback = std::function<void(bool)>;
     using CancelCond = std::function<bool()>;
 
+    // cumulative statistics of the internally batched signature verification (AsyncVerifySig)
+    struct SigVerifyStats {
+        int64_t queued{0};
+        int64_t batches{0};
+        int64_t sigs{0};
+        // batches which failed as a whole and were re-verified signature by signature
+        int64_t fallbacks{0};
+        int64_t timeMs{0};
+    };
+
 private:
     ctpl::thread_pool workerPool;
+    // ids of the pool threads, filled once in Start()
+    std::set<std::thread::id> workerThreadIds;
 
     static const int SIG_VERIFY_BATCH_SIZE = 8;
     struct SigVerifyJob {
@@ -48,6 +63,11 @@ private:
     int sigVerifyBatchesInProgress{0};
     std::vector<SigVerifyJob> sigVerifyQueue;
 
+    std::atomic<int64_t> sigVerifyBatches{0};
+    std::atomic<int64_t> sigVerifySigs{0};
+    std::atomic<int64_t> sigVerifyFallbacks{0};
+    std::atomic<int64_t> sigVerifyTimeMs{0};
+
 public:
     CBLSWorker();
     ~CBLSWorker();
@@ -129,6 +149,14 @@ public:
     std::future<bool> AsyncVerifySig(const CBLSSignature& sig, const CBLSPublicKey& pubKey, const uint256& msgHash, CancelCond cancelCond = [] { return false; });
     bool IsAsyncVerifyInProgress();
 
+    // Runs a verification job of CBLSBatchVerifier (e.g. one sub-batch) in the worker pool. If the pool is not running
+    // or the caller is a pool thread itself, the job is run in the calling thread instead. Otherwise a pool thread which
+    // waits for the returned future could end up waiting for jobs queued behind itself
+    std::future<bool> AsyncVerifyBatch(std::function<bool()> verifyFunc);
+    size_t GetWorkerCount();
+    bool IsWorkerThread() const;
+    SigVerifyStats GetSigVerifyStats();
+
 private:
     void PushSigVerifyBatch();
 };
@@ -32,11 +32,13 @@ void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
 namespace sha256d64_sse41
 {
 void Transform_4way(unsigned char* out, const unsigned char* in);
+void Transform_4way_S64(unsigned char* out, const unsigned char* in);
 }
 
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
+void Transform_8way_S64(unsigned char* out, const unsigned char* in);
 }
 
 namespace sha256d64_x86_shani
@@ -438,7 +440,7 @@ typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
 
 template<TransformType tr>
-void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
+void TransformS64Wrapper(unsigned char* out, const unsigned char* in)
 {
     uint32_t s[8];
     static const unsigned char padding1[64] = {
@@ -447,23 +449,30 @@ void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
         0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0
     };
+    sha256::Initialize(s);
+    tr(s, in, 1);
+    tr(s, padding1, 1);
+    WriteBE32(out + 0, s[0]);
+    WriteBE32(out + 4, s[1]);
+    WriteBE32(out + 8, s[2]);
+    WriteBE32(out + 12, s[3]);
+    WriteBE32(out + 16, s[4]);
+    WriteBE32(out + 20, s[5]);
+    WriteBE32(out + 24, s[6]);
+    WriteBE32(out + 28, s[7]);
+}
+
+template<TransformType tr>
+void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
+{
+    uint32_t s[8];
     unsigned char buffer2[64] = {
         0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0
     };
-    sha256::Initialize(s);
-    tr(s, in, 1);
-    tr(s, padding1, 1);
-    WriteBE32(buffer2 + 0, s[0]);
-    WriteBE32(buffer2 + 4, s[1]);
-    WriteBE32(buffer2 + 8, s[2]);
-    WriteBE32(buffer2 + 12, s[3]);
-    WriteBE32(buffer2 + 16, s[4]);
-    WriteBE32(buffer2 + 20, s[5]);
-    WriteBE32(buffer2 + 24, s[6]);
-    WriteBE32(buffer2 + 28, s[7]);
+    TransformS64Wrapper<tr>(buffer2, in);
     sha256::Initialize(s);
     tr(s, buffer2, 1);
     WriteBE32(out + 0, s[0]);
@@ -481,6 +490,9 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformS64 = TransformS64Wrapper<sha256::Transform>;
+TransformD64Type TransformS64_4way = nullptr;
+TransformD64Type TransformS64_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -528,6 +540,25 @@ bool SelfTest() {
         0x6a, 0x46, 0x30, 0xa6, 0x89, 0x86, 0x23, 0xac, 0xf8, 0xa5, 0x15, 0xe9, 0x0a, 0xaa, 0x1e, 0x9a,
         0xd7, 0x93, 0x6b, 0x28, 0xe4, 0x3b, 0xfd, 0x59, 0xc6, 0xed, 0x7c, 0x5f, 0xa5, 0x41, 0xcb, 0x51
     };
+    // Expected output for each of the individual 8 64-byte messages under single SHA256 (including padding).
+    static const unsigned char result_s64[256] = {
+        0x95, 0xc9, 0x68, 0xb2, 0x6b, 0xaa, 0x56, 0xf8, 0xd3, 0x05, 0xcc, 0x1b, 0xac, 0xe2, 0x30, 0x64,
+        0x56, 0xe9, 0x8e, 0x9d, 0x18, 0x6e, 0xcb, 0x9f, 0x1b, 0x4d, 0xe1, 0x80, 0x8c, 0x6f, 0x13, 0x46,
+        0x7d, 0x68, 0xf4, 0x6a, 0x17, 0xf3, 0x41, 0x41, 0x99, 0x3d, 0xf6, 0x4e, 0xb6, 0x73, 0x51, 0x2d,
+        0xac, 0x93, 0x59, 0x02, 0xce, 0xdc, 0xde, 0xad, 0x5d, 0xbf, 0x2b, 0xf4, 0x03, 0xc2, 0x00, 0x7f,
+        0x72, 0x2d, 0x51, 0x2b, 0xe7, 0xdd, 0x3d, 0xb3, 0x9c, 0xb0, 0x6b, 0x92, 0xac, 0x81, 0x25, 0x86,
+        0x90, 0x75, 0x7d, 0x58, 0xdf, 0x4a, 0x61, 0xd5, 0x82, 0x98, 0x9d, 0x9b, 0x34, 0x09, 0x7c, 0x62,
+        0xbf, 0x0d, 0x3e, 0x61, 0x0b, 0xd1, 0xce, 0xf2, 0x54, 0x71, 0x06, 0xc5, 0x43, 0x0c, 0x6e, 0xd2,
+        0x4c, 0x7d, 0xfc, 0x3d, 0x6b, 0xc5, 0xe6, 0xd7, 0x81, 0x57, 0x42, 0x82, 0xf6, 0x7a, 0x42, 0x7f,
+        0x14, 0x59, 0xa0, 0xc2, 0xac, 0x24, 0xbc, 0x70, 0x24, 0x04, 0x08, 0x2a, 0xee, 0x8c, 0x59, 0x94,
+        0x4d, 0x0e, 0xfd, 0x30, 0x8e, 0x57, 0x0a, 0x62, 0xae, 0x72, 0xc7, 0xd4, 0x1c, 0x6f, 0xe3, 0xd1,
+        0x5b, 0x8f, 0x65, 0xd3, 0x21, 0xa4, 0x03, 0x92, 0xfe, 0x6c, 0x4e, 0x3d, 0x6e, 0xa5, 0x45, 0x05,
+        0xf5, 0x17, 0xd4, 0xed, 0x02, 0xaa, 0xb0, 0x53, 0x46, 0x65, 0x3f, 0x2b, 0xf5, 0x60, 0x20, 0x6b,
+        0xa9, 0x89, 0x74, 0x35, 0x6f, 0x53, 0x19, 0xb3, 0x41, 0x7e, 0xab, 0xac, 0xc0, 0x7d, 0x37, 0x27,
+        0xee, 0x55, 0xfa, 0x18, 0x20, 0x0b, 0x36, 0x8e, 0xcc, 0xbb, 0xfa, 0x13, 0x41, 0x01, 0x8a, 0x00,
+        0xcf, 0xef, 0x7a, 0x66, 0x02, 0xb3, 0x83, 0xff, 0x87, 0xf6, 0x75, 0x5e, 0x45, 0x65, 0x9d, 0x89,
+        0x48, 0xed, 0xa7, 0xf7, 0x47, 0xc4, 0x0e, 0x34, 0x8b, 0x4f, 0x28, 0xfc, 0xbf, 0x8b, 0x92, 0x43
+    };
 
 
     // Test Transform() for 0 through 8 transformations.
@@ -564,6 +595,24 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformS64
+    TransformS64(out, data + 1);
+    if (!std::equal(out, out + 32, result_s64)) return false;
+
+    // Test TransformS64_4way, if available.
+    if (TransformS64_4way) {
+        unsigned char out[128];
+        TransformS64_4way(out, data + 1);
+        if (!std::equal(out, out + 128, result_s64)) return false;
+    }
+
+    // Test TransformS64_8way, if available.
+    if (TransformS64_8way) {
+        unsigned char out[256];
+        TransformS64_8way(out, data + 1);
+        if (!std::equal(out, out + 256, result_s64)) return false;
+    }
+
     return true;
 }
 
@@ -616,6 +665,7 @@ std::string SHA256AutoDetect()
     if (have_x86_shani) {
         Transform = sha256_x86_shani::Transform;
         TransformD64 = TransformD64Wrapper<sha256_x86_shani::Transform>;
+        TransformS64 = TransformS64Wrapper<sha256_x86_shani::Transform>;
         TransformD64_2way = sha256d64_x86_shani::Transform_2way;
         ret = "x86_shani(1way,2way)";
         have_sse4 = false; // Disable SSE4/AVX2;
@@ -627,10 +677,12 @@ std::string SHA256AutoDetect()
 #if defined(__x86_64__) || defined(__amd64__)
         Transform = sha256_sse4::Transform;
         TransformD64 = TransformD64Wrapper<sha256_sse4::Transform>;
+        TransformS64 = TransformS64Wrapper<sha256_sse4::Transform>;
         ret = "sse4(1way)";
 #endif
 #if defined(ENABLE_SSE41) && !defined(BUILD_BITCOIN_INTERNAL)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformS64_4way = sha256d64_sse41::Transform_4way_S64;
         ret += ",sse41(4way)";
 #endif
     }
@@ -638,6 +690,7 @@ std::string SHA256AutoDetect()
 #if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformS64_8way = sha256d64_avx2::Transform_8way_S64;
         ret += ",avx2(8way)";
     }
 #endif
@@ -670,6 +723,7 @@ std::string SHA256AutoDetect()
     if (have_arm_shani) {
         Transform = sha256_arm_shani::Transform;
         TransformD64 = TransformD64Wrapper<sha256_arm_shani::Transform>;
+        TransformS64 = TransformS64Wrapper<sha256_arm_shani::Transform>;
         TransformD64_2way = sha256d64_arm_shani::Transform_2way;
         ret = "arm_shani(1way,2way)";
     }
@@ -769,3 +823,29 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+void SHA256S64(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+    if (TransformS64_8way) {
+        while (blocks >= 8) {
+            TransformS64_8way(out, in);
+            out += 256;
+            in += 512;
+            blocks -= 8;
+        }
+    }
+    if (TransformS64_4way) {
+        while (blocks >= 4) {
+            TransformS64_4way(out, in);
+            out += 128;
+            in += 256;
+            blocks -= 4;
+        }
+    }
+    while (blocks) {
+        TransformS64(out, in);
+        out += 32;
+        in += 64;
+        --blocks;
+    }
+}
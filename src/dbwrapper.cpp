@@ -13,6 +13,9 @@
 #include <memenv.h>
 #include <stdint.h>
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
 
 class CBitcoinLevelDBLogger : public leveldb::Logger {
 public:
@@ -237,6 +240,102 @@ CDBIterator::~CDBIterator() { delete piter; }
 bool CDBIterator::Valid() const { return piter->Valid(); }
 void CDBIterator::SeekToFirst() { piter->SeekToFirst(); }
 void CDBIterator::Next() { piter->Next(); }
+void CDBIterator::Prev() { piter->Prev(); }
+
+const CDBWriteSet::Entry* CDBWriteSet::Find(Span<const unsigned char> key) const
+{
+    const auto sortedEnd = entries.begin() + sortedCount;
+    const auto keyEquals = [&](const Entry& entry) {
+        return entry.keySize == key.size() && std::equal(key.begin(), key.end(), GetKey(entry).begin());
+    };
+
+    // the unsorted tail is small, recently added keys are also the most likely ones to be accessed again
+    for (auto it = entries.end(); it != sortedEnd; ) {
+        --it;
+        if (keyEquals(*it)) {
+            return &*it;
+        }
+    }
+    auto it = std::lower_bound(entries.begin(), sortedEnd, key, [this](const Entry& entry, Span<const unsigned char> k) {
+        return KeyLess(GetKey(entry), k);
+    });
+    if (it != sortedEnd && keyEquals(*it)) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+CDBWriteSet::Entry* CDBWriteSet::FindMutable(Span<const unsigned char> key)
+{
+    return const_cast<Entry*>(Find(key));
+}
+
+void CDBWriteSet::Put(Span<const unsigned char> key, size_t valuePos, bool erased)
+{
+    const size_t valueSize = arena.size() - valuePos;
+
+    Entry* entry = FindMutable(key);
+    if (entry == nullptr) {
+        entry = &entries.emplace_back();
+        entry->keySize = key.size();
+        if (key.size() <= INLINE_KEY_SIZE) {
+            std::copy(key.begin(), key.end(), entry->inlineKey);
+        } else {
+            entry->keyPos = arena.size();
+            arena.insert(arena.end(), key.begin(), key.end());
+        }
+    }
+    // an overwritten value stays in the arena until the write set is cleared
+    entry->valuePos = valuePos;
+    entry->valueSize = valueSize;
+    entry->erased = erased;
+    assert(arena.size() <= std::numeric_limits<uint32_t>::max());
+
+    if (entries.size() - sortedCount > maxUnsortedCount) {
+        Sort();
+    }
+}
+
+void CDBWriteSet::Sort()
+{
+    if (sortedCount == entries.size()) {
+        return;
+    }
+
+    const auto entryLess = [this](const Entry& a, const Entry& b) { return EntryLess(a, b); };
+    std::sort(entries.begin() + sortedCount, entries.end(), entryLess);
+    if (sortedCount != 0) {
+        mergeBuffer.clear();
+        mergeBuffer.reserve(entries.size());
+        std::merge(entries.begin(), entries.begin() + sortedCount, entries.begin() + sortedCount, entries.end(),
+                   std::back_inserter(mergeBuffer), entryLess);
+        entries.swap(mergeBuffer);
+    }
+    sortedCount = entries.size();
+    // keeps lookups in the tail and the cost of merging balanced
+    maxUnsortedCount = std::max(MIN_UNSORTED_ENTRIES, size_t(std::sqrt(double(sortedCount))));
+}
+
+CDBWriteSet::const_iterator CDBWriteSet::lower_bound(Span<const unsigned char> key) const
+{
+    assert(sortedCount == entries.size());
+    return std::lower_bound(entries.begin(), entries.end(), key, [this](const Entry& entry, Span<const unsigned char> k) {
+        return KeyLess(GetKey(entry), k);
+    });
+}
+
+void CDBWriteSet::Clear()
+{
+    if (arena.capacity() + (entries.capacity() + mergeBuffer.capacity()) * sizeof(Entry) > MAX_RETAINED_ARENA_SIZE) {
+        arena = {};
+        entries = {};
+        mergeBuffer = {};
+    }
+    arena.clear();
+    entries.clear();
+    sortedCount = 0;
+    maxUnsortedCount = MIN_UNSORTED_ENTRIES;
+}
 
 namespace dbwrapper_private {
 
@@ -156,6 +156,8 @@ public:
 
     void Next();
 
+    void Prev();
+
     template<typename K> bool GetKey(K& key) {
         try {
             CDataStream ssKey = GetKey();
@@ -393,6 +395,110 @@ public:
 
 };
 
+/**
+ * Pending writes and erases of a CDBTransaction. Keys and values are stored serialized in a single arena which only
+ * grows by appending, so writing does not allocate per entry and Clear() only resets the arena. Keys up to
+ * INLINE_KEY_SIZE bytes are stored in the entry itself, so that comparing them does not touch the arena.
+ *
+ * Entries are kept as a sorted run plus a small unsorted tail of recently added keys, which is merged into the run
+ * once it grows too large. Every key has at most one entry, erases are entries without a value.
+ */
+class CDBWriteSet
+{
+public:
+    static constexpr size_t INLINE_KEY_SIZE = 48;
+
+    struct Entry {
+        uint32_t keySize;
+        uint32_t keyPos; // only used if keySize > INLINE_KEY_SIZE
+        uint32_t valuePos;
+        uint32_t valueSize;
+        bool erased;
+        unsigned char inlineKey[INLINE_KEY_SIZE];
+    };
+    using const_iterator = std::vector<Entry>::const_iterator;
+
+private:
+    //! don't keep the memory of unusually large write sets around after they were cleared
+    static constexpr size_t MAX_RETAINED_ARENA_SIZE = 16 << 20;
+    static constexpr size_t MIN_UNSORTED_ENTRIES = 32;
+
+    std::vector<unsigned char> arena;
+    std::vector<Entry> entries;
+    std::vector<Entry> mergeBuffer;
+    size_t sortedCount{0};
+    size_t maxUnsortedCount{MIN_UNSORTED_ENTRIES};
+
+public:
+    Span<const unsigned char> GetKey(const Entry& entry) const
+    {
+        if (entry.keySize <= INLINE_KEY_SIZE) {
+            return {entry.inlineKey, entry.keySize};
+        }
+        return {arena.data() + entry.keyPos, entry.keySize};
+    }
+
+    Span<const unsigned char> GetValue(const Entry& entry) const
+    {
+        return {arena.data() + entry.valuePos, entry.valueSize};
+    }
+
+    template <typename V>
+    bool ReadValue(const Entry& entry, V& value) const
+    {
+        try {
+            VectorReader reader(SER_DISK, CLIENT_VERSION, arena, entry.valuePos);
+            reader >> value;
+            // the reader is not limited to the value, make sure we didn't read into whatever follows it
+            return arena.size() - entry.valuePos - reader.size() <= entry.valueSize;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    //! Returns the entry of the key or nullptr. Entries are invalidated by all non-const calls
+    const Entry* Find(Span<const unsigned char> key) const;
+
+    template <typename V>
+    void Write(Span<const unsigned char> key, const V& value)
+    {
+        const size_t valuePos = arena.size();
+        CVectorWriter(SER_DISK, CLIENT_VERSION, arena, valuePos) << value;
+        Put(key, valuePos, false);
+    }
+
+    void Erase(Span<const unsigned char> key)
+    {
+        Put(key, arena.size(), true);
+    }
+
+    void Clear();
+
+    //! Merges the unsorted tail, required before using begin(), end() and lower_bound() for ordered iteration
+    void Sort();
+
+    //! Without Sort(), the order of the entries is unspecified
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    const_iterator lower_bound(Span<const unsigned char> key) const;
+
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+    size_t GetMemoryUsage() const { return arena.size() + entries.size() * sizeof(Entry); }
+
+    static bool KeyLess(Span<const unsigned char> a, Span<const unsigned char> b)
+    {
+        const int cmp = memcmp(a.data(), b.data(), std::min(a.size(), b.size()));
+        return cmp < 0 || (cmp == 0 && a.size() < b.size());
+    }
+
+private:
+    //! Sets the value of the entry of the key to everything appended to the arena starting at valuePos
+    void Put(Span<const unsigned char> key, size_t valuePos, bool erased);
+    Entry* FindMutable(Span<const unsigned char> key);
+    bool EntryLess(const Entry& a, const Entry& b) const { return KeyLess(GetKey(a), GetKey(b)); }
+};
+
 template<typename CDBTransaction>
 class CDBTransactionIterator
 {
@@ -405,7 +511,8 @@ private:
     // At all times, only one of both provides the current value. The decision is made by comparing the current keys
     // of both iterators, so that always the smaller key is the current one. On Next(), the previously chosen iterator
     // is advanced.
-    typename CDBTransaction::WritesMap::iterator transactionIt;
+    // Writing to the transaction invalidates this iterator.
+    CDBWriteSet::const_iterator transactionIt;
     std::unique_ptr<ParentIterator> parentIt;
     CDataStream parentKey;
     bool curIsParent{false};
@@ -415,12 +522,14 @@ public:
             transaction(_transaction),
             parentKey(SER_DISK, CLIENT_VERSION)
     {
-        transactionIt = transaction.writes.end();
+        transaction.writeSet.Sort();
+        transactionIt = transaction.writeSet.end();
         parentIt = std::unique_ptr<ParentIterator>(transaction.parent.NewIterator());
     }
 
     void SeekToFirst() {
-        transactionIt = transaction.writes.begin();
+        transactionIt = transaction.writeSet.begin();
+        SkipErased();
         parentIt->SeekToFirst();
         SkipDeletedAndOverwritten();
         DecideCur();
@@ -432,18 +541,19 @@ public:
     }
 
     void Seek(const CDataStream& ssKey) {
-        transactionIt = transaction.writes.lower_bound(ssKey);
+        transactionIt = transaction.writeSet.lower_bound(MakeUCharSpan(ssKey));
+        SkipErased();
         parentIt->Seek(ssKey);
         SkipDeletedAndOverwritten();
         DecideCur();
     }
 
     bool Valid() {
-        return transactionIt != transaction.writes.end() || parentIt->Valid();
+        return transactionIt != transaction.writeSet.end() || parentIt->Valid();
     }
 
     void Next() {
-        if (transactionIt == transaction.writes.end() && !parentIt->Valid()) {
+        if (transactionIt == transaction.writeSet.end() && !parentIt->Valid()) {
             return;
         }
         if (curIsParent) {
@@ -451,8 +561,9 @@ public:
             parentIt->Next();
             SkipDeletedAndOverwritten();
         } else {
-            assert(transactionIt != transaction.writes.end());
+            assert(transactionIt != transaction.writeSet.end());
             ++transactionIt;
+            SkipErased();
         }
         DecideCur();
     }
@@ -463,25 +574,14 @@ public:
             return false;
         }
 
-        if (curIsParent) {
-            try {
-                // TODO try to avoid this copy (we need a stream that allows reading from external buffers)
-                CDataStream ssKey = parentKey;
-                ssKey >> key;
-            } catch (const std::exception&) {
-                return false;
-            }
-            return true;
-        } else {
-            try {
-                // TODO try to avoid this copy (we need a stream that allows reading from external buffers)
-                CDataStream ssKey = transactionIt->first;
-                ssKey >> key;
-            } catch (const std::exception&) {
-                return false;
-            }
-            return true;
+        try {
+            // TODO try to avoid this copy (we need a stream that allows reading from external buffers)
+            CDataStream ssKey = GetKey();
+            ssKey >> key;
+        } catch (const std::exception&) {
+            return false;
         }
+        return true;
     }
 
     CDataStream GetKey() {
@@ -491,7 +591,8 @@ public:
         if (curIsParent) {
             return parentKey;
         } else {
-            return transactionIt->first;
+            const auto key = transaction.writeSet.GetKey(*transactionIt);
+            return CDataStream(CharCast(key.begin()), CharCast(key.end()), SER_DISK, CLIENT_VERSION);
         }
     }
 
@@ -502,7 +603,7 @@ public:
         if (curIsParent) {
             return parentIt->GetKeySize();
         } else {
-            return transactionIt->first.vKey.size();
+            return transactionIt->keySize;
         }
     }
 
@@ -514,15 +615,21 @@ public:
         if (curIsParent) {
             return transaction.Read(parentKey, value);
         } else {
-            return transaction.Read(transactionIt->first, value);
+            return transaction.writeSet.ReadValue(*transactionIt, value);
         }
     };
 
 private:
+    void SkipErased() {
+        while (transactionIt != transaction.writeSet.end() && transactionIt->erased) {
+            ++transactionIt;
+        }
+    }
+
     void SkipDeletedAndOverwritten() {
         while (parentIt->Valid()) {
             parentKey = parentIt->GetKey();
-            if (!transaction.deletes.count(parentKey) && !transaction.writes.count(parentKey)) {
+            if (!transaction.writeSet.Find(MakeUCharSpan(parentKey))) {
                 break;
             }
             parentIt->Next();
@@ -530,12 +637,12 @@ private:
     }
 
     void DecideCur() {
-        if (transactionIt != transaction.writes.end() && !parentIt->Valid()) {
+        if (transactionIt != transaction.writeSet.end() && !parentIt->Valid()) {
             curIsParent = false;
-        } else if (transactionIt == transaction.writes.end() && parentIt->Valid()) {
+        } else if (transactionIt == transaction.writeSet.end() && parentIt->Valid()) {
             curIsParent = true;
-        } else if (transactionIt != transaction.writes.end() && parentIt->Valid()) {
-            if (CDBTransaction::DataStreamCmp::less(transactionIt->first, parentKey)) {
+        } else if (transactionIt != transaction.writeSet.end() && parentIt->Valid()) {
+            if (CDBWriteSet::KeyLess(transaction.writeSet.GetKey(*transactionIt), MakeUCharSpan(parentKey))) {
                 curIsParent = false;
             } else {
                 curIsParent = true;
@@ -551,38 +658,10 @@ class CDBTransaction {
 protected:
     Parent &parent;
     CommitTarget &commitTarget;
-    ssize_t memoryUsage{0}; // signed, just in case we made an error in the calculations so that we don't get an overflow
+    CDBWriteSet writeSet;
 
-    struct DataStreamCmp {
-        static bool less(const CDataStream& a, const CDataStream& b) {
-            return std::lexicographical_compare(
-                    (const uint8_t*)a.data(), (const uint8_t*)a.data() + a.size(),
-                    (const uint8_t*)b.data(), (const uint8_t*)b.data() + b.size());
-        }
-        bool operator()(const CDataStream& a, const CDataStream& b) const {
-            return less(a, b);
-        }
-    };
-
-    struct ValueHolder {
-        size_t memoryUsage;
-        explicit ValueHolder(size_t _memoryUsage) : memoryUsage(_memoryUsage) {}
-        virtual ~ValueHolder() = default;
-        virtual void Write(const CDataStream& ssKey, CommitTarget &parent) = 0;
-    };
-    typedef std::unique_ptr<ValueHolder> ValueHolderPtr;
-
-    template <typename V>
-    struct ValueHolderImpl : ValueHolder {
-        ValueHolderImpl(const V &_value, size_t _memoryUsage) : ValueHolder(_memoryUsage), value(_value) {}
-
-        virtual void Write(const CDataStream& ssKey, CommitTarget &commitTarget) override {
-            // we're moving the value instead of copying it. This means that Write() can only be called once per
-            // ValueHolderImpl instance. Commit() clears the write maps, so this ok.
-            commitTarget.Write(ssKey, std::move(value));
-        }
-        V value;
-    };
+    // reused to serialize keys, so that calls with typed keys don't allocate a stream each time
+    CDataStream ssKeyBuf;
 
     template<typename K>
     static CDataStream KeyToDataStream(const K& key) {
@@ -592,55 +671,38 @@ protected:
         return ssKey;
     }
 
-    typedef std::map<CDataStream, ValueHolderPtr, DataStreamCmp> WritesMap;
-    typedef std::set<CDataStream, DataStreamCmp> DeletesSet;
-
-    WritesMap writes;
-    DeletesSet deletes;
+    template<typename K>
+    const CDataStream& KeyToBuf(const K& key) {
+        ssKeyBuf.clear();
+        ssKeyBuf << key;
+        return ssKeyBuf;
+    }
 
 public:
-    CDBTransaction(Parent &_parent, CommitTarget &_commitTarget) : parent(_parent), commitTarget(_commitTarget) {}
+    CDBTransaction(Parent &_parent, CommitTarget &_commitTarget) : parent(_parent), commitTarget(_commitTarget), ssKeyBuf(SER_DISK, CLIENT_VERSION)
+    {
+        ssKeyBuf.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+    }
 
     template <typename K, typename V>
     void Write(const K& key, const V& v) {
-        Write(KeyToDataStream(key), v);
+        Write(KeyToBuf(key), v);
     }
 
     template <typename V>
     void Write(const CDataStream& ssKey, const V& v) {
-        auto valueMemoryUsage = ::GetSerializeSize(v, CLIENT_VERSION);
-
-        if (deletes.erase(ssKey)) {
-            memoryUsage -= ssKey.size();
-        }
-        auto it = writes.emplace(ssKey, nullptr).first;
-        if (it->second) {
-            memoryUsage -= ssKey.size() + it->second->memoryUsage;
-        }
-        it->second = std::make_unique<ValueHolderImpl<V>>(v, valueMemoryUsage);
-
-        memoryUsage += ssKey.size() + valueMemoryUsage;
+        writeSet.Write(MakeUCharSpan(ssKey), v);
     }
 
     template <typename K, typename V>
     bool Read(const K& key, V& value) {
-        return Read(KeyToDataStream(key), value);
+        return Read(KeyToBuf(key), value);
     }
 
     template <typename V>
     bool Read(const CDataStream& ssKey, V& value) {
-        if (deletes.count(ssKey)) {
-            return false;
-        }
-
-        auto it = writes.find(ssKey);
-        if (it != writes.end()) {
-            auto *impl = dynamic_cast<ValueHolderImpl<V> *>(it->second.get());
-            if (!impl) {
-                throw std::runtime_error("Read called with V != previously written type");
-            }
-            value = impl->value;
-            return true;
+        if (const auto* entry = writeSet.Find(MakeUCharSpan(ssKey))) {
+            return !entry->erased && writeSet.ReadValue(*entry, value);
         }
 
         return parent.Read(ssKey, value);
@@ -648,16 +710,12 @@ public:
 
     template <typename K>
     bool Exists(const K& key) {
-        return Exists(KeyToDataStream(key));
+        return Exists(KeyToBuf(key));
     }
 
     bool Exists(const CDataStream& ssKey) {
-        if (deletes.count(ssKey)) {
-            return false;
-        }
-
-        if (writes.count(ssKey)) {
-            return true;
+        if (const auto* entry = writeSet.Find(MakeUCharSpan(ssKey))) {
+            return !entry->erased;
         }
 
         return parent.Exists(ssKey);
@@ -665,51 +723,35 @@ public:
 
     template <typename K>
     void Erase(const K& key) {
-        return Erase(KeyToDataStream(key));
+        return Erase(KeyToBuf(key));
     }
 
     void Erase(const CDataStream& ssKey) {
-        auto it = writes.find(ssKey);
-        if (it != writes.end()) {
-            memoryUsage -= ssKey.size() + it->second->memoryUsage;
-            writes.erase(it);
-        }
-        if (deletes.emplace(ssKey).second) {
-            memoryUsage += ssKey.size();
-        }
+        writeSet.Erase(MakeUCharSpan(ssKey));
     }
 
     void Clear() {
-        writes.clear();
-        deletes.clear();
-        memoryUsage = 0;
+        writeSet.Clear();
     }
 
     void Commit() {
-        for (const auto &k : deletes) {
-            commitTarget.Erase(k);
-        }
-        for (auto &p : writes) {
-            p.second->Write(p.first, commitTarget);
+        // values are passed on serialized, the commit target copies them as they are
+        for (const auto& entry : writeSet) {
+            if (entry.erased) {
+                commitTarget.Erase(writeSet.GetKey(entry));
+            } else {
+                commitTarget.Write(writeSet.GetKey(entry), writeSet.GetValue(entry));
+            }
         }
         Clear();
     }
 
     bool IsClean() const {
-        return writes.empty() && deletes.empty();
+        return writeSet.empty();
     }
 
     size_t GetMemoryUsage() const {
-        if (memoryUsage < 0) {
-            // something went wrong when we accounted/calculated used memory...
-            static volatile bool didPrint = false;
-            if (!didPrint) {
-                LogPrintf("CDBTransaction::%s -- negative memoryUsage (%d)", __func__, memoryUsage);
-                didPrint = true;
-            }
-            return 0;
-        }
-        return (size_t)memoryUsage;
+        return writeSet.GetMemoryUsage();
     }
 
     CDBTransactionIterator<CDBTransaction>* NewIterator() {
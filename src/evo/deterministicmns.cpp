@@ -14,6 +14,7 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <crypto/sha256.h>
 #include <script/standard.h>
 #include <ui_interface.h>
 #include <validation.h>
@@ -41,6 +42,19 @@ std::string CDeterministicMN::ToString() const
     return strprintf("CDeterministicMN(proTxHash=%s, collateralOutpoint=%s, nOperatorReward=%f, state=%s", proTxHash.ToString(), collateralOutpoint.ToStringShort(), (double)nOperatorReward / 100, pdmnState->ToString());
 }
 
+uint256 CDeterministicMN::GetSmlEntryHash(uint16_t nVersion) const
+{
+    uint256 hash;
+    if (pdmnState->smlEntryHash.Get(nVersion, hash)) {
+        return hash;
+    }
+    CSimplifiedMNListEntry sme(*this);
+    sme.nVersion = nVersion;
+    hash = sme.CalcHash();
+    pdmnState->smlEntryHash.Set(nVersion, hash);
+    return hash;
+}
+
 void CDeterministicMN::ToJson(UniValue& obj) const
 {
     obj.clear();
@@ -237,27 +251,37 @@ std::vector<CDeterministicMNCPtr> CDeterministicMNList::CalculateQuorum(size_t m
 
 std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> CDeterministicMNList::CalculateScores(const uint256& modifier) const
 {
-    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
-    scores.reserve(GetAllMNsCount());
+    std::vector<CDeterministicMNCPtr> mns;
+    mns.reserve(GetAllMNsCount());
     ForEachMNShared(true, [&](const CDeterministicMNCPtr& dmn) {
         if (dmn->pdmnState->confirmedHash.IsNull()) {
             // we only take confirmed MNs into account to avoid hash grinding on the ProRegTxHash to sneak MNs into a
             // future quorums
             return;
         }
-        // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
-        // Please note that this is not a double-sha256 but a single-sha256
-        // The first part is already precalculated (confirmedHashWithProRegTxHash)
-        // TODO When https://github.com/bitcoin/bitcoin/pull/13191 gets backported, implement something that is similar but for single-sha256
-        uint256 h;
-        CSHA256 sha256;
-        sha256.Write(dmn->pdmnState->confirmedHashWithProRegTxHash.begin(), dmn->pdmnState->confirmedHashWithProRegTxHash.size());
-        sha256.Write(modifier.begin(), modifier.size());
-        sha256.Finalize(h.begin());
-
-        scores.emplace_back(UintToArith256(h), dmn);
+        mns.emplace_back(dmn);
     });
 
+    // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
+    // Please note that this is not a double-sha256 but a single-sha256
+    // The first part is already precalculated (confirmedHashWithProRegTxHash), so every MN hashes exactly one 64 byte
+    // blob, which allows hashing all of them at once with the multi-way SHA256 implementations
+    std::vector<unsigned char> input(mns.size() * 64);
+    for (size_t i = 0; i < mns.size(); i++) {
+        const auto& confirmedHashWithProRegTxHash = mns[i]->pdmnState->confirmedHashWithProRegTxHash;
+        std::copy(confirmedHashWithProRegTxHash.begin(), confirmedHashWithProRegTxHash.end(), input.begin() + i * 64);
+        std::copy(modifier.begin(), modifier.end(), input.begin() + i * 64 + 32);
+    }
+    std::vector<unsigned char> output(mns.size() * 32);
+    SHA256S64(output.data(), input.data(), mns.size());
+
+    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
+    scores.reserve(mns.size());
+    for (size_t i = 0; i < mns.size(); i++) {
+        uint256 h;
+        std::copy(output.begin() + i * 32, output.begin() + (i + 1) * 32, h.begin());
+        scores.emplace_back(UintToArith256(h), std::move(mns[i]));
+    }
     return scores;
 }
 
@@ -359,17 +383,13 @@ CSimplifiedMNListDiff CDeterministicMNList::BuildSimplifiedDiff(const CDetermini
     to.ForEachMN(false, [&](const auto& toPtr) {
         auto fromPtr = GetMN(toPtr.proTxHash);
         if (fromPtr == nullptr) {
-            CSimplifiedMNListEntry sme(toPtr);
-            sme.nVersion = diffRet.nVersion;
-            diffRet.mnList.push_back(std::move(sme));
-        } else {
-            CSimplifiedMNListEntry sme1(toPtr);
-            CSimplifiedMNListEntry sme2(*fromPtr);
-            sme1.nVersion = diffRet.nVersion;
-            sme2.nVersion = diffRet.nVersion;
-            if ((sme1 != sme2) ||
-                (extended && (sme1.scriptPayout != sme2.scriptPayout || sme1.scriptOperatorPayout != sme2.scriptOperatorPayout))) {
-                    diffRet.mnList.push_back(std::move(sme1));
+            diffRet.mnList.emplace_back(toPtr, diffRet.nVersion);
+        } else if (fromPtr->pdmnState != toPtr.pdmnState) {
+            // compare memoized entry hashes instead of building and comparing both entries
+            if ((toPtr.GetSmlEntryHash(diffRet.nVersion) != fromPtr->GetSmlEntryHash(diffRet.nVersion)) ||
+                (extended && (toPtr.pdmnState->scriptPayout != fromPtr->pdmnState->scriptPayout ||
+                              toPtr.pdmnState->scriptOperatorPayout != fromPtr->pdmnState->scriptOperatorPayout))) {
+                diffRet.mnList.emplace_back(toPtr, diffRet.nVersion);
             }
         }
     });
@@ -458,6 +478,11 @@ void CDeterministicMNList::UpdateMN(const CDeterministicMN& oldDmn, const std::s
     auto oldState = dmn->pdmnState;
     dmn->pdmnState = pdmnState;
 
+    // carry over the memoized SML entry hash if the entry itself is unchanged
+    if (oldState != pdmnState && oldState->IsSmlEqual(*pdmnState)) {
+        pdmnState->smlEntryHash.CopyFrom(oldState->smlEntryHash);
+    }
+
     // All mnUniquePropertyMap's updates must be atomic.
     // Using this temporary map as a checkpoint to roll back to in case of any issues.
     decltype(mnUniquePropertyMap) mnUniquePropertyMapSaved = mnUniquePropertyMap;
@@ -576,6 +601,8 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
             mnListsCache.emplace(newList.GetBlockHash(), newList);
             LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
                 __func__, nHeight, newList.GetAllMNsCount());
+        } else {
+            AddMemSnapshot(newList);
         }
 
         diff.nHeight = pindex->nHeight;
@@ -624,6 +651,9 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
 
         mnListsCache.erase(blockHash);
         mnListDiffsCache.erase(blockHash);
+        for (auto& snapshots : mnListSnapshots) {
+            snapshots.erase(blockHash);
+        }
     }
 
     if (diff.HasChanges()) {
@@ -645,6 +675,7 @@ void CDeterministicMNManager::UpdatedBlockTip(const CBlockIndex* pindex)
     LOCK(cs);
 
     tipIndex = pindex;
+    std::atomic_store(&tipList, pindex ? std::make_shared<const CDeterministicMNList>(GetListForBlock(pindex)) : nullptr);
 }
 
 bool CDeterministicMNManager::BuildNewListFromBlock(const CBlock& block, const CBlockIndex* pindexPrev, CValidationState& _state, const CCoinsViewCache& view, CDeterministicMNList& mnListRet, bool debugLogs)
@@ -917,18 +948,55 @@ void CDeterministicMNManager::DecreasePoSePenalties(CDeterministicMNList& mnList
     }
 }
 
+CDeterministicMNManager::CDeterministicMNManager(CEvoDB& evoDb, CConnman& _connman, size_t nListCacheSize) :
+    m_evoDb(evoDb), connman(_connman), smlTree(std::make_unique<CSimplifiedMNListMerkleTree>())
+{
+    // split the budget evenly between all snapshot intervals, a zero sized budget disables in-memory snapshots
+    const size_t nPerPeriod = nListCacheSize / MEM_SNAPSHOT_PERIODS.size();
+    if (nPerPeriod != 0) {
+        for (size_t i = 0; i < MEM_SNAPSHOT_PERIODS.size(); i++) {
+            mnListSnapshots.emplace_back(nPerPeriod);
+        }
+    }
+}
+
+CDeterministicMNManager::~CDeterministicMNManager() = default;
+
 CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex* pindex)
 {
+    // Try the lists which are already built first, these don't need cs
+    if (auto list = std::atomic_load(&tipList); list && list->GetBlockHash() == pindex->GetBlockHash()) {
+        lockFreeLookups++;
+        cacheHits++;
+        return *list;
+    }
+    CDeterministicMNList snapshot;
+    if (mnListsCache.get(pindex->GetBlockHash(), snapshot)) {
+        lockFreeLookups++;
+        cacheHits++;
+        return snapshot;
+    }
+
+    lockedLookups++;
+    {
+        TRY_LOCK(cs, fLocked);
+        if (!fLocked) {
+            contendedLookups++;
+        }
+    }
     LOCK(cs);
 
-    CDeterministicMNList snapshot;
     std::list<const CBlockIndex*> listDiffIndexes;
+    bool fFromMemory{false};
 
     while (true) {
         // try using cache before reading from disk
-        auto itLists = mnListsCache.find(pindex->GetBlockHash());
-        if (itLists != mnListsCache.end()) {
-            snapshot = itLists->second;
+        if (mnListsCache.get(pindex->GetBlockHash(), snapshot)) {
+            fFromMemory = true;
+            break;
+        }
+        if (ranges::any_of(mnListSnapshots, [&](auto& snapshots) { return snapshots.get(pindex->GetBlockHash(), snapshot); })) {
+            fFromMemory = true;
             break;
         }
 
@@ -967,18 +1035,26 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
             snapshot.SetBlockHash(diffIndex->GetBlockHash());
             snapshot.SetHeight(diffIndex->nHeight);
         }
+        // snapshots evicted from memory are restored on the way, so that later lookups can start from there again
+        AddMemSnapshot(snapshot);
     }
 
-    if (tipIndex) {
+    if (fFromMemory && listDiffIndexes.empty()) {
+        cacheHits++;
+    } else {
+        cacheMisses++;
+    }
+    maxReplayedDiffs = std::max(maxReplayedDiffs, listDiffIndexes.size());
+
+    if (const CBlockIndex* pindexTip = tipIndex) {
         // always keep a snapshot for the tip
-        if (snapshot.GetBlockHash() == tipIndex->GetBlockHash()) {
+        if (snapshot.GetBlockHash() == pindexTip->GetBlockHash()) {
             mnListsCache.emplace(snapshot.GetBlockHash(), snapshot);
         } else {
             // keep snapshots for yet alive quorums
-            if (ranges::any_of(Params().GetConsensus().llmqs, [&snapshot, this](const auto& params){
-                LOCK(cs);
+            if (ranges::any_of(Params().GetConsensus().llmqs, [&snapshot, pindexTip](const auto& params){
                 return (snapshot.GetHeight() % params.dkgInterval == 0) &&
-                (snapshot.GetHeight() + params.dkgInterval * (params.keepOldConnections + 1) >= tipIndex->nHeight);
+                (snapshot.GetHeight() + params.dkgInterval * (params.keepOldConnections + 1) >= pindexTip->nHeight);
             })) {
                 mnListsCache.emplace(snapshot.GetBlockHash(), snapshot);
             }
@@ -990,11 +1066,67 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
 
 CDeterministicMNList CDeterministicMNManager::GetListAtChainTip()
 {
-    LOCK(cs);
-    if (!tipIndex) {
+    auto list = std::atomic_load(&tipList);
+    if (!list) {
         return {};
     }
-    return GetListForBlock(tipIndex);
+    lockFreeLookups++;
+    return *list;
+}
+
+CDeterministicMNManager::LookupStats CDeterministicMNManager::GetLookupStats() const
+{
+    LookupStats stats;
+    stats.lockFree = lockFreeLookups;
+    stats.locked = lockedLookups;
+    stats.contended = contendedLookups;
+    return stats;
+}
+
+uint256 CDeterministicMNManager::CalcSMLMerkleRoot(const CDeterministicMNList& mnList, bool isV19Active, bool* pmutated)
+{
+    AssertLockHeld(cs);
+
+    // A failure in here must never make a valid block invalid, so try a fresh tree and then the full SML before giving up
+    for (int i = 0; i < 2; i++) {
+        try {
+            smlTree->Update(mnList, isV19Active);
+            return smlTree->GetMerkleRoot(pmutated);
+        } catch (const std::exception& e) {
+            LogPrintf("CDeterministicMNManager::%s -- updating SML merkle tree failed, attempt=%d: %s\n", __func__, i, e.what());
+            smlTree = std::make_unique<CSimplifiedMNListMerkleTree>();
+        }
+    }
+    return CSimplifiedMNList(mnList, isV19Active).CalcMerkleRoot(pmutated);
+}
+
+void CDeterministicMNManager::AddMemSnapshot(const CDeterministicMNList& mnList)
+{
+    AssertLockHeld(cs);
+
+    // Every list is kept at the coarsest interval it matches only, so that the many lists of the fine intervals
+    // never evict the ones of the coarse intervals
+    for (size_t i = 0; i < mnListSnapshots.size(); i++) {
+        if (mnList.GetHeight() % MEM_SNAPSHOT_PERIODS[i] == 0) {
+            mnListSnapshots[i].insert(mnList.GetBlockHash(), mnList);
+            return;
+        }
+    }
+}
+
+CDeterministicMNManager::CacheStats CDeterministicMNManager::GetCacheStats()
+{
+    LOCK(cs);
+    CacheStats stats;
+    stats.lists = mnListsCache.size();
+    for (const auto& snapshots : mnListSnapshots) {
+        stats.lists += snapshots.size();
+        stats.maxSnapshots += snapshots.max_size();
+    }
+    stats.hits = cacheHits;
+    stats.misses = cacheMisses;
+    stats.maxReplayedDiffs = maxReplayedDiffs;
+    return stats;
 }
 
 bool CDeterministicMNManager::IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n)
@@ -1022,12 +1154,12 @@ bool CDeterministicMNManager::IsProTxWithCollateral(const CTransactionRef& tx, u
 bool CDeterministicMNManager::IsDIP3Enforced(int nHeight)
 {
     if (nHeight == -1) {
-        LOCK(cs);
-        if (tipIndex == nullptr) {
+        const CBlockIndex* pindexTip = tipIndex;
+        if (pindexTip == nullptr) {
             // Since EnforcementHeight can be set to block 1, we shouldn't just return false here
             nHeight = 1;
         } else {
-            nHeight = tipIndex->nHeight;
+            nHeight = pindexTip->nHeight;
         }
     }
 
@@ -1038,32 +1170,27 @@ void CDeterministicMNManager::CleanupCache(int nHeight)
 {
     AssertLockHeld(cs);
 
-    std::vector<uint256> toDeleteLists;
+    const CBlockIndex* pindexTip = tipIndex;
     std::vector<uint256> toDeleteDiffs;
-    for (const auto& p : mnListsCache) {
-        if (p.second.GetHeight() + LIST_DIFFS_CACHE_SIZE < nHeight) {
-            toDeleteLists.emplace_back(p.first);
-            continue;
+    mnListsCache.erase_if([&](const uint256& blockHash, const CDeterministicMNList& list) {
+        if (list.GetHeight() + LIST_DIFFS_CACHE_SIZE < nHeight) {
+            return true;
         }
-        bool fQuorumCache = ranges::any_of(Params().GetConsensus().llmqs, [&nHeight, &p](const auto& params){
-            return (p.second.GetHeight() % params.dkgInterval == 0) &&
-                   (p.second.GetHeight() + params.dkgInterval * (params.keepOldConnections + 1) >= nHeight);
+        bool fQuorumCache = ranges::any_of(Params().GetConsensus().llmqs, [&nHeight, &list](const auto& params){
+            return (list.GetHeight() % params.dkgInterval == 0) &&
+                   (list.GetHeight() + params.dkgInterval * (params.keepOldConnections + 1) >= nHeight);
         });
         if (fQuorumCache) {
             // at least one quorum could be using it, keep it
-            continue;
+            return false;
         }
         // no alive quorums using it, see if it was a cache for the tip or for a now outdated quorum
-        if (tipIndex && tipIndex->pprev && (p.first == tipIndex->pprev->GetBlockHash())) {
-            toDeleteLists.emplace_back(p.first);
-        } else if (ranges::any_of(Params().GetConsensus().llmqs,
-                                  [&p](const auto& llmqParams){ return p.second.GetHeight() % llmqParams.dkgInterval == 0; })) {
-            toDeleteLists.emplace_back(p.first);
+        if (pindexTip && pindexTip->pprev && (blockHash == pindexTip->pprev->GetBlockHash())) {
+            return true;
         }
-    }
-    for (const auto& h : toDeleteLists) {
-        mnListsCache.erase(h);
-    }
+        return ranges::any_of(Params().GetConsensus().llmqs,
+                              [&list](const auto& llmqParams){ return list.GetHeight() % llmqParams.dkgInterval == 0; });
+    });
     for (const auto& p : mnListDiffsCache) {
         if (p.second.nHeight + LIST_DIFFS_CACHE_SIZE < nHeight) {
             toDeleteDiffs.emplace_back(p.first);
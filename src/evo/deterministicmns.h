@@ -15,20 +15,29 @@
 #include <saltedhasher.h>
 #include <scheduler.h>
 #include <sync.h>
+#include <unordered_lru_cache.h>
+#include <unordered_sharded_map.h>
 
 #include <immer/map.hpp>
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 class CConnman;
 class CBlock;
 class CBlockIndex;
 class CValidationState;
 class CSimplifiedMNListDiff;
+class CSimplifiedMNListMerkleTree;
 
 extern CCriticalSection cs_main;
 
+static const size_t DEFAULT_MNLIST_CACHE_SIZE = 256;
+
 namespace llmq
 {
     class CFinalCommitment;
@@ -89,6 +98,11 @@ public:
     }
 
     [[nodiscard]] uint64_t GetInternalId() const;
+    /**
+     * Hash of the CSimplifiedMNListEntry with the given version. Memoized in pdmnState, so it's only
+     * recalculated after SML-relevant fields of the state changed.
+     */
+    [[nodiscard]] uint256 GetSmlEntryHash(uint16_t nVersion) const;
 
     [[nodiscard]] std::string ToString() const;
     void ToJson(UniValue& obj) const;
@@ -485,6 +499,11 @@ class CDeterministicMNManager
     static constexpr int LIST_DIFFS_CACHE_SIZE = DISK_SNAPSHOT_PERIOD * DISK_SNAPSHOTS;
 
 public:
+    // Lists between the disk snapshots are kept in memory at these finer intervals (one LRU cache per interval). They
+    // are added when a block is connected and restored when a lookup replays diffs over them, so that a lookup only
+    // has to replay less than MEM_SNAPSHOT_PERIODS.back() diffs as long as the snapshots fit into memory
+    static constexpr std::array<int, 2> MEM_SNAPSHOT_PERIODS{64, 8};
+
     CCriticalSection cs;
 
 private:
@@ -498,14 +517,52 @@ private:
     CEvoDB& m_evoDb;
     CConnman& connman;
 
-    std::unordered_map<uint256, CDeterministicMNList, StaticSaltedHasher> mnListsCache GUARDED_BY(cs);
+    // Lists never change once built for a block, so cached lists can be looked up without holding cs. Only
+    // modifications and building missing lists from diffs need cs
+    unordered_sharded_map<uint256, CDeterministicMNList, StaticSaltedHasher> mnListsCache;
     std::unordered_map<uint256, CDeterministicMNListDiff, StaticSaltedHasher> mnListDiffsCache GUARDED_BY(cs);
-    const CBlockIndex* tipIndex GUARDED_BY(cs) {nullptr};
+    // In-memory snapshots for each of MEM_SNAPSHOT_PERIODS, limited by -mnlistcachesize
+    std::vector<unordered_lru_cache<uint256, CDeterministicMNList, StaticSaltedHasher>> mnListSnapshots GUARDED_BY(cs);
+    std::atomic<const CBlockIndex*> tipIndex {nullptr};
+    // The list at tipIndex. Only written while holding cs, but always read and replaced through std::atomic_load and
+    // std::atomic_store so that GetListAtChainTip never needs cs
+    std::shared_ptr<const CDeterministicMNList> tipList;
+    // Merkle tree of the list last passed to CalcSMLMerkleRoot, so that only changed masternodes have to be rehashed
+    std::unique_ptr<CSimplifiedMNListMerkleTree> smlTree GUARDED_BY(cs);
+
+    std::atomic<uint64_t> lockFreeLookups {0};
+    std::atomic<uint64_t> lockedLookups {0};
+    std::atomic<uint64_t> contendedLookups {0};
+    std::atomic<uint64_t> cacheHits {0};
+    std::atomic<uint64_t> cacheMisses {0};
+    size_t maxReplayedDiffs GUARDED_BY(cs) {0};
 
 public:
-    explicit CDeterministicMNManager(CEvoDB& evoDb, CConnman& _connman) :
-        m_evoDb(evoDb), connman(_connman) {}
-    ~CDeterministicMNManager() = default;
+    // Counters to measure contention on cs caused by list lookups
+    struct LookupStats {
+        // lookups which were answered from the tip list or the list cache without taking cs
+        uint64_t lockFree{0};
+        // lookups which had to take cs to build the list from diffs
+        uint64_t locked{0};
+        // lookups which had to wait for cs because another thread held it
+        uint64_t contended{0};
+    };
+
+    struct CacheStats {
+        // lists kept in memory, both for the tip and alive quorums and as in-memory snapshots
+        size_t lists{0};
+        // maximum number of in-memory snapshots
+        size_t maxSnapshots{0};
+        // lookups which found the list in memory
+        uint64_t hits{0};
+        // lookups which had to read from disk or replay diffs
+        uint64_t misses{0};
+        // most diffs replayed by a single lookup
+        size_t maxReplayedDiffs{0};
+    };
+
+    explicit CDeterministicMNManager(CEvoDB& evoDb, CConnman& _connman, size_t nListCacheSize = DEFAULT_MNLIST_CACHE_SIZE);
+    ~CDeterministicMNManager();
 
     bool ProcessBlock(const CBlock& block, const CBlockIndex* pindex, CValidationState& state,
                       const CCoinsViewCache& view, bool fJustCheck) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -522,6 +579,16 @@ public:
     CDeterministicMNList GetListForBlock(const CBlockIndex* pindex);
     CDeterministicMNList GetListAtChainTip();
 
+    /**
+     * Calculate the merkle root of the SML built from the given list (merkleRootMNList of CCbTx). Incrementally
+     * updates the tree of the previously passed list, the tree is rebuilt and finally the full SML is hashed in case
+     * updating it fails.
+     */
+    uint256 CalcSMLMerkleRoot(const CDeterministicMNList& mnList, bool isV19Active, bool* pmutated) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    LookupStats GetLookupStats() const;
+    CacheStats GetCacheStats();
+
     // Test if given TX is a ProRegTx which also contains the collateral at index n
     static bool IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n);
 
@@ -532,6 +599,7 @@ public:
 
 private:
     void CleanupCache(int nHeight) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    void AddMemSnapshot(const CDeterministicMNList& mnList) EXCLUSIVE_LOCKS_REQUIRED(cs);
 };
 
 bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state, const CCoinsViewCache& view, bool check_sigs);
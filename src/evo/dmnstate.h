@@ -11,6 +11,7 @@
 #include <netaddress.h>
 #include <script/script.h>
 #include <evo/providertx.h>
+#include <sync.h>
 
 #include <memory>
 #include <utility>
@@ -20,6 +21,61 @@ class UniValue;
 
 class CDeterministicMNState;
 
+/**
+ * Memory only, lazily calculated hash of the CSimplifiedMNListEntry built from a CDeterministicMNState.
+ * Copies of a state start without a hash, it is only carried over to a new state explicitly (see
+ * CDeterministicMNList::UpdateMN) when none of the SML-relevant fields changed.
+ */
+class CSimplifiedMNListEntryHashCache
+{
+private:
+    mutable Mutex cs;
+    uint16_t nVersion GUARDED_BY(cs){0};
+    uint256 hash GUARDED_BY(cs);
+
+public:
+    CSimplifiedMNListEntryHashCache() = default;
+    CSimplifiedMNListEntryHashCache(const CSimplifiedMNListEntryHashCache&) {}
+    CSimplifiedMNListEntryHashCache& operator=(const CSimplifiedMNListEntryHashCache&)
+    {
+        Reset();
+        return *this;
+    }
+
+    bool Get(uint16_t _nVersion, uint256& hashRet) const
+    {
+        LOCK(cs);
+        if (nVersion == 0 || nVersion != _nVersion) {
+            return false;
+        }
+        hashRet = hash;
+        return true;
+    }
+    void Set(uint16_t _nVersion, const uint256& _hash)
+    {
+        LOCK(cs);
+        nVersion = _nVersion;
+        hash = _hash;
+    }
+    void CopyFrom(const CSimplifiedMNListEntryHashCache& other)
+    {
+        uint16_t _nVersion;
+        uint256 _hash;
+        {
+            LOCK(other.cs);
+            _nVersion = other.nVersion;
+            _hash = other.hash;
+        }
+        Set(_nVersion, _hash);
+    }
+    void Reset()
+    {
+        LOCK(cs);
+        nVersion = 0;
+        hash.SetNull();
+    }
+};
+
 namespace llmq
 {
     class CFinalCommitment;
@@ -52,6 +108,9 @@ public:
     CScript scriptPayout;
     CScript scriptOperatorPayout;
 
+    // memory only, see CDeterministicMN::GetSmlEntryHash
+    mutable CSimplifiedMNListEntryHashCache smlEntryHash;
+
 public:
     CDeterministicMNState() = default;
     explicit CDeterministicMNState(const CProRegTx& proTx) :
@@ -109,6 +168,15 @@ public:
     {
         return nPoSeBanHeight != -1;
     }
+    // true if both states result in the same CSimplifiedMNListEntry
+    bool IsSmlEqual(const CDeterministicMNState& other) const
+    {
+        return confirmedHash == other.confirmedHash &&
+               addr == other.addr &&
+               keyIDVoting == other.keyIDVoting &&
+               IsBanned() == other.IsBanned() &&
+               pubKeyOperator == other.pubKeyOperator;
+    }
     void Revive(int nRevivedHeight)
     {
         nPoSePenalty = 0;
@@ -149,6 +217,13 @@ public:
         Field_scriptOperatorPayout              = 0x2000,
     };
 
+    // Fields which are part of the CSimplifiedMNListEntry
+    static constexpr uint32_t SML_FIELDS = Field_nPoSeBanHeight |
+                                           Field_confirmedHash |
+                                           Field_pubKeyOperator |
+                                           Field_keyIDVoting |
+                                           Field_addr;
+
 #define DMN_STATE_DIFF_ALL_FIELDS \
     DMN_STATE_DIFF_LINE(nRegisteredHeight) \
     DMN_STATE_DIFF_LINE(nLastPaidHeight) \
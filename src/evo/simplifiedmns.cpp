@@ -34,8 +34,18 @@ CSimplifiedMNListEntry::CSimplifiedMNListEntry(const CDeterministicMN& dmn) :
 {
 }
 
+CSimplifiedMNListEntry::CSimplifiedMNListEntry(const CDeterministicMN& dmn, uint16_t _nVersion) :
+    CSimplifiedMNListEntry(dmn)
+{
+    nVersion = _nVersion;
+    precalculatedHash = dmn.GetSmlEntryHash(nVersion);
+}
+
 uint256 CSimplifiedMNListEntry::CalcHash() const
 {
+    if (!precalculatedHash.IsNull()) {
+        return precalculatedHash;
+    }
     CHashWriter hw(SER_GETHASH, CLIENT_VERSION);
     hw << *this;
     return hw.GetHash();
@@ -97,10 +107,9 @@ CSimplifiedMNList::CSimplifiedMNList(const CDeterministicMNList& dmnList, bool i
     mnList.resize(dmnList.GetAllMNsCount());
 
     size_t i = 0;
-    dmnList.ForEachMN(false, [this, &i, isV19Active](auto& dmn) {
-        auto sme = std::make_unique<CSimplifiedMNListEntry>(dmn);
-        sme->nVersion = isV19Active ? CSimplifiedMNListEntry::BASIC_BLS_VERSION : CSimplifiedMNListEntry::LEGACY_BLS_VERSION;
-        mnList[i++] = std::move(sme);
+    const uint16_t nVersion = isV19Active ? CSimplifiedMNListEntry::BASIC_BLS_VERSION : CSimplifiedMNListEntry::LEGACY_BLS_VERSION;
+    dmnList.ForEachMN(false, [this, &i, nVersion](auto& dmn) {
+        mnList[i++] = std::make_unique<CSimplifiedMNListEntry>(dmn, nVersion);
     });
 
     std::sort(mnList.begin(), mnList.end(), [&](const std::unique_ptr<CSimplifiedMNListEntry>& a, const std::unique_ptr<CSimplifiedMNListEntry>& b) {
@@ -129,6 +138,165 @@ bool CSimplifiedMNList::operator==(const CSimplifiedMNList& rhs) const
             );
 }
 
+void CSimplifiedMNListMerkleTree::Update(const CDeterministicMNList& to, bool _isV19Active)
+{
+    if (!fInitialized || isV19Active != _isV19Active) {
+        Rebuild(to, _isV19Active);
+        return;
+    }
+    // This is the forward diff when moving to a newer list and the undo diff when moving back after a reorg
+    ApplyDiff(to, mnList.BuildDiff(to));
+}
+
+void CSimplifiedMNListMerkleTree::Rebuild(const CDeterministicMNList& to, bool _isV19Active)
+{
+    isV19Active = _isV19Active;
+    const uint16_t nVersion = GetEntryVersion();
+
+    std::vector<std::pair<uint256, uint256>> entries;
+    entries.reserve(to.GetAllMNsCount());
+    to.ForEachMN(false, [&](const auto& dmn) {
+        entries.emplace_back(dmn.proTxHash, dmn.GetSmlEntryHash(nVersion));
+    });
+    std::sort(entries.begin(), entries.end());
+
+    vProRegTxHashes.clear();
+    vProRegTxHashes.reserve(entries.size());
+    vLevels.assign(1, {});
+    vLevels[0].reserve(entries.size());
+    for (const auto& [proRegTxHash, leafHash] : entries) {
+        vProRegTxHashes.emplace_back(proRegTxHash);
+        vLevels[0].emplace_back(leafHash);
+    }
+    RecalcLevels({}, 0, 0);
+
+    mnList = to;
+    fInitialized = true;
+}
+
+void CSimplifiedMNListMerkleTree::ApplyDiff(const CDeterministicMNList& to, const CDeterministicMNListDiff& diff)
+{
+    // in case anything below throws, make sure the next Update() starts from scratch
+    fInitialized = false;
+
+    auto& leaves = vLevels[0];
+    const size_t nOldLeaves = leaves.size();
+    size_t nFirstChanged{NO_CHANGE};
+    std::set<size_t> setDirty;
+
+    for (const auto& id : diff.removedMns) {
+        auto dmn = mnList.GetMNByInternalId(id);
+        if (!dmn) {
+            throw std::runtime_error(strprintf("%s: can't find a removed masternode, id=%d", __func__, id));
+        }
+        auto it = std::lower_bound(vProRegTxHashes.begin(), vProRegTxHashes.end(), dmn->proTxHash);
+        if (it == vProRegTxHashes.end() || *it != dmn->proTxHash) {
+            throw std::runtime_error(strprintf("%s: masternode %s not in tree", __func__, dmn->proTxHash.ToString()));
+        }
+        size_t pos = it - vProRegTxHashes.begin();
+        vProRegTxHashes.erase(it);
+        leaves.erase(leaves.begin() + pos);
+        nFirstChanged = std::min(nFirstChanged, pos);
+    }
+    for (const auto& dmn : diff.addedMNs) {
+        auto it = std::lower_bound(vProRegTxHashes.begin(), vProRegTxHashes.end(), dmn->proTxHash);
+        if (it != vProRegTxHashes.end() && *it == dmn->proTxHash) {
+            throw std::runtime_error(strprintf("%s: masternode %s already in tree", __func__, dmn->proTxHash.ToString()));
+        }
+        size_t pos = it - vProRegTxHashes.begin();
+        vProRegTxHashes.insert(it, dmn->proTxHash);
+        leaves.insert(leaves.begin() + pos, dmn->GetSmlEntryHash(GetEntryVersion()));
+        nFirstChanged = std::min(nFirstChanged, pos);
+    }
+    for (const auto& [id, stateDiff] : diff.updatedMNs) {
+        if (!(stateDiff.fields & CDeterministicMNStateDiff::SML_FIELDS)) {
+            // e.g. nLastPaidHeight or nPoSePenalty, which do not affect the SML entry
+            continue;
+        }
+        auto dmn = to.GetMNByInternalId(id);
+        if (!dmn) {
+            throw std::runtime_error(strprintf("%s: can't find an updated masternode, id=%d", __func__, id));
+        }
+        auto it = std::lower_bound(vProRegTxHashes.begin(), vProRegTxHashes.end(), dmn->proTxHash);
+        if (it == vProRegTxHashes.end() || *it != dmn->proTxHash) {
+            throw std::runtime_error(strprintf("%s: masternode %s not in tree", __func__, dmn->proTxHash.ToString()));
+        }
+        size_t pos = it - vProRegTxHashes.begin();
+        leaves[pos] = dmn->GetSmlEntryHash(GetEntryVersion());
+        setDirty.emplace(pos);
+    }
+
+    RecalcLevels(std::move(setDirty), nFirstChanged, nOldLeaves);
+
+    mnList = to;
+    fInitialized = true;
+}
+
+void CSimplifiedMNListMerkleTree::RecalcLevels(std::set<size_t> setDirty, size_t nFirstChanged, size_t nOldSize)
+{
+    // Same tree layout as ComputeMerkleRoot: the last node of a level with an odd size is hashed with itself
+    size_t nLevel = 0;
+    while (vLevels[nLevel].size() > 1) {
+        if (nLevel + 1 == vLevels.size()) {
+            vLevels.emplace_back();
+        }
+        const auto& cur = vLevels[nLevel];
+        auto& next = vLevels[nLevel + 1];
+
+        // a changed level size affects the last parent, as it might have switched between a pair and a duplicate
+        if (cur.size() != nOldSize) {
+            nFirstChanged = std::min(nFirstChanged, cur.size() - 1);
+        }
+
+        const size_t nOldNextSize = next.size();
+        next.resize((cur.size() + 1) / 2);
+
+        auto calcParent = [&](size_t i) {
+            const uint256& left = cur[i * 2];
+            const uint256& right = i * 2 + 1 < cur.size() ? cur[i * 2 + 1] : left;
+            next[i] = Hash(left.begin(), left.end(), right.begin(), right.end());
+        };
+
+        std::set<size_t> setNextDirty;
+        for (const size_t i : setDirty) {
+            if (i >= nFirstChanged) break;
+            if (setNextDirty.emplace(i / 2).second) {
+                calcParent(i / 2);
+            }
+        }
+        if (nFirstChanged != NO_CHANGE) {
+            nFirstChanged /= 2;
+            for (size_t i = nFirstChanged; i < next.size(); i++) {
+                calcParent(i);
+            }
+        }
+
+        setDirty = std::move(setNextDirty);
+        nOldSize = nOldNextSize;
+        nLevel++;
+    }
+    vLevels.resize(nLevel + 1);
+}
+
+uint256 CSimplifiedMNListMerkleTree::GetMerkleRoot(bool* pmutated) const
+{
+    if (pmutated) {
+        // see ComputeMerkleRoot, identical sibling hashes on any level mean the tree is mutated
+        bool mutation = false;
+        for (size_t nLevel = 0; nLevel + 1 < vLevels.size(); nLevel++) {
+            const auto& level = vLevels[nLevel];
+            for (size_t pos = 0; pos + 1 < level.size(); pos += 2) {
+                if (level[pos] == level[pos + 1]) mutation = true;
+            }
+        }
+        *pmutated = mutation;
+    }
+    if (vLevels.empty() || vLevels.back().empty()) {
+        return uint256();
+    }
+    return vLevels.back()[0];
+}
+
 CSimplifiedMNListDiff::CSimplifiedMNListDiff() = default;
 
 CSimplifiedMNListDiff::~CSimplifiedMNListDiff() = default;
@@ -289,3 +457,69 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
 
     return true;
 }
+
+CSerializedResponseCache mnListDiffResponseCache(MAX_CACHED_MNLISTDIFFS, MAX_CACHED_MNLISTDIFF_BYTES);
+
+CSerializedResponseCache::Buffer CSerializedResponseCache::Get(const uint256& key)
+{
+    LOCK(cs);
+    Buffer buffer;
+    if (!cache.get(key, buffer)) {
+        return nullptr;
+    }
+    return buffer;
+}
+
+void CSerializedResponseCache::Insert(const uint256& key, Buffer buffer)
+{
+    if (buffer == nullptr || buffer->size() > nMaxBytes) {
+        return;
+    }
+
+    LOCK(cs);
+    cache.insert(key, buffer);
+
+    // Only a few dozen entries are kept, so simply walk them to find the size and the least recently used entry
+    size_t nBytes = GetBytesInternal();
+    while (nBytes > nMaxBytes) {
+        std::pair<uint256, size_t> oldest;
+        cache.for_each([&](const uint256& k, const Buffer& v) { oldest = {k, v->size()}; });
+        cache.erase(oldest.first);
+        nBytes -= oldest.second;
+        nBytesEvictions++;
+    }
+}
+
+void CSerializedResponseCache::Clear()
+{
+    LOCK(cs);
+    cache.clear();
+}
+
+size_t CSerializedResponseCache::GetBytesInternal() const
+{
+    AssertLockHeld(cs);
+    size_t nBytes{0};
+    cache.for_each([&](const uint256&, const Buffer& v) { nBytes += v->size(); });
+    return nBytes;
+}
+
+size_t CSerializedResponseCache::Size() const
+{
+    LOCK(cs);
+    return cache.size();
+}
+
+size_t CSerializedResponseCache::GetBytes() const
+{
+    LOCK(cs);
+    return GetBytesInternal();
+}
+
+unordered_lru_cache_stats CSerializedResponseCache::GetStats() const
+{
+    LOCK(cs);
+    auto stats = cache.stats();
+    stats.evictions += nBytesEvictions;
+    return stats;
+}
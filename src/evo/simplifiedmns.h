@@ -6,14 +6,19 @@
 #define BITCOIN_EVO_SIMPLIFIEDMNS_H
 
 #include <bls/bls.h>
+#include <evo/deterministicmns.h>
 #include <merkleblock.h>
 #include <netaddress.h>
 #include <pubkey.h>
+#include <saltedhasher.h>
+#include <sync.h>
+#include <unordered_lru_cache.h>
+
+#include <memory>
+#include <vector>
 
 class UniValue;
 class CBlockIndex;
-class CDeterministicMNList;
-class CDeterministicMN;
 
 namespace llmq {
 class CFinalCommitment;
@@ -36,8 +41,14 @@ public:
     CScript scriptOperatorPayout; // mem-only
     uint16_t nVersion{LEGACY_BLS_VERSION}; // mem-only
 
+private:
+    // mem-only, the memoized hash of the masternode this entry was built from (see CDeterministicMN::GetSmlEntryHash)
+    uint256 precalculatedHash;
+
+public:
     CSimplifiedMNListEntry() = default;
     explicit CSimplifiedMNListEntry(const CDeterministicMN& dmn);
+    CSimplifiedMNListEntry(const CDeterministicMN& dmn, uint16_t _nVersion);
 
     bool operator==(const CSimplifiedMNListEntry& rhs) const
     {
@@ -57,6 +68,7 @@ public:
 
     SERIALIZE_METHODS(CSimplifiedMNListEntry, obj)
     {
+        SER_READ(obj, obj.precalculatedHash.SetNull());
         READWRITE(
                 obj.proRegTxHash,
                 obj.confirmedHash,
@@ -86,6 +98,60 @@ public:
     bool operator==(const CSimplifiedMNList& rhs) const;
 };
 
+/**
+ * Merkle tree over the SML entry hashes of a deterministic MN list, ordered by proRegTxHash.
+ * The tree is moved from one list to another by applying a CDeterministicMNListDiff, so only the leaves of
+ * masternodes with changed SML-relevant fields (and the paths above them) have to be rehashed. Moving the tree
+ * back to an older list (e.g. on reorgs) is just applying the undo diff.
+ * The resulting root is identical to CSimplifiedMNList::CalcMerkleRoot() of the same list.
+ */
+class CSimplifiedMNListMerkleTree
+{
+private:
+    static constexpr size_t NO_CHANGE = std::numeric_limits<size_t>::max();
+
+    // the list the tree currently represents, needed to resolve internalIds of removed MNs
+    CDeterministicMNList mnList;
+    bool isV19Active{false};
+    bool fInitialized{false};
+
+    // sorted proRegTxHashes, index i belongs to vLevels[0][i]
+    std::vector<uint256> vProRegTxHashes;
+    // vLevels[0] holds the leaves, each following level the hashes of the level below, vLevels.back() the root
+    std::vector<std::vector<uint256>> vLevels;
+
+public:
+    CSimplifiedMNListMerkleTree() = default;
+
+    /**
+     * Bring the tree in sync with the given list. Only entries which differ from the list passed in the previous
+     * call are rehashed. A full rebuild happens on the first call and when the BLS scheme changes.
+     */
+    void Update(const CDeterministicMNList& to, bool _isV19Active);
+
+    /**
+     * Apply a diff which transforms the currently represented list into `to`.
+     * Throws if the diff does not match the tree, in which case the tree is rebuilt on the next Update.
+     */
+    void ApplyDiff(const CDeterministicMNList& to, const CDeterministicMNListDiff& diff);
+
+    uint256 GetMerkleRoot(bool* pmutated = nullptr) const;
+    size_t size() const { return vProRegTxHashes.size(); }
+
+private:
+    uint16_t GetEntryVersion() const
+    {
+        return isV19Active ? CSimplifiedMNListEntry::BASIC_BLS_VERSION : CSimplifiedMNListEntry::LEGACY_BLS_VERSION;
+    }
+    void Rebuild(const CDeterministicMNList& to, bool _isV19Active);
+    /**
+     * Recalculate all inner nodes which depend on the leaves in setDirtyLeaves or on any leaf at or after
+     * nFirstChanged (insertions/removals shift all following leaves). nOldLeaves is the number of leaves
+     * before the change.
+     */
+    void RecalcLevels(std::set<size_t> setDirty, size_t nFirstChanged, size_t nOldLeaves);
+};
+
 /// P2P messages
 
 class CGetSimplifiedMNListDiff
@@ -139,4 +205,45 @@ public:
 bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& blockHash, CSimplifiedMNListDiff& mnListDiffRet,
                                const llmq::CQuorumBlockProcessor& quorum_block_processor, std::string& errorRet, bool extended = false);
 
+/**
+ * Serialized responses to GETMNLISTDIFF (and GETQUORUMROTATIONINFO, see llmq/snapshot.h), kept so that light clients
+ * asking for the same data don't make us rebuild and reserialize it over and over again. The cache is limited by the
+ * number of kept messages and by their total size. Buffers are shared with the callers, so a hit doesn't copy anything
+ * while the lock is held and evicting a buffer which is still being sent is fine.
+ */
+class CSerializedResponseCache
+{
+public:
+    using Buffer = std::shared_ptr<const std::vector<unsigned char>>;
+
+private:
+    mutable Mutex cs;
+    unordered_lru_cache<uint256, Buffer, StaticSaltedHasher> cache GUARDED_BY(cs);
+    const size_t nMaxBytes;
+    // entries evicted to stay below nMaxBytes, the cache itself only counts the ones evicted due to their number
+    uint64_t nBytesEvictions GUARDED_BY(cs){0};
+
+    size_t GetBytesInternal() const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+public:
+    CSerializedResponseCache(size_t nMaxEntries, size_t _nMaxBytes) : cache(nMaxEntries), nMaxBytes(_nMaxBytes) {}
+
+    /** Returns the buffer kept for key or nullptr */
+    Buffer Get(const uint256& key);
+    /** Buffers bigger than the whole cache are not kept */
+    void Insert(const uint256& key, Buffer buffer);
+    /** Drops all entries, e.g. when they can't be served anymore */
+    void Clear();
+
+    size_t Size() const;
+    size_t GetBytes() const;
+    unordered_lru_cache_stats GetStats() const;
+};
+
+/** Number and total size of the serialized MNLISTDIFF messages kept for repeated requests */
+static constexpr size_t MAX_CACHED_MNLISTDIFFS = 32;
+static constexpr size_t MAX_CACHED_MNLISTDIFF_BYTES = 8 * 1024 * 1024;
+
+extern CSerializedResponseCache mnListDiffResponseCache;
+
 #endif // BITCOIN_EVO_SIMPLIFIEDMNS_H
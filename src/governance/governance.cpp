@@ -10,6 +10,7 @@
 #include <consensus/validation.h>
 #include <evo/deterministicmns.h>
 #include <governance/classes.h>
+#include <governance/governancedb.h>
 #include <governance/validators.h>
 #include <masternode/meta.h>
 #include <masternode/sync.h>
@@ -45,6 +46,8 @@ CGovernanceManager::CGovernanceManager() :
 {
 }
 
+CGovernanceManager::~CGovernanceManager() = default;
+
 // Accessors for thread-safe access to maps
 bool CGovernanceManager::HaveObjectForHash(const uint256& nHash) const
 {
@@ -238,6 +241,7 @@ void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CConnman& c
     ScopedLockBool guard(cs, fRateChecksEnabled, false);
 
     int64_t nNow = GetAdjustedTime();
+    std::vector<vote_time_pair_t> vecRemoved;
     for (const auto& pairVote : vecVotePairs) {
         bool fRemove = false;
         const CGovernanceVote& vote = pairVote.first;
@@ -250,8 +254,12 @@ void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CConnman& c
         }
         if (fRemove) {
             cmmapOrphanVotes.Erase(nHash, pairVote);
+            vecRemoved.emplace_back(pairVote);
         }
     }
+    if (db && !vecRemoved.empty()) {
+        db->EraseOrphanVotes(vecRemoved);
+    }
 }
 
 void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman& connman, const CNode* pfrom)
@@ -285,6 +293,10 @@ void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman
         return;
     }
 
+    if (db) {
+        db->WriteObject(objpair.first->second);
+    }
+
     // SHOULD WE ADD THIS OBJECT TO ANY OTHER MANAGERS?
 
     LogPrint(BCLog::GOBJECT, "CGovernanceManager::AddGovernanceObject -- Before trigger block, GetDataAsPlainString = %s, nObjectType = %d\n",
@@ -329,7 +341,11 @@ void CGovernanceManager::UpdateCachesAndClean()
         if (it == mapObjects.end()) {
             continue;
         }
-        it->second.ClearMasternodeVotes();
+        for (const auto& mnOutpoint : it->second.ClearMasternodeVotes()) {
+            if (db) {
+                db->WriteMasternodeVotes(it->second, mnOutpoint);
+            }
+        }
     }
 
     ScopedLockBool guard(cs, fRateChecksEnabled, false);
@@ -396,6 +412,9 @@ void CGovernanceManager::UpdateCachesAndClean()
             }
 
             mapErasedGovernanceObjects.insert(std::make_pair(nHash, nTimeExpired));
+            if (db) {
+                db->EraseObject(nHash, nTimeExpired);
+            }
             mapObjects.erase(it++);
         } else {
             // NOTE: triggers are handled via triggerman
@@ -407,19 +426,29 @@ void CGovernanceManager::UpdateCachesAndClean()
                     pObj->PrepareDeletion(nNow);
                 }
             }
+            // the deletion time and the expiration are set in several places, but only once and shortly before the
+            // object gets erased, so simply keep writing objects which wait for that
+            if (db && (pObj->IsSetCachedDelete() || pObj->IsSetExpired())) {
+                db->WriteObject(*pObj);
+            }
             ++it;
         }
     }
 
     // forget about expired deleted objects
+    std::vector<uint256> vecExpired;
     auto s_it = mapErasedGovernanceObjects.begin();
     while (s_it != mapErasedGovernanceObjects.end()) {
         if (s_it->second < nNow) {
+            vecExpired.emplace_back(s_it->first);
             mapErasedGovernanceObjects.erase(s_it++);
         } else {
             ++s_it;
         }
     }
+    if (db && !vecExpired.empty()) {
+        db->ForgetErasedObjects(vecExpired);
+    }
 
     LogPrint(BCLog::GOBJECT, "CGovernanceManager::UpdateCachesAndClean -- %s\n", ToString());
 }
@@ -481,6 +510,16 @@ void CGovernanceManager::GetAllNewerThan(std::vector<CGovernanceObject>& objs, i
 {
     LOCK(cs);
 
+    for (const auto* pObj : GetAllNewerThan(nMoreThanTime)) {
+        objs.push_back(*pObj);
+    }
+}
+
+std::vector<const CGovernanceObject*> CGovernanceManager::GetAllNewerThan(int64_t nMoreThanTime) const
+{
+    AssertLockHeld(cs);
+
+    std::vector<const CGovernanceObject*> vecResult;
     for (const auto& objPair : mapObjects) {
         // IF THIS OBJECT IS OLDER THAN TIME, CONTINUE
         if (objPair.second.GetCreationTime() < nMoreThanTime) {
@@ -488,8 +527,9 @@ void CGovernanceManager::GetAllNewerThan(std::vector<CGovernanceObject>& objs, i
         }
 
         // ADD GOVERNANCE OBJECT TO LIST
-        objs.push_back(objPair.second);
+        vecResult.push_back(&objPair.second);
     }
+    return vecResult;
 }
 
 //
@@ -807,7 +847,11 @@ bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote,
         ostr << "CGovernanceManager::ProcessVote -- Unknown parent object " << nHashGovobj.ToString()
              << ", MN outpoint = " << vote.GetMasternodeOutpoint().ToStringShort();
         exception = CGovernanceException(ostr.str(), GOVERNANCE_EXCEPTION_WARNING);
-        if (cmmapOrphanVotes.Insert(nHashGovobj, vote_time_pair_t(vote, GetAdjustedTime() + GOVERNANCE_ORPHAN_EXPIRATION_TIME))) {
+        vote_time_pair_t pairVote(vote, GetAdjustedTime() + GOVERNANCE_ORPHAN_EXPIRATION_TIME);
+        if (cmmapOrphanVotes.Insert(nHashGovobj, pairVote)) {
+            if (db) {
+                db->WriteOrphanVote(pairVote);
+            }
             LEAVE_CRITICAL_SECTION(cs)
             RequestGovernanceObject(pfrom, nHashGovobj, connman);
             LogPrint(BCLog::GOBJECT, "%s\n", ostr.str());
@@ -828,6 +872,9 @@ bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote,
     }
 
     bool fOk = govobj.ProcessVote(vote, exception) && cmapVoteToObject.Insert(nHashVote, &govobj);
+    if (fOk && db) {
+        db->WriteMasternodeVotes(govobj, vote.GetMasternodeOutpoint());
+    }
     LEAVE_CRITICAL_SECTION(cs)
     return fOk;
 }
@@ -1094,6 +1141,58 @@ void CGovernanceManager::AddCachedTriggers()
     }
 }
 
+void CGovernanceManager::InitDb(bool fMemory, bool fWipe)
+{
+    LOCK(cs);
+    int64_t nStart = GetTimeMillis();
+    db = std::make_unique<CGovernanceDb>(fMemory, fWipe);
+    size_t nVotes = db->ReadObjects(mapObjects);
+    db->ReadErasedObjects(mapErasedGovernanceObjects);
+    db->ReadMNList(*lastMNListForVotingKeys);
+    db->ReadState(*this);
+
+    std::vector<vote_time_pair_t> vecOrphanVotes, vecExpired;
+    db->ReadOrphanVotes(vecOrphanVotes);
+    int64_t nNow = GetAdjustedTime();
+    for (const auto& pairVote : vecOrphanVotes) {
+        // also drops expired votes which were evicted from the cache before they could be cleaned up
+        if (pairVote.second < nNow || !cmmapOrphanVotes.Insert(pairVote.first.GetParentHash(), pairVote)) {
+            vecExpired.emplace_back(pairVote);
+        }
+    }
+    if (!vecExpired.empty()) {
+        db->EraseOrphanVotes(vecExpired);
+    }
+    LogPrintf("Read %d governance objects with %d votes from db  %dms\n", mapObjects.size(), nVotes, GetTimeMillis() - nStart);
+}
+
+void CGovernanceManager::WriteAllToDb()
+{
+    LOCK(cs);
+    if (!db) {
+        return;
+    }
+    for (const auto& [_, govobj] : mapObjects) {
+        db->WriteObjectWithVotes(govobj);
+    }
+    for (const auto& [nHash, nTimeExpired] : mapErasedGovernanceObjects) {
+        db->EraseObject(nHash, nTimeExpired);
+    }
+    for (const auto& item : cmmapOrphanVotes.GetItemList()) {
+        db->WriteOrphanVote(item.value);
+    }
+    db->WriteInvalidatedVotes({}, *lastMNListForVotingKeys);
+    db->WriteState(*this);
+}
+
+void CGovernanceManager::WriteStateToDb()
+{
+    LOCK(cs);
+    if (db) {
+        db->WriteState(*this);
+    }
+}
+
 void CGovernanceManager::InitOnLoad()
 {
     // TODO: drop cs_main here and script addresses limit in
@@ -1226,15 +1325,20 @@ void CGovernanceManager::CleanOrphanObjects()
 
     int64_t nNow = GetAdjustedTime();
 
+    std::vector<vote_time_pair_t> vecExpired;
     auto it = items.begin();
     while (it != items.end()) {
         auto prevIt = it;
         ++it;
         const vote_time_pair_t& pairVote = prevIt->value;
         if (pairVote.second < nNow) {
+            vecExpired.emplace_back(pairVote);
             cmmapOrphanVotes.Erase(prevIt->key, prevIt->value);
         }
     }
+    if (db && !vecExpired.empty()) {
+        db->EraseOrphanVotes(vecExpired);
+    }
 }
 
 void CGovernanceManager::RemoveInvalidVotes()
@@ -1264,12 +1368,14 @@ void CGovernanceManager::RemoveInvalidVotes()
         changedKeyMNs.emplace_back(oldDmn->collateralOutpoint);
     }
 
+    std::vector<std::pair<const CGovernanceObject*, COutPoint>> vecChanged;
     for (const auto& outpoint : changedKeyMNs) {
         for (auto& p : mapObjects) {
             auto removed = p.second.RemoveInvalidVotes(outpoint);
             if (removed.empty()) {
                 continue;
             }
+            vecChanged.emplace_back(&p.second, outpoint);
             for (auto& voteHash : removed) {
                 cmapVoteToObject.Erase(voteHash);
                 cmapInvalidVotes.Erase(voteHash);
@@ -1281,6 +1387,9 @@ void CGovernanceManager::RemoveInvalidVotes()
 
     // store current MN list for the next run so that we can determine which keys changed
     lastMNListForVotingKeys = std::make_shared<CDeterministicMNList>(curMNList);
+    if (db && diff.HasChanges()) {
+        db->WriteInvalidatedVotes(vecChanged, *lastMNListForVotingKeys);
+    }
 }
 
 bool AreSuperblocksEnabled(const CSporkManager& sporkManager)
@@ -11,6 +11,7 @@
 
 class CBloomFilter;
 class CBlockIndex;
+class CGovernanceDb;
 class CInv;
 
 class CGovernanceManager;
@@ -195,6 +196,9 @@ private:
     // used to check for changed voting keys
     CDeterministicMNListPtr lastMNListForVotingKeys;
 
+    // objects and votes are written to it as soon as they change, nullptr if governance is not persisted
+    std::unique_ptr<CGovernanceDb> db;
+
     class ScopedLockBool
     {
         bool& ref;
@@ -221,7 +225,7 @@ public:
 
     CGovernanceManager();
 
-    virtual ~CGovernanceManager() = default;
+    virtual ~CGovernanceManager();
 
     /**
      * This is called by AlreadyHave in net_processing.cpp as part of the inventory
@@ -242,6 +246,8 @@ public:
     // These commands are only used in RPC
     std::vector<CGovernanceVote> GetCurrentVotes(const uint256& nParentHash, const COutPoint& mnCollateralOutpointFilter) const;
     void GetAllNewerThan(std::vector<CGovernanceObject>& objs, int64_t nMoreThanTime) const;
+    /// Same as above without copying the objects and their votes, the pointers are only valid while cs is held
+    std::vector<const CGovernanceObject*> GetAllNewerThan(int64_t nMoreThanTime) const;
 
     void AddGovernanceObject(CGovernanceObject& govobj, CConnman& connman, const CNode* pfrom = nullptr);
 
@@ -298,6 +304,35 @@ public:
             >> *lastMNListForVotingKeys;
     }
 
+    /** The caches which the governance db only stores at shutdown, everything else is written as soon as it changes */
+    struct DbStateFormatter {
+        template <typename Stream>
+        void Ser(Stream& s, const CGovernanceManager& governance)
+        {
+            LOCK(governance.cs);
+            s   << governance.cmapInvalidVotes
+                << governance.mapLastMasternodeObject;
+        }
+
+        template <typename Stream>
+        void Unser(Stream& s, CGovernanceManager& governance)
+        {
+            LOCK(governance.cs);
+            s   >> governance.cmapInvalidVotes
+                >> governance.mapLastMasternodeObject;
+        }
+    };
+
+    /**
+     * Opens the governance db and reads everything from it. From then on objects, votes, erased objects, orphan votes
+     * and the last masternode list are written to the db as soon as they change, the remaining state only by
+     * WriteStateToDb().
+     */
+    void InitDb(bool fMemory, bool fWipe);
+    /// Writes everything to the db, used after importing governance.dat of older versions
+    void WriteAllToDb();
+    void WriteStateToDb();
+
     void UpdatedBlockTip(const CBlockIndex* pindex, CConnman& connman);
     int64_t GetLastDiffTime() const { return nTimeLastDiff; }
     void UpdateLastDiffTime(int64_t nTimeIn) { nTimeLastDiff = nTimeIn; }
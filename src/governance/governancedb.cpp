@@ -0,0 +1,208 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governance/governancedb.h>
+
+#include <evo/deterministicmns.h>
+#include <governance/governance.h>
+#include <util/system.h>
+
+#include <set>
+#include <tuple>
+
+static const std::string DB_OBJECT = "gov_o";
+static const std::string DB_MN_VOTES = "gov_mv";
+static const std::string DB_ERASED_OBJECT = "gov_e";
+static const std::string DB_ORPHAN_VOTE = "gov_ov";
+static const std::string DB_MN_LIST = "gov_l";
+static const std::string DB_STATE = "gov_s";
+
+static const std::string DB_VERSION = "gov_v";
+
+CGovernanceDb::CGovernanceDb(bool _fMemory, bool fWipe) :
+    fMemory(_fMemory)
+{
+    Open(fWipe);
+
+    int nVersion{0};
+    if (db->Read(DB_VERSION, nVersion) && nVersion == CURRENT_VERSION) {
+        return;
+    }
+    if (!fWipe && !db->IsEmpty()) {
+        LogPrintf("CGovernanceDb -- unsupported version %d, wiping\n", nVersion);
+        Open(true);
+    }
+    db->Write(DB_VERSION, CURRENT_VERSION);
+}
+
+void CGovernanceDb::Open(bool fWipe)
+{
+    // make sure an open db releases its lock before opening it again
+    db.reset();
+    db = std::make_unique<CDBWrapper>(fMemory ? "" : (GetDataDir() / "governance"), 8 << 20, fMemory, fWipe);
+}
+
+void CGovernanceDb::WriteObject(const CGovernanceObject& govobj)
+{
+    db->Write(std::make_pair(DB_OBJECT, govobj.GetHash()), Using<CGovernanceObject::DbFormatter>(govobj));
+}
+
+void CGovernanceDb::WriteObjectWithVotes(const CGovernanceObject& govobj)
+{
+    CDBBatch batch(*db);
+    batch.Write(std::make_pair(DB_OBJECT, govobj.GetHash()), Using<CGovernanceObject::DbFormatter>(govobj));
+
+    std::set<COutPoint> setVoters;
+    for (const auto& vote : govobj.GetVoteFile().GetVotes()) {
+        setVoters.emplace(vote.GetMasternodeOutpoint());
+    }
+    for (const auto& mnOutpoint : setVoters) {
+        WriteMasternodeVotes(batch, govobj, mnOutpoint);
+    }
+    db->WriteBatch(batch);
+}
+
+void CGovernanceDb::EraseObject(const uint256& nHash, int64_t nTimeExpired)
+{
+    CDBBatch batch(*db);
+    batch.Erase(std::make_pair(DB_OBJECT, nHash));
+    batch.Write(std::make_pair(DB_ERASED_OBJECT, nHash), nTimeExpired);
+
+    std::unique_ptr<CDBIterator> it(db->NewIterator());
+    it->Seek(std::make_pair(DB_MN_VOTES, nHash));
+    std::tuple<std::string, uint256, COutPoint> curKey;
+    while (it->Valid() && it->GetKey(curKey) && std::get<0>(curKey) == DB_MN_VOTES && std::get<1>(curKey) == nHash) {
+        batch.Erase(curKey);
+        it->Next();
+    }
+    db->WriteBatch(batch);
+}
+
+void CGovernanceDb::ForgetErasedObjects(const std::vector<uint256>& vecHashes)
+{
+    CDBBatch batch(*db);
+    for (const auto& nHash : vecHashes) {
+        batch.Erase(std::make_pair(DB_ERASED_OBJECT, nHash));
+    }
+    db->WriteBatch(batch);
+}
+
+void CGovernanceDb::WriteMasternodeVotes(const CGovernanceObject& govobj, const COutPoint& mnOutpoint)
+{
+    CDBBatch batch(*db);
+    WriteMasternodeVotes(batch, govobj, mnOutpoint);
+    db->WriteBatch(batch);
+}
+
+void CGovernanceDb::WriteMasternodeVotes(CDBBatch& batch, const CGovernanceObject& govobj, const COutPoint& mnOutpoint) const
+{
+    auto key = std::make_tuple(DB_MN_VOTES, govobj.GetHash(), mnOutpoint);
+    vote_rec_t voteRecord;
+    auto votes = govobj.GetVoteFile().GetVotesFromMasternode(mnOutpoint);
+    if (!govobj.GetCurrentMNVotes(mnOutpoint, voteRecord) && votes.empty()) {
+        batch.Erase(key);
+        return;
+    }
+    batch.Write(key, std::make_pair(voteRecord, votes));
+}
+
+void CGovernanceDb::WriteInvalidatedVotes(const std::vector<std::pair<const CGovernanceObject*, COutPoint>>& vecChanged, const CDeterministicMNList& mnList)
+{
+    CDBBatch batch(*db);
+    for (const auto& [pObj, mnOutpoint] : vecChanged) {
+        WriteMasternodeVotes(batch, *pObj, mnOutpoint);
+    }
+    batch.Write(DB_MN_LIST, mnList);
+    db->WriteBatch(batch);
+}
+
+void CGovernanceDb::WriteOrphanVote(const vote_time_pair_t& pairVote)
+{
+    const auto& vote = pairVote.first;
+    db->Write(std::make_tuple(DB_ORPHAN_VOTE, vote.GetParentHash(), vote.GetHash()), pairVote);
+}
+
+void CGovernanceDb::EraseOrphanVotes(const std::vector<vote_time_pair_t>& vecVotePairs)
+{
+    CDBBatch batch(*db);
+    for (const auto& [vote, _] : vecVotePairs) {
+        batch.Erase(std::make_tuple(DB_ORPHAN_VOTE, vote.GetParentHash(), vote.GetHash()));
+    }
+    db->WriteBatch(batch);
+}
+
+size_t CGovernanceDb::ReadObjects(std::map<uint256, CGovernanceObject>& mapObjects) const
+{
+    std::unique_ptr<CDBIterator> it(db->NewIterator());
+    it->Seek(std::make_pair(DB_OBJECT, uint256()));
+    std::pair<std::string, uint256> curKey;
+    while (it->Valid() && it->GetKey(curKey) && curKey.first == DB_OBJECT) {
+        auto& govobj = mapObjects.emplace(std::piecewise_construct, std::forward_as_tuple(curKey.second), std::forward_as_tuple()).first->second;
+        auto value = Using<CGovernanceObject::DbFormatter>(govobj);
+        if (!it->GetValue(value) || govobj.GetHash() != curKey.second) {
+            LogPrintf("CGovernanceDb::%s -- failed to read object %s\n", __func__, curKey.second.ToString());
+            mapObjects.erase(curKey.second);
+        }
+        it->Next();
+    }
+
+    // votes are ordered by object, so this is a single pass over them as well
+    size_t nVotes{0};
+    it->Seek(std::make_pair(DB_MN_VOTES, uint256()));
+    std::tuple<std::string, uint256, COutPoint> curVotesKey;
+    std::pair<vote_rec_t, std::vector<CGovernanceVote>> mnVotes;
+    while (it->Valid() && it->GetKey(curVotesKey) && std::get<0>(curVotesKey) == DB_MN_VOTES) {
+        auto objIt = mapObjects.find(std::get<1>(curVotesKey));
+        if (objIt != mapObjects.end() && it->GetValue(mnVotes)) {
+            objIt->second.LoadMasternodeVotes(std::get<2>(curVotesKey), mnVotes.first, mnVotes.second);
+            nVotes += mnVotes.second.size();
+        }
+        it->Next();
+    }
+    return nVotes;
+}
+
+void CGovernanceDb::ReadErasedObjects(std::map<uint256, int64_t>& mapErased) const
+{
+    std::unique_ptr<CDBIterator> it(db->NewIterator());
+    it->Seek(std::make_pair(DB_ERASED_OBJECT, uint256()));
+    std::pair<std::string, uint256> curKey;
+    int64_t nTimeExpired;
+    while (it->Valid() && it->GetKey(curKey) && curKey.first == DB_ERASED_OBJECT) {
+        if (it->GetValue(nTimeExpired)) {
+            mapErased.emplace(curKey.second, nTimeExpired);
+        }
+        it->Next();
+    }
+}
+
+void CGovernanceDb::ReadOrphanVotes(std::vector<vote_time_pair_t>& vecVotePairs) const
+{
+    std::unique_ptr<CDBIterator> it(db->NewIterator());
+    it->Seek(std::make_tuple(DB_ORPHAN_VOTE, uint256(), uint256()));
+    std::tuple<std::string, uint256, uint256> curKey;
+    vote_time_pair_t pairVote;
+    while (it->Valid() && it->GetKey(curKey) && std::get<0>(curKey) == DB_ORPHAN_VOTE) {
+        if (it->GetValue(pairVote)) {
+            vecVotePairs.emplace_back(pairVote);
+        }
+        it->Next();
+    }
+}
+
+bool CGovernanceDb::ReadMNList(CDeterministicMNList& mnList) const
+{
+    return db->Read(DB_MN_LIST, mnList);
+}
+
+void CGovernanceDb::WriteState(const CGovernanceManager& governance)
+{
+    db->Write(DB_STATE, Using<CGovernanceManager::DbStateFormatter>(governance));
+}
+
+bool CGovernanceDb::ReadState(CGovernanceManager& governance) const
+{
+    auto value = Using<CGovernanceManager::DbStateFormatter>(governance);
+    return db->Read(DB_STATE, value);
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_GOVERNANCE_GOVERNANCEDB_H
+#define BITCOIN_GOVERNANCE_GOVERNANCEDB_H
+
+#include <dbwrapper.h>
+#include <governance/object.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class CDeterministicMNList;
+class CGovernanceManager;
+
+/**
+ * Persists governance objects and their votes. Every object and the votes of every masternode on an object are kept
+ * under their own keys and are written as soon as they change, so the votes of an object can be read on their own.
+ * Erased objects, orphan votes and the masternode list used to detect changed voting keys are written together with
+ * the changes they belong to, so a crash only loses the remaining caches of the manager.
+ */
+class CGovernanceDb
+{
+private:
+    static constexpr int CURRENT_VERSION{2};
+
+    const bool fMemory;
+    std::unique_ptr<CDBWrapper> db;
+
+    void Open(bool fWipe);
+    void WriteMasternodeVotes(CDBBatch& batch, const CGovernanceObject& govobj, const COutPoint& mnOutpoint) const;
+
+public:
+    CGovernanceDb(bool _fMemory, bool fWipe);
+
+    //! Writes the object without its votes
+    void WriteObject(const CGovernanceObject& govobj);
+    //! Writes the object together with all of its votes
+    void WriteObjectWithVotes(const CGovernanceObject& govobj);
+    //! Erases the object together with all of its votes and remembers it as erased until nTimeExpired
+    void EraseObject(const uint256& nHash, int64_t nTimeExpired);
+    //! Forgets about erased objects which expired
+    void ForgetErasedObjects(const std::vector<uint256>& vecHashes);
+    //! Writes the current vote record and votes of the masternode on the object, erases them if there are none left
+    void WriteMasternodeVotes(const CGovernanceObject& govobj, const COutPoint& mnOutpoint);
+    /**
+     * Writes the votes of all masternodes which lost votes because their keys changed, together with the masternode
+     * list which the next check for changed keys compares against
+     */
+    void WriteInvalidatedVotes(const std::vector<std::pair<const CGovernanceObject*, COutPoint>>& vecChanged, const CDeterministicMNList& mnList);
+    void WriteOrphanVote(const vote_time_pair_t& pairVote);
+    void EraseOrphanVotes(const std::vector<vote_time_pair_t>& vecVotePairs);
+
+    //! Reads all objects with their votes into mapObjects, returns the number of votes read
+    size_t ReadObjects(std::map<uint256, CGovernanceObject>& mapObjects) const;
+    void ReadErasedObjects(std::map<uint256, int64_t>& mapErased) const;
+    void ReadOrphanVotes(std::vector<vote_time_pair_t>& vecVotePairs) const;
+    bool ReadMNList(CDeterministicMNList& mnList) const;
+
+    //! The caches of the manager which are not written right away, see CGovernanceManager::DbStateFormatter
+    void WriteState(const CGovernanceManager& governance);
+    bool ReadState(CGovernanceManager& governance) const;
+};
+
+#endif // BITCOIN_GOVERNANCE_GOVERNANCEDB_H
@@ -41,6 +41,7 @@ CGovernanceObject::CGovernanceObject() :
     fExpired(false),
     fUnparsable(false),
     mapCurrentMNVotes(),
+    voteCounts(),
     fileVotes()
 {
     // PARSE JSON DATA STORAGE (VCHDATA)
@@ -68,6 +69,7 @@ CGovernanceObject::CGovernanceObject(const uint256& nHashParentIn, int nRevision
     fExpired(false),
     fUnparsable(false),
     mapCurrentMNVotes(),
+    voteCounts(),
     fileVotes()
 {
     // PARSE JSON DATA STORAGE (VCHDATA)
@@ -95,6 +97,7 @@ CGovernanceObject::CGovernanceObject(const CGovernanceObject& other) :
     fExpired(other.fExpired),
     fUnparsable(other.fUnparsable),
     mapCurrentMNVotes(other.mapCurrentMNVotes),
+    voteCounts(other.voteCounts),
     fileVotes(other.fileVotes)
 {
 }
@@ -140,8 +143,11 @@ bool CGovernanceObject::ProcessVote(const CGovernanceVote& vote, CGovernanceExce
         exception = CGovernanceException(ostr.str(), GOVERNANCE_EXCEPTION_PERMANENT_ERROR, 20);
         return false;
     }
-    auto it2 = voteRecordRef.mapInstances.emplace(vote_instance_m_t::value_type(int(eSignal), vote_instance_t())).first;
+    auto [it2, fInserted] = voteRecordRef.mapInstances.emplace(vote_instance_m_t::value_type(int(eSignal), vote_instance_t()));
     vote_instance_t& voteInstanceRef = it2->second;
+    if (fInserted) {
+        UpdateVoteCount(eSignal, voteInstanceRef.eOutcome, 1);
+    }
 
     // Reject obsolete votes
     if (vote.GetTimestamp() < voteInstanceRef.nCreationTime) {
@@ -209,7 +215,9 @@ bool CGovernanceObject::ProcessVote(const CGovernanceVote& vote, CGovernanceExce
         return false;
     }
 
+    UpdateVoteCount(eSignal, voteInstanceRef.eOutcome, -1);
     voteInstanceRef = vote_instance_t(vote.GetOutcome(), nVoteTimeUpdate, vote.GetTimestamp());
+    UpdateVoteCount(eSignal, voteInstanceRef.eOutcome, 1);
     fileVotes.AddVote(vote);
     fDirtyCache = true;
     // SEND NOTIFICATION TO SCRIPT/ZMQ
@@ -217,22 +225,45 @@ bool CGovernanceObject::ProcessVote(const CGovernanceVote& vote, CGovernanceExce
     return true;
 }
 
-void CGovernanceObject::ClearMasternodeVotes()
+void CGovernanceObject::LoadMasternodeVotes(const COutPoint& mnOutpoint, const vote_rec_t& voteRecord, const std::vector<CGovernanceVote>& votes)
+{
+    LOCK(cs);
+
+    auto it = mapCurrentMNVotes.find(mnOutpoint);
+    if (it != mapCurrentMNVotes.end()) {
+        UpdateVoteCounts(it->second, -1);
+        mapCurrentMNVotes.erase(it);
+    }
+    if (!voteRecord.mapInstances.empty()) {
+        mapCurrentMNVotes.emplace(mnOutpoint, voteRecord);
+        UpdateVoteCounts(voteRecord, 1);
+    }
+    for (const auto& vote : votes) {
+        fileVotes.AddVote(vote);
+    }
+    fDirtyCache = true;
+}
+
+std::vector<COutPoint> CGovernanceObject::ClearMasternodeVotes()
 {
     LOCK(cs);
 
     auto mnList = deterministicMNManager->GetListAtChainTip();
 
+    std::vector<COutPoint> removed;
     auto it = mapCurrentMNVotes.begin();
     while (it != mapCurrentMNVotes.end()) {
         if (!mnList.HasMNByCollateral(it->first)) {
             fileVotes.RemoveVotesFromMasternode(it->first);
+            removed.emplace_back(it->first);
+            UpdateVoteCounts(it->second, -1);
             mapCurrentMNVotes.erase(it++);
             fDirtyCache = true;
         } else {
             ++it;
         }
     }
+    return removed;
 }
 
 std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const COutPoint& mnOutpoint)
@@ -255,6 +286,7 @@ std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const COutPoint& mnOutpo
         CGovernanceVote tmpVote(mnOutpoint, nParentHash, (vote_signal_enum_t)jt->first, jt->second.eOutcome);
         tmpVote.SetTime(jt->second.nCreationTime);
         if (removedVotes.count(tmpVote.GetHash())) {
+            UpdateVoteCount(jt->first, jt->second.eOutcome, -1);
             jt = it->second.mapInstances.erase(jt);
         } else {
             ++jt;
@@ -622,15 +654,36 @@ int CGovernanceObject::CountMatchingVotes(vote_signal_enum_t eVoteSignalIn, vote
 {
     LOCK(cs);
 
-    int nCount = 0;
-    for (const auto& votepair : mapCurrentMNVotes) {
-        const vote_rec_t& recVote = votepair.second;
-        auto it2 = recVote.mapInstances.find(eVoteSignalIn);
-        if (it2 != recVote.mapInstances.end() && it2->second.eOutcome == eVoteOutcomeIn) {
-            ++nCount;
-        }
+    if (eVoteSignalIn < 0 || eVoteSignalIn > MAX_SUPPORTED_VOTE_SIGNAL || eVoteOutcomeIn < 0 || eVoteOutcomeIn > VOTE_OUTCOME_ABSTAIN) {
+        return 0;
+    }
+    return voteCounts[eVoteSignalIn][eVoteOutcomeIn];
+}
+
+void CGovernanceObject::UpdateVoteCount(int nSignal, vote_outcome_enum_t eOutcome, int nDelta)
+{
+    AssertLockHeld(cs);
+    // ProcessVote doesn't accept anything else, so this can only be skipped for broken data from disk
+    if (nSignal < 0 || nSignal > MAX_SUPPORTED_VOTE_SIGNAL || eOutcome < 0 || eOutcome > VOTE_OUTCOME_ABSTAIN) {
+        return;
+    }
+    voteCounts[nSignal][eOutcome] += nDelta;
+}
+
+void CGovernanceObject::UpdateVoteCounts(const vote_rec_t& voteRecord, int nDelta)
+{
+    for (const auto& [nSignal, voteInstance] : voteRecord.mapInstances) {
+        UpdateVoteCount(nSignal, voteInstance.eOutcome, nDelta);
+    }
+}
+
+void CGovernanceObject::RebuildVoteCounts()
+{
+    LOCK(cs);
+    voteCounts = {};
+    for (const auto& [_, voteRecord] : mapCurrentMNVotes) {
+        UpdateVoteCounts(voteRecord, 1);
     }
-    return nCount;
 }
 
 /**
@@ -13,6 +13,8 @@
 
 #include <univalue.h>
 
+#include <array>
+
 class CBLSSecretKey;
 class CBLSPublicKey;
 class CNode;
@@ -154,8 +156,15 @@ private:
 
     vote_m_t mapCurrentMNVotes;
 
+    /// Number of MN's per signal and outcome in mapCurrentMNVotes, kept up to date on every change of it
+    std::array<std::array<int, VOTE_OUTCOME_ABSTAIN + 1>, MAX_SUPPORTED_VOTE_SIGNAL + 1> voteCounts;
+
     CGovernanceObjectVoteFile fileVotes;
 
+    void UpdateVoteCount(int nSignal, vote_outcome_enum_t eOutcome, int nDelta);
+    void UpdateVoteCounts(const vote_rec_t& voteRecord, int nDelta);
+    void RebuildVoteCounts();
+
 public:
     CGovernanceObject();
 
@@ -305,12 +314,30 @@ public:
             // Only include these for the disk file format
             LogPrint(BCLog::GOBJECT, "CGovernanceObject::SerializationOp Reading/writing votes from/to disk\n");
             READWRITE(obj.nDeletionTime, obj.fExpired, obj.mapCurrentMNVotes, obj.fileVotes);
+            SER_READ(obj, obj.RebuildVoteCounts());
             LogPrint(BCLog::GOBJECT, "CGovernanceObject::SerializationOp hash = %s, vote count = %d\n", obj.GetHash().ToString(), obj.fileVotes.GetVoteCount());
         }
 
         // AFTER DESERIALIZATION OCCURS, CACHED VARIABLES MUST BE CALCULATED MANUALLY
     }
 
+    /** The disk format without the votes, the governance db stores these per masternode */
+    struct DbFormatter {
+        template <typename Stream>
+        void Ser(Stream& s, const CGovernanceObject& obj)
+        {
+            ::SerializeMany(s, obj.nHashParent, obj.nRevision, obj.nTime, obj.nCollateralHash, obj.vchData, obj.nObjectType,
+                            obj.masternodeOutpoint, obj.vchSig, obj.nDeletionTime, obj.fExpired);
+        }
+
+        template <typename Stream>
+        void Unser(Stream& s, CGovernanceObject& obj)
+        {
+            ::UnserializeMany(s, obj.nHashParent, obj.nRevision, obj.nTime, obj.nCollateralHash, obj.vchData, obj.nObjectType,
+                              obj.masternodeOutpoint, obj.vchSig, obj.nDeletionTime, obj.fExpired);
+        }
+    };
+
     UniValue ToJson() const;
 
     // FUNCTIONS FOR DEALING WITH DATA STRING
@@ -319,8 +346,11 @@ public:
 
     bool ProcessVote(const CGovernanceVote& vote, CGovernanceException& exception);
 
-    /// Called when MN's which have voted on this object have been removed
-    void ClearMasternodeVotes();
+    /// Restores the votes of a MN as they were stored, without validating them again
+    void LoadMasternodeVotes(const COutPoint& mnOutpoint, const vote_rec_t& voteRecord, const std::vector<CGovernanceVote>& votes);
+
+    /// Called when MN's which have voted on this object have been removed, returns these MN's
+    std::vector<COutPoint> ClearMasternodeVotes();
 
     // Revalidate all votes from this MN and delete them if validation fails.
     // This is the case for DIP3 MNs that changed voting or operator keys and
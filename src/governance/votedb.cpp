@@ -7,14 +7,16 @@
 CGovernanceObjectVoteFile::CGovernanceObjectVoteFile() :
     nMemoryVotes(0),
     listVotes(),
-    mapVoteIndex()
+    mapVoteIndex(),
+    mapMasternodeVotes()
 {
 }
 
 CGovernanceObjectVoteFile::CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other) :
     nMemoryVotes(other.nMemoryVotes),
     listVotes(other.listVotes),
-    mapVoteIndex()
+    mapVoteIndex(),
+    mapMasternodeVotes()
 {
     RebuildIndex();
 }
@@ -27,6 +29,7 @@ void CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote)
         return;
     listVotes.push_front(vote);
     mapVoteIndex.emplace(nHash, listVotes.begin());
+    mapMasternodeVotes.emplace(vote.GetMasternodeOutpoint(), listVotes.begin());
     ++nMemoryVotes;
     RemoveOldVotes(vote);
 }
@@ -54,17 +57,21 @@ std::vector<CGovernanceVote> CGovernanceObjectVoteFile::GetVotes() const
     return vecResult;
 }
 
+std::vector<CGovernanceVote> CGovernanceObjectVoteFile::GetVotesFromMasternode(const COutPoint& outpointMasternode) const
+{
+    std::vector<CGovernanceVote> vecResult;
+    auto range = mapMasternodeVotes.equal_range(outpointMasternode);
+    for (auto it = range.first; it != range.second; ++it) {
+        vecResult.emplace_back(*it->second);
+    }
+    return vecResult;
+}
+
 void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
 {
-    auto it = listVotes.begin();
-    while (it != listVotes.end()) {
-        if (it->GetMasternodeOutpoint() == outpointMasternode) {
-            --nMemoryVotes;
-            mapVoteIndex.erase(it->GetHash());
-            listVotes.erase(it++);
-        } else {
-            ++it;
-        }
+    auto it = mapMasternodeVotes.lower_bound(outpointMasternode);
+    while (it != mapMasternodeVotes.end() && it->first == outpointMasternode) {
+        it = RemoveVote(it);
     }
 }
 
@@ -72,19 +79,16 @@ std::set<uint256> CGovernanceObjectVoteFile::RemoveInvalidVotes(const COutPoint&
 {
     std::set<uint256> removedVotes;
 
-    auto it = listVotes.begin();
-    while (it != listVotes.end()) {
-        if (it->GetMasternodeOutpoint() == outpointMasternode) {
-            bool useVotingKey = fProposal && (it->GetSignal() == VOTE_SIGNAL_FUNDING);
-            if (!it->IsValid(useVotingKey)) {
-                removedVotes.emplace(it->GetHash());
-                --nMemoryVotes;
-                mapVoteIndex.erase(it->GetHash());
-                listVotes.erase(it++);
-                continue;
-            }
+    auto it = mapMasternodeVotes.lower_bound(outpointMasternode);
+    while (it != mapMasternodeVotes.end() && it->first == outpointMasternode) {
+        const CGovernanceVote& vote = *it->second;
+        bool useVotingKey = fProposal && (vote.GetSignal() == VOTE_SIGNAL_FUNDING);
+        if (!vote.IsValid(useVotingKey)) {
+            removedVotes.emplace(vote.GetHash());
+            it = RemoveVote(it);
+        } else {
+            ++it;
         }
-        ++it;
     }
 
     return removedVotes;
@@ -92,25 +96,32 @@ std::set<uint256> CGovernanceObjectVoteFile::RemoveInvalidVotes(const COutPoint&
 
 void CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
 {
-    auto it = listVotes.begin();
-    while (it != listVotes.end()) {
-        if (it->GetMasternodeOutpoint() == vote.GetMasternodeOutpoint() // same masternode
-            && it->GetParentHash() == vote.GetParentHash() // same governance object (e.g. same proposal)
-            && it->GetSignal() == vote.GetSignal() // same signal (e.g. "funding", "delete", etc.)
-            && it->GetTimestamp() < vote.GetTimestamp()) // older than new vote
+    auto it = mapMasternodeVotes.lower_bound(vote.GetMasternodeOutpoint());
+    while (it != mapMasternodeVotes.end() && it->first == vote.GetMasternodeOutpoint()) { // same masternode
+        const CGovernanceVote& oldVote = *it->second;
+        if (oldVote.GetParentHash() == vote.GetParentHash() // same governance object (e.g. same proposal)
+            && oldVote.GetSignal() == vote.GetSignal() // same signal (e.g. "funding", "delete", etc.)
+            && oldVote.GetTimestamp() < vote.GetTimestamp()) // older than new vote
         {
-            --nMemoryVotes;
-            mapVoteIndex.erase(it->GetHash());
-            listVotes.erase(it++);
+            it = RemoveVote(it);
         } else {
             ++it;
         }
     }
 }
 
+CGovernanceObjectVoteFile::vote_mn_mm_t::iterator CGovernanceObjectVoteFile::RemoveVote(vote_mn_mm_t::iterator it)
+{
+    --nMemoryVotes;
+    mapVoteIndex.erase(it->second->GetHash());
+    listVotes.erase(it->second);
+    return mapMasternodeVotes.erase(it);
+}
+
 void CGovernanceObjectVoteFile::RebuildIndex()
 {
     mapVoteIndex.clear();
+    mapMasternodeVotes.clear();
     nMemoryVotes = 0;
     auto it = listVotes.begin();
     while (it != listVotes.end()) {
@@ -118,6 +129,7 @@ void CGovernanceObjectVoteFile::RebuildIndex()
         uint256 nHash = vote.GetHash();
         if (mapVoteIndex.find(nHash) == mapVoteIndex.end()) {
             mapVoteIndex[nHash] = it;
+            mapMasternodeVotes.emplace(vote.GetMasternodeOutpoint(), it);
             ++nMemoryVotes;
             ++it;
         } else {
@@ -28,6 +28,8 @@ public: // Types
 
     using vote_m_t = std::map<uint256, vote_l_t::iterator>;
 
+    using vote_mn_mm_t = std::multimap<COutPoint, vote_l_t::iterator>;
+
 private:
     int nMemoryVotes;
 
@@ -35,6 +37,9 @@ private:
 
     vote_m_t mapVoteIndex;
 
+    // a masternode has at most one vote per signal, so looking up its votes doesn't need to scan the whole file
+    vote_mn_mm_t mapMasternodeVotes;
+
 public:
     CGovernanceObjectVoteFile();
 
@@ -62,6 +67,8 @@ public:
 
     std::vector<CGovernanceVote> GetVotes() const;
 
+    std::vector<CGovernanceVote> GetVotesFromMasternode(const COutPoint& outpointMasternode) const;
+
     void RemoveVotesFromMasternode(const COutPoint& outpointMasternode);
     std::set<uint256> RemoveInvalidVotes(const COutPoint& outpointMasternode, bool fProposal);
 
@@ -75,6 +82,9 @@ private:
     // Drop older votes for the same gobject from the same masternode
     void RemoveOldVotes(const CGovernanceVote& vote);
 
+    // Removes the vote from the file and all indexes, returns the next vote of the same masternode
+    vote_mn_mm_t::iterator RemoveVote(vote_mn_mm_t::iterator it);
+
     void RebuildIndex();
 };
 
@@ -0,0 +1,453 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addressindex.h>
+
+#include <chainparams.h>
+#include <shutdown.h>
+#include <undo.h>
+#include <util/system.h>
+#include <validation.h>
+
+#include <map>
+
+constexpr char DB_ADDRESSINDEX = 'a';
+constexpr char DB_ADDRESSUNSPENTINDEX = 'u';
+constexpr char DB_ADDRESSBALANCE = 'b';
+
+std::unique_ptr<AddressIndex> g_addressindex;
+
+namespace {
+
+/** All address index changes caused by a block */
+struct BlockAddressEntries
+{
+    /// Height of the block
+    int height{0};
+    /// Receiving and spending activity
+    std::vector<std::pair<CAddressIndexKey, CAmount>> deltas;
+    /// Outputs created by the block
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>> created;
+    /// Outputs spent by the block, with the values they had while unspent
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>> spent;
+};
+
+bool GetBlockAddressEntries(const CBlock& block, const CBlockUndo& block_undo, const CBlockIndex* pindex,
+                            BlockAddressEntries& entries)
+{
+    if (block_undo.vtxundo.size() + 1 != block.vtx.size()) {
+        return error("%s: block and undo data inconsistent", __func__);
+    }
+    entries.height = pindex->nHeight;
+
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        const uint256 txhash = tx.GetHash();
+        int addressType;
+        uint160 addressHash;
+
+        if (i > 0) {
+            const CTxUndo& txundo = block_undo.vtxundo[i - 1];
+            if (txundo.vprevout.size() != tx.vin.size()) {
+                return error("%s: transaction and undo data inconsistent", __func__);
+            }
+            for (size_t j = 0; j < tx.vin.size(); j++) {
+                const COutPoint& prevout = tx.vin[j].prevout;
+                const Coin& coin = txundo.vprevout[j];
+                if (!GetIndexAddress(coin.out.scriptPubKey, addressType, addressHash)) {
+                    continue;
+                }
+                entries.deltas.emplace_back(CAddressIndexKey(addressType, addressHash, pindex->nHeight, i, txhash, j, true), coin.out.nValue * -1);
+                entries.spent.emplace_back(CAddressUnspentKey(addressType, addressHash, prevout.hash, prevout.n), CAddressUnspentValue(coin.out.nValue, coin.out.scriptPubKey, coin.nHeight));
+            }
+        }
+
+        for (size_t k = 0; k < tx.vout.size(); k++) {
+            const CTxOut& out = tx.vout[k];
+            if (!GetIndexAddress(out.scriptPubKey, addressType, addressHash)) {
+                continue;
+            }
+            entries.deltas.emplace_back(CAddressIndexKey(addressType, addressHash, pindex->nHeight, i, txhash, k, false), out.nValue);
+            entries.created.emplace_back(CAddressUnspentKey(addressType, addressHash, txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight));
+        }
+    }
+    return true;
+}
+
+/** Sums of the deltas of a single address within a block */
+struct BlockAddressTotals
+{
+    CAmount balance{0};
+    CAmount received{0};
+    uint64_t tx_count{0};
+    uint256 last_txhash;
+};
+
+std::map<std::pair<unsigned int, uint160>, BlockAddressTotals> GetBlockAddressTotals(const BlockAddressEntries& entries)
+{
+    std::map<std::pair<unsigned int, uint160>, BlockAddressTotals> ret;
+    for (const auto& [key, value] : entries.deltas) {
+        auto& totals = ret[{key.type, key.hashBytes}];
+        totals.balance += value;
+        if (value > 0) {
+            totals.received += value;
+        }
+        // Deltas are ordered by transaction, so all deltas of a transaction are adjacent
+        if (totals.tx_count == 0 || totals.last_txhash != key.txhash) {
+            totals.tx_count++;
+            totals.last_txhash = key.txhash;
+        }
+    }
+    return ret;
+}
+
+bool ReadBlockAddressEntries(const CBlockIndex* pindex, const CBlock* pblock, BlockAddressEntries& entries)
+{
+    CBlock block;
+    if (!pblock) {
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            return error("%s: failed to read block %s from disk", __func__, pindex->GetBlockHash().ToString());
+        }
+        pblock = &block;
+    }
+    CBlockUndo block_undo;
+    if (!UndoReadFromDisk(block_undo, pindex)) {
+        return error("%s: failed to read undo data of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    return GetBlockAddressEntries(*pblock, block_undo, pindex, entries);
+}
+
+} // namespace
+
+/** Access to the addressindex database (indexes/addressindex/) */
+class AddressIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the entries of a newly connected block, together with the new best block.
+    bool WriteBlock(const BlockAddressEntries& entries, const CBlockLocator& locator);
+
+    /// Revert the entries of a disconnected block, together with the new best block.
+    bool EraseBlock(const BlockAddressEntries& entries, const CBlockLocator& locator);
+
+    bool ReadAddressIndex(const CAddressIndexKey& from, int end, size_t max_count,
+                          std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
+                          std::optional<CAddressIndexKey>& next);
+
+    bool ReadAddressBalance(const CAddressIndexIteratorKey& key, CAddressBalanceValue& balance);
+
+    bool ReadAddressUnspentIndex(const uint160& addressHash, int type,
+                                 std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs);
+
+    /// Migrate address index data from the block tree DB, where older versions kept it.
+    bool MigrateData(CBlockTreeDB& block_tree_db, const CBlockLocator& best_locator);
+
+private:
+    /// Find the height of the last delta of an address below the given height.
+    bool FindLastHeightBefore(const CAddressIndexIteratorKey& key, int height, int& last_height);
+
+    /// Compute the balances of all addresses from their deltas.
+    bool BuildBalances();
+};
+
+AddressIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(GetDataDir() / "indexes" / "addressindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool AddressIndex::DB::WriteBlock(const BlockAddressEntries& entries, const CBlockLocator& locator)
+{
+    CDBBatch batch(*this);
+    WriteBestBlock(batch, locator);
+    for (const auto& [key, value] : entries.deltas) {
+        batch.Write(std::make_pair(DB_ADDRESSINDEX, key), value);
+    }
+    // Outputs created and spent in the same block must end up erased, so create first
+    for (const auto& [key, value] : entries.created) {
+        batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, key), value);
+    }
+    for (const auto& [key, value] : entries.spent) {
+        batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, key));
+    }
+    for (const auto& [address, totals] : GetBlockAddressTotals(entries)) {
+        const CAddressIndexIteratorKey key(address.first, address.second);
+        CAddressBalanceValue balance;
+        ReadAddressBalance(key, balance);
+        if (balance.IsNull()) {
+            balance.firstHeight = entries.height;
+        }
+        balance.balance += totals.balance;
+        balance.received += totals.received;
+        balance.txCount += totals.tx_count;
+        balance.lastHeight = entries.height;
+        batch.Write(std::make_pair(DB_ADDRESSBALANCE, key), balance);
+    }
+    return WriteBatch(batch);
+}
+
+bool AddressIndex::DB::EraseBlock(const BlockAddressEntries& entries, const CBlockLocator& locator)
+{
+    CDBBatch batch(*this);
+    WriteBestBlock(batch, locator);
+    for (const auto& [key, value] : entries.deltas) {
+        batch.Erase(std::make_pair(DB_ADDRESSINDEX, key));
+    }
+    // Outputs created and spent in the same block must end up erased, so restore first
+    for (const auto& [key, value] : entries.spent) {
+        batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, key), value);
+    }
+    for (const auto& [key, value] : entries.created) {
+        batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, key));
+    }
+    for (const auto& [address, totals] : GetBlockAddressTotals(entries)) {
+        const CAddressIndexIteratorKey key(address.first, address.second);
+        CAddressBalanceValue balance;
+        if (!ReadAddressBalance(key, balance) || balance.txCount < totals.tx_count) {
+            return error("%s: address balance inconsistent with block at height %d", __func__, entries.height);
+        }
+        balance.balance -= totals.balance;
+        balance.received -= totals.received;
+        balance.txCount -= totals.tx_count;
+        if (balance.IsNull()) {
+            batch.Erase(std::make_pair(DB_ADDRESSBALANCE, key));
+            continue;
+        }
+        // The deltas of this block are still in the database until the batch is written
+        if (!FindLastHeightBefore(key, entries.height, balance.lastHeight)) {
+            return error("%s: address balance inconsistent with block at height %d", __func__, entries.height);
+        }
+        batch.Write(std::make_pair(DB_ADDRESSBALANCE, key), balance);
+    }
+    return WriteBatch(batch);
+}
+
+bool AddressIndex::DB::FindLastHeightBefore(const CAddressIndexIteratorKey& key, int height, int& last_height)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(key.type, key.hashBytes, height)));
+    if (!pcursor->Valid()) {
+        return false;
+    }
+    pcursor->Prev();
+
+    std::pair<char, CAddressIndexKey> prev_key;
+    if (!pcursor->Valid() || !pcursor->GetKey(prev_key) || prev_key.first != DB_ADDRESSINDEX ||
+        prev_key.second.type != key.type || prev_key.second.hashBytes != key.hashBytes) {
+        return false;
+    }
+    last_height = prev_key.second.blockHeight;
+    return true;
+}
+
+bool AddressIndex::DB::ReadAddressIndex(const CAddressIndexKey& from, int end, size_t max_count,
+                                        std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
+                                        std::optional<CAddressIndexKey>& next)
+{
+    next.reset();
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, from));
+
+    size_t count = 0;
+    while (pcursor->Valid()) {
+        std::pair<char, CAddressIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX || key.second.type != from.type || key.second.hashBytes != from.hashBytes) {
+            break;
+        }
+        if (end > 0 && key.second.blockHeight > end) {
+            break;
+        }
+        if (max_count > 0 && count == max_count) {
+            next = key.second;
+            break;
+        }
+        CAmount nValue;
+        if (!pcursor->GetValue(nValue)) {
+            return error("failed to get address index value");
+        }
+        addressIndex.emplace_back(key.second, nValue);
+        count++;
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+bool AddressIndex::DB::ReadAddressBalance(const CAddressIndexIteratorKey& key, CAddressBalanceValue& balance)
+{
+    return Read(std::make_pair(DB_ADDRESSBALANCE, key), balance);
+}
+
+bool AddressIndex::DB::ReadAddressUnspentIndex(const uint160& addressHash, int type,
+                                               std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorKey(type, addressHash)));
+
+    while (pcursor->Valid()) {
+        std::pair<char, CAddressUnspentKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSUNSPENTINDEX || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash) {
+            break;
+        }
+        CAddressUnspentValue nValue;
+        if (!pcursor->GetValue(nValue)) {
+            return error("failed to get address unspent value");
+        }
+        unspentOutputs.emplace_back(key.second, nValue);
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+bool AddressIndex::DB::MigrateData(CBlockTreeDB& block_tree_db, const CBlockLocator& best_locator)
+{
+    return MigrateLegacyData(block_tree_db, "addressindex", best_locator, [&]() {
+        return MoveEntriesFrom<CAddressIndexKey, CAmount>(block_tree_db, DB_ADDRESSINDEX) &&
+               MoveEntriesFrom<CAddressUnspentKey, CAddressUnspentValue>(block_tree_db, DB_ADDRESSUNSPENTINDEX) &&
+               BuildBalances();
+    });
+}
+
+bool AddressIndex::DB::BuildBalances()
+{
+    LogPrintf("Computing address balances...\n");
+
+    const size_t batch_size = 1 << 24; // 16 MiB
+    CDBBatch batch(*this);
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(DB_ADDRESSINDEX);
+
+    std::optional<CAddressIndexIteratorKey> address;
+    CAddressBalanceValue balance;
+    uint256 last_txhash;
+    for (; pcursor->Valid(); pcursor->Next()) {
+        if (ShutdownRequested()) {
+            return false;
+        }
+
+        std::pair<char, CAddressIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX) {
+            break;
+        }
+        CAmount value;
+        if (!pcursor->GetValue(value)) {
+            return error("%s: failed to get address index value", __func__);
+        }
+
+        // Deltas are ordered by address first, so each balance is complete once the address changes
+        if (!address || address->type != key.second.type || address->hashBytes != key.second.hashBytes) {
+            if (address) {
+                batch.Write(std::make_pair(DB_ADDRESSBALANCE, *address), balance);
+            }
+            address = CAddressIndexIteratorKey(key.second.type, key.second.hashBytes);
+            balance.SetNull();
+            balance.firstHeight = key.second.blockHeight;
+        }
+
+        balance.balance += value;
+        if (value > 0) {
+            balance.received += value;
+        }
+        if (balance.txCount == 0 || last_txhash != key.second.txhash) {
+            balance.txCount++;
+            last_txhash = key.second.txhash;
+        }
+        balance.lastHeight = key.second.blockHeight;
+
+        if (batch.SizeEstimate() > batch_size) {
+            if (!WriteBatch(batch)) {
+                return false;
+            }
+            batch.Clear();
+        }
+    }
+    if (address) {
+        batch.Write(std::make_pair(DB_ADDRESSBALANCE, *address), balance);
+    }
+    return WriteBatch(batch, true);
+}
+
+AddressIndex::AddressIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(std::make_unique<AddressIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+AddressIndex::~AddressIndex() {}
+
+bool AddressIndex::Init()
+{
+    LOCK(cs_main);
+
+    if (!m_db->MigrateData(*pblocktree, ::ChainActive().GetLocator())) {
+        return false;
+    }
+
+    return BaseIndex::Init();
+}
+
+bool AddressIndex::CommitInternal(CDBBatch& batch)
+{
+    // The best block is written atomically with each block instead, so that the balances can
+    // never have a block applied twice or reverted twice after a crash.
+    return true;
+}
+
+bool AddressIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    BlockAddressEntries entries;
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (pindex->nHeight > 0 && !ReadBlockAddressEntries(pindex, &block, entries)) {
+        return false;
+    }
+    return m_db->WriteBlock(entries, WITH_LOCK(cs_main, return ::ChainActive().GetLocator(pindex)));
+}
+
+bool AddressIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    for (const CBlockIndex* pindex = current_tip; pindex != new_tip; pindex = pindex->pprev) {
+        BlockAddressEntries entries;
+        if (!ReadBlockAddressEntries(pindex, nullptr, entries) ||
+            !m_db->EraseBlock(entries, WITH_LOCK(cs_main, return ::ChainActive().GetLocator(pindex->pprev)))) {
+            return error("%s: failed to revert block %s", __func__, pindex->GetBlockHash().ToString());
+        }
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+BaseIndex::DB& AddressIndex::GetDB() const { return *m_db; }
+
+bool AddressIndex::ReadAddressIndex(const uint160& addressHash, int type,
+                                    std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
+                                    int start, int end) const
+{
+    const CAddressIndexKey from(type, addressHash, start > 0 && end > 0 ? start : 0, 0, uint256(), 0, false);
+    std::optional<CAddressIndexKey> next;
+    return m_db->ReadAddressIndex(from, end, 0, addressIndex, next);
+}
+
+bool AddressIndex::ReadAddressIndex(const CAddressIndexKey& from, int end, size_t max_count,
+                                    std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
+                                    std::optional<CAddressIndexKey>& next) const
+{
+    return m_db->ReadAddressIndex(from, end, max_count, addressIndex, next);
+}
+
+bool AddressIndex::ReadAddressBalance(const uint160& addressHash, int type, CAddressBalanceValue& balance) const
+{
+    balance.SetNull();
+    return m_db->ReadAddressBalance(CAddressIndexIteratorKey(type, addressHash), balance);
+}
+
+bool AddressIndex::ReadAddressUnspentIndex(const uint160& addressHash, int type,
+                                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs) const
+{
+    return m_db->ReadAddressUnspentIndex(addressHash, type, unspentOutputs);
+}
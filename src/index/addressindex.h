@@ -0,0 +1,73 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_ADDRESSINDEX_H
+#define BITCOIN_INDEX_ADDRESSINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <spentindex.h>
+
+#include <optional>
+
+/**
+ * AddressIndex records all receiving and spending activity (deltas) of P2PKH, P2PK and P2SH
+ * addresses as well as their unspent outputs and the running totals (balance) of their deltas. The index is written to its own LevelDB database
+ * and kept in sync with the chain in the background.
+ */
+class AddressIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+protected:
+    /// Override base class init to migrate from the block tree database.
+    bool Init() override;
+
+    bool CommitInternal(CDBBatch& batch) override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "addressindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit AddressIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~AddressIndex() override;
+
+    /// Look up the deltas of an address, optionally limited to the blocks in [start, end].
+    bool ReadAddressIndex(const uint160& addressHash, int type,
+                          std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
+                          int start = 0, int end = 0) const;
+
+    /**
+     * Look up at most max_count (0 for no limit) deltas of the address of `from`, starting at the
+     * delta `from` and ending at height `end` (0 for no limit). If there are more deltas, `next`
+     * is set to the first one that was not returned, so the lookup can be continued from there.
+     */
+    bool ReadAddressIndex(const CAddressIndexKey& from, int end, size_t max_count,
+                          std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
+                          std::optional<CAddressIndexKey>& next) const;
+
+    /// Look up the running totals of all deltas of an address. Returns false if it has none.
+    bool ReadAddressBalance(const uint160& addressHash, int type, CAddressBalanceValue& balance) const;
+
+    /// Look up the unspent outputs of an address.
+    bool ReadAddressUnspentIndex(const uint160& addressHash, int type,
+                                 std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs) const;
+};
+
+/// The global address index. May be null.
+extern std::unique_ptr<AddressIndex> g_addressindex;
+
+#endif // BITCOIN_INDEX_ADDRESSINDEX_H
@@ -12,6 +12,8 @@
 #include <warnings.h>
 
 constexpr char DB_BEST_BLOCK = 'B';
+// Marker in the block tree DB for an unfinished migration of a legacy index, see MigrateLegacyData
+constexpr char DB_LEGACY_INDEX_BLOCK = 'M';
 
 constexpr int64_t SYNC_LOG_INTERVAL = 30; // seconds
 constexpr int64_t SYNC_LOCATOR_WRITE_INTERVAL = 30; // seconds
@@ -44,6 +46,46 @@ void BaseIndex::DB::WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator
     batch.Write(DB_BEST_BLOCK, locator);
 }
 
+bool BaseIndex::DB::MigrateLegacyData(CBlockTreeDB& block_tree_db, const std::string& name,
+                                      const CBlockLocator& best_locator, const std::function<bool()>& move_entries)
+{
+    const auto marker_key = std::make_pair(DB_LEGACY_INDEX_BLOCK, name);
+
+    // Unset the flag first, so that a downgraded node sees the index as disabled instead of a
+    // partially migrated one.
+    bool f_legacy_flag = false;
+    block_tree_db.ReadFlag(name, f_legacy_flag);
+    if (f_legacy_flag) {
+        if (!block_tree_db.Write(marker_key, best_locator)) {
+            return error("%s: cannot write block indicator", __func__);
+        }
+        if (!block_tree_db.WriteFlag(name, false)) {
+            return error("%s: cannot write block index db flag", __func__);
+        }
+    }
+
+    CBlockLocator locator;
+    if (!block_tree_db.Read(marker_key, locator)) {
+        return true;
+    }
+
+    LogPrintf("Upgrading %s database...\n", name);
+    if (!move_entries()) {
+        LogPrintf("Upgrading %s database... [CANCELLED]\n", name);
+        return false;
+    }
+
+    // All entries were moved, the new database is now in sync with the legacy one.
+    CDBBatch batch_newdb(*this);
+    WriteBestBlock(batch_newdb, locator);
+    if (!WriteBatch(batch_newdb, /*fSync=*/ true) || !block_tree_db.Erase(marker_key)) {
+        return error("%s: cannot finish migration of %s", __func__, name);
+    }
+
+    LogPrintf("Upgrading %s database... [DONE]\n", name);
+    return true;
+}
+
 BaseIndex::~BaseIndex()
 {
     Interrupt();
@@ -126,13 +168,6 @@ void BaseIndex::ThreadSync()
                 last_log_time = current_time;
             }
 
-            if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
-                m_best_block_index = pindex;
-                last_locator_write_time = current_time;
-                // No need to handle errors in Commit. See rationale above.
-                Commit();
-            }
-
             CBlock block;
             if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
                 FatalError("%s: Failed to read block %s from disk",
@@ -144,6 +179,15 @@ void BaseIndex::ThreadSync()
                            __func__, pindex->GetBlockHash().ToString());
                 return;
             }
+
+            // Only write the locator once the block was written, otherwise the block would be
+            // skipped after a crash right after the commit.
+            if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
+                m_best_block_index = pindex;
+                last_locator_write_time = current_time;
+                // No need to handle errors in Commit. See rationale above.
+                Commit();
+            }
         }
     }
 
@@ -229,6 +273,26 @@ void BaseIndex::BlockConnected(const std::shared_ptr<const CBlock>& block, const
     }
 }
 
+void BaseIndex::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    if (!m_synced) {
+        return;
+    }
+
+    // Only follow the disconnection of the best block. Blocks of a stale branch that are still in
+    // the ValidationInterface queue after the sync thread caught up are handled by the rewind in
+    // BlockConnected instead.
+    if (m_best_block_index.load() != pindex) {
+        return;
+    }
+
+    if (!Rewind(pindex, pindex->pprev)) {
+        FatalError("%s: Failed to rewind index %s to a previous chain tip",
+                   __func__, GetName());
+        return;
+    }
+}
+
 void BaseIndex::ChainStateFlushed(const CBlockLocator& locator)
 {
     if (!m_synced) {
@@ -281,8 +345,8 @@ bool BaseIndex::BlockUntilSyncedToCurrentChain()
         // ::ChainActive().Tip().
         LOCK(cs_main);
         const CBlockIndex* chain_tip = ::ChainActive().Tip();
-        const CBlockIndex* best_block_index = m_best_block_index.load();
-        if (best_block_index->GetAncestor(chain_tip->nHeight) == chain_tip) {
+        // An index ahead of the tip still has to process the disconnection of its best block.
+        if (m_best_block_index.load() == chain_tip) {
             return true;
         }
     }
@@ -8,10 +8,14 @@
 #include <dbwrapper.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <shutdown.h>
 #include <threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <functional>
+
 class CBlockIndex;
+class CBlockTreeDB;
 
 /**
  * Base class for indices of blockchain data. This implements
@@ -39,6 +43,63 @@ protected:
 
         /// Write block locator of the chain that the txindex is in sync with.
         void WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator);
+
+        /// Migrate an index which older versions kept in the block tree database, always in sync
+        /// with the chain tip and with its presence signalled by the boolean flag `name`. Works like
+        /// the txindex migration (see TxIndex::DB::MigrateData): the flag is replaced by a marker
+        /// holding the chain tip, move_entries is called to move all entries (see MoveEntriesFrom)
+        /// and finally the marker becomes the best block of this database. An interrupted migration
+        /// picks up where it left off on the next start.
+        bool MigrateLegacyData(CBlockTreeDB& block_tree_db, const std::string& name,
+                               const CBlockLocator& best_locator, const std::function<bool()>& move_entries);
+
+        /// Move all entries with the given key prefix from olddb into this database, in batches.
+        /// Returns false if interrupted or on errors.
+        template <typename K, typename V>
+        bool MoveEntriesFrom(CDBWrapper& olddb, unsigned char prefix)
+        {
+            const size_t batch_size = 1 << 24; // 16 MiB
+
+            CDBBatch batch_newdb(*this);
+            CDBBatch batch_olddb(olddb);
+
+            std::pair<unsigned char, K> key;
+            std::pair<unsigned char, K> prev_key{prefix, K()};
+
+            auto write_batches = [&]() {
+                // Sync new DB changes to disk before deleting from old DB.
+                WriteBatch(batch_newdb, /*fSync=*/ true);
+                olddb.WriteBatch(batch_olddb);
+                olddb.CompactRange(prev_key, key);
+                batch_newdb.Clear();
+                batch_olddb.Clear();
+            };
+
+            std::unique_ptr<CDBIterator> cursor(olddb.NewIterator());
+            for (cursor->Seek(prev_key); cursor->Valid(); cursor->Next()) {
+                if (ShutdownRequested()) {
+                    return false;
+                }
+                if (!cursor->GetKey(key) || key.first != prefix) {
+                    break;
+                }
+                V value;
+                if (!cursor->GetValue(value)) {
+                    return error("%s: cannot parse record with prefix '%c'", __func__, prefix);
+                }
+                batch_newdb.Write(key, value);
+                batch_olddb.Erase(key);
+
+                if (batch_newdb.SizeEstimate() > batch_size || batch_olddb.SizeEstimate() > batch_size) {
+                    // It's OK to delete the key pointed at by the cursor, LevelDB iterators provide
+                    // a consistent view of the underlying data.
+                    write_batches();
+                    prev_key = key;
+                }
+            }
+            write_batches();
+            return true;
+        }
     };
 
 private:
@@ -74,6 +135,8 @@ protected:
     void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
                         const std::vector<CTransactionRef>& txn_conflicted) override;
 
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override;
+
     void ChainStateFlushed(const CBlockLocator& locator) override;
 
     /// Initialize internal state from the database and block index.
@@ -0,0 +1,111 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/timestampindex.h>
+
+#include <spentindex.h>
+#include <util/system.h>
+#include <validation.h>
+
+constexpr char DB_TIMESTAMPINDEX = 's';
+
+std::unique_ptr<TimestampIndex> g_timestampindex;
+
+/** Access to the timestampindex database (indexes/timestampindex/) */
+class TimestampIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    bool WriteTimestampIndex(const CTimestampIndexKey& timestampIndex);
+    bool EraseTimestampIndex(const CTimestampIndexKey& timestampIndex);
+    bool ReadTimestampIndex(unsigned int high, unsigned int low, std::vector<uint256>& hashes);
+
+    /// Migrate timestamp index data from the block tree DB, where older versions kept it.
+    bool MigrateData(CBlockTreeDB& block_tree_db, const CBlockLocator& best_locator);
+};
+
+TimestampIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(GetDataDir() / "indexes" / "timestampindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool TimestampIndex::DB::WriteTimestampIndex(const CTimestampIndexKey& timestampIndex)
+{
+    return Write(std::make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
+}
+
+bool TimestampIndex::DB::EraseTimestampIndex(const CTimestampIndexKey& timestampIndex)
+{
+    return Erase(std::make_pair(DB_TIMESTAMPINDEX, timestampIndex));
+}
+
+bool TimestampIndex::DB::ReadTimestampIndex(unsigned int high, unsigned int low, std::vector<uint256>& hashes)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexIteratorKey(low)));
+
+    while (pcursor->Valid()) {
+        std::pair<char, CTimestampIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_TIMESTAMPINDEX || key.second.timestamp > high) {
+            break;
+        }
+        hashes.push_back(key.second.blockHash);
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+bool TimestampIndex::DB::MigrateData(CBlockTreeDB& block_tree_db, const CBlockLocator& best_locator)
+{
+    return MigrateLegacyData(block_tree_db, "timestampindex", best_locator, [&]() {
+        return MoveEntriesFrom<CTimestampIndexKey, int>(block_tree_db, DB_TIMESTAMPINDEX);
+    });
+}
+
+TimestampIndex::TimestampIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(std::make_unique<TimestampIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+TimestampIndex::~TimestampIndex() {}
+
+bool TimestampIndex::Init()
+{
+    LOCK(cs_main);
+
+    if (!m_db->MigrateData(*pblocktree, ::ChainActive().GetLocator())) {
+        return false;
+    }
+
+    return BaseIndex::Init();
+}
+
+bool TimestampIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    // The genesis block was never indexed
+    if (pindex->nHeight == 0) return true;
+
+    return m_db->WriteTimestampIndex(CTimestampIndexKey(pindex->nTime, pindex->GetBlockHash()));
+}
+
+bool TimestampIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    for (const CBlockIndex* pindex = current_tip; pindex != new_tip; pindex = pindex->pprev) {
+        if (!m_db->EraseTimestampIndex(CTimestampIndexKey(pindex->nTime, pindex->GetBlockHash()))) {
+            return error("%s: failed to revert block %s", __func__, pindex->GetBlockHash().ToString());
+        }
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+BaseIndex::DB& TimestampIndex::GetDB() const { return *m_db; }
+
+bool TimestampIndex::ReadTimestampIndex(unsigned int high, unsigned int low, std::vector<uint256>& hashes) const
+{
+    return m_db->ReadTimestampIndex(high, low, hashes);
+}
@@ -26,7 +26,10 @@
 #include <httpserver.h>
 #include <httprpc.h>
 #include <interfaces/chain.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
+#include <index/spentindex.h>
+#include <index/timestampindex.h>
 #include <index/txindex.h>
 #include <interfaces/node.h>
 #include <key.h>
@@ -83,10 +86,12 @@
 #include <walletinitinterface.h>
 
 #include <evo/deterministicmns.h>
+#include <evo/simplifiedmns.h>
 #include <llmq/blockprocessor.h>
 #include <llmq/chainlocks.h>
 #include <llmq/context.h>
 #include <llmq/instantsend.h>
+#include <llmq/metrics.h>
 #include <llmq/quorums.h>
 #include <llmq/dkgsessionmgr.h>
 #include <llmq/signing.h>
@@ -214,6 +219,15 @@ void Interrupt(NodeContext& node)
     if (g_txindex) {
         g_txindex->Interrupt();
     }
+    if (g_addressindex) {
+        g_addressindex->Interrupt();
+    }
+    if (g_spentindex) {
+        g_spentindex->Interrupt();
+    }
+    if (g_timestampindex) {
+        g_timestampindex->Interrupt();
+    }
     ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Interrupt(); });
 }
 
@@ -252,6 +266,7 @@ void PrepareShutdown(NodeContext& node)
     // Because these depend on each-other, we make sure that neither can be
     // using the other before destroying them.
     if (node.peer_logic) UnregisterValidationInterface(node.peer_logic.get());
+    if (node.peer_logic) node.peer_logic->StopMessageLanes();
     if (node.connman) node.connman->Stop();
 
     StopTorControl();
@@ -263,6 +278,9 @@ void PrepareShutdown(NodeContext& node)
     threadGroup.join_all();
     StopScriptCheckWorkerThreads();
 
+    // Send out whatever metrics are still queued
+    statsClient.Stop();
+
     // After there are no more peers/RPC left to give us new data which may generate
     // CValidationInterface callbacks, flush them...
     GetMainSignals().FlushBackgroundCallbacks();
@@ -276,8 +294,7 @@ void PrepareShutdown(NodeContext& node)
         CFlatDB<CSporkManager> flatdb6("sporks.dat", "magicSporkCache");
         flatdb6.Dump(*::sporkManager);
         if (!fDisableGovernance) {
-            CFlatDB<CGovernanceManager> flatdb3("governance.dat", "magicGovernanceCache");
-            flatdb3.Dump(*::governance);
+            ::governance->WriteStateToDb();
         }
     }
 
@@ -332,6 +349,18 @@ void PrepareShutdown(NodeContext& node)
         g_txindex->Stop();
         g_txindex.reset();
     }
+    if (g_addressindex) {
+        g_addressindex->Stop();
+        g_addressindex.reset();
+    }
+    if (g_spentindex) {
+        g_spentindex->Stop();
+        g_spentindex.reset();
+    }
+    if (g_timestampindex) {
+        g_timestampindex->Stop();
+        g_timestampindex.reset();
+    }
     ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Stop(); });
     DestroyAllBlockFilterIndexes();
 
@@ -536,11 +565,12 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-maxrecsigsage=<n>", strprintf("Number of seconds to keep LLMQ recovery sigs (default: %u)", llmq::DEFAULT_MAX_RECOVERED_SIGS_AGE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-mnlistcachesize=<n>", strprintf("Number of intermediate masternode lists to keep in memory to speed up lookups of historical lists (0 to disable, default: %u)", DEFAULT_MNLIST_CACHE_SIZE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", BITCOIN_PID_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
-    argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex, -rescan and -disablegovernance=false. "
+    argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex, -addressindex, -spentindex, -timestampindex, -rescan and -disablegovernance=false. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
             "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >%u = automatically prune block files to stay under the specified target size in MiB)", MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-settings=<file>", strprintf("Specify path to dynamic settings data file. Can be disabled with -nosettings. File is written at runtime and not meant to be edited by users (use %s instead for custom settings). Relative paths will be prefixed by datadir location. (default: %s)", BITCOIN_CONF_FILENAME, BITCOIN_SETTINGS_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -582,6 +612,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-maxsendbuffer=<n>", strprintf("Maximum per-connection send buffer, <n>*1000 bytes (default: %u)", DEFAULT_MAXSENDBUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-maxtimeadjustment", strprintf("Maximum allowed median peer time offset adjustment. Local perspective of time may be influenced by peers forward or backward by this amount. (default: %u seconds)", DEFAULT_MAX_TIME_ADJUSTMENT), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-maxuploadtarget=<n>", strprintf("Tries to keep outbound traffic under the given target (in MiB per 24h), 0 = no limit (default: %d)", DEFAULT_MAX_UPLOAD_TARGET), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    argsman.AddArg("-msglanes=<n>", strprintf("Number of threads processing LLMQ signing messages outside of the message handler thread, messages of a peer are always processed by the same thread (0 = disable, max: %d, default: %d)", MAX_MESSAGE_LANES, DEFAULT_MESSAGE_LANES), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-onion=<ip:port>", "Use separate SOCKS5 proxy to reach peers via Tor hidden services, set -noonion to disable (default: -proxy)", ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-onlynet=<net>", "Make outgoing connections only through network <net> (ipv4, ipv6 or onion). Incoming connections are not affected by this option. This option can be specified multiple times to allow multiple networks.", ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-peerblockfilters", strprintf("Serve compact block filters to peers per BIP 157 (default: %u)", DEFAULT_PEERBLOCKFILTERS), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
@@ -746,6 +777,7 @@ void SetupServerArgs(NodeContext& node)
     SetupChainParamsBaseOptions(argsman);
 
     argsman.AddArg("-llmq-data-recovery=<n>", strprintf("Enable automated quorum data recovery (default: %u)", llmq::DEFAULT_ENABLE_QUORUM_DATA_RECOVERY), ArgsManager::ALLOW_ANY, OptionsCategory::MASTERNODE);
+    argsman.AddArg("-llmqsigthreads=<n>", strprintf("Number of threads used for each of the verification and recovery stages of LLMQ signing (0 = auto, max: %d, default: %d)", llmq::MAX_LLMQ_SIG_THREADS, llmq::DEFAULT_LLMQ_SIG_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::MASTERNODE);
     argsman.AddArg("-llmq-qvvec-sync=<quorum_name>:<mode>", strprintf("Defines from which LLMQ type the masternode should sync quorum verification vectors. Can be used multiple times with different LLMQ types. <mode>: %d (sync always from all quorums of the type defined by <quorum_name>), %d (sync from all quorums of the type defined by <quorum_name> if a member of any of the quorums)", (int32_t)llmq::QvvecSyncMode::Always, (int32_t)llmq::QvvecSyncMode::OnlyIfTypeMember), ArgsManager::ALLOW_ANY, OptionsCategory::MASTERNODE);
     argsman.AddArg("-masternodeblsprivkey=<hex>", "Set the masternode BLS private key and enable the client to act as a masternode", ArgsManager::ALLOW_ANY, OptionsCategory::MASTERNODE);
     argsman.AddArg("-platform-user=<user>", "Set the username for the \"platform user\", a restricted user intended to be used by Dash Platform, to the specified username.", ArgsManager::ALLOW_ANY, OptionsCategory::MASTERNODE);
@@ -786,6 +818,8 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-statsport=<port>", strprintf("Specify statsd port (default: %u)", DEFAULT_STATSD_PORT), ArgsManager::ALLOW_ANY, OptionsCategory::STATSD);
     argsman.AddArg("-statsns=<ns>", strprintf("Specify additional namespace prefix (default: %s)", DEFAULT_STATSD_NAMESPACE), ArgsManager::ALLOW_ANY, OptionsCategory::STATSD);
     argsman.AddArg("-statsperiod=<seconds>", strprintf("Specify the number of seconds between periodic measurements (default: %d)", DEFAULT_STATSD_PERIOD), ArgsManager::ALLOW_ANY, OptionsCategory::STATSD);
+    argsman.AddArg("-statsflushinterval=<ms>", strprintf("Specify the number of milliseconds between sending batches of queued metrics (minimum: %d, default: %d)", MIN_STATSD_FLUSH_INTERVAL, DEFAULT_STATSD_FLUSH_INTERVAL), ArgsManager::ALLOW_ANY, OptionsCategory::STATSD);
+    argsman.AddArg("-statspercentiles", strprintf("Send the count, 50th, 90th and 99th percentile and maximum of timings per flush interval instead of every sample (default: %u)", DEFAULT_STATSD_PERCENTILES), ArgsManager::ALLOW_ANY, OptionsCategory::STATSD);
 #if HAVE_DECL_DAEMON
     argsman.AddArg("-daemon", "Run in the background as a daemon and accept commands", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #else
@@ -988,7 +1022,7 @@ static void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImp
     ::mempool.SetIsLoaded(!ShutdownRequested());
 }
 
-void PeriodicStats(ArgsManager& args)
+void PeriodicStats(ArgsManager& args, const LLMQContext& llmq_ctx)
 {
     assert(args.GetBoolArg("-statsenabled", DEFAULT_STATSD_ENABLE));
     CCoinsStats stats;
@@ -1033,6 +1067,32 @@ void PeriodicStats(ArgsManager& args)
     statsClient.gauge("transactions.mempool.totalTxBytes", (int64_t) mempool.GetTotalTxSize(), 1.0f);
     statsClient.gauge("transactions.mempool.memoryUsageBytes", (int64_t) mempool.DynamicMemoryUsage(), 1.0f);
     statsClient.gauge("transactions.mempool.minFeePerKb", mempool.GetMinFee(args.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000).GetFeePerK(), 1.0f);
+
+    if (deterministicMNManager) {
+        const auto mnListStats = deterministicMNManager->GetLookupStats();
+        statsClient.gauge("masternodes.listLookups.lockFree", mnListStats.lockFree, 1.0f);
+        statsClient.gauge("masternodes.listLookups.locked", mnListStats.locked, 1.0f);
+        statsClient.gauge("masternodes.listLookups.contended", mnListStats.contended, 1.0f);
+    }
+
+    const auto reportCacheStats = [](const std::string& prefix, const std::map<std::string, unordered_lru_cache_stats>& caches) {
+        for (const auto& [name, stats] : caches) {
+            statsClient.gauge(strprintf("%s.%s.hits", prefix, name), stats.hits, 1.0f);
+            statsClient.gauge(strprintf("%s.%s.misses", prefix, name), stats.misses, 1.0f);
+            statsClient.gauge(strprintf("%s.%s.evictions", prefix, name), stats.evictions, 1.0f);
+        }
+    };
+    reportCacheStats("llmq.caches.recoveredSigs", llmq_ctx.sigman->GetCacheStats());
+    reportCacheStats("llmq.caches.instantsend", llmq_ctx.isman->GetCacheStats());
+    reportCacheStats("llmq.caches.quorumManager", llmq_ctx.qman->GetCacheStats());
+    reportCacheStats("llmq.caches.responses", {
+        {"mnListDiff", mnListDiffResponseCache.GetStats()},
+        {"quorumRotationInfo", llmq::quorumRotationInfoResponseCache.GetStats()},
+    });
+
+    for (const auto& [name, value] : llmq::CollectLLMQGauges(llmq_ctx)) {
+        statsClient.gauge("llmq." + name, (size_t)std::max<int64_t>(value, 0), 1.0f);
+    }
 }
 
 /** Sanity checks
@@ -1152,18 +1212,6 @@ void InitParameterInteraction(ArgsManager& args)
         }
     }
 
-    // Make sure additional indexes are recalculated correctly in VerifyDB
-    // (we must reconnect blocks whenever we disconnect them for these indexes to work)
-    bool fAdditionalIndexes =
-        args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX) ||
-        args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX) ||
-        args.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
-
-    if (fAdditionalIndexes && args.GetArg("-checklevel", DEFAULT_CHECKLEVEL) < 4) {
-        args.ForceSetArg("-checklevel", "4");
-        LogPrintf("%s: parameter interaction: additional indexes -> setting -checklevel=4\n", __func__);
-    }
-
     if (args.IsArgSet("-masternodeblsprivkey") && args.SoftSetBoolArg("-disablewallet", true)) {
         LogPrintf("%s: parameter interaction: -masternodeblsprivkey set -> setting -disablewallet=1\n", __func__);
     }
@@ -1329,6 +1377,15 @@ bool AppInitParameterInteraction(const ArgsManager& args)
         if (!g_enabled_filter_types.empty()) {
             return InitError(_("Prune mode is incompatible with -blockfilterindex."));
         }
+        if (args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
+            return InitError(_("Prune mode is incompatible with -addressindex."));
+        }
+        if (args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
+            return InitError(_("Prune mode is incompatible with -spentindex."));
+        }
+        if (args.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX)) {
+            return InitError(_("Prune mode is incompatible with -timestampindex."));
+        }
     }
 
     if (args.IsArgSet("-devnet")) {
@@ -1677,6 +1734,14 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
                   args.GetArg("-datadir", ""), fs::current_path().string());
     }
 
+    if (args.GetBoolArg("-statsenabled", DEFAULT_STATSD_ENABLE)) {
+        statsClient.config(args.GetArg("-statshost", DEFAULT_STATSD_HOST), args.GetArg("-statsport", DEFAULT_STATSD_PORT),
+                           args.GetArg("-statsns", DEFAULT_STATSD_NAMESPACE), args.GetArg("-statshostname", DEFAULT_STATSD_HOSTNAME));
+        if (!statsClient.Start(args.GetArg("-statsflushinterval", DEFAULT_STATSD_FLUSH_INTERVAL), args.GetBoolArg("-statspercentiles", DEFAULT_STATSD_PERCENTILES))) {
+            InitWarning(strprintf(_("Could not start statsd client: %s"), statsClient.errmsg()));
+        }
+    }
+
     InitSignatureCache();
     InitScriptExecutionCache();
 
@@ -1969,6 +2034,9 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
 
     fReindex = args.GetBoolArg("-reindex", false);
     bool fReindexChainState = args.GetBoolArg("-reindex-chainstate", false);
+    fAddressIndex = args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
+    fSpentIndex = args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
+    fTimestampIndex = args.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
 
     // cache size calculations
     int64_t nTotalCache = (args.GetArg("-dbcache", nDefaultDbCache) << 20);
@@ -1978,6 +2046,12 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
     nTotalCache -= nBlockTreeDBCache;
     int64_t nTxIndexCache = std::min(nTotalCache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
     nTotalCache -= nTxIndexCache;
+    int64_t nAddressIndexCache = std::min(nTotalCache / 8, fAddressIndex ? nMaxAddressIndexCache << 20 : 0);
+    nTotalCache -= nAddressIndexCache;
+    int64_t nSpentIndexCache = std::min(nTotalCache / 8, fSpentIndex ? nMaxSpentIndexCache << 20 : 0);
+    nTotalCache -= nSpentIndexCache;
+    int64_t nTimestampIndexCache = std::min(nTotalCache / 8, fTimestampIndex ? nMaxTimestampIndexCache << 20 : 0);
+    nTotalCache -= nTimestampIndexCache;
     int64_t filter_index_cache = 0;
     if (!g_enabled_filter_types.empty()) {
         size_t n_indexes = g_enabled_filter_types.size();
@@ -1996,11 +2070,22 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
     if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
         LogPrintf("* Using %.1f MiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
     }
+    if (fAddressIndex) {
+        LogPrintf("* Using %.1f MiB for address index database\n", nAddressIndexCache * (1.0 / 1024 / 1024));
+    }
+    if (fSpentIndex) {
+        LogPrintf("* Using %.1f MiB for spent index database\n", nSpentIndexCache * (1.0 / 1024 / 1024));
+    }
+    if (fTimestampIndex) {
+        LogPrintf("* Using %.1f MiB for timestamp index database\n", nTimestampIndexCache * (1.0 / 1024 / 1024));
+    }
     for (BlockFilterType filter_type : g_enabled_filter_types) {
         LogPrintf("* Using %.1f MiB for %s block filter index database\n",
                   filter_index_cache * (1.0 / 1024 / 1024), BlockFilterTypeName(filter_type));
     }
     LogPrintf("* Using %.1f MiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
+    const size_t nMNListCacheSize = std::max<int64_t>(0, args.GetArg("-mnlistcachesize", DEFAULT_MNLIST_CACHE_SIZE));
+    LogPrintf("* Using %u in-memory masternode list snapshots\n", nMNListCacheSize);
     LogPrintf("* Using %.1f MiB for in-memory UTXO set (plus up to %.1f MiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
     bool fLoaded = false;
@@ -2035,7 +2120,7 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
 
                 // Same logic as above with pblocktree
                 deterministicMNManager.reset();
-                deterministicMNManager.reset(new CDeterministicMNManager(*node.evodb, *node.connman));
+                deterministicMNManager.reset(new CDeterministicMNManager(*node.evodb, *node.connman, nMNListCacheSize));
                 llmq::quorumSnapshotManager.reset();
                 llmq::quorumSnapshotManager.reset(new llmq::CQuorumSnapshotManager(*node.evodb));
                 node.llmq_ctx.reset();
@@ -2076,24 +2161,6 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
                     return InitError(_("Incorrect or no devnet genesis block found. Wrong datadir for devnet specified?"));
                 }
 
-                // Check for changed -addressindex state
-                if (fAddressIndex != args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -addressindex");
-                    break;
-                }
-
-                // Check for changed -timestampindex state
-                if (fTimestampIndex != args.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -timestampindex");
-                    break;
-                }
-
-                // Check for changed -spentindex state
-                if (fSpentIndex != args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -spentindex");
-                    break;
-                }
-
                 // Check for changed -prune state.  What we are concerned about is a user who has pruned blocks
                 // in the past, but is now trying to run unpruned.
                 if (fHavePruned && !fPruneMode) {
@@ -2278,6 +2345,21 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
         g_txindex->Start();
     }
 
+    if (fAddressIndex) {
+        g_addressindex = std::make_unique<AddressIndex>(nAddressIndexCache, false, fReindex);
+        g_addressindex->Start();
+    }
+
+    if (fSpentIndex) {
+        g_spentindex = std::make_unique<SpentIndex>(nSpentIndexCache, false, fReindex);
+        g_spentindex->Start();
+    }
+
+    if (fTimestampIndex) {
+        g_timestampindex = std::make_unique<TimestampIndex>(nTimestampIndexCache, false, fReindex);
+        g_timestampindex->Start();
+    }
+
     for (const auto& filter_type : g_enabled_filter_types) {
         InitBlockFilterIndex(filter_type, filter_index_cache, false, fReindex);
         GetBlockFilterIndex(filter_type)->Start();
@@ -2353,19 +2435,23 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
         }
     }
 
+    // governance objects and votes are kept in their own db now, older versions stored them in governance.dat
     strDBName = "governance.dat";
     uiInterface.InitMessage(_("Loading governance cache...").translated);
-    CFlatDB<CGovernanceManager> flatdb3(strDBName, "magicGovernanceCache");
-    if (fLoadCacheFiles && !fDisableGovernance) {
+    const bool fImportGovernance = fLoadCacheFiles && !fDisableGovernance && fs::exists(pathDB / strDBName);
+    ::governance->InitDb(/* fMemory = */ false, /* fWipe = */ !fLoadCacheFiles || fDisableGovernance || fImportGovernance);
+    if (fImportGovernance) {
+        CFlatDB<CGovernanceManager> flatdb3(strDBName, "magicGovernanceCache");
         if(!flatdb3.Load(*::governance)) {
             return InitError(strprintf(_("Failed to load governance cache from %s"), (pathDB / strDBName).string()));
         }
+        ::governance->WriteAllToDb();
+    }
+    if (fs::exists(pathDB / strDBName)) {
+        fs::remove(pathDB / strDBName);
+    }
+    if (fLoadCacheFiles && !fDisableGovernance) {
         ::governance->InitOnLoad();
-    } else {
-        CGovernanceManager governanceTmp;
-        if(!flatdb3.Dump(governanceTmp)) {
-            return InitError(strprintf(_("Failed to clear governance cache at %s"), (pathDB / strDBName).string()));
-        }
     }
 
     strDBName = "netfulfilled.dat";
@@ -2388,6 +2474,10 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
     node.scheduler->scheduleEvery(std::bind(&CMasternodeSync::DoMaintenance, std::ref(*::masternodeSync)), 1 * 1000);
     node.scheduler->scheduleEvery(std::bind(&CMasternodeUtils::DoMaintenance, std::ref(*node.connman), std::ref(*::masternodeSync)), 60 * 1000);
     node.scheduler->scheduleEvery(std::bind(&CDeterministicMNManager::DoMaintenance, std::ref(*deterministicMNManager)), 10 * 1000);
+    node.scheduler->scheduleEvery([] {
+        const int nHeight = WITH_LOCK(cs_main, return ::ChainActive().Height());
+        llmq::quorumSnapshotManager->CleanupOldQuorumMembers(nHeight);
+    }, 60 * 60 * 1000);
 
     if (!fDisableGovernance) {
         node.scheduler->scheduleEvery(std::bind(&CGovernanceManager::DoMaintenance, std::ref(*::governance), std::ref(*node.connman)), 60 * 5 * 1000);
@@ -2404,7 +2494,7 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
 
     if (args.GetBoolArg("-statsenabled", DEFAULT_STATSD_ENABLE)) {
         int nStatsPeriod = std::min(std::max((int)args.GetArg("-statsperiod", DEFAULT_STATSD_PERIOD), MIN_STATSD_PERIOD), MAX_STATSD_PERIOD);
-        node.scheduler->scheduleEvery(std::bind(&PeriodicStats, std::ref(*node.args)), nStatsPeriod * 1000);
+        node.scheduler->scheduleEvery(std::bind(&PeriodicStats, std::ref(*node.args), std::cref(*node.llmq_ctx)), nStatsPeriod * 1000);
     }
 
     node.llmq_ctx->Start();
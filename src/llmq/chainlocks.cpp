@@ -5,6 +5,7 @@
 #include <llmq/chainlocks.h>
 #include <llmq/quorums.h>
 #include <llmq/instantsend.h>
+#include <llmq/metrics.h>
 #include <llmq/utils.h>
 #include <llmq/signing_shares.h>
 
@@ -20,6 +21,8 @@
 #include <util/validation.h>
 #include <validation.h>
 
+#include <limits>
+
 namespace llmq
 {
 std::unique_ptr<CChainLocksHandler> chainLocksHandler;
@@ -119,6 +122,7 @@ void CChainLocksHandler::ProcessNewChainLock(const NodeId from, const llmq::CCha
     const uint256 requestId = ::SerializeHash(std::make_pair(CLSIG_REQUESTID_PREFIX, clsig.getHeight()));
     if (!llmq::CSigningManager::VerifyRecoveredSig(Params().GetConsensus().llmqTypeChainLocks, *llmq::quorumManager, clsig.getHeight(), requestId, clsig.getBlockHash(), clsig.getSig())) {
         LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- invalid CLSIG (%s), peer=%d\n", __func__, clsig.ToString(), from);
+        llmqMetrics.Inc("chainlocks.invalid");
         if (from != -1) {
             LOCK(cs_main);
             Misbehaving(from, 10);
@@ -145,6 +149,10 @@ void CChainLocksHandler::ProcessNewChainLock(const NodeId from, const llmq::CCha
 
             bestChainLockWithKnownBlock = bestChainLock;
             bestChainLockBlockIndex = pindex;
+
+            if (auto it = seenBlockHeaders.find(clsig.getBlockHash()); it != seenBlockHeaders.end()) {
+                llmqMetrics.Timing("chainlocks.blockToClsig", GetTimeMillis() - it->second);
+            }
         }
         // else if (pindex == nullptr)
         // Note: make sure to still relay clsig further.
@@ -173,6 +181,10 @@ void CChainLocksHandler::AcceptedBlockHeader(const CBlockIndex* pindexNew)
 {
     LOCK(cs);
 
+    if (m_mn_sync->IsBlockchainSynced()) {
+        seenBlockHeaders.emplace(pindexNew->GetBlockHash(), GetTimeMillis());
+    }
+
     if (pindexNew->GetBlockHash() == bestChainLock.getBlockHash()) {
         LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- block header %s came in late, updating and enforcing\n", __func__, pindexNew->GetBlockHash().ToString());
 
@@ -294,27 +306,15 @@ void CChainLocksHandler::TrySignChainTip()
                 break;
             }
 
-            auto txids = GetBlockTxs(pindexWalk->GetBlockHash());
-            if (!txids) {
-                pindexWalk = pindexWalk->pprev;
-                continue;
-            }
-
-            for (const auto& txid : *txids) {
-                int64_t txAge = 0;
-                {
-                    LOCK(cs);
-                    auto it = txFirstSeenTime.find(txid);
-                    if (it != txFirstSeenTime.end()) {
-                        txAge = GetAdjustedTime() - it->second;
-                    }
-                }
-
-                if (txAge < WAIT_FOR_ISLOCK_TIMEOUT && !quorumInstantSendManager->IsLocked(txid)) {
+            const int64_t nAdjustedTime = GetAdjustedTime();
+            const auto hasUnsafeTxs = HasUnsafeBlockTxs(pindexWalk, nAdjustedTime);
+            if (hasUnsafeTxs.value_or(false)) {
+                if (LogAcceptCategory(BCLog::CHAINLOCKS)) {
+                    const auto [txid, txAge] = GetUnsafeBlockTx(pindexWalk->GetBlockHash(), nAdjustedTime);
                     LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- not signing block %s due to TX %s not being islocked and not old enough. age=%d\n", __func__,
                               pindexWalk->GetBlockHash().ToString(), txid.ToString(), txAge);
-                    return;
                 }
+                return;
             }
 
             pindexWalk = pindexWalk->pprev;
@@ -344,8 +344,16 @@ void CChainLocksHandler::TransactionAddedToMempool(const CTransactionRef& tx, in
         return;
     }
 
-    LOCK(cs);
-    txFirstSeenTime.emplace(tx->GetHash(), nAcceptTime);
+    int64_t firstSeenTime;
+    {
+        LOCK(cs);
+        firstSeenTime = txFirstSeenTime.emplace(tx->GetHash(), nAcceptTime).first->second;
+    }
+    if (firstSeenTime < nAcceptTime) {
+        // seen before, e.g. in a block that got disconnected
+        LOCK(mempool.cs);
+        mempool.UpdateFirstSeenTime(tx->GetHash(), firstSeenTime);
+    }
 }
 
 void CChainLocksHandler::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted)
@@ -354,114 +362,174 @@ void CChainLocksHandler::BlockConnected(const std::shared_ptr<const CBlock>& pbl
         return;
     }
 
-    // We listen for BlockConnected so that we can collect all TX ids of all included TXs of newly received blocks
+    // We listen for BlockConnected so that we can count the TXs of newly received blocks which are not islocked yet.
     // We need this information later when we try to sign a new tip, so that we can determine if all included TXs are
     // safe.
 
+    AddBlockTxs(pindex->GetBlockHash(), pblock->vtx, GetAdjustedTime());
+}
+
+void CChainLocksHandler::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
+{
+    const uint256& blockHash = pindexDisconnected->GetBlockHash();
+
     LOCK(cs);
+    if (blockTxs.erase(blockHash) == 0) {
+        return;
+    }
+    for (const auto& tx : pblock->vtx) {
+        auto range = unlockedBlockTxs.equal_range(tx->GetHash());
+        for (auto it = range.first; it != range.second; ) {
+            if (it->second.first == blockHash) {
+                it = unlockedBlockTxs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
 
-    auto it = blockTxs.find(pindex->GetBlockHash());
-    if (it == blockTxs.end()) {
-        // we must create this entry even if there are no lockable transactions in the block, so that TrySignChainTip
-        // later knows about this block
-        it = blockTxs.emplace(pindex->GetBlockHash(), std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>()).first;
+void CChainLocksHandler::TransactionsLocked(const std::vector<uint256>& txids)
+{
+    LOCK(cs);
+    for (const auto& txid : txids) {
+        auto range = unlockedBlockTxs.equal_range(txid);
+        for (auto it = range.first; it != range.second; ++it) {
+            const auto& [blockHash, firstSeenTime] = it->second;
+            auto itBlock = blockTxs.find(blockHash);
+            if (itBlock != blockTxs.end()) {
+                itBlock->second.RemoveUnlockedTx(firstSeenTime);
+            }
+        }
+        unlockedBlockTxs.erase(range.first, range.second);
     }
-    auto& txids = *it->second;
+    ++txsLockedCounter;
+}
 
-    int64_t curTime = GetAdjustedTime();
+void CChainLocksHandler::AddBlockTxs(const uint256& blockHash, const std::vector<CTransactionRef>& vtx, int64_t nTime)
+{
+    AssertLockNotHeld(cs);
 
-    for (const auto& tx : pblock->vtx) {
+    if (WITH_LOCK(cs, return blockTxs.count(blockHash) != 0)) {
+        return;
+    }
+
+    // An islock written after we looked it up here but before we added the TX below can't update the counters. So if
+    // any TXs got locked in between, we look up the TXs we counted once more afterwards
+    const uint64_t prevTxsLockedCounter = txsLockedCounter;
+    std::vector<uint256> unlockedTxids;
+    for (const auto& tx : vtx) {
         if (tx->IsCoinBase() || tx->vin.empty()) {
             continue;
         }
-
-        txids.emplace(tx->GetHash());
-        txFirstSeenTime.emplace(tx->GetHash(), curTime);
+        if (!quorumInstantSendManager->IsLocked(tx->GetHash())) {
+            unlockedTxids.emplace_back(tx->GetHash());
+        }
     }
 
-}
+    {
+        LOCK(cs);
+        // we must create this entry even if there are no lockable transactions in the block, so that TrySignChainTip
+        // later knows about this block
+        auto [it, inserted] = blockTxs.try_emplace(blockHash);
+        if (!inserted) {
+            return;
+        }
+        for (const auto& tx : vtx) {
+            if (!tx->IsCoinBase() && !tx->vin.empty()) {
+                it->second.txids.emplace_back(tx->GetHash());
+                txFirstSeenTime.emplace(tx->GetHash(), nTime);
+            }
+        }
+        for (const auto& txid : unlockedTxids) {
+            const int64_t firstSeenTime = txFirstSeenTime.at(txid);
+            it->second.AddUnlockedTx(firstSeenTime);
+            unlockedBlockTxs.emplace(txid, std::make_pair(blockHash, firstSeenTime));
+        }
+        if (txsLockedCounter == prevTxsLockedCounter) {
+            return;
+        }
+    }
 
-void CChainLocksHandler::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
-{
-    LOCK(cs);
-    blockTxs.erase(pindexDisconnected->GetBlockHash());
+    std::vector<uint256> lockedTxids;
+    for (const auto& txid : unlockedTxids) {
+        if (quorumInstantSendManager->IsLocked(txid)) {
+            lockedTxids.emplace_back(txid);
+        }
+    }
+    if (!lockedTxids.empty()) {
+        TransactionsLocked(lockedTxids);
+    }
 }
 
-CChainLocksHandler::BlockTxs::mapped_type CChainLocksHandler::GetBlockTxs(const uint256& blockHash)
+std::optional<bool> CChainLocksHandler::HasUnsafeBlockTxs(const CBlockIndex* pindex, int64_t nAdjustedTime)
 {
     AssertLockNotHeld(cs);
     AssertLockNotHeld(cs_main);
 
-    CChainLocksHandler::BlockTxs::mapped_type ret;
-
     {
         LOCK(cs);
-        auto it = blockTxs.find(blockHash);
+        auto it = blockTxs.find(pindex->GetBlockHash());
         if (it != blockTxs.end()) {
-            ret = it->second;
+            return it->second.HasUnsafeTxs(nAdjustedTime);
         }
     }
-    if (!ret) {
-        // This should only happen when freshly started.
-        // If running for some time, SyncTransaction should have been called before which fills blockTxs.
-        LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- blockTxs for %s not found. Trying ReadBlockFromDisk\n", __func__,
-                 blockHash.ToString());
 
-        uint32_t blockTime;
-        {
-            LOCK(cs_main);
-            auto* pindex = LookupBlockIndex(blockHash);
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-                return nullptr;
-            }
+    // This should only happen when freshly started.
+    // If running for some time, BlockConnected should have been called before which fills blockTxs.
+    LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- blockTxs for %s not found. Trying ReadBlockFromDisk\n", __func__,
+             pindex->GetBlockHash().ToString());
 
-            ret = std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>();
-            for (auto& tx : block.vtx) {
-                if (tx->IsCoinBase() || tx->vin.empty()) {
-                    continue;
-                }
-                ret->emplace(tx->GetHash());
-            }
-
-            blockTime = block.nTime;
+    CBlock block;
+    {
+        LOCK(cs_main);
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            return std::nullopt;
         }
+    }
 
-        LOCK(cs);
-        blockTxs.emplace(blockHash, ret);
-        for (const auto& txid : *ret) {
-            txFirstSeenTime.emplace(txid, blockTime);
+    AddBlockTxs(pindex->GetBlockHash(), block.vtx, block.nTime);
+
+    LOCK(cs);
+    auto it = blockTxs.find(pindex->GetBlockHash());
+    if (it == blockTxs.end()) {
+        // disconnected or cleaned up in the meantime
+        return std::nullopt;
+    }
+    return it->second.HasUnsafeTxs(nAdjustedTime);
+}
+
+std::pair<uint256, int64_t> CChainLocksHandler::GetUnsafeBlockTx(const uint256& blockHash, int64_t nAdjustedTime) const
+{
+    LOCK(cs);
+    std::pair<uint256, int64_t> ret{uint256(), 0};
+    int64_t newestFirstSeenTime{std::numeric_limits<int64_t>::min()};
+    for (const auto& [txid, p] : unlockedBlockTxs) {
+        if (p.first == blockHash && p.second > newestFirstSeenTime) {
+            newestFirstSeenTime = p.second;
+            ret = {txid, nAdjustedTime - p.second};
         }
     }
     return ret;
 }
 
-bool CChainLocksHandler::IsTxSafeForMining(const CInstantSendManager& isman, const uint256& txid) const
+bool CChainLocksHandler::IsTxSafetyEnforced(const CInstantSendManager& isman) const
 {
     if (!isman.RejectConflictingBlocks()) {
-        return true;
+        return false;
     }
     if (!isEnabled || !isEnforced) {
-        return true;
+        return false;
     }
+    return isman.IsInstantSendEnabled();
+}
 
-    if (!isman.IsInstantSendEnabled()) {
-        return true;
-    }
-    if (isman.IsLocked(txid)) {
+bool CChainLocksHandler::IsTxSafeForMining(const CTxMemPoolEntry& entry, int64_t nAdjustedTime)
+{
+    if (entry.m_instantsend_locked) {
         return true;
     }
-
-    int64_t txAge = 0;
-    {
-        LOCK(cs);
-        auto it = txFirstSeenTime.find(txid);
-        if (it != txFirstSeenTime.end()) {
-            txAge = GetAdjustedTime() - it->second;
-        }
-    }
-
-    return txAge >= WAIT_FOR_ISLOCK_TIMEOUT;
+    return nAdjustedTime - entry.m_first_seen_time >= WAIT_FOR_ISLOCK_TIMEOUT;
 }
 
 // WARNING: cs_main and cs should not be held!
@@ -632,16 +700,33 @@ void CChainLocksHandler::Cleanup()
             ++it;
         }
     }
+    for (auto it = seenBlockHeaders.begin(); it != seenBlockHeaders.end(); ) {
+        if (GetTimeMillis() - it->second >= CLEANUP_SEEN_TIMEOUT) {
+            it = seenBlockHeaders.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
+    const int64_t nAdjustedTime = GetAdjustedTime();
     for (auto it = blockTxs.begin(); it != blockTxs.end(); ) {
         auto* pindex = LookupBlockIndex(it->first);
         if (InternalHasChainLock(pindex->nHeight, pindex->GetBlockHash())) {
-            for (const auto& txid : *it->second) {
+            for (const auto& txid : it->second.txids) {
                 txFirstSeenTime.erase(txid);
             }
             it = blockTxs.erase(it);
         } else if (InternalHasConflictingChainLock(pindex->nHeight, pindex->GetBlockHash())) {
             it = blockTxs.erase(it);
+        } else {
+            it->second.ExpireUnlockedTxs(nAdjustedTime);
+            ++it;
+        }
+    }
+    for (auto it = unlockedBlockTxs.begin(); it != unlockedBlockTxs.end(); ) {
+        const auto& [blockHash, firstSeenTime] = it->second;
+        if (nAdjustedTime - firstSeenTime >= WAIT_FOR_ISLOCK_TIMEOUT || blockTxs.count(blockHash) == 0) {
+            it = unlockedBlockTxs.erase(it);
         } else {
             ++it;
         }
@@ -17,12 +17,16 @@
 #include <sync.h>
 
 #include <atomic>
+#include <map>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 
 class CConnman;
 class CBlockIndex;
 class CScheduler;
 class CTxMemPool;
+class CTxMemPoolEntry;
 class CSporkManager;
 class CMasternodeSync;
 
@@ -37,9 +41,38 @@ class CChainLocksHandler : public CRecoveredSigsListener
     static constexpr int64_t CLEANUP_INTERVAL = 1000 * 30;
     static constexpr int64_t CLEANUP_SEEN_TIMEOUT = 24 * 60 * 60 * 1000;
 
+public:
     // how long to wait for islocks until we consider a block with non-islocked TXs to be safe to sign
     static constexpr int64_t WAIT_FOR_ISLOCK_TIMEOUT = 10 * 60;
 
+    // Counts the TXs of a block which are not islocked yet, by the time they were first seen
+    struct BlockTxsState
+    {
+        // all lockable TXs of the block, so that they can be forgotten once the block is ChainLocked
+        std::vector<uint256> txids;
+        std::map<int64_t, uint32_t> unlockedTxs;
+
+        void AddUnlockedTx(int64_t firstSeenTime) { unlockedTxs[firstSeenTime]++; }
+        void RemoveUnlockedTx(int64_t firstSeenTime)
+        {
+            auto it = unlockedTxs.find(firstSeenTime);
+            if (it != unlockedTxs.end() && --it->second == 0) {
+                unlockedTxs.erase(it);
+            }
+        }
+        // TXs that are known long enough are safe without an islock, no need to count them anymore
+        void ExpireUnlockedTxs(int64_t nAdjustedTime)
+        {
+            unlockedTxs.erase(unlockedTxs.begin(), unlockedTxs.lower_bound(nAdjustedTime - WAIT_FOR_ISLOCK_TIMEOUT + 1));
+        }
+        // whether any of the TXs is not islocked and too young to be considered safe without an islock. Only needs to
+        // look at the newest TXs
+        bool HasUnsafeTxs(int64_t nAdjustedTime) const
+        {
+            return !unlockedTxs.empty() && nAdjustedTime - unlockedTxs.rbegin()->first < WAIT_FOR_ISLOCK_TIMEOUT;
+        }
+    };
+
 private:
     CConnman& connman;
     CTxMemPool& mempool;
@@ -65,16 +98,22 @@ private:
     uint256 lastSignedRequestId GUARDED_BY(cs);
     uint256 lastSignedMsgHash GUARDED_BY(cs);
 
-    // We keep track of txids from recently received blocks so that we can check if all TXs got islocked
+    // We keep track of recently received blocks which include TXs that are not islocked yet, so that we don't have to
+    // look at all TXs of the tip and the previous blocks whenever we try to sign a new tip
     struct BlockHasher
     {
         size_t operator()(const uint256& hash) const { return ReadLE64(hash.begin()); }
     };
-    using BlockTxs = std::unordered_map<uint256, std::shared_ptr<std::unordered_set<uint256, StaticSaltedHasher>>, BlockHasher>;
-    BlockTxs blockTxs GUARDED_BY(cs);
+    std::unordered_map<uint256, BlockTxsState, BlockHasher> blockTxs GUARDED_BY(cs);
+    // txid -> (block hash, first seen time) for all TXs counted in blockTxs, so that islocks can update the counters
+    std::unordered_multimap<uint256, std::pair<uint256, int64_t>, StaticSaltedHasher> unlockedBlockTxs GUARDED_BY(cs);
+    // incremented whenever TransactionsLocked is done, see AddBlockTxs
+    std::atomic<uint64_t> txsLockedCounter{0};
     std::unordered_map<uint256, int64_t, StaticSaltedHasher> txFirstSeenTime GUARDED_BY(cs);
 
     std::map<uint256, int64_t> seenChainLocks GUARDED_BY(cs);
+    // when headers were first seen, used to measure how long it took until they got ChainLocked
+    std::unordered_map<uint256, int64_t, StaticSaltedHasher> seenBlockHeaders GUARDED_BY(cs);
 
     int64_t lastCleanupTime GUARDED_BY(cs) {0};
 
@@ -96,6 +135,8 @@ public:
     void TransactionAddedToMempool(const CTransactionRef& tx, int64_t nAcceptTime);
     void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted);
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected);
+    // Called by InstantSend after the islocks for these TXs were written
+    void TransactionsLocked(const std::vector<uint256>& txids);
     void CheckActiveState();
     void TrySignChainTip();
     void EnforceBestChainLock();
@@ -104,14 +145,25 @@ public:
     bool HasChainLock(int nHeight, const uint256& blockHash) const;
     bool HasConflictingChainLock(int nHeight, const uint256& blockHash) const;
 
-    bool IsTxSafeForMining(const CInstantSendManager& isman, const uint256& txid) const;
+    // Whether blocks may only include TXs that are safe in regard to ChainLocks, see IsTxSafeForMining
+    bool IsTxSafetyEnforced(const CInstantSendManager& isman) const;
+    // A TX is safe if it's InstantSend locked or too old to still get locked at nAdjustedTime. Uses the state of the
+    // mempool entry, so the mempool lock must be held
+    static bool IsTxSafeForMining(const CTxMemPoolEntry& entry, int64_t nAdjustedTime);
 
 private:
     // these require locks to be held already
     bool InternalHasChainLock(int nHeight, const uint256& blockHash) const EXCLUSIVE_LOCKS_REQUIRED(cs);
     bool InternalHasConflictingChainLock(int nHeight, const uint256& blockHash) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
-    BlockTxs::mapped_type GetBlockTxs(const uint256& blockHash);
+    // Counts the TXs of the block which are not islocked yet. Looking up the islocks reads from the InstantSend db, so
+    // this is done without holding cs
+    void AddBlockTxs(const uint256& blockHash, const std::vector<CTransactionRef>& vtx, int64_t nTime) LOCKS_EXCLUDED(cs);
+    // Whether the block includes TXs which are neither islocked nor known long enough. Returns nullopt if the block
+    // could not be read from disk
+    std::optional<bool> HasUnsafeBlockTxs(const CBlockIndex* pindex, int64_t nAdjustedTime);
+    // One of the newest TXs of the block that are not islocked yet and its age, only used for logging
+    std::pair<uint256, int64_t> GetUnsafeBlockTx(const uint256& blockHash, int64_t nAdjustedTime) const LOCKS_EXCLUDED(cs);
 
     void Cleanup();
 };
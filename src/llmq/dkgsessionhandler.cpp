@@ -8,6 +8,7 @@
 #include <llmq/dkgsession.h>
 #include <llmq/blockprocessor.h>
 #include <llmq/debug.h>
+#include <llmq/metrics.h>
 #include <llmq/utils.h>
 
 #include <evo/deterministicmns.h>
@@ -292,6 +293,20 @@ void CDKGSessionHandler::SleepBeforePhase(QuorumPhase curPhase,
     LogPrint(BCLog::LLMQ_DKG, "CDKGSessionManager::%s -- %s qi[%d] - done, curPhase=%d\n", __func__, params.name, quorumIndex, int(curPhase));
 }
 
+static std::string PhaseName(QuorumPhase phase)
+{
+    switch (phase) {
+    case QuorumPhase::Initialized: return "initialized";
+    case QuorumPhase::Contribute: return "contribute";
+    case QuorumPhase::Complain: return "complain";
+    case QuorumPhase::Justify: return "justify";
+    case QuorumPhase::Commit: return "commit";
+    case QuorumPhase::Finalize: return "finalize";
+    case QuorumPhase::Idle: return "idle";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
 void CDKGSessionHandler::HandlePhase(QuorumPhase curPhase,
                                      QuorumPhase nextPhase,
                                      const uint256& expectedQuorumHash,
@@ -301,9 +316,11 @@ void CDKGSessionHandler::HandlePhase(QuorumPhase curPhase,
 {
     LogPrint(BCLog::LLMQ_DKG, "CDKGSessionManager::%s -- %s qi[%d] - starting, curPhase=%d, nextPhase=%d\n", __func__, params.name, quorumIndex, int(curPhase), int(nextPhase));
 
+    const int64_t nStartTime = GetTimeMillis();
     SleepBeforePhase(curPhase, expectedQuorumHash, randomSleepFactor, runWhileWaiting);
     startPhaseFunc();
     WaitForNextPhase(curPhase, nextPhase, expectedQuorumHash, runWhileWaiting);
+    llmqMetrics.Timing(strprintf("dkg.%s.%s", params.name, PhaseName(curPhase)), GetTimeMillis() - nStartTime);
 
     LogPrint(BCLog::LLMQ_DKG, "CDKGSessionManager::%s -- %s qi[%d] - done, curPhase=%d, nextPhase=%d\n", __func__, params.name, quorumIndex, int(curPhase), int(nextPhase));
 }
@@ -8,6 +8,7 @@
 #include <llmq/quorums.h>
 #include <llmq/utils.h>
 #include <llmq/commitment.h>
+#include <llmq/metrics.h>
 #include <llmq/signing_shares.h>
 
 #include <bls/bls_batchverifier.h>
@@ -28,7 +29,7 @@
 namespace llmq
 {
 
-static const std::string INPUTLOCK_REQUESTID_PREFIX = "inlock";
+const std::string INPUTLOCK_REQUESTID_PREFIX = "inlock";
 static const std::string ISLOCK_REQUESTID_PREFIX = "islock";
 
 static const std::string DB_ISLOCK_BY_HASH = "is_i";
@@ -96,13 +97,33 @@ void CInstantSendDb::WriteNewInstantSendLock(const uint256& hash, const CInstant
 {
     LOCK(cs_db);
     CDBBatch batch(*db);
+    WriteNewInstantSendLock(batch, hash, islock);
+    db->WriteBatch(batch);
+}
+
+void CInstantSendDb::WriteNewInstantSendLocks(const std::vector<std::tuple<uint256, CInstantSendLockPtr, int>>& locks)
+{
+    LOCK(cs_db);
+    CDBBatch batch(*db);
+    for (const auto& [hash, islock, nMinedHeight] : locks) {
+        WriteNewInstantSendLock(batch, hash, *islock);
+        if (nMinedHeight != -1) {
+            WriteInstantSendLockMined(batch, hash, nMinedHeight);
+        }
+    }
+    db->WriteBatch(batch);
+}
+
+void CInstantSendDb::WriteNewInstantSendLock(CDBBatch& batch, const uint256& hash, const CInstantSendLock& islock)
+{
+    AssertLockHeld(cs_db);
     batch.Write(std::make_tuple(DB_ISLOCK_BY_HASH, hash), islock);
     batch.Write(std::make_tuple(DB_HASH_BY_TXID, islock.txid), hash);
     for (const auto& in : islock.inputs) {
         batch.Write(std::make_tuple(DB_HASH_BY_OUTPOINT, in), hash);
     }
-    db->WriteBatch(batch);
 
+    // the caches are updated before the batch is written, which is fine as cs_db is held until then
     auto p = std::make_shared<CInstantSendLock>(islock);
     islockCache.insert(hash, p);
     txidCache.insert(islock.txid, hash);
@@ -314,6 +335,16 @@ size_t CInstantSendDb::GetInstantSendLockCount() const
     return cnt;
 }
 
+std::map<std::string, unordered_lru_cache_stats> CInstantSendDb::GetCacheStats() const
+{
+    LOCK(cs_db);
+    return {
+        {"islock", islockCache.stats()},
+        {"txid", txidCache.stats()},
+        {"outpoint", outpointCache.stats()},
+    };
+}
+
 CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByHashInternal(const uint256& hash, bool use_cache) const
 {
     AssertLockHeld(cs_db);
@@ -849,65 +880,110 @@ bool CInstantSendLock::TriviallyValid() const
     return true;
 }
 
-bool CInstantSendManager::ProcessPendingInstantSendLocks()
+bool SelectPendingInstantSendLocks(PendingInstantSendLocks& pending, PendingInstantSendLocks& batch, size_t maxCount, bool fDeterministicActive)
 {
-    const CBlockIndex* pBlockIndexTip = WITH_LOCK(cs_main, return ::ChainActive().Tip());
-    if (pBlockIndexTip && utils::GetInstantSendLLMQType(qman, pBlockIndexTip) == Params().GetConsensus().llmqTypeDIP0024InstantSend) {
-        // Don't short circuit. Try to process deterministic and not deterministic islocks
-        return ProcessPendingInstantSendLocks(true) & ProcessPendingInstantSendLocks(false);
-    } else {
-        return ProcessPendingInstantSendLocks(false);
+    bool fMoreWork{false};
+    std::unordered_set<uint256, StaticSaltedHasher> txids;
+    for (const auto& [_, p] : batch) {
+        txids.emplace(p.second->txid);
     }
+
+    for (auto it = pending.begin(); it != pending.end(); ) {
+        const auto& islock = it->second.second;
+        if (batch.size() >= maxCount) {
+            fMoreWork = true;
+            break;
+        }
+        // Check if we care about this islock on this run
+        if (islock->IsDeterministic() && !fDeterministicActive) {
+            ++it;
+            continue;
+        }
+        if (!txids.emplace(islock->txid).second) {
+            fMoreWork = true;
+            ++it;
+            continue;
+        }
+        batch.emplace(it->first, std::move(it->second));
+        it = pending.erase(it);
+    }
+    return fMoreWork;
 }
 
-bool CInstantSendManager::ProcessPendingInstantSendLocks(bool deterministic)
+bool RetryPendingInstantSendLock(RetriedInstantSendLocks& retried, const uint256& hash, int maxRetries, size_t maxCount)
 {
-    decltype(pendingInstantSendLocks) pend;
-    bool fMoreWork{false};
+    auto it = retried.find(hash);
+    if (it == retried.end()) {
+        if (retried.size() >= maxCount) {
+            return false;
+        }
+        it = retried.emplace(hash, 0).first;
+    }
+    if (it->second >= maxRetries) {
+        return false;
+    }
+    it->second++;
+    return true;
+}
 
+bool CInstantSendManager::ProcessPendingInstantSendLocks()
+{
     if (!IsInstantSendEnabled()) {
         return false;
     }
 
-    {
-        LOCK(cs_pendingLocks);
-        // only process a max 32 locks at a time to avoid duplicate verification of recovered signatures which have been
-        // verified by CSigningManager in parallel
-        const size_t maxCount = 32;
-        // The keys of the removed values are temporaily stored here to avoid invalidating an iterator
-        std::vector<uint256> removed;
-        removed.reserve(maxCount);
-
-        for (const auto& [islockHash, nodeid_islptr_pair] : pendingInstantSendLocks) {
-            const auto& [_, islock_ptr] = nodeid_islptr_pair;
-            // Check if we've reached max count
-            if (pend.size() >= maxCount) {
-                fMoreWork = true;
-                break;
+    // Deterministic islocks are only processed once DIP0024 InstantSend quorums are active. Locks of both kinds are
+    // verified in the same batch
+    const CBlockIndex* pBlockIndexTip = WITH_LOCK(cs_main, return ::ChainActive().Tip());
+    const bool fDeterministicActive = pBlockIndexTip && utils::GetInstantSendLLMQType(qman, pBlockIndexTip) == Params().GetConsensus().llmqTypeDIP0024InstantSend;
+
+    // only process a max 32 locks at a time to avoid duplicate verification of recovered signatures which have been
+    // verified by CSigningManager in parallel
+    PendingInstantSendLocks pend;
+    const bool fMoreWork = WITH_LOCK(cs_pendingLocks, return SelectPendingInstantSendLocks(pendingInstantSendLocks, pend, 32, fDeterministicActive));
+
+    // Don't waste time on verifying locks which would be ignored anyway, either because we already know them or
+    // because their TX is already locked by a deterministic islock
+    std::vector<std::pair<uint256, CInstantSendLockPtr>> skipped;
+    for (auto it = pend.begin(); it != pend.end(); ) {
+        const auto& islock = it->second.second;
+        bool fSkip = db.KnownInstantSendLock(it->first);
+        if (!fSkip) {
+            const auto sameTxIsLock = db.GetInstantSendLockByTxid(islock->txid);
+            if (sameTxIsLock != nullptr && sameTxIsLock->IsDeterministic()) {
+                LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txid=%s, islock=%s: skipping islock, TX is already locked by islock %s, peer=%d\n", __func__,
+                         islock->txid.ToString(), it->first.ToString(), ::SerializeHash(*sameTxIsLock).ToString(), it->second.first);
+                fSkip = true;
             }
-            // Check if we care about this islock on this run
-            if (islock_ptr->IsDeterministic() != deterministic) {
-                continue;
+        }
+        if (fSkip) {
+            skipped.emplace_back(it->first, islock);
+            it = pend.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!skipped.empty()) {
+        {
+            LOCK(cs_pendingLocks);
+            for (const auto& [hash, _] : skipped) {
+                retriedInstantSendLocks.erase(hash);
             }
-            pend.emplace(islockHash, std::move(nodeid_islptr_pair));
-            removed.emplace_back(islockHash);
         }
-
-        for (const auto& islockHash : removed) {
-            pendingInstantSendLocks.erase(islockHash);
+        LOCK(cs_creating);
+        for (const auto& [_, islock] : skipped) {
+            creatingInstantSendLocks.erase(islock->GetRequestId());
+            txToCreatingInstantSendLocks.erase(islock->txid);
         }
+        llmqMetrics.Inc("instantsend.skipped", skipped.size());
     }
 
     if (pend.empty()) {
-        return false;
+        return fMoreWork;
     }
 
-    //TODO Investigate if leaving this is ok
-    auto llmqType = utils::GetInstantSendLLMQType(deterministic);
-    auto dkgInterval = GetLLMQParams(llmqType).dkgInterval;
-
     // First check against the current active set and don't ban
-    auto badISLocks = ProcessPendingInstantSendLocks(llmqType, 0, pend, false);
+    auto badISLocks = ProcessPendingInstantSendLocks(pend, false);
     if (!badISLocks.empty()) {
         LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- doing verification on old active set\n", __func__);
 
@@ -920,25 +996,61 @@ bool CInstantSendManager::ProcessPendingInstantSendLocks(bool deterministic)
             }
         }
         // Now check against the previous active set and perform banning if this fails
-        ProcessPendingInstantSendLocks(llmqType, dkgInterval, pend, true);
+        ProcessPendingInstantSendLocks(pend, true);
     }
 
     return fMoreWork;
 }
 
-std::unordered_set<uint256, StaticSaltedHasher> CInstantSendManager::ProcessPendingInstantSendLocks(const Consensus::LLMQType llmqType, int signOffset, const std::unordered_map<uint256, std::pair<NodeId, CInstantSendLockPtr>, StaticSaltedHasher>& pend, bool ban)
+std::unordered_set<uint256, StaticSaltedHasher> CInstantSendManager::ProcessPendingInstantSendLocks(const PendingInstantSendLocks& pend, bool ban)
 {
-    CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, true, 8);
+    CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, true, 8, &blsWorker);
     std::unordered_map<uint256, CRecoveredSig, StaticSaltedHasher> recSigs;
 
+    // Resolve the signing heights of all locks while holding cs_main only once. Locks without an entry reference an
+    // unknown cycle
+    std::unordered_map<uint256, int, StaticSaltedHasher> signHeights;
+    {
+        LOCK(cs_main);
+        const int nTipHeight = ::ChainActive().Height();
+        for (const auto& [hash, p] : pend) {
+            const auto& islock = p.second;
+            if (!islock->IsDeterministic()) {
+                signHeights.emplace(hash, nTipHeight);
+                continue;
+            }
+
+            const auto blockIndex = LookupBlockIndex(islock->cycleHash);
+            if (blockIndex == nullptr) {
+                continue;
+            }
+
+            const auto dkgInterval = GetLLMQParams(utils::GetInstantSendLLMQType(true)).dkgInterval;
+            if (blockIndex->nHeight + dkgInterval < nTipHeight) {
+                signHeights.emplace(hash, blockIndex->nHeight + dkgInterval - 1);
+            } else {
+                signHeights.emplace(hash, nTipHeight);
+            }
+        }
+    }
+
+    // Most locks of a batch are signed at the same height, so the quorums are only scanned once per LLMQ type and height
+    std::map<std::pair<Consensus::LLMQType, int>, CSigningQuorums> signingQuorums;
+
+    // Only these are processed after verification
+    std::vector<uint256> toProcess;
+    toProcess.reserve(pend.size());
+    // Locks of peers which already sent an invalid lock and locks of an unknown cycle are not verified in this batch.
+    // They might still be valid, so they are verified again in a later batch, up to MAX_ISLOCK_RETRIES times
+    std::vector<uint256> toRetry;
+
     size_t verifyCount = 0;
     size_t alreadyVerified = 0;
-    for (const auto& p : pend) {
-        const auto& hash = p.first;
-        auto nodeId = p.second.first;
-        const auto& islock = p.second.second;
+    for (const auto& [hash, p] : pend) {
+        const auto& [nodeId, islock] = p;
 
         if (batchVerifier.badSources.count(nodeId)) {
+            toRetry.emplace_back(hash);
             continue;
         }
 
@@ -947,37 +1059,38 @@ std::unordered_set<uint256, StaticSaltedHasher> CInstantSendManager::ProcessPend
             continue;
         }
 
+        const auto llmqType = utils::GetInstantSendLLMQType(islock->IsDeterministic());
         auto id = islock->GetRequestId();
 
         // no need to verify an ISLOCK if we already have verified the recovered sig that belongs to it
         if (sigman.HasRecoveredSig(llmqType, id, islock->txid)) {
             alreadyVerified++;
+            toProcess.emplace_back(hash);
             continue;
         }
 
-        int nSignHeight{-1};
-        if (islock->IsDeterministic()) {
-            LOCK(cs_main);
-
-            const auto blockIndex = LookupBlockIndex(islock->cycleHash);
-            if (blockIndex == nullptr) {
-                batchVerifier.badSources.emplace(nodeId);
-                continue;
-            }
-
-            const auto dkgInterval = GetLLMQParams(llmqType).dkgInterval;
-            if (blockIndex->nHeight + dkgInterval < ::ChainActive().Height()) {
-                nSignHeight = blockIndex->nHeight + dkgInterval - 1;
-            }
+        const auto itSignHeight = signHeights.find(hash);
+        if (itSignHeight == signHeights.end()) {
+            toRetry.emplace_back(hash);
+            continue;
         }
 
-        auto quorum = llmq::CSigningManager::SelectQuorumForSigning(llmqType, qman, id, nSignHeight, signOffset);
+        const auto quorumsKey = std::make_pair(llmqType, itSignHeight->second);
+        auto itQuorums = signingQuorums.find(quorumsKey);
+        if (itQuorums == signingQuorums.end()) {
+            const int signOffset = ban ? GetLLMQParams(llmqType).dkgInterval : 0;
+            itQuorums = signingQuorums.emplace(quorumsKey, CSigningManager::GetSigningQuorums(llmqType, qman, itSignHeight->second, signOffset)).first;
+        }
+        auto quorum = itQuorums->second.Select(id);
         if (!quorum) {
-            // should not happen, but if one fails to select, all others will also fail to select
-            return {};
+            // should not happen, but if one fails to select, all others of the same type will also fail to select
+            LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txid=%s, islock=%s: failed to select quorum, peer=%d\n", __func__,
+                     islock->txid.ToString(), hash.ToString(), nodeId);
+            continue;
         }
         uint256 signHash = utils::BuildSignHash(llmqType, quorum->qc->quorumHash, id, islock->txid);
         batchVerifier.PushMessage(nodeId, hash, signHash, islock->sig.Get(), quorum->qc->quorumPublicKey);
+        toProcess.emplace_back(hash);
         verifyCount++;
 
         // We can reconstruct the CRecoveredSig objects from the islock and pass it to the signing manager, which
@@ -994,9 +1107,35 @@ std::unordered_set<uint256, StaticSaltedHasher> CInstantSendManager::ProcessPend
 
     LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- verified locks. count=%d, alreadyVerified=%d, vt=%d, nodes=%d\n", __func__,
             verifyCount, alreadyVerified, verifyTimer.count(), batchVerifier.GetUniqueSourceCount());
+    llmqMetrics.Inc("instantsend.verified", verifyCount);
+    llmqMetrics.Inc("instantsend.invalid", batchVerifier.badMessages.size());
+    llmqMetrics.Timing("instantsend.batchVerifyTime", verifyTimer.count());
 
     std::unordered_set<uint256, StaticSaltedHasher> badISLocks;
 
+    if (!toRetry.empty()) {
+        size_t retryCount = 0;
+        LOCK(cs_pendingLocks);
+        for (const auto& hash : toRetry) {
+            if (RetryPendingInstantSendLock(retriedInstantSendLocks, hash, MAX_ISLOCK_RETRIES, MAX_RETRIED_ISLOCKS)) {
+                pendingInstantSendLocks.try_emplace(hash, pend.at(hash));
+                retryCount++;
+                continue;
+            }
+            // Retried too often or too many locks are retried already. Treat it like an invalid lock, so that its
+            // peer gets punished in the ban pass
+            const auto& [nodeId, islock] = pend.at(hash);
+            LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txid=%s, islock=%s: dropping unverified islock, peer=%d\n", __func__,
+                     islock->txid.ToString(), hash.ToString(), nodeId);
+            if (ban) {
+                batchVerifier.badSources.emplace(nodeId);
+            } else {
+                badISLocks.emplace(hash);
+            }
+        }
+        LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- retrying %d locks in a later batch\n", __func__, retryCount);
+    }
+
     if (ban && !batchVerifier.badSources.empty()) {
         LOCK(cs_main);
         for (const auto& nodeId : batchVerifier.badSources) {
@@ -1005,10 +1144,11 @@ std::unordered_set<uint256, StaticSaltedHasher> CInstantSendManager::ProcessPend
             Misbehaving(nodeId, 20);
         }
     }
-    for (const auto& p : pend) {
-        const auto& hash = p.first;
-        auto nodeId = p.second.first;
-        const auto& islock = p.second.second;
+
+    std::vector<std::pair<uint256, std::pair<NodeId, CInstantSendLockPtr>>> validLocks;
+    validLocks.reserve(toProcess.size());
+    for (const auto& hash : toProcess) {
+        const auto& [nodeId, islock] = pend.at(hash);
 
         if (batchVerifier.badMessages.count(hash)) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txid=%s, islock=%s: invalid sig in islock, peer=%d\n", __func__,
@@ -1016,15 +1156,30 @@ std::unordered_set<uint256, StaticSaltedHasher> CInstantSendManager::ProcessPend
             badISLocks.emplace(hash);
             continue;
         }
+        validLocks.emplace_back(hash, std::make_pair(nodeId, islock));
+    }
+
+    // Forget the retries of all locks which are done now. Invalid locks are only done after the ban pass
+    {
+        LOCK(cs_pendingLocks);
+        for (const auto& [hash, _] : pend) {
+            if (!pendingInstantSendLocks.count(hash) && (ban || !badISLocks.count(hash))) {
+                retriedInstantSendLocks.erase(hash);
+            }
+        }
+    }
+
+    ProcessInstantSendLocks(validLocks);
 
-        ProcessInstantSendLock(nodeId, hash, islock);
+    for (const auto& [hash, p] : validLocks) {
+        const auto& [nodeId, islock] = p;
 
         // See comment further on top. We pass a reconstructed recovered sig to the signing manager to avoid
         // double-verification of the sig.
         auto it = recSigs.find(hash);
         if (it != recSigs.end()) {
             auto recSig = std::make_shared<CRecoveredSig>(std::move(it->second));
-            if (!sigman.HasRecoveredSigForId(llmqType, recSig->getId())) {
+            if (!sigman.HasRecoveredSigForId(recSig->getLlmqType(), recSig->getId())) {
                 LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txid=%s, islock=%s: passing reconstructed recSig to signing mgr, peer=%d\n", __func__,
                          islock->txid.ToString(), hash.ToString(), nodeId);
                 sigman.PushReconstructedRecoveredSig(recSig);
@@ -1035,103 +1190,183 @@ std::unordered_set<uint256, StaticSaltedHasher> CInstantSendManager::ProcessPend
     return badISLocks;
 }
 
-void CInstantSendManager::ProcessInstantSendLock(NodeId from, const uint256& hash, const CInstantSendLockPtr& islock)
+void CInstantSendManager::ProcessInstantSendLocks(const std::vector<std::pair<uint256, std::pair<NodeId, CInstantSendLockPtr>>>& locks)
 {
-    LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txid=%s, islock=%s: processing islock, peer=%d\n", __func__,
-             islock->txid.ToString(), hash.ToString(), from);
+    if (locks.empty()) {
+        return;
+    }
+
     {
         LOCK(cs_creating);
-        creatingInstantSendLocks.erase(islock->GetRequestId());
-        txToCreatingInstantSendLocks.erase(islock->txid);
-    }
-    if (db.KnownInstantSendLock(hash)) {
-        return;
+        for (const auto& [_, p] : locks) {
+            const auto& islock = p.second;
+            creatingInstantSendLocks.erase(islock->GetRequestId());
+            txToCreatingInstantSendLocks.erase(islock->txid);
+        }
     }
 
-    uint256 hashBlock;
-    CTransactionRef tx = GetTransaction(/* block_index */ nullptr, &mempool, islock->txid, Params().GetConsensus(), hashBlock);
-    const CBlockIndex* pindexMined{nullptr};
-    // we ignore failure here as we must be able to propagate the lock even if we don't have the TX locally
-    if (tx && !hashBlock.IsNull()) {
-        pindexMined = WITH_LOCK(cs_main, return LookupBlockIndex(hashBlock));
-
-        // Let's see if the TX that was locked by this islock is already mined in a ChainLocked block. If yes,
-        // we can simply ignore the islock, as the ChainLock implies locking of all TXs in that chain
-        if (pindexMined != nullptr && clhandler.HasChainLock(pindexMined->nHeight, pindexMined->GetBlockHash())) {
-            LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txlock=%s, islock=%s: dropping islock as it already got a ChainLock in block %s, peer=%d\n", __func__,
-                     islock->txid.ToString(), hash.ToString(), hashBlock.ToString(), from);
-            return;
+    // Look up the TXs of all locks in the mempool at once. Only the ones that are not in the mempool have to be
+    // looked up in the blocks
+    std::vector<CTransactionRef> txs(locks.size());
+    {
+        LOCK(mempool.cs);
+        for (const auto i : irange::range(locks.size())) {
+            txs[i] = mempool.get(locks[i].second.second->txid);
         }
     }
 
-    const auto sameTxIsLock = db.GetInstantSendLockByTxid(islock->txid);
-    if (sameTxIsLock != nullptr) {
-        if (sameTxIsLock->IsDeterministic() == islock->IsDeterministic()) {
-            // shouldn't happen, investigate
-            LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: duplicate islock, other islock=%s, peer=%d\n", __func__,
-                      islock->txid.ToString(), hash.ToString(), ::SerializeHash(*sameTxIsLock).ToString(), from);
+    struct AcceptedLock {
+        const uint256& hash;
+        const CInstantSendLockPtr& islock;
+        CTransactionRef tx;
+        const CBlockIndex* pindexMined;
+    };
+    std::vector<AcceptedLock> accepted;
+    accepted.reserve(locks.size());
+    // All new locks are written in one batch after the loop. This is fine because batches never contain two locks for
+    // the same TX, see ProcessPendingInstantSendLocks()
+    std::vector<std::tuple<uint256, CInstantSendLockPtr, int>> toWrite;
+    toWrite.reserve(locks.size());
+
+    for (const auto i : irange::range(locks.size())) {
+        const auto& [hash, p] = locks[i];
+        const auto& [from, islock] = p;
+
+        LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txid=%s, islock=%s: processing islock, peer=%d\n", __func__,
+                 islock->txid.ToString(), hash.ToString(), from);
+        if (db.KnownInstantSendLock(hash)) {
+            continue;
         }
-        if (sameTxIsLock->IsDeterministic()) {
-            // can happen, nothing to do
-            return;
-        } else if (islock->IsDeterministic()) {
-            // can happen, remove and archive the non-deterministic sameTxIsLock
-            db.RemoveAndArchiveInstantSendLock(sameTxIsLock, WITH_LOCK(::cs_main, return ::ChainActive().Height()));
+
+        CTransactionRef tx = txs[i];
+        const CBlockIndex* pindexMined{nullptr};
+        if (tx == nullptr) {
+            uint256 hashBlock;
+            tx = GetTransaction(/* block_index */ nullptr, /* mempool */ nullptr, islock->txid, Params().GetConsensus(), hashBlock);
+            // we ignore failure here as we must be able to propagate the lock even if we don't have the TX locally
+            if (tx && !hashBlock.IsNull()) {
+                pindexMined = WITH_LOCK(cs_main, return LookupBlockIndex(hashBlock));
+
+                // Let's see if the TX that was locked by this islock is already mined in a ChainLocked block. If yes,
+                // we can simply ignore the islock, as the ChainLock implies locking of all TXs in that chain
+                if (pindexMined != nullptr && clhandler.HasChainLock(pindexMined->nHeight, pindexMined->GetBlockHash())) {
+                    LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- txlock=%s, islock=%s: dropping islock as it already got a ChainLock in block %s, peer=%d\n", __func__,
+                             islock->txid.ToString(), hash.ToString(), hashBlock.ToString(), from);
+                    continue;
+                }
+            }
         }
-    } else {
-        for (const auto& in : islock->inputs) {
-            const auto sameOutpointIsLock = db.GetInstantSendLockByInput(in);
-            if (sameOutpointIsLock != nullptr) {
-                LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: conflicting outpoint in islock. input=%s, other islock=%s, peer=%d\n", __func__,
-                          islock->txid.ToString(), hash.ToString(), in.ToStringShort(), ::SerializeHash(*sameOutpointIsLock).ToString(), from);
+
+        const auto sameTxIsLock = db.GetInstantSendLockByTxid(islock->txid);
+        if (sameTxIsLock != nullptr) {
+            if (sameTxIsLock->IsDeterministic() == islock->IsDeterministic()) {
+                // shouldn't happen, investigate
+                LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: duplicate islock, other islock=%s, peer=%d\n", __func__,
+                          islock->txid.ToString(), hash.ToString(), ::SerializeHash(*sameTxIsLock).ToString(), from);
+            }
+            if (sameTxIsLock->IsDeterministic()) {
+                // can happen, nothing to do
+                continue;
+            } else if (islock->IsDeterministic()) {
+                // can happen, remove and archive the non-deterministic sameTxIsLock
+                db.RemoveAndArchiveInstantSendLock(sameTxIsLock, WITH_LOCK(::cs_main, return ::ChainActive().Height()));
+            }
+        } else {
+            for (const auto& in : islock->inputs) {
+                const auto sameOutpointIsLock = db.GetInstantSendLockByInput(in);
+                if (sameOutpointIsLock != nullptr) {
+                    LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: conflicting outpoint in islock. input=%s, other islock=%s, peer=%d\n", __func__,
+                              islock->txid.ToString(), hash.ToString(), in.ToStringShort(), ::SerializeHash(*sameOutpointIsLock).ToString(), from);
+                }
             }
         }
-    }
 
-    if (tx == nullptr) {
-        // put it in a separate pending map and try again later
-        LOCK(cs_pendingLocks);
-        pendingNoTxInstantSendLocks.try_emplace(hash, std::make_pair(from, islock));
-    } else {
-        db.WriteNewInstantSendLock(hash, *islock);
-        if (pindexMined) {
-            db.WriteInstantSendLockMined(hash, pindexMined->nHeight);
+        if (tx == nullptr) {
+            // put it in a separate pending map and try again later
+            LOCK(cs_pendingLocks);
+            pendingNoTxInstantSendLocks.try_emplace(hash, std::make_pair(from, islock));
+        } else {
+            toWrite.emplace_back(hash, islock, pindexMined ? pindexMined->nHeight : -1);
         }
+        accepted.push_back({hash, islock, tx, pindexMined});
     }
 
-    // This will also add children TXs to pendingRetryTxs
-    RemoveNonLockedTx(islock->txid, true);
-    // We don't need the recovered sigs for the inputs anymore. This prevents unnecessary propagation of these sigs.
-    // We only need the ISLOCK from now on to detect conflicts
-    TruncateRecoveredSigsForInputs(*islock);
+    db.WriteNewInstantSendLocks(toWrite);
 
-    const auto is_det = islock->IsDeterministic();
-    CInv inv(is_det ? MSG_ISDLOCK : MSG_ISLOCK, hash);
-    if (tx != nullptr) {
-        connman.RelayInvFiltered(inv, *tx, is_det ? ISDLOCK_PROTO_VERSION : MIN_PEER_PROTO_VERSION);
-    } else {
-        // we don't have the TX yet, so we only filter based on txid. Later when that TX arrives, we will re-announce
-        // with the TX taken into account.
-        connman.RelayInvFiltered(inv, islock->txid, is_det ? ISDLOCK_PROTO_VERSION : MIN_PEER_PROTO_VERSION);
+    // update the ChainLocks bookkeeping of blocks which include TXs that were not islocked yet
+    std::vector<uint256> lockedTxids;
+    lockedTxids.reserve(toWrite.size());
+    for (const auto& lock : toWrite) {
+        lockedTxids.emplace_back(std::get<1>(lock)->txid);
+    }
+    clhandler.TransactionsLocked(lockedTxids);
+
+    std::vector<std::pair<uint256, CInstantSendLockPtr>> lockedMempoolTxs;
+    for (const auto& [hash, islock, tx, pindexMined] : accepted) {
+        if (tx != nullptr && pindexMined == nullptr) {
+            int64_t timeAdded{0};
+            {
+                LOCK(cs_nonLocked);
+                auto it = nonLockedTxs.find(islock->txid);
+                if (it != nonLockedTxs.end()) {
+                    timeAdded = it->second.timeAdded;
+                }
+            }
+            if (timeAdded != 0) {
+                llmqMetrics.Timing("instantsend.timeToLock", GetTimeMillis() - timeAdded);
+            }
+        }
+
+        // This will also add children TXs to pendingRetryTxs
+        RemoveNonLockedTx(islock->txid, true);
+        // We don't need the recovered sigs for the inputs anymore. This prevents unnecessary propagation of these sigs.
+        // We only need the ISLOCK from now on to detect conflicts
+        TruncateRecoveredSigsForInputs(*islock);
+
+        const auto is_det = islock->IsDeterministic();
+        CInv inv(is_det ? MSG_ISDLOCK : MSG_ISLOCK, hash);
+        if (tx != nullptr) {
+            connman.RelayInvFiltered(inv, *tx, is_det ? ISDLOCK_PROTO_VERSION : MIN_PEER_PROTO_VERSION);
+        } else {
+            // we don't have the TX yet, so we only filter based on txid. Later when that TX arrives, we will re-announce
+            // with the TX taken into account.
+            connman.RelayInvFiltered(inv, islock->txid, is_det ? ISDLOCK_PROTO_VERSION : MIN_PEER_PROTO_VERSION);
+        }
+
+        ResolveBlockConflicts(hash, *islock);
+
+        if (tx != nullptr) {
+            lockedMempoolTxs.emplace_back(hash, islock);
+        }
     }
 
-    ResolveBlockConflicts(hash, *islock);
+    // block assembly uses the lock state of the mempool entries
+    RemoveMempoolConflictsForLocks(lockedMempoolTxs, true);
 
-    if (tx != nullptr) {
-        RemoveMempoolConflictsForLock(hash, *islock);
-        LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- notify about lock %s for tx %s\n", __func__,
-                hash.ToString(), tx->GetHash().ToString());
-        GetMainSignals().NotifyTransactionLock(tx, islock);
-        // bump mempool counter to make sure newly locked txes are picked up by getblocktemplate
-        mempool.AddTransactionsUpdated(1);
-    } else {
-        AskNodesForLockedTx(islock->txid, connman);
+    for (const auto& [hash, islock, tx, _] : accepted) {
+        if (tx != nullptr) {
+            LogPrint(BCLog::INSTANTSEND, "CInstantSendManager::%s -- notify about lock %s for tx %s\n", __func__,
+                    hash.ToString(), tx->GetHash().ToString());
+            GetMainSignals().NotifyTransactionLock(tx, islock);
+        } else {
+            AskNodesForLockedTx(islock->txid, connman);
+        }
     }
 }
 
 void CInstantSendManager::TransactionAddedToMempool(const CTransactionRef& tx)
 {
-    if (!IsInstantSendEnabled() || !m_mn_sync->IsBlockchainSynced() || tx->vin.empty()) {
+    if (!IsInstantSendEnabled() || tx->vin.empty()) {
+        return;
+    }
+
+    if (IsLocked(tx->GetHash())) {
+        // locked before, e.g. a TX of a disconnected block or one loaded from mempool.dat
+        LOCK(mempool.cs);
+        mempool.SetInstantSendLocked(tx->GetHash());
+    }
+
+    if (!m_mn_sync->IsBlockchainSynced()) {
         return;
     }
 
@@ -1158,7 +1393,7 @@ void CInstantSendManager::TransactionAddedToMempool(const CTransactionRef& tx)
         // TX is not locked, so make sure it is tracked
         AddNonLockedTx(tx, nullptr);
     } else {
-        RemoveMempoolConflictsForLock(::SerializeHash(*islock), *islock);
+        RemoveMempoolConflictsForLocks({{::SerializeHash(*islock), islock}});
     }
 }
 
@@ -1226,6 +1461,7 @@ void CInstantSendManager::AddNonLockedTx(const CTransactionRef& tx, const CBlock
 
         if (did_insert) {
             nonLockedTxInfo.tx = tx;
+            nonLockedTxInfo.timeAdded = GetTimeMillis();
             for (const auto &in: tx->vin) {
                 nonLockedTxs[in.prevout.hash].children.emplace(tx->GetHash());
                 nonLockedTxsByOutpoints.emplace(in.prevout, tx->GetHash());
@@ -1381,36 +1617,57 @@ void CInstantSendManager::HandleFullyConfirmedBlock(const CBlockIndex* pindex)
     }
 }
 
-void CInstantSendManager::RemoveMempoolConflictsForLock(const uint256& hash, const CInstantSendLock& islock)
+void CInstantSendManager::RemoveMempoolConflictsForLocks(const std::vector<std::pair<uint256, CInstantSendLockPtr>>& locks, bool fLocked)
 {
+    if (locks.empty()) {
+        return;
+    }
+
     std::unordered_map<uint256, CTransactionRef, StaticSaltedHasher> toDelete;
+    // TXs of locks which had conflicts
+    std::vector<uint256> conflictedLockTxids;
 
     {
         LOCK(mempool.cs);
 
-        for (const auto& in : islock.inputs) {
-            auto it = mempool.mapNextTx.find(in);
-            if (it == mempool.mapNextTx.end()) {
-                continue;
-            }
-            if (it->second->GetHash() != islock.txid) {
-                toDelete.emplace(it->second->GetHash(), mempool.get(it->second->GetHash()));
+        for (const auto& [hash, islock] : locks) {
+            bool fConflicted{false};
+            for (const auto& in : islock->inputs) {
+                auto it = mempool.mapNextTx.find(in);
+                if (it == mempool.mapNextTx.end()) {
+                    continue;
+                }
+                if (it->second->GetHash() != islock->txid) {
+                    toDelete.emplace(it->second->GetHash(), mempool.get(it->second->GetHash()));
+                    fConflicted = true;
 
-                LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: mempool TX %s with input %s conflicts with islock\n", __func__,
-                         islock.txid.ToString(), hash.ToString(), it->second->GetHash().ToString(), in.ToStringShort());
+                    LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: mempool TX %s with input %s conflicts with islock\n", __func__,
+                             islock->txid.ToString(), hash.ToString(), it->second->GetHash().ToString(), in.ToStringShort());
+                }
+            }
+            if (fConflicted) {
+                conflictedLockTxids.emplace_back(islock->txid);
             }
         }
 
         for (const auto& p : toDelete) {
             mempool.removeRecursive(*p.second, MemPoolRemovalReason::CONFLICT);
         }
-    }
 
-    if (!toDelete.empty()) {
-        for (const auto& p : toDelete) {
-            RemoveConflictedTx(*p.second);
+        if (fLocked) {
+            for (const auto& [_, islock] : locks) {
+                mempool.SetInstantSendLocked(islock->txid);
+            }
+            // bump mempool counter to make sure newly locked txes are picked up by getblocktemplate
+            mempool.AddTransactionsUpdated(1);
         }
-        AskNodesForLockedTx(islock.txid, connman);
+    }
+
+    for (const auto& p : toDelete) {
+        RemoveConflictedTx(*p.second);
+    }
+    for (const auto& txid : conflictedLockTxids) {
+        AskNodesForLockedTx(txid, connman);
     }
 }
 
@@ -1713,6 +1970,24 @@ size_t CInstantSendManager::GetInstantSendLockCount() const
     return db.GetInstantSendLockCount();
 }
 
+std::map<std::string, unordered_lru_cache_stats> CInstantSendManager::GetCacheStats() const
+{
+    return db.GetCacheStats();
+}
+
+std::map<std::string, int64_t> CInstantSendManager::GetMetricGauges() const
+{
+    std::map<std::string, int64_t> ret;
+    {
+        LOCK(cs_pendingLocks);
+        ret.emplace("pendingLocks", pendingInstantSendLocks.size());
+        ret.emplace("pendingNoTxLocks", pendingNoTxInstantSendLocks.size());
+    }
+    ret.emplace("creatingLocks", WITH_LOCK(cs_creating, return creatingInstantSendLocks.size()));
+    ret.emplace("nonLockedTxs", WITH_LOCK(cs_nonLocked, return nonLockedTxs.size()));
+    return ret;
+}
+
 void CInstantSendManager::WorkThreadMain()
 {
     while (!workInterrupt) {
@@ -15,9 +15,12 @@
 #include <threadinterrupt.h>
 #include <txmempool.h>
 
+#include <map>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
+class CBLSWorker;
 class CSporkManager;
 class CMasternodeSync;
 
@@ -28,6 +31,8 @@ class CQuorumManager;
 class CSigningManager;
 class CSigSharesManager;
 
+extern const std::string INPUTLOCK_REQUESTID_PREFIX;
+
 struct CInstantSendLock
 {
     // This is the old format of instant send lock, it must be 0
@@ -63,6 +68,27 @@ struct CInstantSendLock
 };
 
 using CInstantSendLockPtr = std::shared_ptr<CInstantSendLock>;
+// IS Lock hash -> (peer it was received from, IS Lock)
+using PendingInstantSendLocks = std::unordered_map<uint256, std::pair<NodeId, CInstantSendLockPtr>, StaticSaltedHasher>;
+
+/**
+ * Moves the next batch of at most maxCount IS Locks from pending to batch. Only one lock per TX is taken, other locks
+ * for the same TX are left for the next batch, as processing them depends on the result of the first one. This way all
+ * locks of a batch can be written to the db in one go. Deterministic IS Locks are left pending until DIP0024
+ * InstantSend quorums are active
+ * @return Whether locks were left pending which could be processed right away
+ */
+bool SelectPendingInstantSendLocks(PendingInstantSendLocks& pending, PendingInstantSendLocks& batch, size_t maxCount, bool fDeterministicActive);
+
+// IS Lock hash -> number of times it was put back into the pending IS Locks
+using RetriedInstantSendLocks = std::unordered_map<uint256, int, StaticSaltedHasher>;
+
+/**
+ * Counts another attempt to verify an IS Lock which could not be verified in its batch. A lock is retried at most
+ * maxRetries times and at most maxCount locks are retried at the same time
+ * @return Whether the lock should be put back into the pending IS Locks. If not, the lock should be dropped
+ */
+bool RetryPendingInstantSendLock(RetriedInstantSendLocks& retried, const uint256& hash, int maxRetries, size_t maxCount);
 
 class CInstantSendDb
 {
@@ -82,6 +108,8 @@ private:
 
     void RemoveInstantSendLockMined(CDBBatch& batch, const uint256& hash, int nHeight) EXCLUSIVE_LOCKS_REQUIRED(cs_db);
 
+    void WriteNewInstantSendLock(CDBBatch& batch, const uint256& hash, const CInstantSendLock& islock) EXCLUSIVE_LOCKS_REQUIRED(cs_db);
+
     /**
      * This method removes a InstantSend Lock from the database and is called when a tx with an IS lock is confirmed and Chainlocked
      * @param batch Object used to batch many calls together
@@ -128,6 +156,12 @@ public:
      * @param islock The InstantSend Lock object itself
      */
     void WriteNewInstantSendLock(const uint256& hash, const CInstantSendLock& islock) LOCKS_EXCLUDED(cs_db);
+    /**
+     * Adds many InstantSend Locks to the database in a single batch
+     * @param locks The hash of each InstantSend Lock, the lock itself and the height its transaction was mined at, or -1
+     * if it's not mined yet
+     */
+    void WriteNewInstantSendLocks(const std::vector<std::tuple<uint256, CInstantSendLockPtr, int>>& locks) LOCKS_EXCLUDED(cs_db);
     /**
      * This method updates a DB entry for an InstantSend Lock from being not included in a block to being included in a block
      * @param hash The hash of the InstantSend Lock
@@ -153,6 +187,11 @@ public:
      * @return size_t value of the number of IS Locks not confirmed by a block
      */
     size_t GetInstantSendLockCount() const LOCKS_EXCLUDED(cs_db);
+    /**
+     * Gets hit/miss/eviction counters of the in-memory caches
+     * @return Counters keyed by cache name
+     */
+    std::map<std::string, unordered_lru_cache_stats> GetCacheStats() const LOCKS_EXCLUDED(cs_db);
     /**
      * Gets a pointer to the IS Lock based on the hash
      * @param hash The hash of the IS Lock
@@ -203,6 +242,7 @@ class CInstantSendManager : public CRecoveredSigsListener
 private:
     CInstantSendDb db;
     CConnman& connman;
+    CBLSWorker& blsWorker;
     CTxMemPool& mempool;
     CSporkManager& spork_manager;
     CQuorumManager& qman;
@@ -237,9 +277,14 @@ private:
 
     mutable Mutex cs_pendingLocks;
     // Incoming and not verified yet
-    std::unordered_map<uint256, std::pair<NodeId, CInstantSendLockPtr>, StaticSaltedHasher> pendingInstantSendLocks GUARDED_BY(cs_pendingLocks);
+    PendingInstantSendLocks pendingInstantSendLocks GUARDED_BY(cs_pendingLocks);
     // Tried to verify but there is no tx yet
-    std::unordered_map<uint256, std::pair<NodeId, CInstantSendLockPtr>, StaticSaltedHasher> pendingNoTxInstantSendLocks GUARDED_BY(cs_pendingLocks);
+    PendingInstantSendLocks pendingNoTxInstantSendLocks GUARDED_BY(cs_pendingLocks);
+    // Could not be verified yet and were put back into pendingInstantSendLocks
+    RetriedInstantSendLocks retriedInstantSendLocks GUARDED_BY(cs_pendingLocks);
+
+    static constexpr int MAX_ISLOCK_RETRIES{50};
+    static constexpr size_t MAX_RETRIED_ISLOCKS{1000};
 
     // TXs which are neither IS locked nor ChainLocked. We use this to determine for which TXs we need to retry IS locking
     // of child TXs
@@ -247,6 +292,8 @@ private:
         const CBlockIndex* pindexMined;
         CTransactionRef tx;
         std::unordered_set<uint256, StaticSaltedHasher> children;
+        // when the TX was first added, used to measure the time it took to get locked
+        int64_t timeAdded{0};
     };
 
     mutable Mutex cs_nonLocked;
@@ -257,10 +304,10 @@ private:
     std::unordered_set<uint256, StaticSaltedHasher> pendingRetryTxs GUARDED_BY(cs_pendingRetry);
 
 public:
-    explicit CInstantSendManager(CTxMemPool& _mempool, CConnman& _connman, CSporkManager& sporkManager,
+    explicit CInstantSendManager(CTxMemPool& _mempool, CConnman& _connman, CBLSWorker& _blsWorker, CSporkManager& sporkManager,
                                  CQuorumManager& _qman, CSigningManager& _sigman, CSigSharesManager& _shareman,
                                  CChainLocksHandler& _clhandler, const std::unique_ptr<CMasternodeSync>& mn_sync, bool unitTests, bool fWipe) :
-        db(unitTests, fWipe), mempool(_mempool), connman(_connman), spork_manager(sporkManager), qman(_qman), sigman(_sigman), shareman(_shareman),
+        db(unitTests, fWipe), connman(_connman), blsWorker(_blsWorker), mempool(_mempool), spork_manager(sporkManager), qman(_qman), sigman(_sigman), shareman(_shareman),
         clhandler(_clhandler), m_mn_sync(mn_sync)
     {
         workInterrupt.reset();
@@ -284,23 +331,30 @@ private:
     void TrySignInstantSendLock(const CTransaction& tx) LOCKS_EXCLUDED(cs_creating);
 
     void ProcessMessageInstantSendLock(const CNode* pfrom, const CInstantSendLockPtr& islock);
-    bool ProcessPendingInstantSendLocks();
-    bool ProcessPendingInstantSendLocks(bool deterministic) LOCKS_EXCLUDED(cs_pendingLocks);
+    bool ProcessPendingInstantSendLocks() LOCKS_EXCLUDED(cs_pendingLocks);
 
-    std::unordered_set<uint256, StaticSaltedHasher> ProcessPendingInstantSendLocks(const Consensus::LLMQType llmqType,
-                                                                                   int signOffset,
-                                                                                   const std::unordered_map<uint256,
-                                                                                   std::pair<NodeId, CInstantSendLockPtr>,
-                                                                                   StaticSaltedHasher>& pend,
-                                                                                   bool ban) LOCKS_EXCLUDED(cs_pendingLocks);
-    void ProcessInstantSendLock(NodeId from, const uint256& hash, const CInstantSendLockPtr& islock) LOCKS_EXCLUDED(cs_creating, cs_pendingLocks);
+    /**
+     * Verifies a batch of pending IS Locks, which may be signed by quorums of different LLMQ types, and processes the
+     * valid ones
+     * @param pend The IS Locks to verify
+     * @param ban Verify against the previous active quorum set instead of the current one and punish peers which sent
+     * invalid IS Locks
+     * @return The hashes of the IS Locks with invalid signatures. IS Locks which could not be verified in this batch
+     * (e.g. because their peer already sent an invalid one) are put back into pendingInstantSendLocks, at most
+     * MAX_ISLOCK_RETRIES times. Once they can't be retried anymore, they are returned as invalid or, when banning,
+     * dropped and their peers punished
+     */
+    std::unordered_set<uint256, StaticSaltedHasher> ProcessPendingInstantSendLocks(const PendingInstantSendLocks& pend, bool ban) LOCKS_EXCLUDED(cs_pendingLocks);
+    void ProcessInstantSendLocks(const std::vector<std::pair<uint256, std::pair<NodeId, CInstantSendLockPtr>>>& locks) LOCKS_EXCLUDED(cs_creating, cs_pendingLocks);
 
     void AddNonLockedTx(const CTransactionRef& tx, const CBlockIndex* pindexMined) LOCKS_EXCLUDED(cs_pendingLocks, cs_nonLocked);
     void RemoveNonLockedTx(const uint256& txid, bool retryChildren) LOCKS_EXCLUDED(cs_nonLocked, cs_pendingRetry);
     void RemoveConflictedTx(const CTransaction& tx) LOCKS_EXCLUDED(cs_inputReqests);
     void TruncateRecoveredSigsForInputs(const CInstantSendLock& islock) LOCKS_EXCLUDED(cs_inputReqests);
 
-    void RemoveMempoolConflictsForLock(const uint256& hash, const CInstantSendLock& islock);
+    // Removes mempool TXs which conflict with the locks. With fLocked, the TXs of the locks are also marked as locked in
+    // the mempool, all while holding mempool.cs only once
+    void RemoveMempoolConflictsForLocks(const std::vector<std::pair<uint256, CInstantSendLockPtr>>& locks, bool fLocked = false);
     void ResolveBlockConflicts(const uint256& islockHash, const CInstantSendLock& islock) LOCKS_EXCLUDED(cs_pendingLocks, cs_nonLocked);
     static void AskNodesForLockedTx(const uint256& txid, const CConnman& connman);
     void ProcessPendingRetryLockTxs() LOCKS_EXCLUDED(cs_creating, cs_nonLocked, cs_pendingRetry);
@@ -333,6 +387,9 @@ public:
     void RemoveConflictingLock(const uint256& islockHash, const CInstantSendLock& islock);
 
     size_t GetInstantSendLockCount() const;
+    std::map<std::string, unordered_lru_cache_stats> GetCacheStats() const;
+    // current queue depths, see CollectLLMQGauges
+    std::map<std::string, int64_t> GetMetricGauges() const;
 
     bool IsInstantSendEnabled() const;
     /**
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <llmq/metrics.h>
+
+#include <bls/bls_worker.h>
+#include <llmq/chainlocks.h>
+#include <llmq/context.h>
+#include <llmq/instantsend.h>
+#include <llmq/quorums.h>
+#include <llmq/signing_shares.h>
+#include <statsd_client.h>
+
+namespace llmq
+{
+
+CLLMQMetrics llmqMetrics;
+
+void CLLMQMetrics::Inc(const std::string& name, int64_t n)
+{
+    if (n == 0) return;
+    WITH_LOCK(cs, counters[name] += n);
+    statsClient.count("llmq." + name, n, 1.0f);
+}
+
+void CLLMQMetrics::Timing(const std::string& name, int64_t ms)
+{
+    {
+        LOCK(cs);
+        auto& t = timings[name];
+        t.count++;
+        t.total += ms;
+        t.max = std::max(t.max, ms);
+        t.last = ms;
+    }
+    statsClient.timing("llmq." + name, ms, 1.0f);
+}
+
+int64_t CLLMQMetrics::GetCounter(const std::string& name) const
+{
+    LOCK(cs);
+    auto it = counters.find(name);
+    return it != counters.end() ? it->second : 0;
+}
+
+CLLMQMetrics::TimingStats CLLMQMetrics::GetTiming(const std::string& name) const
+{
+    LOCK(cs);
+    auto it = timings.find(name);
+    return it != timings.end() ? it->second : TimingStats{};
+}
+
+UniValue CLLMQMetrics::ToJson() const
+{
+    LOCK(cs);
+    UniValue countersObj(UniValue::VOBJ);
+    for (const auto& [name, value] : counters) {
+        countersObj.pushKV(name, value);
+    }
+    UniValue timingsObj(UniValue::VOBJ);
+    for (const auto& [name, t] : timings) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("count", t.count);
+        obj.pushKV("avg", t.count != 0 ? t.total / (int64_t)t.count : 0);
+        obj.pushKV("max", t.max);
+        obj.pushKV("last", t.last);
+        timingsObj.pushKV(name, obj);
+    }
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("counters", countersObj);
+    ret.pushKV("timings", timingsObj);
+    return ret;
+}
+
+std::map<std::string, int64_t> CollectLLMQGauges(const LLMQContext& llmq_ctx)
+{
+    std::map<std::string, int64_t> ret;
+    const auto add = [&ret](const std::string& prefix, const std::map<std::string, int64_t>& gauges) {
+        for (const auto& [name, value] : gauges) {
+            ret.emplace(prefix + name, value);
+        }
+    };
+
+    add("sigshares.", llmq_ctx.shareman->GetMetricGauges());
+    add("instantsend.", llmq_ctx.isman->GetMetricGauges());
+    add("quorums.", llmq_ctx.qman->GetMetricGauges());
+
+    const auto blsStats = llmq_ctx.bls_worker->GetSigVerifyStats();
+    ret.emplace("bls.sigVerifyQueue", blsStats.queued);
+    ret.emplace("bls.sigVerifyBatches", blsStats.batches);
+    ret.emplace("bls.sigVerifySigs", blsStats.sigs);
+    ret.emplace("bls.sigVerifyFallbacks", blsStats.fallbacks);
+    ret.emplace("bls.sigVerifyTimeMs", blsStats.timeMs);
+
+    ret.emplace("chainlocks.bestChainLockHeight", llmq_ctx.clhandler->GetBestChainLock().getHeight());
+
+    return ret;
+}
+
+} // namespace llmq
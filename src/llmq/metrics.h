@@ -0,0 +1,57 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_LLMQ_METRICS_H
+#define BITCOIN_LLMQ_METRICS_H
+
+#include <sync.h>
+#include <univalue.h>
+
+#include <map>
+#include <string>
+
+struct LLMQContext;
+
+namespace llmq
+{
+
+/**
+ * Counters and timings of the signing pipeline (sig shares, recovery, InstantSend, ChainLocks and DKG). Every update is
+ * forwarded to statsd with a "llmq." prefix and also accumulated here, so that it can be queried via "quorum metrics".
+ * Queue depths are not pushed but collected on demand, see CollectLLMQGauges().
+ */
+class CLLMQMetrics
+{
+public:
+    struct TimingStats {
+        uint64_t count{0};
+        int64_t total{0};
+        int64_t max{0};
+        int64_t last{0};
+    };
+
+private:
+    mutable Mutex cs;
+    std::map<std::string, int64_t> counters GUARDED_BY(cs);
+    std::map<std::string, TimingStats> timings GUARDED_BY(cs);
+
+public:
+    void Inc(const std::string& name, int64_t n = 1);
+    // duration in milliseconds
+    void Timing(const std::string& name, int64_t ms);
+
+    int64_t GetCounter(const std::string& name) const;
+    TimingStats GetTiming(const std::string& name) const;
+
+    UniValue ToJson() const;
+};
+
+extern CLLMQMetrics llmqMetrics;
+
+// Current queue depths and sizes of all LLMQ subsystems, keyed by the same kind of names as used by CLLMQMetrics
+std::map<std::string, int64_t> CollectLLMQGauges(const LLMQContext& llmq_ctx);
+
+} // namespace llmq
+
+#endif // BITCOIN_LLMQ_METRICS_H
@@ -81,6 +81,12 @@ void CQuorum::Init(CFinalCommitmentPtr _qc, const CBlockIndex* _pQuorumBaseBlock
     m_quorum_base_block_index = _pQuorumBaseBlockIndex;
     members = _members;
     minedBlockHash = _minedBlockHash;
+
+    memberIds.clear();
+    memberIds.reserve(members.size());
+    for (const auto& dmn : members) {
+        memberIds.emplace_back(dmn->proTxHash);
+    }
 }
 
 bool CQuorum::SetVerificationVector(const BLSVerificationVector& quorumVecIn)
@@ -129,8 +135,52 @@ CBLSPublicKey CQuorum::GetPubKeyShare(size_t memberIdx) const
     if (!HasVerificationVector() || memberIdx >= members.size() || !qc->validMembers[memberIdx]) {
         return CBLSPublicKey();
     }
-    const auto& m = members[memberIdx];
-    return blsCache.BuildPubKeyShare(m->proTxHash, quorumVvec, CBLSId(m->proTxHash));
+    return blsCache.BuildPubKeyShare(members[memberIdx]->proTxHash, quorumVvec, memberIds[memberIdx]);
+}
+
+std::shared_ptr<const CBLSLagrangeCoefficients> CQuorum::GetLagrangeCoefficients(const std::vector<uint16_t>& memberIndexes) const
+{
+    const uint256 key = ::SerializeHash(memberIndexes);
+
+    std::shared_ptr<const CBLSLagrangeCoefficients> ret;
+    if (WITH_LOCK(cs_coefficients, return coefficientsCache.get(key, ret))) {
+        return ret;
+    }
+
+    std::vector<CBLSId> ids;
+    ids.reserve(memberIndexes.size());
+    for (const auto idx : memberIndexes) {
+        if (idx >= memberIds.size()) {
+            return nullptr;
+        }
+        ids.emplace_back(memberIds[idx]);
+    }
+
+    // computed without holding the lock, at worst two threads compute the same coefficients
+    auto coefficients = std::make_shared<CBLSLagrangeCoefficients>();
+    if (!coefficients->Compute(ids)) {
+        return nullptr;
+    }
+
+    LOCK(cs_coefficients);
+    coefficientsCache.insert(key, coefficients);
+    return coefficients;
+}
+
+unordered_lru_cache_stats CQuorum::GetLagrangeCoefficientsCacheStats() const
+{
+    LOCK(cs_coefficients);
+    return coefficientsCache.stats();
+}
+
+size_t CQuorum::GetLagrangeCoefficientsCacheSize(size_t& retMemoryUsage) const
+{
+    LOCK(cs_coefficients);
+    retMemoryUsage = 0;
+    coefficientsCache.for_each([&retMemoryUsage](const uint256&, const std::shared_ptr<const CBLSLagrangeCoefficients>& coefficients) {
+        retMemoryUsage += coefficients->DynamicMemoryUsage();
+    });
+    return coefficientsCache.size();
 }
 
 bool CQuorum::HasVerificationVector() const {
@@ -482,6 +532,61 @@ bool CQuorumManager::RequestQuorumData(CNode* pFrom, Consensus::LLMQType llmqTyp
     return true;
 }
 
+std::map<std::string, unordered_lru_cache_stats> CQuorumManager::GetCacheStats() const
+{
+    const auto sum = [](const auto& caches) {
+        unordered_lru_cache_stats ret;
+        for (const auto& p : caches) {
+            ret.hits += p.second.stats().hits;
+            ret.misses += p.second.stats().misses;
+            ret.evictions += p.second.stats().evictions;
+        }
+        return ret;
+    };
+    std::map<std::string, unordered_lru_cache_stats> ret;
+    ret.emplace("quorums", WITH_LOCK(cs_map_quorums, return sum(mapQuorumsCache)));
+    ret.emplace("scanQuorums", WITH_LOCK(cs_scan_quorums, return sum(scanQuorumsCache)));
+
+    unordered_lru_cache_stats coefficients;
+    for (const auto& quorum : GetCachedQuorums()) {
+        const auto stats = quorum->GetLagrangeCoefficientsCacheStats();
+        coefficients.hits += stats.hits;
+        coefficients.misses += stats.misses;
+        coefficients.evictions += stats.evictions;
+    }
+    ret.emplace("lagrangeCoefficients", coefficients);
+    return ret;
+}
+
+std::map<std::string, int64_t> CQuorumManager::GetMetricGauges() const
+{
+    const auto quorums = GetCachedQuorums();
+    size_t coefficients{0};
+    size_t coefficientsMemory{0};
+    for (const auto& quorum : quorums) {
+        size_t memoryUsage;
+        coefficients += quorum->GetLagrangeCoefficientsCacheSize(memoryUsage);
+        coefficientsMemory += memoryUsage;
+    }
+    return {
+        {"cached", (int64_t)quorums.size()},
+        {"lagrangeCoefficients", (int64_t)coefficients},
+        {"lagrangeCoefficientsMemory", (int64_t)coefficientsMemory},
+    };
+}
+
+std::vector<CQuorumCPtr> CQuorumManager::GetCachedQuorums() const
+{
+    std::vector<CQuorumCPtr> ret;
+    LOCK(cs_map_quorums);
+    for (const auto& [_, cache] : mapQuorumsCache) {
+        cache.for_each([&ret](const uint256&, const CQuorumPtr& quorum) {
+            ret.emplace_back(quorum);
+        });
+    }
+    return ret;
+}
+
 std::vector<CQuorumCPtr> CQuorumManager::ScanQuorums(Consensus::LLMQType llmqType, size_t nCountRequested) const
 {
     const CBlockIndex* pindex = WITH_LOCK(cs_main, return ::ChainActive().Tip());
@@ -158,6 +158,10 @@ class CQuorum
 {
     friend class CQuorumManager;
 public:
+    // Number of member sets for which Lagrange coefficients are kept. Usually the first threshold members whose shares
+    // arrive are the same for most sessions, so a few entries cover the common cases
+    static constexpr size_t LAGRANGE_COEFFICIENTS_CACHE_SIZE{16};
+
     const Consensus::LLMQParams& params;
     CFinalCommitmentPtr qc;
     const CBlockIndex* m_quorum_base_block_index{nullptr};
@@ -170,6 +174,14 @@ private:
     mutable CBLSWorkerCache blsCache;
     mutable std::atomic<bool> fQuorumDataRecoveryThreadRunning{false};
 
+    // CBLSIds of all members, in the same order as members
+    std::vector<CBLSId> memberIds;
+
+    // Lagrange coefficients for recovering from the shares of specific sets of members, keyed by the hash of the
+    // sorted member indexes
+    mutable Mutex cs_coefficients;
+    mutable unordered_lru_cache<uint256, std::shared_ptr<const CBLSLagrangeCoefficients>, StaticSaltedHasher, LAGRANGE_COEFFICIENTS_CACHE_SIZE> coefficientsCache GUARDED_BY(cs_coefficients);
+
     mutable CCriticalSection cs;
     // These are only valid when we either participated in the DKG or fully watched it
     BLSVerificationVectorPtr quorumVvec GUARDED_BY(cs);
@@ -191,6 +203,12 @@ public:
     CBLSPublicKey GetPubKeyShare(size_t memberIdx) const;
     CBLSSecretKey GetSkShare() const;
 
+    const CBLSId& GetMemberId(size_t memberIdx) const { return memberIds.at(memberIdx); }
+    // Returns nullptr if the coefficients can't be computed, e.g. for duplicate or out of range member indexes
+    std::shared_ptr<const CBLSLagrangeCoefficients> GetLagrangeCoefficients(const std::vector<uint16_t>& memberIndexes) const;
+    unordered_lru_cache_stats GetLagrangeCoefficientsCacheStats() const;
+    size_t GetLagrangeCoefficientsCacheSize(size_t& retMemoryUsage) const;
+
 private:
     void WriteContributions(CEvoDB& evoDb) const;
     bool ReadContributions(CEvoDB& evoDb);
@@ -245,6 +263,11 @@ public:
     // this one is cs_main-free
     std::vector<CQuorumCPtr> ScanQuorums(Consensus::LLMQType llmqType, const CBlockIndex* pindexStart, size_t nCountRequested) const;
 
+    // hit/miss/eviction counters of the quorum caches, summed over all LLMQ types
+    std::map<std::string, unordered_lru_cache_stats> GetCacheStats() const;
+    // current cache sizes, see CollectLLMQGauges
+    std::map<std::string, int64_t> GetMetricGauges() const;
+
 private:
     // all private methods here are cs_main-free
     void CheckQuorumConnections(const Consensus::LLMQParams& llmqParams, const CBlockIndex *pindexNew) const;
@@ -253,6 +276,7 @@ private:
     bool BuildQuorumContributions(const CFinalCommitmentPtr& fqc, const std::shared_ptr<CQuorum>& quorum) const;
 
     CQuorumCPtr GetQuorum(Consensus::LLMQType llmqType, const CBlockIndex* pindex) const;
+    std::vector<CQuorumCPtr> GetCachedQuorums() const;
     /// Returns the start offset for the masternode with the given proTxHash. This offset is applied when picking data recovery members of a quorum's
     /// memberlist and is calculated based on a list of all member of all active quorums for the given llmqType in a way that each member
     /// should receive the same number of request if all active llmqType members requests data from one llmqType quorum.
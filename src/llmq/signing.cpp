@@ -24,6 +24,41 @@
 
 namespace llmq
 {
+namespace {
+// Recovered sig keys are ("rs_b", bucket, kind, ...) and vote keys are ("rs_bv", bucket, llmqType, id). Buckets are
+// stored big endian so that keys are ordered by time
+const std::string DB_RECSIG_BUCKET{"rs_b"};
+const std::string DB_VOTE_BUCKET{"rs_bv"};
+
+constexpr uint8_t KIND_RECSIG{'r'};  // (llmqType, id) -> CRecoveredSig
+constexpr uint8_t KIND_HASH{'h'};    // (hash) -> (llmqType, id)
+constexpr uint8_t KIND_SESSION{'s'}; // (signHash) -> 1
+
+uint32_t GetBucket(int64_t time)
+{
+    return (uint32_t)(std::max<int64_t>(time, 0) / CRecoveredSigsDb::BUCKET_DURATION);
+}
+
+template<typename... Args>
+auto RecSigKey(uint32_t bucket, uint8_t kind, const Args&... args)
+{
+    return std::make_tuple(DB_RECSIG_BUCKET, (uint32_t)htobe32(bucket), kind, args...);
+}
+
+auto VoteKey(uint32_t bucket, Consensus::LLMQType llmqType, const uint256& id)
+{
+    return std::make_tuple(DB_VOTE_BUCKET, (uint32_t)htobe32(bucket), llmqType, id);
+}
+
+template<typename... Args>
+std::vector<unsigned char> BloomKey(const Args&... args)
+{
+    CDataStream ds(SER_DISK, CLIENT_VERSION);
+    (ds << ... << args);
+    return std::vector<unsigned char>(ds.begin(), ds.end());
+}
+} // anonymous namespace
+
 UniValue CRecoveredSig::ToJson() const
 {
     UniValue ret(UniValue::VOBJ);
@@ -222,90 +257,375 @@ void CRecoveredSigsDb::MigrateRecoveredSigs()
     LogPrint(BCLog::LLMQ, "CRecoveredSigsDb::%d -- done\n", __func__);
 }
 
+void CRecoveredSigsDb::MigrateToBuckets()
+{
+    // Older versions kept global "rs_r", "rs_h", "rs_s" and "rs_t" indexes for recovered sigs and "rs_v"/"rs_vt" for
+    // votes. Move every entry into the bucket of its write time and remove the old keys
+    const std::vector<std::string> oldPrefixes{"rs_r", "rs_h", "rs_s", "rs_t", "rs_v", "rs_vt"};
+    std::unique_ptr<CDBIterator> pcursor(db->NewIterator());
+    const auto hasKeys = [&pcursor](const std::string& prefix) {
+        std::tuple<std::string> k;
+        pcursor->Seek(std::make_tuple(prefix));
+        return pcursor->Valid() && pcursor->GetKey(k) && std::get<0>(k) == prefix;
+    };
+    if (std::none_of(oldPrefixes.begin(), oldPrefixes.end(), hasKeys)) {
+        return;
+    }
+
+    LogPrintf("CRecoveredSigsDb::%s -- moving recovered sigs and votes to time buckets\n", __func__);
+
+    const uint32_t curBucket = GetBucket(GetAdjustedTime());
+    CDBBatch batch(*db);
+    const auto flushIfNeeded = [&]() {
+        if (batch.SizeEstimate() >= (1 << 24)) {
+            db->WriteBatch(batch);
+            batch.Clear();
+        }
+    };
+
+    size_t recSigCount{0};
+    size_t voteCount{0};
+
+    // every recovered sig has a "rs_h" key, including the truncated ones
+    auto start_h = std::make_tuple(std::string("rs_h"), uint256());
+    pcursor->Seek(start_h);
+    while (pcursor->Valid()) {
+        decltype(start_h) k;
+        std::pair<Consensus::LLMQType, uint256> v;
+
+        if (!pcursor->GetKey(k) || std::get<0>(k) != "rs_h") {
+            break;
+        }
+        if (!pcursor->GetValue(v)) {
+            break;
+        }
+
+        const auto& hash = std::get<1>(k);
+        const auto& [llmqType, id] = v;
+
+        CRecoveredSig recSig;
+        CDataStream ds(SER_DISK, CLIENT_VERSION);
+        bool haveRecSig{false};
+        if (db->ReadDataStream(std::make_tuple(std::string("rs_r"), llmqType, id), ds)) {
+            try {
+                recSig.Unserialize(ds);
+                haveRecSig = recSig.GetHash() == hash;
+            } catch (std::exception&) {
+            }
+        }
+
+        if (haveRecSig) {
+            // entries written by versions < 0.14.1 have no write time, keep them for another maxAge
+            uint32_t writeTime;
+            const uint32_t bucket = db->Read(std::make_tuple(std::string("rs_r"), llmqType, id, recSig.getMsgHash()), writeTime) ? GetBucket(writeTime) : curBucket;
+            batch.Write(RecSigKey(bucket, KIND_RECSIG, llmqType, id), recSig);
+            batch.Write(RecSigKey(bucket, KIND_HASH, hash), v);
+            batch.Write(RecSigKey(bucket, KIND_SESSION, recSig.buildSignHash()), (uint8_t)1);
+        } else {
+            // truncated, only keep the hash so that HasRecoveredSigForHash still returns true
+            batch.Write(RecSigKey(curBucket, KIND_HASH, hash), v);
+        }
+        recSigCount++;
+        flushIfNeeded();
+
+        pcursor->Next();
+    }
+
+    auto start_vt = std::make_tuple(std::string("rs_vt"), (uint32_t)0, (Consensus::LLMQType)0, uint256());
+    pcursor->Seek(start_vt);
+    while (pcursor->Valid()) {
+        decltype(start_vt) k;
+
+        if (!pcursor->GetKey(k) || std::get<0>(k) != "rs_vt") {
+            break;
+        }
+
+        const auto llmqType = std::get<2>(k);
+        const auto& id = std::get<3>(k);
+        uint256 msgHash;
+        if (db->Read(std::make_tuple(std::string("rs_v"), llmqType, id), msgHash)) {
+            batch.Write(VoteKey(GetBucket(be32toh(std::get<1>(k))), llmqType, id), msgHash);
+            voteCount++;
+            flushIfNeeded();
+        }
+
+        pcursor->Next();
+    }
+
+    for (const auto& prefix : oldPrefixes) {
+        pcursor->Seek(std::make_tuple(prefix));
+        while (pcursor->Valid()) {
+            std::tuple<std::string> k;
+            if (!pcursor->GetKey(k) || std::get<0>(k) != prefix) {
+                break;
+            }
+            batch.Erase(pcursor->GetKey());
+            flushIfNeeded();
+            pcursor->Next();
+        }
+    }
+
+    db->WriteBatch(batch);
+    pcursor.reset();
+    db->CompactFull();
+
+    LogPrintf("CRecoveredSigsDb::%s -- moved %d recovered sigs and %d votes\n", __func__, recSigCount, voteCount);
+}
+
+void CRecoveredSigsDb::LoadBuckets()
+{
+    std::unique_ptr<CDBIterator> pcursor(db->NewIterator());
+    size_t cnt{0};
+
+    LOCK(cs);
+
+    auto start = std::make_tuple(DB_RECSIG_BUCKET, (uint32_t)0, (uint8_t)0);
+    pcursor->Seek(start);
+    while (pcursor->Valid()) {
+        decltype(start) k;
+
+        if (!pcursor->GetKey(k) || std::get<0>(k) != DB_RECSIG_BUCKET) {
+            break;
+        }
+
+        const uint32_t bucket = be32toh(std::get<1>(k));
+        const uint8_t kind = std::get<2>(k);
+        if (kind == KIND_RECSIG) {
+            decltype(RecSigKey(0, KIND_RECSIG, Consensus::LLMQType{}, uint256())) k2;
+            if (pcursor->GetKey(k2)) {
+                GetBucketFilter(false, bucket).insert(BloomKey(KIND_RECSIG, std::get<3>(k2), std::get<4>(k2)));
+            }
+        } else {
+            decltype(RecSigKey(0, kind, uint256())) k2;
+            if (pcursor->GetKey(k2)) {
+                GetBucketFilter(false, bucket).insert(BloomKey(kind, std::get<3>(k2)));
+            }
+        }
+        cnt++;
+
+        pcursor->Next();
+    }
+
+    auto start_v = VoteKey(0, Consensus::LLMQType{}, uint256());
+    pcursor->Seek(start_v);
+    while (pcursor->Valid()) {
+        decltype(start_v) k;
+
+        if (!pcursor->GetKey(k) || std::get<0>(k) != DB_VOTE_BUCKET) {
+            break;
+        }
+
+        GetBucketFilter(true, be32toh(std::get<1>(k))).insert(BloomKey(std::get<2>(k), std::get<3>(k)));
+        cnt++;
+
+        pcursor->Next();
+    }
+
+    LogPrint(BCLog::LLMQ, "CRecoveredSigsDb::%s -- loaded %d keys into %d recovered sig and %d vote buckets\n", __func__,
+             cnt, recSigBuckets.size(), voteBuckets.size());
+}
+
+void CRecoveredSigsDb::BucketFilter::insert(const std::vector<unsigned char>& key)
+{
+    if (filters.empty() || lastFilterElements >= BUCKET_BLOOM_ELEMENTS) {
+        filters.emplace_back(BUCKET_BLOOM_ELEMENTS, BUCKET_BLOOM_FP_RATE, GetRand(std::numeric_limits<uint32_t>::max()), BLOOM_UPDATE_NONE);
+        lastFilterElements = 0;
+    }
+    filters.back().insert(key);
+    lastFilterElements++;
+}
+
+bool CRecoveredSigsDb::BucketFilter::contains(const std::vector<unsigned char>& key) const
+{
+    return std::any_of(filters.begin(), filters.end(), [&key](const CBloomFilter& filter) { return filter.contains(key); });
+}
+
+CRecoveredSigsDb::BucketFilter& CRecoveredSigsDb::GetBucketFilter(bool votes, uint32_t bucket)
+{
+    AssertLockHeld(cs);
+    auto& buckets = votes ? voteBuckets : recSigBuckets;
+    return buckets[bucket];
+}
+
+template<typename Callback>
+bool CRecoveredSigsDb::ForEachCandidateBucket(bool votes, const std::vector<unsigned char>& bloomKey, Callback&& f) const
+{
+    std::vector<uint32_t> candidates;
+    {
+        LOCK(cs);
+        const auto& buckets = votes ? voteBuckets : recSigBuckets;
+        for (auto it = buckets.rbegin(); it != buckets.rend(); ++it) {
+            if (it->second.contains(bloomKey)) {
+                candidates.emplace_back(it->first);
+            }
+        }
+    }
+    return std::any_of(candidates.begin(), candidates.end(), f);
+}
+
+void CRecoveredSigsDb::DropBuckets(bool votes, uint32_t firstKeptBucket)
+{
+    std::vector<uint32_t> toDrop;
+    {
+        LOCK(cs);
+        auto& buckets = votes ? voteBuckets : recSigBuckets;
+        for (auto it = buckets.begin(); it != buckets.end() && it->first < firstKeptBucket; ) {
+            toDrop.emplace_back(it->first);
+            it = buckets.erase(it);
+        }
+    }
+    if (toDrop.empty()) {
+        return;
+    }
+
+    const auto& prefix = votes ? DB_VOTE_BUCKET : DB_RECSIG_BUCKET;
+    std::unique_ptr<CDBIterator> pcursor(db->NewIterator());
+    CDBBatch batch(*db);
+    size_t cnt{0};
+    for (const auto bucket : toDrop) {
+        const auto start = std::make_tuple(prefix, (uint32_t)htobe32(bucket));
+        pcursor->Seek(start);
+        while (pcursor->Valid()) {
+            std::remove_const_t<decltype(start)> k;
+            if (!pcursor->GetKey(k) || k != start) {
+                break;
+            }
+            batch.Erase(pcursor->GetKey());
+            cnt++;
+
+            if (batch.SizeEstimate() >= (1 << 24)) {
+                db->WriteBatch(batch);
+                batch.Clear();
+            }
+
+            pcursor->Next();
+        }
+    }
+    db->WriteBatch(batch);
+    pcursor.reset();
+
+    // Nothing will ever be written to these ranges again, so compact them right away instead of leaving the
+    // tombstones to LevelDB's background compactions
+    db->CompactRange(std::make_tuple(prefix, (uint32_t)htobe32(toDrop.front())), std::make_tuple(prefix, (uint32_t)htobe32(firstKeptBucket)));
+
+    if (!votes) {
+        // entries of the remaining buckets and unknown entries are still valid
+        const auto isDropped = [firstKeptBucket](const auto&, const LookupCacheValue& bucket) {
+            return bucket && *bucket < firstKeptBucket;
+        };
+        LOCK(cs);
+        hasSigForIdCache.erase_if(isDropped);
+        hasSigForSessionCache.erase_if(isDropped);
+        hasSigForHashCache.erase_if(isDropped);
+    }
+
+    LogPrint(BCLog::LLMQ, "CRecoveredSigsDb::%s -- dropped %d %s buckets with %d keys\n", __func__,
+             toDrop.size(), votes ? "vote" : "recovered sig", cnt);
+}
+
 bool CRecoveredSigsDb::HasRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash) const
 {
-    auto k = std::make_tuple(std::string("rs_r"), llmqType, id, msgHash);
-    return db->Exists(k);
+    CRecoveredSig recSig;
+    return ReadRecoveredSig(llmqType, id, recSig) && recSig.getMsgHash() == msgHash;
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForId(Consensus::LLMQType llmqType, const uint256& id) const
 {
     auto cacheKey = std::make_pair(llmqType, id);
-    bool ret;
+    LookupCacheValue ret;
     {
         LOCK(cs);
         if (hasSigForIdCache.get(cacheKey, ret)) {
-            return ret;
+            return ret.has_value();
         }
     }
 
-
-    auto k = std::make_tuple(std::string("rs_r"), llmqType, id);
-    ret = db->Exists(k);
+    ForEachCandidateBucket(false, BloomKey(KIND_RECSIG, llmqType, id), [&](uint32_t bucket) {
+        if (!db->Exists(RecSigKey(bucket, KIND_RECSIG, llmqType, id))) {
+            return false;
+        }
+        ret = bucket;
+        return true;
+    });
 
     LOCK(cs);
     hasSigForIdCache.insert(cacheKey, ret);
-    return ret;
+    return ret.has_value();
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForSession(const uint256& signHash) const
 {
-    bool ret;
+    LookupCacheValue ret;
     {
         LOCK(cs);
         if (hasSigForSessionCache.get(signHash, ret)) {
-            return ret;
+            return ret.has_value();
         }
     }
 
-    auto k = std::make_tuple(std::string("rs_s"), signHash);
-    ret = db->Exists(k);
+    ForEachCandidateBucket(false, BloomKey(KIND_SESSION, signHash), [&](uint32_t bucket) {
+        if (!db->Exists(RecSigKey(bucket, KIND_SESSION, signHash))) {
+            return false;
+        }
+        ret = bucket;
+        return true;
+    });
 
     LOCK(cs);
     hasSigForSessionCache.insert(signHash, ret);
-    return ret;
+    return ret.has_value();
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForHash(const uint256& hash) const
 {
-    bool ret;
+    LookupCacheValue ret;
     {
         LOCK(cs);
         if (hasSigForHashCache.get(hash, ret)) {
-            return ret;
+            return ret.has_value();
         }
     }
 
-    auto k = std::make_tuple(std::string("rs_h"), hash);
-    ret = db->Exists(k);
+    ForEachCandidateBucket(false, BloomKey(KIND_HASH, hash), [&](uint32_t bucket) {
+        if (!db->Exists(RecSigKey(bucket, KIND_HASH, hash))) {
+            return false;
+        }
+        ret = bucket;
+        return true;
+    });
 
     LOCK(cs);
     hasSigForHashCache.insert(hash, ret);
-    return ret;
+    return ret.has_value();
 }
 
-bool CRecoveredSigsDb::ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret) const
+bool CRecoveredSigsDb::ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret, uint32_t* bucketRet) const
 {
-    auto k = std::make_tuple(std::string("rs_r"), llmqType, id);
-
-    CDataStream ds(SER_DISK, CLIENT_VERSION);
-    if (!db->ReadDataStream(k, ds)) {
-        return false;
-    }
+    return ForEachCandidateBucket(false, BloomKey(KIND_RECSIG, llmqType, id), [&](uint32_t bucket) {
+        CDataStream ds(SER_DISK, CLIENT_VERSION);
+        if (!db->ReadDataStream(RecSigKey(bucket, KIND_RECSIG, llmqType, id), ds)) {
+            return false;
+        }
 
-    try {
-        ret.Unserialize(ds);
+        try {
+            ret.Unserialize(ds);
+        } catch (std::exception&) {
+            return false;
+        }
+        if (bucketRet != nullptr) {
+            *bucketRet = bucket;
+        }
         return true;
-    } catch (std::exception&) {
-        return false;
-    }
+    });
 }
 
 bool CRecoveredSigsDb::GetRecoveredSigByHash(const uint256& hash, CRecoveredSig& ret) const
 {
-    auto k1 = std::make_tuple(std::string("rs_h"), hash);
     std::pair<Consensus::LLMQType, uint256> k2;
-    if (!db->Read(k1, k2)) {
+    const bool found = ForEachCandidateBucket(false, BloomKey(KIND_HASH, hash), [&](uint32_t bucket) {
+        return db->Read(RecSigKey(bucket, KIND_HASH, hash), k2);
+    });
+    if (!found) {
         return false;
     }
 
@@ -319,208 +639,96 @@ bool CRecoveredSigsDb::GetRecoveredSigById(Consensus::LLMQType llmqType, const u
 
 void CRecoveredSigsDb::WriteRecoveredSig(const llmq::CRecoveredSig& recSig)
 {
-    CDBBatch batch(*db);
-
-    uint32_t curTime = GetAdjustedTime();
-
-    // we put these close to each other to leverage leveldb's key compaction
-    // this way, the second key can be used for fast HasRecoveredSig checks while the first key stores the recSig
-    auto k1 = std::make_tuple(std::string("rs_r"), recSig.getLlmqType(), recSig.getId());
-    auto k2 = std::make_tuple(std::string("rs_r"), recSig.getLlmqType(), recSig.getId(), recSig.getMsgHash());
-    batch.Write(k1, recSig);
-    // this key is also used to store the current time, so that we can easily get to the "rs_t" key when we have the id
-    batch.Write(k2, curTime);
-
-    // store by object hash
-    auto k3 = std::make_tuple(std::string("rs_h"), recSig.GetHash());
-    batch.Write(k3, std::make_pair(recSig.getLlmqType(), recSig.getId()));
+    const uint32_t bucket = GetBucket(GetAdjustedTime());
+    const auto signHash = recSig.buildSignHash();
 
-    // store by signHash
-    auto signHash = recSig.buildSignHash();
-    auto k4 = std::make_tuple(std::string("rs_s"), signHash);
-    batch.Write(k4, (uint8_t)1);
+    CDBBatch batch(*db);
+    batch.Write(RecSigKey(bucket, KIND_RECSIG, recSig.getLlmqType(), recSig.getId()), recSig);
+    batch.Write(RecSigKey(bucket, KIND_HASH, recSig.GetHash()), std::make_pair(recSig.getLlmqType(), recSig.getId()));
+    batch.Write(RecSigKey(bucket, KIND_SESSION, signHash), (uint8_t)1);
 
-    // store by current time. Allows fast cleanup of old recSigs
-    auto k5 = std::make_tuple(std::string("rs_t"), (uint32_t)htobe32(curTime), recSig.getLlmqType(), recSig.getId());
-    batch.Write(k5, (uint8_t)1);
+    {
+        // the filter must be updated before the db, otherwise lookups could miss the new entry
+        LOCK(cs);
+        auto& filter = GetBucketFilter(false, bucket);
+        filter.insert(BloomKey(KIND_RECSIG, recSig.getLlmqType(), recSig.getId()));
+        filter.insert(BloomKey(KIND_HASH, recSig.GetHash()));
+        filter.insert(BloomKey(KIND_SESSION, signHash));
+    }
 
     db->WriteBatch(batch);
 
     {
         LOCK(cs);
-        hasSigForIdCache.insert(std::make_pair(recSig.getLlmqType(), recSig.getId()), true);
-        hasSigForSessionCache.insert(signHash, true);
-        hasSigForHashCache.insert(recSig.GetHash(), true);
+        hasSigForIdCache.insert(std::make_pair(recSig.getLlmqType(), recSig.getId()), bucket);
+        hasSigForSessionCache.insert(signHash, bucket);
+        hasSigForHashCache.insert(recSig.GetHash(), bucket);
     }
 }
 
-void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, bool deleteHashKey, bool deleteTimeKey)
+// Remove the recovered sig itself and all keys required to get from id -> recSig
+// This will leave the byHash key in-place so that HasRecoveredSigForHash still returns true
+void CRecoveredSigsDb::TruncateRecoveredSig(Consensus::LLMQType llmqType, const uint256& id)
 {
-    AssertLockHeld(cs);
-
     CRecoveredSig recSig;
-    if (!ReadRecoveredSig(llmqType, id, recSig)) {
+    uint32_t bucket;
+    if (!ReadRecoveredSig(llmqType, id, recSig, &bucket)) {
         return;
     }
 
     auto signHash = recSig.buildSignHash();
 
-    auto k1 = std::make_tuple(std::string("rs_r"), recSig.getLlmqType(), recSig.getId());
-    auto k2 = std::make_tuple(std::string("rs_r"), recSig.getLlmqType(), recSig.getId(), recSig.getMsgHash());
-    auto k3 = std::make_tuple(std::string("rs_h"), recSig.GetHash());
-    auto k4 = std::make_tuple(std::string("rs_s"), signHash);
-    batch.Erase(k1);
-    batch.Erase(k2);
-    if (deleteHashKey) {
-        batch.Erase(k3);
-    }
-    batch.Erase(k4);
-
-    if (deleteTimeKey) {
-        CDataStream writeTimeDs(SER_DISK, CLIENT_VERSION);
-        // TODO remove the size() == sizeof(uint32_t) in a future version (when we stop supporting upgrades from < 0.14.1)
-        if (db->ReadDataStream(k2, writeTimeDs) && writeTimeDs.size() == sizeof(uint32_t)) {
-            uint32_t writeTime;
-            writeTimeDs >> writeTime;
-            auto k5 = std::make_tuple(std::string("rs_t"), (uint32_t) htobe32(writeTime), recSig.getLlmqType(), recSig.getId());
-            batch.Erase(k5);
-        }
-    }
-
-    hasSigForIdCache.erase(std::make_pair(recSig.getLlmqType(), recSig.getId()));
-    hasSigForSessionCache.erase(signHash);
-    if (deleteHashKey) {
-        hasSigForHashCache.erase(recSig.GetHash());
-    }
-}
-
-// Remove the recovered sig itself and all keys required to get from id -> recSig
-// This will leave the byHash key in-place so that HasRecoveredSigForHash still returns true
-void CRecoveredSigsDb::TruncateRecoveredSig(Consensus::LLMQType llmqType, const uint256& id)
-{
-    LOCK(cs);
     CDBBatch batch(*db);
-    RemoveRecoveredSig(batch, llmqType, id, false, false);
+    batch.Erase(RecSigKey(bucket, KIND_RECSIG, llmqType, id));
+    batch.Erase(RecSigKey(bucket, KIND_SESSION, signHash));
     db->WriteBatch(batch);
+
+    LOCK(cs);
+    hasSigForIdCache.erase(std::make_pair(llmqType, id));
+    hasSigForSessionCache.erase(signHash);
 }
 
+// Entries are kept until their whole bucket is older than maxAge, so up to BUCKET_DURATION longer than maxAge
 void CRecoveredSigsDb::CleanupOldRecoveredSigs(int64_t maxAge)
 {
-    std::unique_ptr<CDBIterator> pcursor(db->NewIterator());
-
-    auto start = std::make_tuple(std::string("rs_t"), (uint32_t)0, (Consensus::LLMQType)0, uint256());
-    uint32_t endTime = (uint32_t)(GetAdjustedTime() - maxAge);
-    pcursor->Seek(start);
-
-    std::vector<std::pair<Consensus::LLMQType, uint256>> toDelete;
-    std::vector<decltype(start)> toDelete2;
-
-    while (pcursor->Valid()) {
-        decltype(start) k;
-
-        if (!pcursor->GetKey(k) || std::get<0>(k) != "rs_t") {
-            break;
-        }
-        if (be32toh(std::get<1>(k)) >= endTime) {
-            break;
-        }
-
-        toDelete.emplace_back(std::get<2>(k), std::get<3>(k));
-        toDelete2.emplace_back(k);
-
-        pcursor->Next();
-    }
-    pcursor.reset();
-
-    if (toDelete.empty()) {
-        return;
-    }
-
-    CDBBatch batch(*db);
-    {
-        LOCK(cs);
-        for (const auto& e : toDelete) {
-            RemoveRecoveredSig(batch, e.first, e.second, true, false);
-
-            if (batch.SizeEstimate() >= (1 << 24)) {
-                db->WriteBatch(batch);
-                batch.Clear();
-            }
-        }
-    }
-
-    for (const auto& e : toDelete2) {
-        batch.Erase(e);
-    }
-
-    db->WriteBatch(batch);
-
-    LogPrint(BCLog::LLMQ, "CRecoveredSigsDb::%d -- deleted %d entries\n", __func__, toDelete.size());
+    DropBuckets(false, GetBucket(GetAdjustedTime() - maxAge));
 }
 
 bool CRecoveredSigsDb::HasVotedOnId(Consensus::LLMQType llmqType, const uint256& id) const
 {
-    auto k = std::make_tuple(std::string("rs_v"), llmqType, id);
-    return db->Exists(k);
+    return ForEachCandidateBucket(true, BloomKey(llmqType, id), [&](uint32_t bucket) {
+        return db->Exists(VoteKey(bucket, llmqType, id));
+    });
 }
 
 bool CRecoveredSigsDb::GetVoteForId(Consensus::LLMQType llmqType, const uint256& id, uint256& msgHashRet) const
 {
-    auto k = std::make_tuple(std::string("rs_v"), llmqType, id);
-    return db->Read(k, msgHashRet);
+    return ForEachCandidateBucket(true, BloomKey(llmqType, id), [&](uint32_t bucket) {
+        return db->Read(VoteKey(bucket, llmqType, id), msgHashRet);
+    });
 }
 
 void CRecoveredSigsDb::WriteVoteForId(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash)
 {
-    auto k1 = std::make_tuple(std::string("rs_v"), llmqType, id);
-    auto k2 = std::make_tuple(std::string("rs_vt"), (uint32_t)htobe32(GetAdjustedTime()), llmqType, id);
-
-    CDBBatch batch(*db);
-    batch.Write(k1, msgHash);
-    batch.Write(k2, (uint8_t)1);
+    const uint32_t bucket = GetBucket(GetAdjustedTime());
 
-    db->WriteBatch(batch);
+    WITH_LOCK(cs, GetBucketFilter(true, bucket).insert(BloomKey(llmqType, id)));
+    db->Write(VoteKey(bucket, llmqType, id), msgHash);
 }
 
 void CRecoveredSigsDb::CleanupOldVotes(int64_t maxAge)
 {
-    std::unique_ptr<CDBIterator> pcursor(db->NewIterator());
-
-    auto start = std::make_tuple(std::string("rs_vt"), (uint32_t)0, (Consensus::LLMQType)0, uint256());
-    uint32_t endTime = (uint32_t)(GetAdjustedTime() - maxAge);
-    pcursor->Seek(start);
-
-    CDBBatch batch(*db);
-    size_t cnt = 0;
-    while (pcursor->Valid()) {
-        decltype(start) k;
-
-        if (!pcursor->GetKey(k) || std::get<0>(k) != "rs_vt") {
-            break;
-        }
-        if (be32toh(std::get<1>(k)) >= endTime) {
-            break;
-        }
-
-        Consensus::LLMQType llmqType = std::get<2>(k);
-        const uint256& id = std::get<3>(k);
-
-        batch.Erase(k);
-        batch.Erase(std::make_tuple(std::string("rs_v"), llmqType, id));
-
-        cnt++;
-
-        pcursor->Next();
-    }
-    pcursor.reset();
-
-    if (cnt == 0) {
-        return;
-    }
-
-    db->WriteBatch(batch);
+    DropBuckets(true, GetBucket(GetAdjustedTime() - maxAge));
+}
 
-    LogPrint(BCLog::LLMQ, "CRecoveredSigsDb::%d -- deleted %d entries\n", __func__, cnt);
+std::map<std::string, unordered_lru_cache_stats> CRecoveredSigsDb::GetCacheStats() const
+{
+    LOCK(cs);
+    return {
+        {"hasSigForId", hasSigForIdCache.stats()},
+        {"hasSigForSession", hasSigForSessionCache.stats()},
+        {"hasSigForHash", hasSigForHashCache.stats()},
+    };
 }
 
 //////////////////
@@ -979,7 +1187,7 @@ bool CSigningManager::GetVoteForId(Consensus::LLMQType llmqType, const uint256&
     return db.GetVoteForId(llmqType, id, msgHashRet);
 }
 
-CQuorumCPtr CSigningManager::SelectQuorumForSigning(Consensus::LLMQType llmqType, const CQuorumManager& quorum_manager, const uint256& selectionHash, int signHeight, int signOffset)
+CSigningQuorums CSigningManager::GetSigningQuorums(Consensus::LLMQType llmqType, const CQuorumManager& quorum_manager, int signHeight, int signOffset)
 {
     size_t poolSize = GetLLMQParams(llmqType).signingActiveQuorumCount;
 
@@ -996,11 +1204,25 @@ CQuorumCPtr CSigningManager::SelectQuorumForSigning(Consensus::LLMQType llmqType
         pindexStart = ::ChainActive()[startBlockHeight];
     }
 
-    if (utils::IsQuorumRotationEnabled(llmqType, pindexStart)) {
-        auto quorums = quorum_manager.ScanQuorums(llmqType, pindexStart, poolSize);
-        if (quorums.empty()) {
-            return nullptr;
-        }
+    CSigningQuorums ret;
+    ret.llmqType = llmqType;
+    ret.rotation = utils::IsQuorumRotationEnabled(llmqType, pindexStart);
+    ret.quorums = quorum_manager.ScanQuorums(llmqType, pindexStart, poolSize);
+    return ret;
+}
+
+CQuorumCPtr CSigningManager::SelectQuorumForSigning(Consensus::LLMQType llmqType, const CQuorumManager& quorum_manager, const uint256& selectionHash, int signHeight, int signOffset)
+{
+    return GetSigningQuorums(llmqType, quorum_manager, signHeight, signOffset).Select(selectionHash);
+}
+
+CQuorumCPtr CSigningQuorums::Select(const uint256& selectionHash) const
+{
+    if (quorums.empty()) {
+        return nullptr;
+    }
+
+    if (rotation) {
         //log2 int
         int n = std::log2(GetLLMQParams(llmqType).signingActiveQuorumCount);
         //Extract last 64 bits of selectionHash
@@ -1021,11 +1243,6 @@ CQuorumCPtr CSigningManager::SelectQuorumForSigning(Consensus::LLMQType llmqType
         }
         return *itQuorum;
     } else {
-        auto quorums = quorum_manager.ScanQuorums(llmqType, pindexStart, poolSize);
-        if (quorums.empty()) {
-            return nullptr;
-        }
-
         std::vector<std::pair<uint256, size_t>> scores;
         scores.reserve(quorums.size());
         for (const auto i : irange::range(quorums.size())) {
@@ -8,6 +8,7 @@
 #include <bls/bls.h>
 #include <unordered_lru_cache.h>
 
+#include <bloom.h>
 #include <consensus/params.h>
 #include <dbwrapper.h>
 #include <random.h>
@@ -15,7 +16,11 @@
 #include <sync.h>
 #include <univalue.h>
 
+#include <map>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 using NodeId = int64_t;
 class CConnman;
@@ -102,21 +107,53 @@ public:
     UniValue ToJson() const;
 };
 
+// Recovered sigs and votes are stored in time buckets. All keys of an entry are written to the bucket of the time it
+// was written, so expiring old entries means dropping whole key ranges instead of deleting them one by one, which
+// keeps compaction churn low. Each bucket has an in-memory bloom filter of everything that can be looked up in it, so
+// lookups of unknown ids, sessions and hashes usually don't touch the db at all.
 class CRecoveredSigsDb
 {
+public:
+    static constexpr int64_t BUCKET_DURATION{60 * 60};
+
+    // A filter holds ~3300 recovered sigs (3 keys each) and is ~18KB, a quiet week of buckets for recovered sigs and
+    // votes is ~6MB
+    static constexpr unsigned int BUCKET_BLOOM_ELEMENTS{10000};
+    static constexpr double BUCKET_BLOOM_FP_RATE{0.001};
+
+    // The bloom filters of a bucket. Once a filter holds BUCKET_BLOOM_ELEMENTS keys, a new one is started, so busy
+    // buckets keep the false positive rate of their filters instead of saturating a single one
+    class BucketFilter
+    {
+    private:
+        std::vector<CBloomFilter> filters;
+        unsigned int lastFilterElements{0};
+
+    public:
+        void insert(const std::vector<unsigned char>& key);
+        bool contains(const std::vector<unsigned char>& key) const;
+        size_t GetFilterCount() const { return filters.size(); }
+    };
+
 private:
     std::unique_ptr<CDBWrapper> db{nullptr};
 
     mutable CCriticalSection cs;
-    mutable unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, bool, StaticSaltedHasher, 30000> hasSigForIdCache GUARDED_BY(cs);
-    mutable unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForSessionCache GUARDED_BY(cs);
-    mutable unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForHashCache GUARDED_BY(cs);
+    std::map<uint32_t, BucketFilter> recSigBuckets GUARDED_BY(cs);
+    std::map<uint32_t, BucketFilter> voteBuckets GUARDED_BY(cs);
+    // The bucket of known entries, nullopt for unknown ones. This allows to only forget the entries of dropped buckets
+    using LookupCacheValue = std::optional<uint32_t>;
+    mutable unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, LookupCacheValue, StaticSaltedHasher, 30000> hasSigForIdCache GUARDED_BY(cs);
+    mutable unordered_lru_cache<uint256, LookupCacheValue, StaticSaltedHasher, 30000> hasSigForSessionCache GUARDED_BY(cs);
+    mutable unordered_lru_cache<uint256, LookupCacheValue, StaticSaltedHasher, 30000> hasSigForHashCache GUARDED_BY(cs);
 
 public:
     explicit CRecoveredSigsDb(bool fMemory, bool fWipe) :
             db(std::make_unique<CDBWrapper>(fMemory ? "" : (GetDataDir() / "llmq/recsigdb"), 8 << 20, fMemory, fWipe))
     {
         MigrateRecoveredSigs();
+        MigrateToBuckets();
+        LoadBuckets();
     }
 
     bool HasRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash) const;
@@ -137,11 +174,31 @@ public:
 
     void CleanupOldVotes(int64_t maxAge);
 
+    std::map<std::string, unordered_lru_cache_stats> GetCacheStats() const;
+
 private:
     void MigrateRecoveredSigs();
+    void MigrateToBuckets();
+    void LoadBuckets();
 
-    bool ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret) const;
-    void RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, bool deleteHashKey, bool deleteTimeKey) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    BucketFilter& GetBucketFilter(bool votes, uint32_t bucket) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    // Calls f(bucket) for all buckets whose filter contains bloomKey, newest first, until f returns true
+    template<typename Callback>
+    bool ForEachCandidateBucket(bool votes, const std::vector<unsigned char>& bloomKey, Callback&& f) const LOCKS_EXCLUDED(cs);
+    void DropBuckets(bool votes, uint32_t firstKeptBucket) LOCKS_EXCLUDED(cs);
+
+    bool ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret, uint32_t* bucketRet = nullptr) const;
+};
+
+// The quorums which are eligible for signing at a given height. Selecting quorums for many ids from the same set avoids
+// scanning the quorums for each of them
+struct CSigningQuorums
+{
+    Consensus::LLMQType llmqType{Consensus::LLMQType::LLMQ_NONE};
+    bool rotation{false};
+    std::vector<CQuorumCPtr> quorums;
+
+    CQuorumCPtr Select(const uint256& selectionHash) const;
 };
 
 class CRecoveredSigsListener
@@ -196,6 +253,8 @@ public:
     // allows AlreadyHave to keep returning true. Cleanup will later remove the remains
     void TruncateRecoveredSig(Consensus::LLMQType llmqType, const uint256& id);
 
+    std::map<std::string, unordered_lru_cache_stats> GetCacheStats() const { return db.GetCacheStats(); }
+
 private:
     void ProcessMessageRecoveredSig(CNode* pfrom, const std::shared_ptr<const CRecoveredSig>& recoveredSig);
     static bool PreVerifyRecoveredSig(const CQuorumManager& quorum_manager, const CRecoveredSig& recoveredSig, bool& retBan);
@@ -223,6 +282,7 @@ public:
     bool GetVoteForId(Consensus::LLMQType llmqType, const uint256& id, uint256& msgHashRet) const;
 
     static std::vector<CQuorumCPtr> GetActiveQuorumSet(Consensus::LLMQType llmqType, int signHeight);
+    static CSigningQuorums GetSigningQuorums(Consensus::LLMQType llmqType, const CQuorumManager& quorum_manager, int signHeight = -1 /*chain tip*/, int signOffset = SIGN_HEIGHT_OFFSET);
     static CQuorumCPtr SelectQuorumForSigning(Consensus::LLMQType llmqType, const CQuorumManager& quorum_manager, const uint256& selectionHash, int signHeight = -1 /*chain tip*/, int signOffset = SIGN_HEIGHT_OFFSET);
 
     // Verifies a recovered sig that was signed while the chain tip was at signedAtTip
@@ -6,11 +6,13 @@
 
 #include <llmq/quorums.h>
 #include <llmq/commitment.h>
+#include <llmq/metrics.h>
 #include <llmq/signing.h>
 #include <llmq/utils.h>
 
 #include <bls/bls_batchverifier.h>
 #include <chainparams.h>
+#include <ctpl_stl.h>
 #include <evo/deterministicmns.h>
 #include <masternode/node.h>
 #include <net_processing.h>
@@ -20,6 +22,9 @@
 
 #include <cxxtimer.hpp>
 
+#include <algorithm>
+#include <future>
+
 namespace llmq
 {
 void CSigShare::UpdateKey()
@@ -173,6 +178,17 @@ void CSigSharesNodeState::RemoveSession(const uint256& signHash)
 
 //////////////////////
 
+CSigSharesManager::~CSigSharesManager()
+{
+    // queued jobs reference this object, make sure they are gone before any member is destroyed
+    for (auto& lanes : {&verifyLanes, &recoveryLanes}) {
+        for (auto& lane : *lanes) {
+            lane->clear_queue();
+            lane->stop(true);
+        }
+    }
+}
+
 void CSigSharesManager::StartWorkerThread()
 {
     // can't start new thread if we have one running already
@@ -180,9 +196,30 @@ void CSigSharesManager::StartWorkerThread()
         assert(false);
     }
 
+    int laneCount = gArgs.GetArg("-llmqsigthreads", DEFAULT_LLMQ_SIG_THREADS);
+    if (laneCount <= 0) {
+        laneCount = std::clamp<int>(std::thread::hardware_concurrency() / 2, 1, 4);
+    }
+    laneCount = std::min(laneCount, MAX_LLMQ_SIG_THREADS);
+
+    const auto createLanes = [laneCount](std::vector<std::unique_ptr<ctpl::thread_pool>>& lanes, const std::string& name) {
+        for (const auto i : irange::range(laneCount)) {
+            auto& lane = lanes.emplace_back(std::make_unique<ctpl::thread_pool>(1));
+            lane->push([threadName = strprintf("%s-%d", name, i)](int) { util::ThreadRename(std::string(threadName)); });
+        }
+    };
+    createLanes(verifyLanes, "sigsh-verify");
+    createLanes(recoveryLanes, "sigsh-recover");
+    for ([[maybe_unused]] const auto i : irange::range(laneCount)) {
+        pendingRecoveries.emplace_back(std::make_unique<PendingRecoveries>());
+    }
+
     workThread = std::thread(&TraceThread<std::function<void()> >,
         "sigshares",
         std::function<void()>(std::bind(&CSigSharesManager::WorkThreadMain, this)));
+    sendThread = std::thread(&TraceThread<std::function<void()> >,
+        "sigsh-send",
+        std::function<void()>(std::bind(&CSigSharesManager::SendThreadMain, this)));
 }
 
 void CSigSharesManager::StopWorkerThread()
@@ -195,6 +232,18 @@ void CSigSharesManager::StopWorkerThread()
     if (workThread.joinable()) {
         workThread.join();
     }
+    if (sendThread.joinable()) {
+        sendThread.join();
+    }
+    // the work thread waits for all verification jobs it started, so only recovery jobs can still be queued
+    for (auto& lanes : {&verifyLanes, &recoveryLanes}) {
+        for (auto& lane : *lanes) {
+            lane->clear_queue();
+            lane->stop(true);
+        }
+        lanes->clear();
+    }
+    pendingRecoveries.clear();
 }
 
 void CSigSharesManager::RegisterAsRecoveredSigsListener()
@@ -423,7 +472,7 @@ bool CSigSharesManager::ProcessMessageBatchedSigShares(const CNode* pfrom, const
             // It's important to only skip seen *valid* sig shares here. If a node sends us a
             // batch of mostly valid sig shares with a single invalid one and thus batched
             // verification fails, we'd skip the valid ones in the future if received from other nodes
-            if (sigShares.Has(sigShare.GetKey())) {
+            if (HasSigShare(sigShare.GetKey())) {
                 continue;
             }
 
@@ -486,7 +535,7 @@ void CSigSharesManager::ProcessMessageSigShare(NodeId fromId, const CSigShare& s
     {
         LOCK(cs);
 
-        if (sigShares.Has(sigShare.GetKey())) {
+        if (HasSigShare(sigShare.GetKey())) {
             return;
         }
 
@@ -569,8 +618,7 @@ void CSigSharesManager::CollectPendingSigSharesToVerify(
             }
             const auto& sigShare = *ns.pendingIncomingSigShares.GetFirst();
 
-            AssertLockHeld(cs);
-            if (const bool alreadyHave = this->sigShares.Has(sigShare.GetKey()); !alreadyHave) {
+            if (const bool alreadyHave = HasSigShare(sigShare.GetKey()); !alreadyHave) {
                 uniqueSignHashes.emplace(nodeId, sigShare.GetSignHash());
                 retSigShares[nodeId].emplace_back(sigShare);
             }
@@ -607,14 +655,51 @@ bool CSigSharesManager::ProcessPendingSigShares(const CConnman& connman)
     std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher> quorums;
 
     const size_t nMaxBatchSize{32};
-    CollectPendingSigSharesToVerify(nMaxBatchSize, sigSharesByNodes, quorums);
+    const size_t laneCount = std::max<size_t>(verifyLanes.size(), 1);
+    CollectPendingSigSharesToVerify(nMaxBatchSize * laneCount, sigSharesByNodes, quorums);
     if (sigSharesByNodes.empty()) {
         return false;
     }
 
+    if (verifyLanes.empty()) {
+        VerifyAndProcessSigShares(sigSharesByNodes, quorums, connman);
+        return sigSharesByNodes.size() >= nMaxBatchSize;
+    }
+
+    // Split the collected shares by lane. Every lane verifies its part as one batch and then stores the shares. We
+    // wait for all lanes before collecting again, as shares which are still in flight would not be detected as
+    // duplicates and thus be verified twice
+    std::vector<std::unordered_map<NodeId, std::vector<CSigShare>>> sigSharesByLanes(laneCount);
+    for (auto& [nodeId, v] : sigSharesByNodes) {
+        for (auto& sigShare : v) {
+            sigSharesByLanes[GetLaneIndex(sigShare.GetSignHash(), laneCount)][nodeId].emplace_back(std::move(sigShare));
+        }
+    }
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(laneCount);
+    for (const auto i : irange::range(laneCount)) {
+        if (sigSharesByLanes[i].empty()) {
+            continue;
+        }
+        futures.emplace_back(verifyLanes[i]->push([this, &sigSharesByLanes, &quorums, &connman, i](int) {
+            VerifyAndProcessSigShares(sigSharesByLanes[i], quorums, connman);
+        }));
+    }
+    for (auto& f : futures) {
+        f.get();
+    }
+
+    return sigSharesByNodes.size() >= nMaxBatchSize * laneCount;
+}
+
+void CSigSharesManager::VerifyAndProcessSigShares(const std::unordered_map<NodeId, std::vector<CSigShare>>& sigSharesByNodes,
+        const std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& quorums,
+        const CConnman& connman)
+{
     // It's ok to perform insecure batched verification here as we verify against the quorum public key shares,
     // which are not craftable by individual entities, making the rogue public key attack impossible
-    CBLSBatchVerifier<NodeId, SigShareKey> batchVerifier(false, true);
+    CBLSBatchVerifier<NodeId, SigShareKey> batchVerifier(false, true, 0, &blsWorker);
 
     cxxtimer::Timer prepareTimer(true);
     size_t verifyCount = 0;
@@ -652,12 +737,16 @@ bool CSigSharesManager::ProcessPendingSigShares(const CConnman& connman)
     batchVerifier.Verify();
     verifyTimer.stop();
 
+    llmqMetrics.Inc("sigshares.verified", verifyCount);
+    llmqMetrics.Timing("sigshares.batchVerifyTime", verifyTimer.count());
+
     LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- verified sig shares. count=%d, pt=%d, vt=%d, nodes=%d\n", __func__, verifyCount, prepareTimer.count(), verifyTimer.count(), sigSharesByNodes.size());
 
     for (const auto& [nodeId, v] : sigSharesByNodes) {
         if (batchVerifier.badSources.count(nodeId) != 0) {
             LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- invalid sig shares from other node, banning peer=%d\n",
                      __func__, nodeId);
+            llmqMetrics.Inc("sigshares.invalidSources");
             // this will also cause re-requesting of the shares that were sent by this node
             BanNode(nodeId);
             continue;
@@ -665,8 +754,6 @@ bool CSigSharesManager::ProcessPendingSigShares(const CConnman& connman)
 
         ProcessPendingSigShares(v, quorums, connman);
     }
-
-    return sigSharesByNodes.size() >= nMaxBatchSize;
 }
 
 // It's ensured that no duplicates are passed to this method
@@ -690,8 +777,6 @@ void CSigSharesManager::ProcessSigShare(const CSigShare& sigShare, const CConnma
 {
     auto llmqType = quorum->params.type;
 
-    bool canTryRecovery = false;
-
     // prepare node set for direct-push in case this is our sig share
     std::set<NodeId> quorumNodes;
     if (!utils::IsAllMembersConnectedEnabled(llmqType) && sigShare.getQuorumMember() == quorum->GetMemberIndex(WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.proTxHash))) {
@@ -702,19 +787,24 @@ void CSigSharesManager::ProcessSigShare(const CSigShare& sigShare, const CConnma
         return;
     }
 
-    {
+    // The shares are guarded by their shard alone, cs is only needed when node state is updated as well. Sessions are
+    // removed under both locks, so whatever path is taken here, a share is either added before the removal (and
+    // removed with it) or after it
+    size_t sigShareCount{0};
+    if (utils::IsAllMembersConnectedEnabled(llmqType) && quorumNodes.empty()) {
+        if (!AddSigShare(sigShare, sigShareCount)) {
+            return;
+        }
+    } else {
         LOCK(cs);
 
-        if (!sigShares.Add(sigShare.GetKey(), sigShare)) {
+        if (!AddSigShare(sigShare, sigShareCount)) {
             return;
         }
         if (!utils::IsAllMembersConnectedEnabled(llmqType)) {
             sigSharesQueuedToAnnounce.Add(sigShare.GetKey(), true);
         }
 
-        // Update the time we've seen the last sigShare
-        timeSeenForSessions[sigShare.GetSignHash()] = GetAdjustedTime();
-
         if (!quorumNodes.empty()) {
             // don't announce and wait for other nodes to request this share and directly send it to them
             // there is no way the other nodes know about this share as this is the one created on this node
@@ -726,78 +816,224 @@ void CSigSharesManager::ProcessSigShare(const CSigShare& sigShare, const CConnma
                 session.knows.Set(sigShare.getQuorumMember(), true);
             }
         }
+    }
 
-        size_t sigShareCount = sigShares.CountForSignHash(sigShare.GetSignHash());
-        if (sigShareCount >= size_t(quorum->params.threshold)) {
-            canTryRecovery = true;
-        }
+    if (sigman.HasRecoveredSigForId(llmqType, sigShare.getId())) {
+        // The recovered sig arrived after the check above and its session might have been removed before we added the
+        // share. Don't leave a session behind which would only be removed on timeout
+        WITH_LOCK(cs, RemoveSigSharesForSession(sigShare.GetSignHash()));
+        return;
     }
 
-    if (canTryRecovery) {
-        TryRecoverSig(quorum, sigShare.getId(), sigShare.getMsgHash());
+    if (sigShareCount < size_t(quorum->params.threshold)) {
+        return;
+    }
+    if (recoveryLanes.empty()) {
+        TryRecoverSigs({PendingRecovery{quorum, sigShare.getId(), sigShare.getMsgHash()}});
+        return;
+    }
+    // Sessions are queued per lane and everything that was queued while the lane was busy is recovered as one batch.
+    // As all shares of a session end up in the same lane, later attempts see the recovered sig and bail out early
+    const size_t laneIndex = GetLaneIndex(sigShare.GetSignHash(), recoveryLanes.size());
+    bool schedule;
+    {
+        auto& pending = *pendingRecoveries[laneIndex];
+        LOCK(pending.cs);
+        schedule = pending.sessions.empty();
+        pending.sessions.try_emplace(sigShare.GetSignHash(), PendingRecovery{quorum, sigShare.getId(), sigShare.getMsgHash()});
+    }
+    if (schedule) {
+        recoveryLanes[laneIndex]->push([this, laneIndex](int) { RecoverPendingSigs(laneIndex); });
     }
 }
 
-void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash)
+void CSigSharesManager::RecoverPendingSigs(size_t laneIndex)
 {
-    if (sigman.HasRecoveredSigForId(quorum->params.type, id)) {
-        return;
+    std::vector<PendingRecovery> v;
+    {
+        auto& pending = *pendingRecoveries[laneIndex];
+        LOCK(pending.cs);
+        v.reserve(pending.sessions.size());
+        for (auto& [_, p] : pending.sessions) {
+            v.emplace_back(std::move(p));
+        }
+        pending.sessions.clear();
     }
+    TryRecoverSigs(v);
+}
 
-    std::vector<CBLSSignature> sigSharesForRecovery;
-    std::vector<CBLSId> idsForRecovery;
-    {
-        LOCK(cs);
+void CSigSharesManager::TryRecoverSigs(const std::vector<PendingRecovery>& pending)
+{
+    struct Recovery {
+        const PendingRecovery& p;
+        uint256 signHash;
+        std::vector<CBLSSignature> sigShares;
+        std::vector<uint16_t> members;
+        CBLSSignature recoveredSig;
+    };
 
-        auto signHash = utils::BuildSignHash(quorum->params.type, quorum->qc->quorumHash, id, msgHash);
-        const auto* sigSharesForSignHash = sigShares.GetAllForSignHash(signHash);
-        if (sigSharesForSignHash == nullptr) {
-            return;
+    std::vector<Recovery> recoveries;
+    recoveries.reserve(pending.size());
+    for (const auto& p : pending) {
+        const auto& quorum = p.quorum;
+        if (sigman.HasRecoveredSigForId(quorum->params.type, p.id)) {
+            continue;
         }
 
-        sigSharesForRecovery.reserve((size_t) quorum->params.threshold);
-        idsForRecovery.reserve((size_t) quorum->params.threshold);
-        for (auto it = sigSharesForSignHash->begin(); it != sigSharesForSignHash->end() && sigSharesForRecovery.size() < size_t(quorum->params.threshold); ++it) {
-            const auto& sigShare = it->second;
-            sigSharesForRecovery.emplace_back(sigShare.sigShare.Get());
-            idsForRecovery.emplace_back(quorum->members[sigShare.getQuorumMember()]->proTxHash);
+        auto& r = recoveries.emplace_back(Recovery{p, utils::BuildSignHash(quorum->params.type, quorum->qc->quorumHash, p.id, p.msgHash), {}, {}, {}});
+        {
+            auto& shard = GetSessionShard(r.signHash);
+            LOCK(shard.cs);
+
+            if (const auto* sigSharesForSignHash = shard.sigShares.GetAllForSignHash(r.signHash);
+                sigSharesForSignHash != nullptr && sigSharesForSignHash->size() >= size_t(quorum->params.threshold)) {
+                // Always use the shares of the members with the lowest indexes. This way most sessions of a quorum
+                // end up with the same set of members, so the quorum's cached Lagrange coefficients can be reused
+                for (const auto& [member, _] : *sigSharesForSignHash) {
+                    r.members.emplace_back(member);
+                }
+                std::sort(r.members.begin(), r.members.end());
+                r.members.resize((size_t) quorum->params.threshold);
+                r.sigShares.reserve(r.members.size());
+                for (const auto member : r.members) {
+                    r.sigShares.emplace_back(sigSharesForSignHash->at(member).sigShare.Get());
+                }
+            }
         }
 
         // check if we can recover the final signature
-        if (sigSharesForRecovery.size() < size_t(quorum->params.threshold)) {
-            return;
+        if (r.sigShares.size() < size_t(quorum->params.threshold)) {
+            recoveries.pop_back();
         }
     }
-
-    // now recover it
-    cxxtimer::Timer t(true);
-    CBLSSignature recoveredSig;
-    if (!recoveredSig.Recover(sigSharesForRecovery, idsForRecovery)) {
-        LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- failed to recover signature. id=%s, msgHash=%s, time=%d\n", __func__,
-                  id.ToString(), msgHash.ToString(), t.count());
+    if (recoveries.empty()) {
         return;
     }
 
-    LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- recovered signature. id=%s, msgHash=%s, time=%d\n", __func__,
-              id.ToString(), msgHash.ToString(), t.count());
+    // now recover them. The Lagrange coefficients only depend on the members which provided the shares, see
+    // CQuorum::GetLagrangeCoefficients
+    cxxtimer::Timer recoverTimer(true);
+    // It's ok to perform insecure batched verification here as we verify against the quorum public keys
+    CBLSBatchVerifier<uint256, uint256> batchVerifier(false, true, 0, &blsWorker);
+    for (auto& r : recoveries) {
+        const auto& quorum = r.p.quorum;
+        const auto coefficients = quorum->GetLagrangeCoefficients(r.members);
+        if (coefficients == nullptr || !r.recoveredSig.Recover(r.sigShares, *coefficients)) {
+            LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- failed to recover signature. id=%s, msgHash=%s\n", __func__,
+                      r.p.id.ToString(), r.p.msgHash.ToString());
+            continue;
+        }
+        batchVerifier.PushMessage(r.signHash, r.signHash, r.signHash, r.recoveredSig, quorum->qc->quorumPublicKey);
+    }
+    recoverTimer.stop();
+
+    // The recovered signatures should always be valid as all shares were verified before. Verifying them is cheap
+    // compared to the recovery when done in one batch, so do it anyway to catch bugs
+    cxxtimer::Timer verifyTimer(true);
+    batchVerifier.Verify();
+    verifyTimer.stop();
 
-    auto rs = std::make_shared<CRecoveredSig>(quorum->params.type, quorum->qc->quorumHash, id, msgHash, recoveredSig);
+    LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- recovered signatures. count=%d, rt=%d, vt=%d\n", __func__,
+              recoveries.size(), recoverTimer.count(), verifyTimer.count());
+    llmqMetrics.Timing("sigshares.recoveryTime", recoverTimer.count());
+    llmqMetrics.Timing("sigshares.recoveryVerifyTime", verifyTimer.count());
 
-    // There should actually be no need to verify the self-recovered signatures as it should always succeed. Let's
-    // however still verify it from time to time, so that we have a chance to catch bugs. We do only this sporadic
-    // verification because this is unbatched and thus slow verification that happens here.
-    if (((recoveredSigsCounter++) % 100) == 0) {
-        auto signHash = rs->buildSignHash();
-        bool valid = recoveredSig.VerifyInsecure(quorum->qc->quorumPublicKey, signHash);
-        if (!valid) {
+    for (const auto& r : recoveries) {
+        if (!r.recoveredSig.IsValid()) {
+            continue;
+        }
+        if (batchVerifier.badSources.count(r.signHash) != 0) {
             // this should really not happen as we have verified all signature shares before
             LogPrintf("CSigSharesManager::%s -- own recovered signature is invalid. id=%s, msgHash=%s\n", __func__,
-                      id.ToString(), msgHash.ToString());
-            return;
+                      r.p.id.ToString(), r.p.msgHash.ToString());
+            continue;
         }
+
+        llmqMetrics.Inc("sigshares.recovered");
+        const auto& quorum = r.p.quorum;
+        sigman.ProcessRecoveredSig(std::make_shared<CRecoveredSig>(quorum->params.type, quorum->qc->quorumHash, r.p.id, r.p.msgHash, r.recoveredSig));
+    }
+}
+
+std::map<std::string, int64_t> CSigSharesManager::GetMetricGauges()
+{
+    int64_t sessions{0};
+    int64_t stored{0};
+    for (auto& shard : sessionShards) {
+        LOCK(shard.cs);
+        sessions += shard.timeSeenForSessions.size();
+        stored += shard.sigShares.Size();
+    }
+
+    LOCK(cs);
+    int64_t pendingIncoming{0};
+    for (const auto& [_, ns] : nodeStates) {
+        pendingIncoming += ns.pendingIncomingSigShares.Size();
+    }
+    return {
+        {"pendingIncoming", pendingIncoming},
+        {"pendingSigns", (int64_t)pendingSigns.size()},
+        {"queuedToAnnounce", (int64_t)sigSharesQueuedToAnnounce.Size()},
+        {"requested", (int64_t)sigSharesRequested.Size()},
+        {"sessions", sessions},
+        {"stored", stored},
+    };
+}
+
+size_t CSigSharesManager::GetLaneIndex(const uint256& signHash, size_t laneCount) const
+{
+    // signHash is a hash already, so any part of it is evenly distributed. Use a different part than for the session
+    // shards so that the lanes don't end up working on the same shards
+    return signHash.GetUint64(1) % laneCount;
+}
+
+CSigSharesManager::SessionShard& CSigSharesManager::GetSessionShard(const uint256& signHash)
+{
+    return sessionShards[signHash.GetUint64(0) % SESSION_SHARD_COUNT];
+}
+
+bool CSigSharesManager::AddSigShare(const CSigShare& sigShare, size_t& retSigShareCount)
+{
+    auto& shard = GetSessionShard(sigShare.GetSignHash());
+    LOCK(shard.cs);
+
+    if (!shard.sigShares.Add(sigShare.GetKey(), sigShare)) {
+        return false;
     }
 
-    sigman.ProcessRecoveredSig(rs);
+    // Update the time we've seen the last sigShare
+    shard.timeSeenForSessions[sigShare.GetSignHash()] = GetAdjustedTime();
+
+    retSigShareCount = shard.sigShares.CountForSignHash(sigShare.GetSignHash());
+    return true;
+}
+
+bool CSigSharesManager::HasSigShare(const SigShareKey& k)
+{
+    auto& shard = GetSessionShard(k.first);
+    LOCK(shard.cs);
+    return shard.sigShares.Has(k);
+}
+
+std::optional<CSigShare> CSigSharesManager::GetSigShare(const SigShareKey& k)
+{
+    auto& shard = GetSessionShard(k.first);
+    LOCK(shard.cs);
+    const CSigShare* sigShare = shard.sigShares.Get(k);
+    if (sigShare == nullptr) {
+        return std::nullopt;
+    }
+    return *sigShare;
+}
+
+// Shards are locked one after the other, so the callback must not try to lock cs or any shard
+template<typename Callback>
+void CSigSharesManager::ForEachSigShare(Callback&& cb)
+{
+    for (auto& shard : sessionShards) {
+        LOCK(shard.cs);
+        shard.sigShares.ForEach(cb);
+    }
 }
 
 CDeterministicMNCPtr CSigSharesManager::SelectMemberForRecovery(const CQuorumCPtr& quorum, const uint256 &id, size_t attempt)
@@ -866,7 +1102,7 @@ void CSigSharesManager::CollectSigSharesToRequest(std::unordered_map<NodeId, std
                     continue;
                 }
                 auto k = std::make_pair(signHash, (uint16_t) i);
-                if (sigShares.Has(k)) {
+                if (HasSigShare(k)) {
                     // we already have it
                     session.announced.inv[i] = false;
                     continue;
@@ -939,8 +1175,8 @@ void CSigSharesManager::CollectSigSharesToSend(std::unordered_map<NodeId, std::u
                 session.requested.inv[i] = false;
 
                 auto k = std::make_pair(signHash, (uint16_t)i);
-                const CSigShare* sigShare = sigShares.Get(k);
-                if (sigShare == nullptr) {
+                auto sigShare = GetSigShare(k);
+                if (!sigShare) {
                     // he requested something we don't have
                     session.requested.inv[i] = false;
                     continue;
@@ -1015,8 +1251,8 @@ void CSigSharesManager::CollectSigSharesToAnnounce(std::unordered_map<NodeId, st
         AssertLockHeld(cs);
         const auto& signHash = sigShareKey.first;
         auto quorumMember = sigShareKey.second;
-        const CSigShare* sigShare = sigShares.Get(sigShareKey);
-        if (sigShare == nullptr) {
+        auto sigShare = GetSigShare(sigShareKey);
+        if (!sigShare) {
             return;
         }
 
@@ -1244,12 +1480,9 @@ void CSigSharesManager::Cleanup()
     // quorumHash -> quorumPtr (as GetQuorum() requires cs_main, leading to deadlocks with cs held)
     std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher> quorums;
 
-    {
-        LOCK(cs);
-        sigShares.ForEach([&quorums](const SigShareKey&, const CSigShare& sigShare) {
-            quorums.try_emplace(std::make_pair(sigShare.getLlmqType(), sigShare.getQuorumHash()), nullptr);
-        });
-    }
+    ForEachSigShare([&quorums](const SigShareKey&, const CSigShare& sigShare) {
+        quorums.try_emplace(std::make_pair(sigShare.getLlmqType(), sigShare.getQuorumHash()), nullptr);
+    });
 
     // Find quorums which became inactive
     for (auto it = quorums.begin(); it != quorums.end(); ) {
@@ -1263,70 +1496,88 @@ void CSigSharesManager::Cleanup()
 
     {
         // Now delete sessions which are for inactive quorums
-        LOCK(cs);
         std::unordered_set<uint256, StaticSaltedHasher> inactiveQuorumSessions;
-        sigShares.ForEach([&quorums, &inactiveQuorumSessions](const SigShareKey&, const CSigShare& sigShare) {
+        ForEachSigShare([&quorums, &inactiveQuorumSessions](const SigShareKey&, const CSigShare& sigShare) {
             if (quorums.count(std::make_pair(sigShare.getLlmqType(), sigShare.getQuorumHash())) == 0) {
                 inactiveQuorumSessions.emplace(sigShare.GetSignHash());
             }
         });
+        LOCK(cs);
         for (const auto& signHash : inactiveQuorumSessions) {
             RemoveSigSharesForSession(signHash);
         }
     }
 
     {
-        LOCK(cs);
-
         // Remove sessions which were successfully recovered
+        std::unordered_set<uint256, StaticSaltedHasher> sessions;
+        ForEachSigShare([&sessions](const SigShareKey& k, const CSigShare&) {
+            sessions.emplace(k.first);
+        });
         std::unordered_set<uint256, StaticSaltedHasher> doneSessions;
-        sigShares.ForEach([&doneSessions, this](const SigShareKey&, const CSigShare& sigShare) {
-            if (doneSessions.count(sigShare.GetSignHash()) != 0) {
-                return;
-            }
-            if (sigman.HasRecoveredSigForSession(sigShare.GetSignHash())) {
-                doneSessions.emplace(sigShare.GetSignHash());
+        for (const auto& signHash : sessions) {
+            if (sigman.HasRecoveredSigForSession(signHash)) {
+                doneSessions.emplace(signHash);
             }
-        });
+        }
+
+        LOCK(cs);
         for (const auto& signHash : doneSessions) {
             RemoveSigSharesForSession(signHash);
         }
 
         // Remove sessions which timed out
         std::unordered_set<uint256, StaticSaltedHasher> timeoutSessions;
-        for (const auto& [signHash, lastSeenTime] : timeSeenForSessions) {
-            if (now - lastSeenTime >= SESSION_NEW_SHARES_TIMEOUT) {
-                timeoutSessions.emplace(signHash);
+        for (auto& shard : sessionShards) {
+            LOCK(shard.cs);
+            for (const auto& [signHash, lastSeenTime] : shard.timeSeenForSessions) {
+                if (now - lastSeenTime >= SESSION_NEW_SHARES_TIMEOUT) {
+                    timeoutSessions.emplace(signHash);
+                }
             }
         }
         for (const auto& signHash : timeoutSessions) {
+            {
+                auto& shard = GetSessionShard(signHash);
+                LOCK(shard.cs);
+
+                // The lanes add shares without cs, so the session might have received a share since it was collected.
+                // Check and remove it under the same shard lock, so that a new share is never removed with it
+                const auto timeIt = shard.timeSeenForSessions.find(signHash);
+                if (timeIt == shard.timeSeenForSessions.end() || now - timeIt->second < SESSION_NEW_SHARES_TIMEOUT) {
+                    continue;
+                }
 
-            if (const size_t count = sigShares.CountForSignHash(signHash); count > 0) {
-                const auto* m = sigShares.GetAllForSignHash(signHash);
-                assert(m);
-
-                const auto& oneSigShare = m->begin()->second;
-
-                std::string strMissingMembers;
-                if (LogAcceptCategory(BCLog::LLMQ_SIGS)) {
-                    if (const auto quorumIt = quorums.find(std::make_pair(oneSigShare.getLlmqType(), oneSigShare.getQuorumHash())); quorumIt != quorums.end()) {
-                        const auto& quorum = quorumIt->second;
-                        for (const auto i : irange::range(quorum->members.size())) {
-                            if (m->count((uint16_t)i) == 0) {
-                                const auto& dmn = quorum->members[i];
-                                strMissingMembers += strprintf("\n  %s", dmn->proTxHash.ToString());
+                if (const size_t count = shard.sigShares.CountForSignHash(signHash); count > 0) {
+                    const auto* m = shard.sigShares.GetAllForSignHash(signHash);
+                    assert(m);
+
+                    const auto& oneSigShare = m->begin()->second;
+
+                    std::string strMissingMembers;
+                    if (LogAcceptCategory(BCLog::LLMQ_SIGS)) {
+                        if (const auto quorumIt = quorums.find(std::make_pair(oneSigShare.getLlmqType(), oneSigShare.getQuorumHash())); quorumIt != quorums.end()) {
+                            const auto& quorum = quorumIt->second;
+                            for (const auto i : irange::range(quorum->members.size())) {
+                                if (m->count((uint16_t)i) == 0) {
+                                    const auto& dmn = quorum->members[i];
+                                    strMissingMembers += strprintf("\n  %s", dmn->proTxHash.ToString());
+                                }
                             }
                         }
                     }
+
+                    LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- signing session timed out. signHash=%s, id=%s, msgHash=%s, sigShareCount=%d, missingMembers=%s\n", __func__,
+                              signHash.ToString(), oneSigShare.getId().ToString(), oneSigShare.getMsgHash().ToString(), count, strMissingMembers);
+                } else {
+                    LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- signing session timed out. signHash=%s, sigShareCount=%d\n", __func__,
+                              signHash.ToString(), count);
                 }
 
-                LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- signing session timed out. signHash=%s, id=%s, msgHash=%s, sigShareCount=%d, missingMembers=%s\n", __func__,
-                          signHash.ToString(), oneSigShare.getId().ToString(), oneSigShare.getMsgHash().ToString(), count, strMissingMembers);
-            } else {
-                LogPrint(BCLog::LLMQ_SIGS, "CSigSharesManager::%s -- signing session timed out. signHash=%s, sigShareCount=%d\n", __func__,
-                          signHash.ToString(), count);
+                shard.sigShares.EraseAllForSignHash(signHash);
+                shard.timeSeenForSessions.erase(timeIt);
             }
-            RemoveSigSharesForSession(signHash);
+            RemoveSessionFromNodeStates(signHash);
         }
     }
 
@@ -1364,15 +1615,25 @@ void CSigSharesManager::RemoveSigSharesForSession(const uint256& signHash)
 {
     AssertLockHeld(cs);
 
+    RemoveSessionFromNodeStates(signHash);
+
+    auto& shard = GetSessionShard(signHash);
+    LOCK(shard.cs);
+    shard.sigShares.EraseAllForSignHash(signHash);
+    shard.timeSeenForSessions.erase(signHash);
+}
+
+void CSigSharesManager::RemoveSessionFromNodeStates(const uint256& signHash)
+{
+    AssertLockHeld(cs);
+
     for (auto& [_, nodeState] : nodeStates) {
         nodeState.RemoveSession(signHash);
     }
 
     sigSharesRequested.EraseAllForSignHash(signHash);
     sigSharesQueuedToAnnounce.EraseAllForSignHash(signHash);
-    sigShares.EraseAllForSignHash(signHash);
     signedSessions.erase(signHash);
-    timeSeenForSessions.erase(signHash);
 }
 
 void CSigSharesManager::RemoveBannedNodeStates()
@@ -1424,8 +1685,6 @@ void CSigSharesManager::BanNode(NodeId nodeId)
 
 void CSigSharesManager::WorkThreadMain()
 {
-    int64_t lastSendTime = 0;
-
     while (!workInterrupt) {
         bool fMoreWork{false};
 
@@ -1434,11 +1693,6 @@ void CSigSharesManager::WorkThreadMain()
         fMoreWork |= ProcessPendingSigShares(connman);
         SignPendingSigShares();
 
-        if (GetTimeMillis() - lastSendTime > 100) {
-            SendMessages();
-            lastSendTime = GetTimeMillis();
-        }
-
         Cleanup();
         sigman.Cleanup();
 
@@ -1449,6 +1703,17 @@ void CSigSharesManager::WorkThreadMain()
     }
 }
 
+void CSigSharesManager::SendThreadMain()
+{
+    while (!workInterrupt) {
+        SendMessages();
+
+        if (!workInterrupt.sleep_for(std::chrono::milliseconds(100))) {
+            return;
+        }
+    }
+}
+
 void CSigSharesManager::AsyncSign(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash)
 {
     LOCK(cs);
@@ -1530,10 +1795,14 @@ void CSigSharesManager::ForceReAnnouncement(const CQuorumCPtr& quorum, Consensus
 
     LOCK(cs);
     auto signHash = utils::BuildSignHash(llmqType, quorum->qc->quorumHash, id, msgHash);
-    if (const auto *const sigs = sigShares.GetAllForSignHash(signHash)) {
-        for (const auto& [quorumMemberIndex, _] : *sigs) {
-            // re-announce every sigshare to every node
-            sigSharesQueuedToAnnounce.Add(std::make_pair(signHash, quorumMemberIndex), true);
+    {
+        auto& shard = GetSessionShard(signHash);
+        LOCK(shard.cs);
+        if (const auto *const sigs = shard.sigShares.GetAllForSignHash(signHash)) {
+            for (const auto& [quorumMemberIndex, _] : *sigs) {
+                // re-announce every sigshare to every node
+                sigSharesQueuedToAnnounce.Add(std::make_pair(signHash, quorumMemberIndex), true);
+            }
         }
     }
     for (auto& [_, nodeState] : nodeStates) {
@@ -14,14 +14,21 @@
 #include <sync.h>
 #include <uint256.h>
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <optional>
 #include <thread>
 #include <unordered_map>
 #include <utility>
 
+class CBLSWorker;
 class CEvoDB;
 class CScheduler;
 class CSporkManager;
+namespace ctpl {
+class thread_pool;
+} // namespace ctpl
 
 class CDeterministicMN;
 using CDeterministicMNCPtr = std::shared_ptr<const CDeterministicMN>;
@@ -35,6 +42,10 @@ using SigShareKey = std::pair<uint256, uint16_t>;
 
 constexpr uint32_t UNINITIALIZED_SESSION_ID{std::numeric_limits<uint32_t>::max()};
 
+// number of threads per stage (verification and recovery), 0 = auto
+static constexpr int DEFAULT_LLMQ_SIG_THREADS{0};
+static constexpr int MAX_LLMQ_SIG_THREADS{16};
+
 class CSigShare : virtual public CSigBase
 {
 protected:
@@ -369,17 +380,47 @@ private:
     static constexpr int64_t MAX_SEND_FOR_RECOVERY_TIMEOUT{10000};
     static constexpr size_t MAX_MSGS_SIG_SHARES{32};
 
+    static constexpr size_t SESSION_SHARD_COUNT{16};
+
     CCriticalSection cs;
 
+    // Sig shares are processed in stages: the work thread collects pending shares and hands them to the verification
+    // lanes, verified shares are recovered in the recovery lanes and the send thread builds and sends all messages.
+    // Each lane is a single thread and work is assigned to lanes by signHash, so all shares of one signing session are
+    // handled in the order they were received.
     std::thread workThread;
+    std::thread sendThread;
     CThreadInterrupt workInterrupt;
+    std::vector<std::unique_ptr<ctpl::thread_pool>> verifyLanes;
+    std::vector<std::unique_ptr<ctpl::thread_pool>> recoveryLanes;
 
-    SigShareMap<CSigShare> sigShares GUARDED_BY(cs);
-    std::unordered_map<uint256, CSignedSession, StaticSaltedHasher> signedSessions GUARDED_BY(cs);
+    struct PendingRecovery {
+        CQuorumCPtr quorum;
+        uint256 id;
+        uint256 msgHash;
+    };
+    // Sessions which reached the threshold, one entry per recovery lane
+    struct PendingRecoveries {
+        Mutex cs;
+        std::unordered_map<uint256, PendingRecovery, StaticSaltedHasher> sessions GUARDED_BY(cs);
+    };
+    std::vector<std::unique_ptr<PendingRecoveries>> pendingRecoveries;
+
+    // The sig shares themselves are sharded by signHash, so that the lanes only contend with each other (and with the
+    // network code holding cs) when they work on sessions which map to the same shard. Lock order is cs -> shard.cs
+    struct SessionShard {
+        mutable Mutex cs;
+        SigShareMap<CSigShare> sigShares GUARDED_BY(cs);
+        // stores time of last receivedSigShare. Used to detect timeouts
+        std::unordered_map<uint256, int64_t, StaticSaltedHasher> timeSeenForSessions GUARDED_BY(cs);
+    };
+    std::array<SessionShard, SESSION_SHARD_COUNT> sessionShards;
 
-    // stores time of last receivedSigShare. Used to detect timeouts
-    std::unordered_map<uint256, int64_t, StaticSaltedHasher> timeSeenForSessions GUARDED_BY(cs);
+    std::unordered_map<uint256, CSignedSession, StaticSaltedHasher> signedSessions GUARDED_BY(cs);
 
+    // The node states are not sharded. The lanes only touch them for our own shares when not all members are
+    // connected, while the network code and the send thread walk over all of them (e.g. when collecting messages or
+    // when a session is removed), so per-node locks would just have to be taken all at once there.
     std::unordered_map<NodeId, CSigSharesNodeState> nodeStates GUARDED_BY(cs);
     SigShareMap<std::pair<NodeId, int64_t>> sigSharesRequested GUARDED_BY(cs);
     SigShareMap<bool> sigSharesQueuedToAnnounce GUARDED_BY(cs);
@@ -397,18 +438,19 @@ private:
     FastRandomContext rnd GUARDED_BY(cs);
 
     CConnman& connman;
+    CBLSWorker& blsWorker;
     const CQuorumManager& qman;
     CSigningManager& sigman;
     int64_t lastCleanupTime{0};
-    std::atomic<uint32_t> recoveredSigsCounter{0};
 
 public:
-    explicit CSigSharesManager(CConnman& _connman, CQuorumManager& _qman, CSigningManager& _sigman) : connman(_connman), qman(_qman), sigman(_sigman)
+    explicit CSigSharesManager(CConnman& _connman, CBLSWorker& _blsWorker, CQuorumManager& _qman, CSigningManager& _sigman) :
+        connman(_connman), blsWorker(_blsWorker), qman(_qman), sigman(_sigman)
     {
         workInterrupt.reset();
     };
     CSigSharesManager() = delete;
-    ~CSigSharesManager() override = default;
+    ~CSigSharesManager() override;
 
     void StartWorkerThread();
     void StopWorkerThread();
@@ -426,7 +468,12 @@ public:
 
     static CDeterministicMNCPtr SelectMemberForRecovery(const CQuorumCPtr& quorum, const uint256& id, size_t attempt);
 
+    // current queue depths, see CollectLLMQGauges
+    std::map<std::string, int64_t> GetMetricGauges();
+
 private:
+    friend struct CSigSharesManagerTest;
+
     // all of these return false when the currently processed message should be aborted (as each message actually contains multiple messages)
     bool ProcessMessageSigSesAnn(const CNode* pfrom, const CSigSesAnn& ann);
     bool ProcessMessageSigSharesInv(const CNode* pfrom, const CSigSharesInv& inv);
@@ -442,18 +489,31 @@ private:
             std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& retQuorums);
     bool ProcessPendingSigShares(const CConnman& connman);
 
+    void VerifyAndProcessSigShares(const std::unordered_map<NodeId, std::vector<CSigShare>>& sigSharesByNodes,
+            const std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& quorums,
+            const CConnman& connman);
     void ProcessPendingSigShares(const std::vector<CSigShare>& sigSharesToProcess,
             const std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& quorums,
             const CConnman& connman);
 
     void ProcessSigShare(const CSigShare& sigShare, const CConnman& connman, const CQuorumCPtr& quorum);
-    void TryRecoverSig(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash);
+    void RecoverPendingSigs(size_t laneIndex);
+    void TryRecoverSigs(const std::vector<PendingRecovery>& pending);
+
+    size_t GetLaneIndex(const uint256& signHash, size_t laneCount) const;
+    SessionShard& GetSessionShard(const uint256& signHash);
+    bool AddSigShare(const CSigShare& sigShare, size_t& retSigShareCount);
+    bool HasSigShare(const SigShareKey& k);
+    std::optional<CSigShare> GetSigShare(const SigShareKey& k);
+    template<typename Callback>
+    void ForEachSigShare(Callback&& cb);
 
     bool GetSessionInfoByRecvId(NodeId nodeId, uint32_t sessionId, CSigSharesNodeState::SessionInfo& retInfo);
     static CSigShare RebuildSigShare(const CSigSharesNodeState::SessionInfo& session, const std::pair<uint16_t, CBLSLazySignature>& in);
 
     void Cleanup();
     void RemoveSigSharesForSession(const uint256& signHash) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    void RemoveSessionFromNodeStates(const uint256& signHash) EXCLUSIVE_LOCKS_REQUIRED(cs);
     void RemoveBannedNodeStates();
 
     void BanNode(NodeId nodeId);
@@ -465,6 +525,7 @@ private:
     void CollectSigSharesToAnnounce(std::unordered_map<NodeId, std::unordered_map<uint256, CSigSharesInv, StaticSaltedHasher>>& sigSharesToAnnounce) EXCLUSIVE_LOCKS_REQUIRED(cs);
     void SignPendingSigShares();
     void WorkThreadMain();
+    void SendThreadMain();
 };
 } // namespace llmq
 
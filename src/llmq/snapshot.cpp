@@ -4,6 +4,7 @@
 
 #include <llmq/snapshot.h>
 
+#include <evo/deterministicmns.h>
 #include <evo/simplifiedmns.h>
 #include <evo/specialtx.h>
 
@@ -13,6 +14,8 @@
 
 #include <base58.h>
 #include <chainparams.h>
+#include <compat/endian.h>
+#include <dbwrapper.h>
 #include <serialize.h>
 #include <univalue.h>
 #include <validation.h>
@@ -20,9 +23,12 @@
 namespace llmq {
 
 static const std::string DB_QUORUM_SNAPSHOT = "llmq_S";
+static const std::string DB_QUORUM_MEMBERS = "llmq_M";
 
 std::unique_ptr<CQuorumSnapshotManager> quorumSnapshotManager;
 
+CSerializedResponseCache quorumRotationInfoResponseCache(MAX_CACHED_QUORUMROTATIONINFOS, MAX_CACHED_QUORUMROTATIONINFO_BYTES);
+
 void CQuorumSnapshot::ToJson(UniValue& obj) const
 {
     //TODO Check this function if correct
@@ -391,4 +397,77 @@ void CQuorumSnapshotManager::StoreSnapshotForBlock(const Consensus::LLMQType llm
     quorumSnapshotCache.insert(snapshotHash, snapshot);
 }
 
+// Keyed by big endian height first, so that cleanup can stop at the first entry which is still recent enough
+static std::tuple<std::string, Consensus::LLMQType, uint32_t, uint256, int> BuildQuorumMembersKey(const Consensus::LLMQType llmqType, const CBlockIndex* pCycleQuorumBaseBlockIndex, int quorumIndex)
+{
+    return std::make_tuple(DB_QUORUM_MEMBERS, llmqType, htobe32(pCycleQuorumBaseBlockIndex->nHeight), pCycleQuorumBaseBlockIndex->GetBlockHash(), quorumIndex);
+}
+
+std::optional<std::vector<CDeterministicMNCPtr>> CQuorumSnapshotManager::GetQuorumMembers(const Consensus::LLMQType llmqType, const CBlockIndex* pCycleQuorumBaseBlockIndex, int quorumIndex)
+{
+    std::vector<CDeterministicMNCPtr> members;
+    if (!m_evoDb.Read(BuildQuorumMembersKey(llmqType, pCycleQuorumBaseBlockIndex, quorumIndex), members)) {
+        return std::nullopt;
+    }
+    return members;
+}
+
+void CQuorumSnapshotManager::StoreQuorumMembers(const Consensus::LLMQType llmqType, const CBlockIndex* pCycleQuorumBaseBlockIndex, const std::vector<std::vector<CDeterministicMNCPtr>>& quorumMembers)
+{
+    AssertLockNotHeld(m_evoDb.cs);
+    LOCK(m_evoDb.cs);
+    CDBBatch batch(m_evoDb.GetRawDB());
+    for (int i = 0; i < static_cast<int>(quorumMembers.size()); ++i) {
+        batch.Write(BuildQuorumMembersKey(llmqType, pCycleQuorumBaseBlockIndex, i), quorumMembers[i]);
+    }
+    m_evoDb.GetRawDB().WriteBatch(batch);
+}
+
+void CQuorumSnapshotManager::EraseQuorumMembers(const Consensus::LLMQType llmqType, const CBlockIndex* pCycleQuorumBaseBlockIndex)
+{
+    AssertLockNotHeld(m_evoDb.cs);
+    LOCK(m_evoDb.cs);
+    CDBBatch batch(m_evoDb.GetRawDB());
+    for (int i = 0; i < std::max(1, GetLLMQParams(llmqType).signingActiveQuorumCount); ++i) {
+        batch.Erase(BuildQuorumMembersKey(llmqType, pCycleQuorumBaseBlockIndex, i));
+    }
+    m_evoDb.GetRawDB().WriteBatch(batch);
+}
+
+void CQuorumSnapshotManager::CleanupOldQuorumMembers(int nTipHeight)
+{
+    AssertLockNotHeld(m_evoDb.cs);
+    LOCK(m_evoDb.cs);
+
+    for (const auto& params : Params().GetConsensus().llmqs) {
+        // Same depth as the one used for DKG contributions, older quorums are not used for signing anymore
+        const int MAX_STORE_DEPTH = 2 * params.signingActiveQuorumCount * params.dkgInterval;
+
+        CDBBatch batch(m_evoDb.GetRawDB());
+        size_t cnt_old{0};
+        std::unique_ptr<CDBIterator> pcursor(m_evoDb.GetRawDB().NewIterator());
+        auto start = std::make_tuple(DB_QUORUM_MEMBERS, params.type, uint32_t(0), uint256(), 0);
+        decltype(start) k;
+
+        pcursor->Seek(start);
+        while (pcursor->Valid()) {
+            if (!pcursor->GetKey(k) || std::get<0>(k) != DB_QUORUM_MEMBERS || std::get<1>(k) != params.type) {
+                break;
+            }
+            if (int(be32toh(std::get<2>(k))) + MAX_STORE_DEPTH >= nTipHeight) {
+                break;
+            }
+            batch.Erase(k);
+            cnt_old++;
+            pcursor->Next();
+        }
+        pcursor.reset();
+
+        if (cnt_old > 0) {
+            m_evoDb.GetRawDB().WriteBatch(batch);
+            LogPrint(BCLog::LLMQ, "CQuorumSnapshotManager::%s -- removed %lld old quorum members entries for llmq type %d\n", __func__, cnt_old, uint8_t(params.type));
+        }
+    }
+}
+
 } // namespace llmq
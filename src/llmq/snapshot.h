@@ -15,6 +15,7 @@
 #include <unordered_lru_cache.h>
 #include <util/irange.h>
 
+#include <memory>
 #include <optional>
 
 class CBlockIndex;
@@ -226,10 +227,27 @@ public:
 
     std::optional<CQuorumSnapshot> GetSnapshotForBlock(Consensus::LLMQType llmqType, const CBlockIndex* pindex);
     void StoreSnapshotForBlock(Consensus::LLMQType llmqType, const CBlockIndex* pindex, const CQuorumSnapshot& snapshot);
+
+    /**
+     * Computed quorum members are persisted so that they don't have to be recalculated after a restart. They are
+     * keyed by the (cycle) quorum base block and the quorum index, as all rotated quorums of a cycle are calculated
+     * at once, before the blocks of the later quorum indexes exist. Non-rotated quorums always use quorum index 0.
+     */
+    std::optional<std::vector<std::shared_ptr<const CDeterministicMN>>> GetQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pCycleQuorumBaseBlockIndex, int quorumIndex);
+    void StoreQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pCycleQuorumBaseBlockIndex, const std::vector<std::vector<std::shared_ptr<const CDeterministicMN>>>& quorumMembers);
+    void EraseQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pCycleQuorumBaseBlockIndex);
+    /** Removes persisted members of quorums which are too old to be still in use at the given tip height */
+    void CleanupOldQuorumMembers(int nTipHeight);
 };
 
 extern std::unique_ptr<CQuorumSnapshotManager> quorumSnapshotManager;
 
+/** Number and total size of the serialized QUORUMROTATIONINFO messages kept for repeated requests, these are much bigger */
+static constexpr size_t MAX_CACHED_QUORUMROTATIONINFOS = 8;
+static constexpr size_t MAX_CACHED_QUORUMROTATIONINFO_BYTES = 16 * 1024 * 1024;
+
+extern CSerializedResponseCache quorumRotationInfoResponseCache;
+
 } // namespace llmq
 
 #endif //BITCOIN_LLMQ_SNAPSHOT_H
@@ -92,13 +92,21 @@ std::vector<CDeterministicMNCPtr> GetAllQuorumMembers(Consensus::LLMQType llmqTy
         if (reset_cache) {
             LOCK(cs_indexed_members);
             mapIndexedQuorumMembers[llmqType].clear();
+            quorumSnapshotManager->EraseQuorumMembers(llmqType, pCycleQuorumBaseBlockIndex);
         } else if (LOCK(cs_indexed_members); mapIndexedQuorumMembers[llmqType].get(std::pair(pCycleQuorumBaseBlockIndex->GetBlockHash(), quorumIndex), quorumMembers)) {
             LOCK(cs_members);
             mapQuorumMembers[llmqType].insert(pQuorumBaseBlockIndex->GetBlockHash(), quorumMembers);
             return quorumMembers;
+        } else if (auto persisted = quorumSnapshotManager->GetQuorumMembers(llmqType, pCycleQuorumBaseBlockIndex, quorumIndex)) {
+            quorumMembers = std::move(*persisted);
+            mapIndexedQuorumMembers[llmqType].insert(std::make_pair(pCycleQuorumBaseBlockIndex->GetBlockHash(), quorumIndex), quorumMembers);
+            LOCK(cs_members);
+            mapQuorumMembers[llmqType].insert(pQuorumBaseBlockIndex->GetBlockHash(), quorumMembers);
+            return quorumMembers;
         }
 
         auto q = ComputeQuorumMembersByQuarterRotation(llmqType, pCycleQuorumBaseBlockIndex);
+        quorumSnapshotManager->StoreQuorumMembers(llmqType, pCycleQuorumBaseBlockIndex, q);
         LOCK(cs_indexed_members);
         for (int i = 0; i < static_cast<int>(q.size()); ++i) {
             mapIndexedQuorumMembers[llmqType].insert(std::make_pair(pCycleQuorumBaseBlockIndex->GetBlockHash(), i), q[i]);
@@ -106,7 +114,18 @@ std::vector<CDeterministicMNCPtr> GetAllQuorumMembers(Consensus::LLMQType llmqTy
 
         quorumMembers = q[quorumIndex];
     } else {
-        quorumMembers = ComputeQuorumMembers(llmqType, pQuorumBaseBlockIndex);
+        std::optional<std::vector<CDeterministicMNCPtr>> persisted;
+        if (reset_cache) {
+            quorumSnapshotManager->EraseQuorumMembers(llmqType, pQuorumBaseBlockIndex);
+        } else {
+            persisted = quorumSnapshotManager->GetQuorumMembers(llmqType, pQuorumBaseBlockIndex, 0);
+        }
+        if (persisted) {
+            quorumMembers = std::move(*persisted);
+        } else {
+            quorumMembers = ComputeQuorumMembers(llmqType, pQuorumBaseBlockIndex);
+            quorumSnapshotManager->StoreQuorumMembers(llmqType, pQuorumBaseBlockIndex, {quorumMembers});
+        }
     }
 
     LOCK(cs_members);
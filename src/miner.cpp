@@ -146,6 +146,8 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     nLockTimeCutoff = (STANDARD_LOCKTIME_VERIFY_FLAGS & LOCKTIME_MEDIAN_TIME_PAST)
                        ? nMedianTimePast
                        : pblock->GetBlockTime();
+    // the same for all TXs, so only look at the sporks once
+    fTxSafetyEnforced = m_clhandler.IsTxSafetyEnforced(m_isman);
 
     if (fDIP0003Active_context) {
         for (const Consensus::LLMQParams& params : llmq::utils::GetEnabledQuorumParams(pindexPrev)) {
@@ -274,7 +276,7 @@ bool BlockAssembler::TestPackageTransactions(const CTxMemPool::setEntries& packa
     for (CTxMemPool::txiter it : package) {
         if (!IsFinalTx(it->GetTx(), nHeight, nLockTimeCutoff))
             return false;
-        if (!m_clhandler.IsTxSafeForMining(m_isman, it->GetTx().GetHash())) {
+        if (fTxSafetyEnforced && !llmq::CChainLocksHandler::IsTxSafeForMining(*it, pblocktemplate->block.GetBlockTime())) {
             return false;
         }
     }
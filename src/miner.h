@@ -153,6 +153,7 @@ private:
     // Chain context for the block
     int nHeight;
     int64_t nLockTimeCutoff;
+    bool fTxSafetyEnforced; //!< Only include TXs that are safe in regard to ChainLocks
     const CChainParams& chainparams;
     const CTxMemPool& m_mempool;
     const CSporkManager& spork_manager;
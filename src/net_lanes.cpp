@@ -0,0 +1,92 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net_lanes.h>
+
+#include <ctpl_stl.h>
+#include <tinyformat.h>
+#include <util/irange.h>
+#include <util/system.h>
+#include <util/threadnames.h>
+
+#include <algorithm>
+
+CPeerMessageLanes::CPeerMessageLanes(int laneCount, std::function<void()> _onDrained) :
+    onDrained(std::move(_onDrained))
+{
+    laneCount = std::clamp(laneCount, 0, MAX_MESSAGE_LANES);
+    for (const auto i : irange::range(laneCount)) {
+        auto& lane = lanes.emplace_back(std::make_unique<ctpl::thread_pool>(1));
+        lane->push([threadName = strprintf("msglane-%d", i)](int) { util::ThreadRename(std::string(threadName)); });
+    }
+}
+
+CPeerMessageLanes::~CPeerMessageLanes()
+{
+    Stop();
+}
+
+bool CPeerMessageLanes::Push(NodeId nodeId, size_t size, std::function<void()>&& f)
+{
+    LOCK(cs);
+    if (stopped || lanes.empty()) {
+        return false;
+    }
+    queuedBytes[nodeId] += size;
+    lanes[size_t(nodeId) % lanes.size()]->push([this, nodeId, size, f = std::move(f)](int) {
+        try {
+            f();
+        } catch (...) {
+            PrintExceptionContinue(std::current_exception(), "CPeerMessageLanes");
+        }
+
+        bool drained{false};
+        {
+            LOCK(cs);
+            auto it = queuedBytes.find(nodeId);
+            if (it == queuedBytes.end()) {
+                return;
+            }
+            drained = it->second >= MAX_PEER_QUEUED_BYTES && it->second - size < MAX_PEER_QUEUED_BYTES;
+            it->second -= size;
+            if (it->second == 0) {
+                queuedBytes.erase(it);
+            }
+        }
+        if (drained && onDrained) {
+            onDrained();
+        }
+    });
+    return true;
+}
+
+bool CPeerMessageLanes::IsFull(NodeId nodeId) const
+{
+    return GetQueuedBytes(nodeId) >= MAX_PEER_QUEUED_BYTES;
+}
+
+size_t CPeerMessageLanes::GetQueuedBytes(NodeId nodeId) const
+{
+    LOCK(cs);
+    auto it = queuedBytes.find(nodeId);
+    return it != queuedBytes.end() ? it->second : 0;
+}
+
+void CPeerMessageLanes::Stop()
+{
+    {
+        LOCK(cs);
+        if (stopped) {
+            return;
+        }
+        stopped = true;
+    }
+    // queued jobs reference this object, make sure they are gone before any member is destroyed
+    for (auto& lane : lanes) {
+        lane->clear_queue();
+        lane->stop(true);
+    }
+    LOCK(cs);
+    queuedBytes.clear();
+}
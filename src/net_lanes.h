@@ -0,0 +1,63 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NET_LANES_H
+#define BITCOIN_NET_LANES_H
+
+#include <net.h>
+#include <sync.h>
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ctpl {
+class thread_pool;
+} // namespace ctpl
+
+//! Number of message processing lanes (0 = process all messages on the message handler thread)
+static const int DEFAULT_MESSAGE_LANES = 2;
+static const int MAX_MESSAGE_LANES = 16;
+
+/**
+ * Processes messages outside of the message handler thread. Every lane is a single worker thread and each peer is
+ * assigned to one lane, so the messages of a peer are processed in the order they were pushed while peers on different
+ * lanes are processed in parallel. The number of bytes a peer may have queued is limited, the message handler is
+ * expected to stop taking messages from a peer while IsFull() returns true.
+ */
+class CPeerMessageLanes
+{
+public:
+    //! Maximum number of bytes a single peer may have queued into its lane
+    static constexpr size_t MAX_PEER_QUEUED_BYTES{5 * 1000 * 1000};
+
+private:
+    mutable Mutex cs;
+    std::vector<std::unique_ptr<ctpl::thread_pool>> lanes;
+    std::unordered_map<NodeId, size_t> queuedBytes GUARDED_BY(cs);
+    bool stopped GUARDED_BY(cs){false};
+
+    //! Called whenever a peer drops below MAX_PEER_QUEUED_BYTES again
+    const std::function<void()> onDrained;
+
+public:
+    CPeerMessageLanes(int laneCount, std::function<void()> _onDrained);
+    ~CPeerMessageLanes();
+
+    size_t GetLaneCount() const { return lanes.size(); }
+
+    /**
+     * Queues f on the lane of the given peer. Returns false if the lanes were stopped already, f is not called then.
+     * @param[in]   size    Number of bytes accounted to the peer until f has finished
+     */
+    bool Push(NodeId nodeId, size_t size, std::function<void()>&& f) LOCKS_EXCLUDED(cs);
+    //! Whether the peer reached its limit of queued bytes
+    bool IsFull(NodeId nodeId) const LOCKS_EXCLUDED(cs);
+    size_t GetQueuedBytes(NodeId nodeId) const LOCKS_EXCLUDED(cs);
+    //! Drops all queued work and waits for running work to finish
+    void Stop() LOCKS_EXCLUDED(cs);
+};
+
+#endif // BITCOIN_NET_LANES_H
@@ -1255,7 +1255,9 @@ static bool BlockRequestAllowed(const CBlockIndex* pindex, const Consensus::Para
 
 PeerLogicValidation::PeerLogicValidation(CConnman* connmanIn, BanMan* banman, CScheduler &scheduler, ChainstateManager& chainman, CTxMemPool& pool,
                                         std::unique_ptr<LLMQContext>& llmq_ctx) :
-    connman(connmanIn), m_banman(banman), m_chainman(chainman), m_mempool(pool), m_llmq_ctx(llmq_ctx), m_stale_tip_check_time(0)
+    connman(connmanIn), m_banman(banman), m_chainman(chainman), m_mempool(pool), m_llmq_ctx(llmq_ctx),
+    m_msg_lanes(gArgs.GetArg("-msglanes", DEFAULT_MESSAGE_LANES), [this] { if (connman) connman->WakeMessageHandler(); }),
+    m_stale_tip_check_time(0)
 {
     // Initialize global variables that cannot be constructed at startup.
     recentRejects.reset(new CRollingBloomFilter(120000, 0.000001));
@@ -1355,6 +1357,10 @@ void PeerLogicValidation::BlockDisconnected(const std::shared_ptr<const CBlock>
     // should be just after a new block containing it is found.
     LOCK(g_cs_recent_confirmed_transactions);
     g_recent_confirmed_transactions->reset();
+
+    // Cached diffs are only served while both of their blocks are in the active chain, so the ones involving this
+    // block are useless now. Reorgs are rare enough to simply drop all of them
+    mnListDiffResponseCache.Clear();
 }
 
 // All of the following cache a recent block, and are protected by cs_most_recent_block
@@ -1415,6 +1421,9 @@ void PeerLogicValidation::UpdatedBlockTip(const CBlockIndex *pindexNew, const CB
     const int nNewHeight = pindexNew->nHeight;
     connman->SetBestHeight(nNewHeight);
 
+    // Cached rotation infos are keyed by the tip they were built for, none of them can be served anymore
+    llmq::quorumRotationInfoResponseCache.Clear();
+
     SetServiceFlagsIBDCache(!fInitialDownload);
     if (!fInitialDownload) {
         // Find the hashes of all blocks that weren't previously in the best chain.
@@ -2543,9 +2552,123 @@ std::pair<bool /*ret*/, bool /*do_return*/> static ValidateDSTX(CCoinJoinBroadca
     return {true, false};
 }
 
+/** Dash specific message handlers */
+enum class DashMessageHandler {
+    COINJOIN_CLIENT_QUEUE,
+    COINJOIN_CLIENT,
+    COINJOIN_SERVER,
+    SPORK,
+    MASTERNODE_SYNC,
+    GOVERNANCE,
+    MNAUTH,
+    QUORUM_BLOCK_PROCESSOR,
+    QUORUM_DKG,
+    QUORUM_MANAGER,
+    SIG_SHARES,
+    SIGNING,
+    CHAINLOCKS,
+    INSTANTSEND,
+};
+
+struct DashMessageHandlers {
+    //! Called in this order
+    std::vector<DashMessageHandler> handlers;
+    //! Whether the message can be processed in a message lane. Only messages which don't need cs_main for more than a
+    //! short lookup and which don't have to be ordered with the non-Dash messages of the same peer qualify
+    bool useLane{false};
+};
+
+/** Maps every Dash message type to the handlers which registered for it */
+static const std::unordered_map<std::string, DashMessageHandlers>& GetDashMessageHandlers()
+{
+    static const auto handlers = [] {
+        std::unordered_map<std::string, DashMessageHandlers> ret;
+        const auto reg = [&ret](DashMessageHandler handler, std::initializer_list<const char*> msgTypes, bool useLane = false) {
+            for (const char* msgType : msgTypes) {
+                // a message only goes to a lane if all of its handlers can process it there
+                auto& entry = ret[msgType];
+                entry.useLane = (entry.handlers.empty() || entry.useLane) && useLane;
+                entry.handlers.emplace_back(handler);
+            }
+        };
+        reg(DashMessageHandler::COINJOIN_CLIENT_QUEUE, {NetMsgType::DSQUEUE});
+        reg(DashMessageHandler::COINJOIN_CLIENT, {NetMsgType::DSSTATUSUPDATE, NetMsgType::DSFINALTX, NetMsgType::DSCOMPLETE});
+        reg(DashMessageHandler::COINJOIN_SERVER, {NetMsgType::DSACCEPT, NetMsgType::DSQUEUE, NetMsgType::DSVIN, NetMsgType::DSSIGNFINALTX});
+        reg(DashMessageHandler::SPORK, {NetMsgType::SPORK, NetMsgType::GETSPORKS});
+        reg(DashMessageHandler::MASTERNODE_SYNC, {NetMsgType::SYNCSTATUSCOUNT});
+        reg(DashMessageHandler::GOVERNANCE, {NetMsgType::MNGOVERNANCESYNC, NetMsgType::MNGOVERNANCEOBJECT, NetMsgType::MNGOVERNANCEOBJECTVOTE});
+        reg(DashMessageHandler::MNAUTH, {NetMsgType::MNAUTH});
+        reg(DashMessageHandler::QUORUM_BLOCK_PROCESSOR, {NetMsgType::QFCOMMITMENT});
+        reg(DashMessageHandler::QUORUM_DKG, {NetMsgType::QCONTRIB, NetMsgType::QCOMPLAINT, NetMsgType::QJUSTIFICATION, NetMsgType::QPCOMMITMENT, NetMsgType::QWATCH});
+        reg(DashMessageHandler::QUORUM_MANAGER, {NetMsgType::QGETDATA, NetMsgType::QDATA});
+        reg(DashMessageHandler::SIG_SHARES, {NetMsgType::QSIGSESANN, NetMsgType::QSIGSHARESINV, NetMsgType::QGETSIGSHARES, NetMsgType::QBSIGSHARES, NetMsgType::QSIGSHARE}, true);
+        reg(DashMessageHandler::SIGNING, {NetMsgType::QSIGREC}, true);
+        reg(DashMessageHandler::CHAINLOCKS, {NetMsgType::CLSIG});
+        reg(DashMessageHandler::INSTANTSEND, {NetMsgType::ISLOCK, NetMsgType::ISDLOCK});
+        return ret;
+    }();
+    return handlers;
+}
+
+static void ProcessDashMessage(DashMessageHandler handler, CNode* pfrom, const std::string& msg_type, CDataStream& vRecv,
+                               LLMQContext& llmq_ctx, CConnman* connman)
+{
+    switch (handler) {
+    case DashMessageHandler::COINJOIN_CLIENT_QUEUE:
+#ifdef ENABLE_WALLET
+        coinJoinClientQueueManager->ProcessMessage(*pfrom, msg_type, vRecv);
+#endif // ENABLE_WALLET
+        break;
+    case DashMessageHandler::COINJOIN_CLIENT:
+#ifdef ENABLE_WALLET
+        for (auto& pair : coinJoinClientManagers) {
+            pair.second->ProcessMessage(*pfrom, msg_type, vRecv, *connman);
+        }
+#endif // ENABLE_WALLET
+        break;
+    case DashMessageHandler::COINJOIN_SERVER:
+        coinJoinServer->ProcessMessage(*pfrom, msg_type, vRecv);
+        break;
+    case DashMessageHandler::SPORK:
+        sporkManager->ProcessSporkMessages(*pfrom, msg_type, vRecv, *connman);
+        break;
+    case DashMessageHandler::MASTERNODE_SYNC:
+        ::masternodeSync->ProcessMessage(*pfrom, msg_type, vRecv);
+        break;
+    case DashMessageHandler::GOVERNANCE:
+        governance->ProcessMessage(*pfrom, msg_type, vRecv, *connman);
+        break;
+    case DashMessageHandler::MNAUTH:
+        CMNAuth::ProcessMessage(*pfrom, msg_type, vRecv, *connman);
+        break;
+    case DashMessageHandler::QUORUM_BLOCK_PROCESSOR:
+        llmq_ctx.quorum_block_processor->ProcessMessage(*pfrom, msg_type, vRecv);
+        break;
+    case DashMessageHandler::QUORUM_DKG:
+        llmq_ctx.qdkgsman->ProcessMessage(pfrom, *llmq_ctx.qman, msg_type, vRecv);
+        break;
+    case DashMessageHandler::QUORUM_MANAGER:
+        llmq_ctx.qman->ProcessMessage(pfrom, msg_type, vRecv);
+        break;
+    case DashMessageHandler::SIG_SHARES:
+        llmq_ctx.shareman->ProcessMessage(pfrom, msg_type, vRecv, *sporkManager);
+        break;
+    case DashMessageHandler::SIGNING:
+        llmq_ctx.sigman->ProcessMessage(pfrom, msg_type, vRecv);
+        break;
+    case DashMessageHandler::CHAINLOCKS:
+        llmq_ctx.clhandler->ProcessMessage(pfrom, msg_type, vRecv);
+        break;
+    case DashMessageHandler::INSTANTSEND:
+        llmq_ctx.isman->ProcessMessage(pfrom, msg_type, vRecv);
+        break;
+    } // no default case, so the compiler can warn about missing cases
+}
+
 bool ProcessMessage(CNode* pfrom, const std::string& msg_type, CDataStream& vRecv, int64_t nTimeReceived,
                     const CChainParams& chainparams, ChainstateManager& chainman, CTxMemPool& mempool,
-                    LLMQContext& llmq_ctx, CConnman* connman, BanMan* banman, const std::atomic<bool>& interruptMsgProc)
+                    LLMQContext& llmq_ctx, CConnman* connman, BanMan* banman, const std::atomic<bool>& interruptMsgProc,
+                    CPeerMessageLanes* msg_lanes)
 {
     LogPrint(BCLog::NET, "received: %s (%u bytes) peer=%d\n", SanitizeString(msg_type), vRecv.size(), pfrom->GetId());
     statsClient.inc("message.received." + SanitizeString(msg_type), 1.0f);
@@ -3606,7 +3729,7 @@ bool ProcessMessage(CNode* pfrom, const std::string& msg_type, CDataStream& vRec
         } // cs_main
 
         if (fProcessBLOCKTXN)
-            return ProcessMessage(pfrom, NetMsgType::BLOCKTXN, blockTxnMsg, nTimeReceived, chainparams, chainman, mempool, llmq_ctx, connman, banman, interruptMsgProc);
+            return ProcessMessage(pfrom, NetMsgType::BLOCKTXN, blockTxnMsg, nTimeReceived, chainparams, chainman, mempool, llmq_ctx, connman, banman, interruptMsgProc, msg_lanes);
 
         if (fRevertToHeaderProcessing) {
             // Headers received from HB compact block peers are permitted to be
@@ -4003,10 +4126,29 @@ bool ProcessMessage(CNode* pfrom, const std::string& msg_type, CDataStream& vRec
 
         LOCK(cs_main);
 
+        // A diff between two blocks of the active chain never changes, so only these are served from the cache.
+        // Everything else is left to BuildSimplifiedMNListDiff, which also produces the errors
+        const CBlockIndex* baseBlockIndex = cmd.baseBlockHash.IsNull() ? ::ChainActive().Genesis() : LookupBlockIndex(cmd.baseBlockHash);
+        const CBlockIndex* blockIndex = LookupBlockIndex(cmd.blockHash);
+        const bool fCacheable = baseBlockIndex && blockIndex && ::ChainActive().Contains(baseBlockIndex) && ::ChainActive().Contains(blockIndex);
+        const uint256 cacheKey = ::SerializeHash(std::make_tuple(cmd.baseBlockHash, cmd.blockHash, pfrom->GetSendVersion()));
+
+        if (const auto cachedData = fCacheable ? mnListDiffResponseCache.Get(cacheKey) : nullptr) {
+            CSerializedNetMsg msg;
+            msg.command = NetMsgType::MNLISTDIFF;
+            msg.data = *cachedData;
+            connman->PushMessage(pfrom, std::move(msg));
+            return true;
+        }
+
         CSimplifiedMNListDiff mnListDiff;
         std::string strError;
         if (BuildSimplifiedMNListDiff(cmd.baseBlockHash, cmd.blockHash, mnListDiff, *llmq_ctx.quorum_block_processor, strError)) {
-            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNLISTDIFF, mnListDiff));
+            auto msg = msgMaker.Make(NetMsgType::MNLISTDIFF, mnListDiff);
+            if (fCacheable) {
+                mnListDiffResponseCache.Insert(cacheKey, std::make_shared<const std::vector<unsigned char>>(msg.data));
+            }
+            connman->PushMessage(pfrom, std::move(msg));
         } else {
             strError = strprintf("getmnlistdiff failed for baseBlockHash=%s, blockHash=%s. error=%s", cmd.baseBlockHash.ToString(), cmd.blockHash.ToString(), strError);
             Misbehaving(pfrom->GetId(), 1, strError);
@@ -4043,10 +4185,23 @@ bool ProcessMessage(CNode* pfrom, const std::string& msg_type, CDataStream& vRec
 
         LOCK(cs_main);
 
+        // The response is built relative to the tip, so it stays valid for as long as the tip doesn't change
+        const uint256 cacheKey = ::SerializeHash(std::make_tuple(cmd, ::ChainActive().Tip()->GetBlockHash(), pfrom->GetSendVersion()));
+
+        if (const auto cachedData = llmq::quorumRotationInfoResponseCache.Get(cacheKey)) {
+            CSerializedNetMsg msg;
+            msg.command = NetMsgType::QUORUMROTATIONINFO;
+            msg.data = *cachedData;
+            connman->PushMessage(pfrom, std::move(msg));
+            return true;
+        }
+
         llmq::CQuorumRotationInfo quorumRotationInfoRet;
         std::string strError;
         if (BuildQuorumRotationInfo(cmd, quorumRotationInfoRet, *llmq_ctx.qman, *llmq_ctx.quorum_block_processor, strError)) {
-            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::QUORUMROTATIONINFO, quorumRotationInfoRet));
+            auto msg = msgMaker.Make(NetMsgType::QUORUMROTATIONINFO, quorumRotationInfoRet);
+            llmq::quorumRotationInfoResponseCache.Insert(cacheKey, std::make_shared<const std::vector<unsigned char>>(msg.data));
+            connman->PushMessage(pfrom, std::move(msg));
         } else {
             strError = strprintf("getquorumrotationinfo failed for size(baseBlockHashes)=%d, blockRequestHash=%s. error=%s", cmd.baseBlockHashes.size(), cmd.blockRequestHash.ToString(), strError);
             Misbehaving(pfrom->GetId(), 1, strError);
@@ -4086,6 +4241,35 @@ bool ProcessMessage(CNode* pfrom, const std::string& msg_type, CDataStream& vRec
         return true;
     }
 
+    const auto& dashHandlers = GetDashMessageHandlers();
+    if (const auto it = dashHandlers.find(msg_type); it != dashHandlers.end()) {
+        const auto& [handlers, useLane] = it->second;
+        if (useLane && msg_lanes != nullptr && msg_lanes->GetLaneCount() != 0) {
+            // the lane holds a reference, so the node is not deleted before the message was processed
+            pfrom->AddRef();
+            const size_t nMessageSize = vRecv.size();
+            const bool pushed = msg_lanes->Push(pfrom->GetId(), nMessageSize, [pfrom, &msg_type = it->first, &handlers = handlers, vRecv = std::move(vRecv), nMessageSize, &llmq_ctx, connman]() mutable {
+                try {
+                    for (const auto handler : handlers) {
+                        ProcessDashMessage(handler, pfrom, msg_type, vRecv, llmq_ctx, connman);
+                    }
+                } catch (const std::exception& e) {
+                    LogPrint(BCLog::NET, "ProcessMessage(%s, %u bytes): Exception '%s' caught, peer=%d\n", SanitizeString(msg_type), nMessageSize, e.what(), pfrom->GetId());
+                }
+                pfrom->Release();
+            });
+            if (!pushed) {
+                // the lanes were stopped already, we are shutting down and the message is dropped
+                pfrom->Release();
+            }
+            return true;
+        }
+        for (const auto handler : handlers) {
+            ProcessDashMessage(handler, pfrom, msg_type, vRecv, llmq_ctx, connman);
+        }
+        return true;
+    }
+
     bool found = false;
     const std::vector<std::string> &allMessages = getAllNetMessageTypes();
     for (const std::string& msg : allMessages) {
@@ -4097,25 +4281,7 @@ bool ProcessMessage(CNode* pfrom, const std::string& msg_type, CDataStream& vRec
 
     if (found)
     {
-        //probably one the extensions
-#ifdef ENABLE_WALLET
-        coinJoinClientQueueManager->ProcessMessage(*pfrom, msg_type, vRecv);
-        for (auto& pair : coinJoinClientManagers) {
-            pair.second->ProcessMessage(*pfrom, msg_type, vRecv, *connman);
-        }
-#endif // ENABLE_WALLET
-        coinJoinServer->ProcessMessage(*pfrom, msg_type, vRecv);
-        sporkManager->ProcessSporkMessages(*pfrom, msg_type, vRecv, *connman);
-        ::masternodeSync->ProcessMessage(*pfrom, msg_type, vRecv);
-        governance->ProcessMessage(*pfrom, msg_type, vRecv, *connman);
-        CMNAuth::ProcessMessage(*pfrom, msg_type, vRecv, *connman);
-        llmq_ctx.quorum_block_processor->ProcessMessage(*pfrom, msg_type, vRecv);
-        llmq_ctx.qdkgsman->ProcessMessage(pfrom, *llmq_ctx.qman, msg_type, vRecv);
-        llmq_ctx.qman->ProcessMessage(pfrom, msg_type, vRecv);
-        llmq_ctx.shareman->ProcessMessage(pfrom, msg_type, vRecv, *sporkManager);
-        llmq_ctx.sigman->ProcessMessage(pfrom, msg_type, vRecv);
-        llmq_ctx.clhandler->ProcessMessage(pfrom, msg_type, vRecv);
-        llmq_ctx.isman->ProcessMessage(pfrom, msg_type, vRecv);
+        // known message type without a handler
         return true;
     }
 
@@ -4178,6 +4344,10 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     if (pfrom->fPauseSend)
         return false;
 
+    // Let the lanes catch up with this peer first, we are woken up again once they did
+    if (m_msg_lanes.IsFull(pfrom->GetId()))
+        return false;
+
     std::list<CNetMessage> msgs;
     {
         LOCK(pfrom->cs_vProcessMsg);
@@ -4201,7 +4371,7 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     bool fRet = false;
     try
     {
-        fRet = ProcessMessage(pfrom, msg_type, msg.m_recv, msg.m_time, chainparams, m_chainman, m_mempool, *m_llmq_ctx, connman, m_banman, interruptMsgProc);
+        fRet = ProcessMessage(pfrom, msg_type, msg.m_recv, msg.m_time, chainparams, m_chainman, m_mempool, *m_llmq_ctx, connman, m_banman, interruptMsgProc, &m_msg_lanes);
         if (interruptMsgProc)
             return false;
         if (!pfrom->vRecvGetData.empty())
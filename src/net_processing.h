@@ -8,6 +8,7 @@
 
 #include <consensus/params.h>
 #include <net.h>
+#include <net_lanes.h>
 #include <sync.h>
 #include <validationinterface.h>
 
@@ -31,6 +32,8 @@ private:
     ChainstateManager& m_chainman;
     CTxMemPool& m_mempool;
     std::unique_ptr<LLMQContext>& m_llmq_ctx;
+    //! Lanes processing LLMQ signing messages outside of the message handler thread
+    CPeerMessageLanes m_msg_lanes;
 
     bool MaybeDiscourageAndDisconnect(CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 public:
@@ -82,6 +85,9 @@ public:
     void EvictExtraOutboundPeers(int64_t time_in_seconds) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     /** Retrieve unbroadcast transactions from the mempool and reattempt sending to peers */
     void ReattemptInitialBroadcast(CScheduler& scheduler) const;
+    /** Drop all messages queued into the message lanes and wait for the ones being processed. Must be called before the
+     *  nodes are deleted */
+    void StopMessageLanes() { m_msg_lanes.Stop(); }
 
 private:
     int64_t m_stale_tip_check_time; //!< Next time to check for stale tip
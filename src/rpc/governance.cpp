@@ -719,13 +719,14 @@ static UniValue ListObjects(const std::string& strCachedSignal, const std::strin
 
     LOCK2(cs_main, governance->cs);
 
-    std::vector<CGovernanceObject> objs;
-    governance->GetAllNewerThan(objs, nStartTime);
+    // the vote counts are kept up to date by the objects, so there is no need to copy them together with their votes
+    const auto objs = governance->GetAllNewerThan(nStartTime);
 
     governance->UpdateLastDiffTime(GetTime());
     // CREATE RESULTS FOR USER
 
-    for (const auto& govObj : objs) {
+    for (const auto* pGovObj : objs) {
+        const CGovernanceObject& govObj = *pGovObj;
         if (strCachedSignal == "valid" && !govObj.IsSetCachedValid()) continue;
         if (strCachedSignal == "funding" && !govObj.IsSetCachedFunding()) continue;
         if (strCachedSignal == "delete" && !govObj.IsSetCachedDelete()) continue;
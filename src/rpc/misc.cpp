@@ -6,8 +6,11 @@
 
 #include <chainparams.h>
 #include <consensus/consensus.h>
+#include <evo/deterministicmns.h>
 #include <evo/mnauth.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
+#include <index/spentindex.h>
 #include <init.h>
 #include <interfaces/chain.h>
 #include <key_io.h>
@@ -30,6 +33,7 @@
 #include <spork.h>
 
 #include <stdint.h>
+#include <optional>
 #include <tuple>
 #ifdef HAVE_MALLOC_INFO
 #include <malloc.h>
@@ -642,6 +646,100 @@ static bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelt
     return a.second.time < b.second.time;
 }
 
+/** Parse the "limit" and "cursor" pagination options of the address index RPCs. */
+static size_t getPageFromParams(const UniValue& params, std::optional<CAddressIndexKey>& cursor)
+{
+    if (!params[0].isObject()) {
+        return 0;
+    }
+
+    UniValue limitValue = find_value(params[0].get_obj(), "limit");
+    UniValue cursorValue = find_value(params[0].get_obj(), "cursor");
+
+    if (limitValue.isNull()) {
+        if (!cursorValue.isNull()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor requires a limit");
+        }
+        return 0;
+    }
+    if (!limitValue.isNum() || limitValue.get_int() <= 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Limit is expected to be a positive number");
+    }
+    if (!cursorValue.isNull()) {
+        if (!cursorValue.isStr() || !IsHex(cursorValue.get_str())) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+        CDataStream ssCursor(ParseHex(cursorValue.get_str()), SER_DISK, CLIENT_VERSION);
+        try {
+            CAddressIndexKey key;
+            ssCursor >> key;
+            if (!ssCursor.empty()) {
+                throw std::ios_base::failure("trailing data");
+            }
+            cursor = key;
+        } catch (const std::exception&) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+    }
+    return limitValue.get_int();
+}
+
+static std::string getCursorString(const CAddressIndexKey& key)
+{
+    CDataStream ssCursor(SER_DISK, CLIENT_VERSION);
+    ssCursor << key;
+    return HexStr(ssCursor);
+}
+
+/**
+ * Read at most `limit` deltas of the given addresses, one address after the other, continuing
+ * at `cursor` if it is set. When `whole_txs` is set, the deltas of a transaction are never split
+ * across pages, so a page may exceed the limit. Returns the cursor of the next page, if any.
+ */
+static std::optional<CAddressIndexKey> getAddressDeltasPage(const std::vector<std::pair<uint160, int> >& addresses,
+                                                            int start, int end, size_t limit, bool whole_txs,
+                                                            const std::optional<CAddressIndexKey>& cursor,
+                                                            std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex)
+{
+    const bool has_range = start > 0 && end > 0;
+    auto first_key = [&](size_t pos) {
+        return CAddressIndexKey(addresses[pos].second, addresses[pos].first, has_range ? start : 0, 0, uint256(), 0, false);
+    };
+
+    size_t pos = 0;
+    if (cursor) {
+        while (pos < addresses.size() && (addresses[pos].first != cursor->hashBytes || (unsigned int)addresses[pos].second != cursor->type)) {
+            pos++;
+        }
+        if (pos == addresses.size()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor does not belong to any of the addresses");
+        }
+    }
+    // the cursor only applies to the address it was created for, all following addresses are read from their start
+    const size_t cursor_pos = pos;
+
+    for (; pos < addresses.size(); pos++) {
+        if (addressIndex.size() >= limit) {
+            return first_key(pos);
+        }
+        std::optional<CAddressIndexKey> next;
+        const CAddressIndexKey from = (cursor && pos == cursor_pos) ? *cursor : first_key(pos);
+        if (!g_addressindex || !g_addressindex->ReadAddressIndex(from, has_range ? end : 0, limit - addressIndex.size(), addressIndex, next)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        while (whole_txs && next && !addressIndex.empty() && next->txhash == addressIndex.back().first.txhash) {
+            if (!g_addressindex->ReadAddressIndex(*next, has_range ? end : 0, 1, addressIndex, next)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+        }
+        if (next) {
+            return next;
+        }
+    }
+
+    return std::nullopt;
+}
+
 static UniValue getaddressmempool(const JSONRPCRequest& request)
 {
     RPCHelpMan{"getaddressmempool",
@@ -749,6 +847,10 @@ static UniValue getaddressutxos(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    if (g_addressindex && !g_addressindex->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Addresses are still in the process of being indexed, try again later");
+    }
+
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
 
     for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
@@ -782,8 +884,21 @@ static UniValue getaddressutxos(const JSONRPCRequest& request)
 
 static UniValue getaddressdeltas(const JSONRPCRequest& request)
 {
+    const RPCResult delta_result{RPCResult::Type::OBJ, "", "",
+        {
+            {RPCResult::Type::NUM, "satoshis", "The difference of duffs"},
+            {RPCResult::Type::STR_HEX, "txid", "The related txid"},
+            {RPCResult::Type::NUM, "index", "The related input or output index"},
+            {RPCResult::Type::NUM, "blockindex", "The related block index"},
+            {RPCResult::Type::NUM, "height", "The block height"},
+            {RPCResult::Type::STR, "address", "The base58check encoded address"},
+        }};
+
     RPCHelpMan{"getaddressdeltas",
-        "\nReturns all changes for an address (requires addressindex to be enabled).\n",
+        "\nReturns all changes for an address (requires addressindex to be enabled).\n"
+        "\nThe request object may also contain \"start\" and \"end\" block heights and a \"limit\" on the number of\n"
+        "changes to return. Results of a limited request come with a \"cursor\" that continues the listing when it is\n"
+        "passed in the next request. Multiple addresses are then listed one after the other.\n",
         {
             {"addresses", RPCArg::Type::ARR, /* default */ "", "",
                 {
@@ -791,21 +906,19 @@ static UniValue getaddressdeltas(const JSONRPCRequest& request)
                 },
             },
         },
-        RPCResult{
-            RPCResult::Type::ARR, "", "",
-            {
-                {RPCResult::Type::OBJ, "", "",
+        RPCResults{
+            {"if \"limit\" is not set",
+                RPCResult::Type::ARR, "", "", {delta_result}},
+            {"if \"limit\" is set",
+                RPCResult::Type::OBJ, "", "",
                 {
-                    {RPCResult::Type::NUM, "satoshis", "The difference of duffs"},
-                    {RPCResult::Type::STR_HEX, "txid", "The related txid"},
-                    {RPCResult::Type::NUM, "index", "The related input or output index"},
-                    {RPCResult::Type::NUM, "blockindex", "The related block index"},
-                    {RPCResult::Type::NUM, "height", "The block height"},
-                    {RPCResult::Type::STR, "address", "The base58check encoded address"},
+                    {RPCResult::Type::ARR, "deltas", "", {delta_result}},
+                    {RPCResult::Type::STR_HEX, "cursor", /* optional */ true, "The cursor of the next page, if there are more changes"},
                 }},
-            }},
+        },
         RPCExamples{
             HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+    + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
     + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         },
     }.Check(request);
@@ -831,21 +944,32 @@ static UniValue getaddressdeltas(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    std::optional<CAddressIndexKey> cursor;
+    const size_t limit = getPageFromParams(request.params, cursor);
+
+    if (g_addressindex && !g_addressindex->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Addresses are still in the process of being indexed, try again later");
+    }
+
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    if (limit > 0) {
+        cursor = getAddressDeltasPage(addresses, start, end, limit, /* whole_txs */ false, cursor, addressIndex);
+    } else {
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (start > 0 && end > 0) {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+            } else {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
             }
         }
     }
 
-    UniValue result(UniValue::VARR);
+    UniValue deltas(UniValue::VARR);
 
     for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
         std::string address;
@@ -860,9 +984,18 @@ static UniValue getaddressdeltas(const JSONRPCRequest& request)
         delta.pushKV("blockindex", (int)it->first.txindex);
         delta.pushKV("height", it->first.blockHeight);
         delta.pushKV("address", address);
-        result.push_back(delta);
+        deltas.push_back(delta);
+    }
+
+    if (limit == 0) {
+        return deltas;
     }
 
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("deltas", deltas);
+    if (cursor) {
+        result.pushKV("cursor", getCursorString(*cursor));
+    }
     return result;
 }
 
@@ -884,6 +1017,9 @@ static UniValue getaddressbalance(const JSONRPCRequest& request)
                     {RPCResult::Type::NUM, "balance_immature", "The current immature balance in duffs"},
                     {RPCResult::Type::NUM, "balance_spendable", "The current spendable balance in duffs"},
                     {RPCResult::Type::NUM, "received", "The total number of duffs received (including change)"},
+                    {RPCResult::Type::NUM, "tx_count", "The number of transactions, counted once for each address they involve"},
+                    {RPCResult::Type::NUM, "first_height", /* optional */ true, "The height of the first block involving any of the addresses"},
+                    {RPCResult::Type::NUM, "last_height", /* optional */ true, "The height of the last block involving any of the addresses"},
                 }},
         RPCExamples{
             HelpExampleCli("getaddressbalance", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
@@ -897,38 +1033,54 @@ static UniValue getaddressbalance(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-        }
+    if (!g_addressindex) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    }
+    if (!g_addressindex->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Addresses are still in the process of being indexed, try again later");
     }
 
     int nHeight = WITH_LOCK(cs_main, return ::ChainActive().Height());
 
     CAmount balance = 0;
-    CAmount balance_spendable = 0;
     CAmount balance_immature = 0;
     CAmount received = 0;
+    uint64_t tx_count = 0;
+    std::optional<int> first_height;
+    std::optional<int> last_height;
 
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        if (it->second > 0) {
-            received += it->second;
+    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+        CAddressBalanceValue totals;
+        if (g_addressindex->ReadAddressBalance((*it).first, (*it).second, totals)) {
+            balance += totals.balance;
+            received += totals.received;
+            tx_count += totals.txCount;
+            first_height = std::min(first_height.value_or(totals.firstHeight), totals.firstHeight);
+            last_height = std::max(last_height.value_or(totals.lastHeight), totals.lastHeight);
         }
-        if (it->first.txindex == 0 && nHeight - it->first.blockHeight < COINBASE_MATURITY) {
-            balance_immature += it->second;
-        } else {
-            balance_spendable += it->second;
+
+        // Only coinbase outputs of the last COINBASE_MATURITY blocks can be immature
+        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+        if (!GetAddressIndex((*it).first, (*it).second, addressIndex, std::max(1, nHeight - COINBASE_MATURITY + 1), std::max(1, nHeight))) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it2=addressIndex.begin(); it2!=addressIndex.end(); it2++) {
+            if (it2->first.txindex == 0) {
+                balance_immature += it2->second;
+            }
         }
-        balance += it->second;
     }
 
     UniValue result(UniValue::VOBJ);
     result.pushKV("balance", balance);
     result.pushKV("balance_immature", balance_immature);
-    result.pushKV("balance_spendable", balance_spendable);
+    result.pushKV("balance_spendable", balance - balance_immature);
     result.pushKV("received", received);
+    result.pushKV("tx_count", tx_count);
+    if (first_height) {
+        result.pushKV("first_height", *first_height);
+        result.pushKV("last_height", *last_height);
+    }
 
     return result;
 
@@ -937,7 +1089,11 @@ static UniValue getaddressbalance(const JSONRPCRequest& request)
 static UniValue getaddresstxids(const JSONRPCRequest& request)
 {
     RPCHelpMan{"getaddresstxids",
-        "\nReturns the txids for an address(es) (requires addressindex to be enabled).\n",
+        "\nReturns the txids for an address(es) (requires addressindex to be enabled).\n"
+        "\nThe request object may also contain \"start\" and \"end\" block heights and a \"limit\" on the number of\n"
+        "address changes to read, which also bounds the number of txids returned. Results of a limited request come\n"
+        "with a \"cursor\" that continues the listing when it is passed in the next request. Multiple addresses are\n"
+        "then listed one after the other instead of being sorted by height, so a txid can occur for each address.\n",
         {
             {"addresses", RPCArg::Type::ARR, /* default */ "", "",
                 {
@@ -945,12 +1101,21 @@ static UniValue getaddresstxids(const JSONRPCRequest& request)
                 },
             },
         },
-        RPCResult{
-            RPCResult::Type::ARR, "", "",
-            {{RPCResult::Type::STR_HEX, "transactionid", "The transaction id"}}
+        RPCResults{
+            {"if \"limit\" is not set",
+                RPCResult::Type::ARR, "", "",
+                {{RPCResult::Type::STR_HEX, "transactionid", "The transaction id"}}},
+            {"if \"limit\" is set",
+                RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::ARR, "txids", "",
+                        {{RPCResult::Type::STR_HEX, "transactionid", "The transaction id"}}},
+                    {RPCResult::Type::STR_HEX, "cursor", /* optional */ true, "The cursor of the next page, if there are more txids"},
+                }},
         },
         RPCExamples{
             HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+    + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
     + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         },
     }.Check(request);
@@ -972,8 +1137,34 @@ static UniValue getaddresstxids(const JSONRPCRequest& request)
         }
     }
 
+    std::optional<CAddressIndexKey> cursor;
+    const size_t limit = getPageFromParams(request.params, cursor);
+
+    if (g_addressindex && !g_addressindex->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Addresses are still in the process of being indexed, try again later");
+    }
+
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
+    if (limit > 0) {
+        cursor = getAddressDeltasPage(addresses, start, end, limit, /* whole_txs */ true, cursor, addressIndex);
+
+        UniValue txids(UniValue::VARR);
+        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
+            // The changes of a transaction are adjacent and never split across pages
+            if (it == addressIndex.begin() || it->first.txhash != std::prev(it)->first.txhash || it->first.hashBytes != std::prev(it)->first.hashBytes) {
+                txids.push_back(it->first.txhash.GetHex());
+            }
+        }
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("txids", txids);
+        if (cursor) {
+            result.pushKV("cursor", getCursorString(*cursor));
+        }
+        return result;
+    }
+
     for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
         if (start > 0 && end > 0) {
             if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
@@ -1049,6 +1240,10 @@ static UniValue getspentinfo(const JSONRPCRequest& request)
     CSpentIndexKey key(txid, outputIndex);
     CSpentIndexValue value;
 
+    if (g_spentindex && !g_spentindex->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Spent outputs are still in the process of being indexed, try again later");
+    }
+
     if (!GetSpentIndex(key, value)) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unable to get spent info");
     }
@@ -1105,6 +1300,17 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCMNListCacheInfo()
+{
+    const auto stats = deterministicMNManager->GetCacheStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("lists", uint64_t(stats.lists));
+    obj.pushKV("max_snapshots", uint64_t(stats.maxSnapshots));
+    obj.pushKV("hits", stats.hits);
+    obj.pushKV("misses", stats.misses);
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -1149,6 +1355,13 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
                         {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                         {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
                     }},
+                    {RPCResult::Type::OBJ, "mnlistcache", /* optional */ true, "Information about the in-memory masternode list cache",
+                    {
+                        {RPCResult::Type::NUM, "lists", "Number of masternode lists kept in memory"},
+                        {RPCResult::Type::NUM, "max_snapshots", "Maximum number of intermediate snapshots kept in memory (see -mnlistcachesize)"},
+                        {RPCResult::Type::NUM, "hits", "Number of list lookups which were served from memory"},
+                        {RPCResult::Type::NUM, "misses", "Number of list lookups which had to read from disk or replay diffs"},
+                    }},
                 }
             },
             RPCResult{"mode \"mallocinfo\"",
@@ -1165,6 +1378,9 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        if (deterministicMNManager) {
+            obj.pushKV("mnlistcache", RPCMNListCacheInfo());
+        }
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
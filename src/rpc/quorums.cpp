@@ -18,6 +18,7 @@
 #include <llmq/context.h>
 #include <llmq/debug.h>
 #include <llmq/dkgsession.h>
+#include <llmq/metrics.h>
 #include <llmq/quorums.h>
 #include <llmq/signing.h>
 #include <llmq/signing_shares.h>
@@ -346,6 +347,32 @@ static UniValue quorum_dkgstatus(const JSONRPCRequest& request)
     return ret;
 }
 
+static void quorum_metrics_help(const JSONRPCRequest& request)
+{
+    RPCHelpMan{"quorum metrics",
+        "Return counters, timings (in milliseconds) and current queue depths of the signing pipeline, InstantSend,\n"
+        "ChainLocks and DKG. Counters and timings are accumulated since startup.\n",
+        {},
+        RPCResults{},
+        RPCExamples{""},
+    }.Check(request);
+}
+
+static UniValue quorum_metrics(const JSONRPCRequest& request)
+{
+    quorum_metrics_help(request);
+
+    const LLMQContext& llmq_ctx = EnsureLLMQContext(request.context);
+
+    UniValue ret = llmq::llmqMetrics.ToJson();
+    UniValue gauges(UniValue::VOBJ);
+    for (const auto& [name, value] : llmq::CollectLLMQGauges(llmq_ctx)) {
+        gauges.pushKV(name, value);
+    }
+    ret.pushKV("gauges", gauges);
+    return ret;
+}
+
 static void quorum_memberof_help(const JSONRPCRequest& request)
 {
     RPCHelpMan{"quorum memberof",
@@ -786,6 +813,7 @@ static UniValue quorum_rotationinfo(const JSONRPCRequest& request)
             "  info              - Return information about a quorum\n"
             "  dkgsimerror       - Simulates DKG errors and malicious behavior\n"
             "  dkgstatus         - Return the status of the current DKG process\n"
+            "  metrics           - Return counters, timings and queue depths of the LLMQ subsystems\n"
             "  memberof          - Checks which quorums the given masternode is a member of\n"
             "  sign              - Threshold-sign a message\n"
             "  verify            - Test if a quorum signature is valid for a request id and a message hash\n"
@@ -817,6 +845,8 @@ static UniValue _quorum(const JSONRPCRequest& request)
         return quorum_info(new_request);
     } else if (command == "quorumdkgstatus") {
         return quorum_dkgstatus(new_request);
+    } else if (command == "quorummetrics") {
+        return quorum_metrics(new_request);
     } else if (command == "quorummemberof") {
         return quorum_memberof(new_request);
     } else if (command == "quorumsign" || command == "quorumverify" || command == "quorumhasrecsig" || command == "quorumgetrecsig" || command == "quorumisconflicting") {
@@ -8,6 +8,7 @@
 
 #include <uint256.h>
 #include <amount.h>
+#include <hash.h>
 #include <script/script.h>
 #include <serialize.h>
 
@@ -323,6 +324,36 @@ struct CAddressIndexIteratorKey {
     }
 };
 
+/** Running totals of all address index deltas of an address */
+struct CAddressBalanceValue {
+    CAmount balance;
+    CAmount received;
+    uint64_t txCount;
+    int firstHeight;
+    int lastHeight;
+
+    SERIALIZE_METHODS(CAddressBalanceValue, obj)
+    {
+        READWRITE(obj.balance, obj.received, obj.txCount, obj.firstHeight, obj.lastHeight);
+    }
+
+    CAddressBalanceValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+        txCount = 0;
+        firstHeight = -1;
+        lastHeight = -1;
+    }
+
+    bool IsNull() const {
+        return (txCount == 0);
+    }
+};
+
 struct CAddressIndexIteratorHeightKey {
     unsigned int type;
     uint160 hashBytes;
@@ -361,5 +392,27 @@ struct CAddressIndexIteratorHeightKey {
     }
 };
 
+/**
+ * Get the address type (1 for P2PKH and P2PK, 2 for P2SH) and hash under which outputs with
+ * the given script are indexed. Returns false for all other scripts.
+ */
+inline bool GetIndexAddress(const CScript& script, int& addressType, uint160& addressHash)
+{
+    if (script.IsPayToScriptHash()) {
+        addressHash = uint160(std::vector<unsigned char>(script.begin() + 2, script.begin() + 22));
+        addressType = 2;
+    } else if (script.IsPayToPublicKeyHash()) {
+        addressHash = uint160(std::vector<unsigned char>(script.begin() + 3, script.begin() + 23));
+        addressType = 1;
+    } else if (script.IsPayToPublicKey()) {
+        addressHash = Hash160(script.begin() + 1, script.end() - 1);
+        addressType = 1;
+    } else {
+        addressHash.SetNull();
+        addressType = 0;
+        return false;
+    }
+    return true;
+}
 
 #endif // BITCOIN_SPENTINDEX_H
@@ -33,10 +33,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <compat.h>
 #include <netbase.h>
 #include <random.h>
+#include <threadinterrupt.h>
 #include <util/system.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
 
 statsd::StatsdClient statsClient;
 
@@ -61,6 +67,69 @@ inline bool should_send(float sample_rate)
     return sample_rate > p;
 }
 
+enum class MetricType : uint8_t {
+    COUNT,
+    GAUGE,
+    GAUGE_DOUBLE,
+    TIMING,
+    RAW,
+};
+
+struct Metric {
+    MetricType type{MetricType::RAW};
+    std::string key;
+    int64_t value{0};
+    double dvalue{0};
+    float sample_rate{1.0};
+};
+
+/**
+ * Multi-producer single-consumer queue (non-intrusive variant of Dmitry Vyukov's MPSC queue). Producers only do a
+ * single atomic exchange and never block each other or the consumer. A pop can miss an element whose producer has
+ * not linked it yet, it is then returned by a later pop.
+ */
+class MetricQueue
+{
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        Metric metric;
+    };
+
+    std::atomic<Node*> head;
+    // only accessed by the consumer
+    Node* tail;
+
+public:
+    MetricQueue() : head(new Node), tail(head.load()) {}
+    ~MetricQueue()
+    {
+        Metric metric;
+        while (pop(metric)) {}
+        delete tail;
+    }
+
+    void push(Metric&& metric)
+    {
+        Node* node = new Node;
+        node->metric = std::move(metric);
+        Node* prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    bool pop(Metric& metric)
+    {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        metric = std::move(next->metric);
+        delete tail;
+        tail = next;
+        return true;
+    }
+};
+
 struct _StatsdClientData {
     SOCKET  sock;
     struct  sockaddr_in server;
@@ -72,8 +141,45 @@ struct _StatsdClientData {
     bool    init;
 
     char    errmsg[1024];
+
+    MetricQueue queue;
+    std::atomic<size_t> queued{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> running{false};
+
+    std::thread thread;
+    CThreadInterrupt interrupt;
+    int flush_interval_ms{DEFAULT_STATSD_FLUSH_INTERVAL};
+    bool percentiles{DEFAULT_STATSD_PERCENTILES};
+
+    // aggregated between two flushes, only accessed by the sender thread (or by Stop() after it was joined)
+    std::map<std::string, double> counters;
+    std::map<std::string, std::string> gauges;
+    std::map<std::string, std::pair<float, std::vector<int64_t>>> timings;
+    std::vector<std::string> raw;
 };
 
+/* will change the original string */
+static void cleanup(std::string& key)
+{
+    size_t pos = key.find_first_of(":|@");
+    while ( pos != std::string::npos )
+    {
+        key[pos] = '_';
+        pos = key.find_first_of(":|@");
+    }
+}
+
+// prefix the namespace and partition stats by node name if set
+static std::string FormatKey(const _StatsdClientData& d, std::string key)
+{
+    if (!d.nodename.empty()) {
+        key = key + "." + d.nodename;
+    }
+    cleanup(key);
+    return d.ns + key;
+}
+
 StatsdClient::StatsdClient(const std::string& host, int port, const std::string& ns) :
     d(std::make_unique<_StatsdClientData>())
 {
@@ -83,28 +189,27 @@ StatsdClient::StatsdClient(const std::string& host, int port, const std::string&
 
 StatsdClient::~StatsdClient()
 {
+    Stop();
     // close socket
     CloseSocket(d->sock);
 }
 
-void StatsdClient::config(const std::string& host, int port, const std::string& ns)
+void StatsdClient::config(const std::string& host, int port, const std::string& ns, const std::string& nodename)
 {
+    if (d->running) return;
+
     d->ns = ns;
     d->host = host;
     d->port = port;
+    d->nodename = nodename;
     d->init = false;
     CloseSocket(d->sock);
 }
 
 int StatsdClient::init()
 {
-    static bool fEnabled = gArgs.GetBoolArg("-statsenabled", DEFAULT_STATSD_ENABLE);
-    if (!fEnabled) return -3;
-
     if ( d->init ) return 0;
 
-    config(gArgs.GetArg("-statshost", DEFAULT_STATSD_HOST), gArgs.GetArg("-statsport", DEFAULT_STATSD_PORT), gArgs.GetArg("-statsns", DEFAULT_STATSD_NAMESPACE));
-
     d->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if ( d->sock == INVALID_SOCKET ) {
         snprintf(d->errmsg, sizeof(d->errmsg), "could not create socket, err=%m");
@@ -121,22 +226,43 @@ int StatsdClient::init()
         return -2;
     }
 
-    if (gArgs.IsArgSet("-statshostname")) {
-        d->nodename = gArgs.GetArg("-statshostname", DEFAULT_STATSD_HOSTNAME);
-    }
-
     d->init = true;
     return 0;
 }
 
-/* will change the original string */
-void StatsdClient::cleanup(std::string& key)
+bool StatsdClient::Start(int flush_interval_ms, bool percentiles)
 {
-    size_t pos = key.find_first_of(":|@");
-    while ( pos != std::string::npos )
-    {
-        key[pos] = '_';
-        pos = key.find_first_of(":|@");
+    if (d->running) return true;
+    if (init() != 0) return false;
+
+    d->flush_interval_ms = std::max(flush_interval_ms, MIN_STATSD_FLUSH_INTERVAL);
+    d->percentiles = percentiles;
+    d->interrupt.reset();
+    d->running = true;
+    d->thread = std::thread(&TraceThread<std::function<void()> >, "statsd", std::function<void()>(std::bind(&StatsdClient::ThreadSender, this)));
+    return true;
+}
+
+void StatsdClient::Stop()
+{
+    if (!d->running.exchange(false)) return;
+
+    d->interrupt();
+    if (d->thread.joinable()) {
+        d->thread.join();
+    }
+    flush();
+}
+
+uint64_t StatsdClient::GetDroppedCount() const
+{
+    return d->dropped;
+}
+
+void StatsdClient::ThreadSender()
+{
+    while (d->interrupt.sleep_for(std::chrono::milliseconds(d->flush_interval_ms))) {
+        flush();
     }
 }
 
@@ -170,74 +296,168 @@ int StatsdClient::timing(const std::string& key, size_t ms, float sample_rate)
     return send(key, ms, "ms", sample_rate);
 }
 
+int StatsdClient::enqueue(Metric&& metric)
+{
+    if (!d->running.load(std::memory_order_relaxed)) {
+        return -3;
+    }
+    if (d->queued.fetch_add(1, std::memory_order_relaxed) >= MAX_STATSD_QUEUE_SIZE) {
+        d->queued.fetch_sub(1, std::memory_order_relaxed);
+        d->dropped++;
+        return -4;
+    }
+    d->queue.push(std::move(metric));
+    return 0;
+}
+
 int StatsdClient::send(std::string key, size_t value, const std::string& type, float sample_rate)
 {
+    if (!d->running.load(std::memory_order_relaxed)) {
+        return -3;
+    }
     if (!should_send(sample_rate)) {
         return 0;
     }
 
-    // partition stats by node name if set
-    if (!d->nodename.empty())
-        key = key + "." + d->nodename;
-
-    cleanup(key);
-
-    char buf[256];
-    if ( fequal( sample_rate, 1.0 ) )
-    {
-        snprintf(buf, sizeof(buf), "%s%s:%zd|%s",
-                d->ns.c_str(), key.c_str(), (ssize_t) value, type.c_str());
+    Metric metric;
+    metric.key = std::move(key);
+    metric.value = (int64_t) value;
+    metric.sample_rate = sample_rate;
+    if (type == "c") {
+        metric.type = MetricType::COUNT;
+    } else if (type == "g") {
+        metric.type = MetricType::GAUGE;
+    } else if (type == "ms") {
+        metric.type = MetricType::TIMING;
+    } else {
+        // unknown types can't be aggregated and are forwarded as-is
+        metric.type = MetricType::RAW;
+        metric.key = strprintf("%s:%d|%s", FormatKey(*d, std::move(metric.key)), metric.value, type);
     }
-    else
-    {
-        snprintf(buf, sizeof(buf), "%s%s:%zd|%s|@%.2f",
-                d->ns.c_str(), key.c_str(), (ssize_t) value, type.c_str(), sample_rate);
-    }
-
-    return send(buf);
+    return enqueue(std::move(metric));
 }
 
 int StatsdClient::sendDouble(std::string key, double value, const std::string& type, float sample_rate)
 {
+    if (!d->running.load(std::memory_order_relaxed)) {
+        return -3;
+    }
     if (!should_send(sample_rate)) {
         return 0;
     }
 
-    // partition stats by node name if set
-    if (!d->nodename.empty())
-        key = key + "." + d->nodename;
+    Metric metric;
+    metric.key = std::move(key);
+    metric.dvalue = value;
+    metric.sample_rate = sample_rate;
+    metric.type = MetricType::GAUGE_DOUBLE;
+    if (type != "g") {
+        // unknown types can't be aggregated and are forwarded as-is
+        metric.type = MetricType::RAW;
+        metric.key = strprintf("%s:%f|%s", FormatKey(*d, std::move(metric.key)), value, type);
+    }
+    return enqueue(std::move(metric));
+}
 
-    cleanup(key);
+int StatsdClient::send(const std::string& message)
+{
+    Metric metric;
+    metric.type = MetricType::RAW;
+    metric.key = message;
+    return enqueue(std::move(metric));
+}
 
-    char buf[256];
-    if ( fequal( sample_rate, 1.0 ) )
-    {
-        snprintf(buf, sizeof(buf), "%s%s:%f|%s",
-                d->ns.c_str(), key.c_str(), value, type.c_str());
-    }
-    else
-    {
-        snprintf(buf, sizeof(buf), "%s%s:%f|%s|@%.2f",
-                d->ns.c_str(), key.c_str(), value, type.c_str(), sample_rate);
+void StatsdClient::flush()
+{
+    Metric metric;
+    while (d->queue.pop(metric)) {
+        d->queued.fetch_sub(1, std::memory_order_relaxed);
+        switch (metric.type) {
+        case MetricType::COUNT:
+            // counters are summed up, so sampling has to be compensated for here rather than by the server
+            d->counters[FormatKey(*d, std::move(metric.key))] += (double) metric.value / metric.sample_rate;
+            break;
+        case MetricType::GAUGE:
+            d->gauges[FormatKey(*d, std::move(metric.key))] = strprintf("%d", metric.value);
+            break;
+        case MetricType::GAUGE_DOUBLE:
+            d->gauges[FormatKey(*d, std::move(metric.key))] = strprintf("%f", metric.dvalue);
+            break;
+        case MetricType::TIMING: {
+            auto& timing = d->timings[FormatKey(*d, std::move(metric.key))];
+            timing.first = metric.sample_rate;
+            timing.second.emplace_back(metric.value);
+            break;
+        }
+        case MetricType::RAW:
+            d->raw.emplace_back(std::move(metric.key));
+            break;
+        }
     }
 
-    return send(buf);
+    std::vector<std::string> lines;
+    for (const auto& [key, value] : d->counters) {
+        lines.emplace_back(strprintf("%s:%d|c", key, std::llround(value)));
+    }
+    for (const auto& [key, value] : d->gauges) {
+        lines.emplace_back(strprintf("%s:%s|g", key, value));
+    }
+    for (auto& [key, timing] : d->timings) {
+        auto& [sample_rate, samples] = timing;
+        if (d->percentiles) {
+            std::sort(samples.begin(), samples.end());
+            const auto percentile = [&samples](int p) {
+                // nearest-rank method
+                const size_t rank = (samples.size() * p + 99) / 100;
+                return samples[std::max<size_t>(rank, 1) - 1];
+            };
+            lines.emplace_back(strprintf("%s.count:%d|c", key, std::llround(samples.size() / sample_rate)));
+            lines.emplace_back(strprintf("%s.p50:%d|g", key, percentile(50)));
+            lines.emplace_back(strprintf("%s.p90:%d|g", key, percentile(90)));
+            lines.emplace_back(strprintf("%s.p99:%d|g", key, percentile(99)));
+            lines.emplace_back(strprintf("%s.max:%d|g", key, samples.back()));
+        } else {
+            for (const auto& sample : samples) {
+                if (fequal(sample_rate, 1.0)) {
+                    lines.emplace_back(strprintf("%s:%d|ms", key, sample));
+                } else {
+                    lines.emplace_back(strprintf("%s:%d|ms|@%.2f", key, sample, sample_rate));
+                }
+            }
+        }
+    }
+    for (auto& line : d->raw) {
+        lines.emplace_back(std::move(line));
+    }
+    d->counters.clear();
+    d->gauges.clear();
+    d->timings.clear();
+    d->raw.clear();
+
+    // pack as many lines as fit into a single datagram
+    std::string datagram;
+    for (const auto& line : lines) {
+        if (!datagram.empty() && datagram.size() + 1 + line.size() > MAX_STATSD_DATAGRAM_SIZE) {
+            sendDatagram(datagram);
+            datagram.clear();
+        }
+        if (!datagram.empty()) {
+            datagram += '\n';
+        }
+        datagram += line;
+    }
+    if (!datagram.empty()) {
+        sendDatagram(datagram);
+    }
 }
 
-int StatsdClient::send(const std::string& message)
+void StatsdClient::sendDatagram(const std::string& datagram)
 {
-    int ret = init();
-    if ( ret )
-    {
-        return ret;
-    }
-    ret = sendto(d->sock, message.data(), message.size(), 0, (struct sockaddr *) &d->server, sizeof(d->server));
+    int ret = sendto(d->sock, datagram.data(), datagram.size(), 0, (struct sockaddr *) &d->server, sizeof(d->server));
     if ( ret == -1) {
         snprintf(d->errmsg, sizeof(d->errmsg),
                 "sendto server fail, host=%s:%d, err=%m", d->host.c_str(), d->port);
-        return -1;
     }
-    return 0;
 }
 
 const char* StatsdClient::errmsg()
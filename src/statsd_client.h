@@ -5,6 +5,7 @@
 #ifndef BITCOIN_STATSD_CLIENT_H
 #define BITCOIN_STATSD_CLIENT_H
 
+#include <atomic>
 #include <string>
 #include <memory>
 
@@ -19,20 +20,44 @@ static const int DEFAULT_STATSD_PERIOD = 60;
 static const int MIN_STATSD_PERIOD = 5;
 static const int MAX_STATSD_PERIOD = 60 * 60;
 
+// metrics are queued by the recording thread and sent in batches by a background thread every this many milliseconds
+static const int DEFAULT_STATSD_FLUSH_INTERVAL = 1000;
+static const int MIN_STATSD_FLUSH_INTERVAL = 100;
+// summarize timings into percentiles client-side instead of sending every sample
+static const bool DEFAULT_STATSD_PERCENTILES = false;
+// maximum payload of a single datagram: ethernet MTU (1500) minus IP and UDP headers, with some headroom for options
+static const size_t MAX_STATSD_DATAGRAM_SIZE = 1432;
+// metrics recorded while this many are already waiting to be sent are dropped
+static const size_t MAX_STATSD_QUEUE_SIZE = 100000;
+
 namespace statsd {
 
 struct _StatsdClientData;
 
+struct Metric;
+
+/**
+ * Metrics are not sent by the thread recording them. They are pushed into a lock-free queue instead and a background
+ * thread drains it every flush interval: counters are summed up, only the last value of each gauge is kept, timings
+ * are either forwarded as-is or summarized into percentiles, and the result is packed into as few datagrams as possible.
+ * Nothing is recorded (and all calls return -3) unless the client has been started.
+ */
 class StatsdClient {
     public:
         explicit StatsdClient(const std::string& host = DEFAULT_STATSD_HOST, int port = DEFAULT_STATSD_PORT, const std::string& ns = DEFAULT_STATSD_NAMESPACE);
         ~StatsdClient();
 
     public:
-        // you can config at anytime; client will use new address (useful for Singleton)
-        void config(const std::string& host, int port, const std::string& ns = DEFAULT_STATSD_NAMESPACE);
+        // must be called before Start(), has no effect on a running client
+        void config(const std::string& host, int port, const std::string& ns = DEFAULT_STATSD_NAMESPACE, const std::string& nodename = DEFAULT_STATSD_HOSTNAME);
         const char* errmsg();
 
+        // open the socket and start the sender thread, returns false (see errmsg()) if the socket could not be set up
+        bool Start(int flush_interval_ms = DEFAULT_STATSD_FLUSH_INTERVAL, bool percentiles = DEFAULT_STATSD_PERCENTILES);
+        // stop the sender thread and synchronously send whatever is still queued
+        void Stop();
+        uint64_t GetDroppedCount() const;
+
     public:
         int inc(const std::string& key, float sample_rate = 1.0);
         int dec(const std::string& key, float sample_rate = 1.0);
@@ -45,11 +70,12 @@ class StatsdClient {
         /**
          * (Low Level Api) manually send a message
          * which might be composed of several lines.
+         * It is queued and sent verbatim, without namespace or aggregation.
          */
         int send(const std::string& message);
 
         /* (Low Level Api) manually send a message
-         * type = "c", "g" or "ms"
+         * type = "c", "g" or "ms", anything else is sent without aggregation
          */
         int send(std::string key, size_t value,
                 const std::string& type, float sample_rate);
@@ -58,7 +84,10 @@ class StatsdClient {
 
     protected:
         int init();
-        static void cleanup(std::string& key);
+        int enqueue(Metric&& metric);
+        void flush();
+        void sendDatagram(const std::string& datagram);
+        void ThreadSender();
 
     protected:
         std::unique_ptr<struct _StatsdClientData> d;
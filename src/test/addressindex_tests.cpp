@@ -0,0 +1,269 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <hash.h>
+#include <index/addressindex.h>
+#include <context.h>
+#include <key_io.h>
+#include <rpc/server.h>
+#include <script/interpreter.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <univalue.h>
+
+BOOST_AUTO_TEST_SUITE(addressindex_tests)
+
+//! Check the running totals of an address against a full scan of its deltas
+static void CheckAddressBalance(const AddressIndex& index, const uint160& hash, int type)
+{
+    std::vector<std::pair<CAddressIndexKey, CAmount>> deltas;
+    BOOST_REQUIRE(index.ReadAddressIndex(hash, type, deltas));
+
+    CAddressBalanceValue expected;
+    for (size_t i = 0; i < deltas.size(); i++) {
+        const auto& [key, value] = deltas[i];
+        if (expected.IsNull()) {
+            expected.firstHeight = key.blockHeight;
+        }
+        expected.balance += value;
+        if (value > 0) {
+            expected.received += value;
+        }
+        if (i == 0 || deltas[i - 1].first.txhash != key.txhash) {
+            expected.txCount++;
+        }
+        expected.lastHeight = key.blockHeight;
+    }
+
+    CAddressBalanceValue balance;
+    BOOST_CHECK_EQUAL(index.ReadAddressBalance(hash, type, balance), !expected.IsNull());
+    BOOST_CHECK_EQUAL(balance.balance, expected.balance);
+    BOOST_CHECK_EQUAL(balance.received, expected.received);
+    BOOST_CHECK_EQUAL(balance.txCount, expected.txCount);
+    BOOST_CHECK_EQUAL(balance.firstHeight, expected.firstHeight);
+    BOOST_CHECK_EQUAL(balance.lastHeight, expected.lastHeight);
+}
+
+static void WaitForSync(AddressIndex& index)
+{
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(addressindex_balances, TestChain100Setup)
+{
+    AddressIndex addressindex(1 << 20, true);
+    addressindex.Start();
+    WaitForSync(addressindex);
+
+    const CScript coinbase_script = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    const uint160 coinbase_hash = uint160(coinbaseKey.GetPubKey().GetID());
+    CKey other_key;
+    other_key.MakeNewKey(true);
+    const CScript other_script = GetScriptForDestination(other_key.GetPubKey().GetID());
+    const uint160 other_hash = uint160(other_key.GetPubKey().GetID());
+
+    CAddressBalanceValue balance;
+    BOOST_CHECK(addressindex.ReadAddressBalance(coinbase_hash, 1, balance));
+    BOOST_CHECK_EQUAL(balance.txCount, 100U);
+    BOOST_CHECK_EQUAL(balance.firstHeight, 1);
+    BOOST_CHECK_EQUAL(balance.lastHeight, 100);
+    CheckAddressBalance(addressindex, coinbase_hash, 1);
+    BOOST_CHECK(!addressindex.ReadAddressBalance(other_hash, 1, balance));
+
+    // Spend a coinbase output to both addresses
+    CMutableTransaction spend;
+    spend.vin.resize(1);
+    spend.vin[0].prevout = COutPoint(m_coinbase_txns[0]->GetHash(), 0);
+    spend.vout.resize(2);
+    spend.vout[0].nValue = m_coinbase_txns[0]->vout[0].nValue / 2;
+    spend.vout[0].scriptPubKey = other_script;
+    spend.vout[1].nValue = m_coinbase_txns[0]->vout[0].nValue / 4;
+    spend.vout[1].scriptPubKey = coinbase_script;
+    std::vector<unsigned char> sig;
+    const uint256 sighash = SignatureHash(coinbase_script, spend, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+    BOOST_REQUIRE(coinbaseKey.Sign(sighash, sig));
+    sig.push_back((unsigned char)SIGHASH_ALL);
+    spend.vin[0].scriptSig << sig;
+
+    CreateAndProcessBlock({spend}, coinbase_script);
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+
+    // The spending transaction and the coinbase both count, but only once each
+    BOOST_CHECK(addressindex.ReadAddressBalance(coinbase_hash, 1, balance));
+    BOOST_CHECK_EQUAL(balance.txCount, 102U);
+    BOOST_CHECK_EQUAL(balance.lastHeight, 101);
+    CheckAddressBalance(addressindex, coinbase_hash, 1);
+    BOOST_CHECK(addressindex.ReadAddressBalance(other_hash, 1, balance));
+    BOOST_CHECK_EQUAL(balance.balance, spend.vout[0].nValue);
+    BOOST_CHECK_EQUAL(balance.txCount, 1U);
+    CheckAddressBalance(addressindex, other_hash, 1);
+
+    // Disconnecting the tip rewinds the index
+    {
+        CValidationState state;
+        InvalidateBlock(state, Params(), WITH_LOCK(cs_main, return ::ChainActive().Tip()));
+        BOOST_REQUIRE(state.IsValid());
+    }
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK(addressindex.ReadAddressBalance(coinbase_hash, 1, balance));
+    BOOST_CHECK_EQUAL(balance.txCount, 100U);
+    BOOST_CHECK_EQUAL(balance.lastHeight, 100);
+    CheckAddressBalance(addressindex, coinbase_hash, 1);
+    BOOST_CHECK(!addressindex.ReadAddressBalance(other_hash, 1, balance));
+
+    // Replace the tip with a block that only pays to the coinbase address
+    m_node.mempool->clear();
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+
+    BOOST_CHECK(addressindex.ReadAddressBalance(coinbase_hash, 1, balance));
+    BOOST_CHECK_EQUAL(balance.txCount, 101U);
+    BOOST_CHECK_EQUAL(balance.lastHeight, 101);
+    CheckAddressBalance(addressindex, coinbase_hash, 1);
+    BOOST_CHECK(!addressindex.ReadAddressBalance(other_hash, 1, balance));
+    CheckAddressBalance(addressindex, other_hash, 1);
+
+    addressindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_FIXTURE_TEST_CASE(addressindex_pages, TestChain100Setup)
+{
+    AddressIndex addressindex(1 << 20, true);
+    addressindex.Start();
+    WaitForSync(addressindex);
+
+    const uint160 hash = uint160(coinbaseKey.GetPubKey().GetID());
+    std::vector<std::pair<CAddressIndexKey, CAmount>> all;
+    BOOST_REQUIRE(addressindex.ReadAddressIndex(hash, 1, all));
+    BOOST_REQUIRE_EQUAL(all.size(), 100U);
+
+    // Reading in pages returns the same deltas, in the same order
+    std::vector<std::pair<CAddressIndexKey, CAmount>> paged;
+    std::optional<CAddressIndexKey> next = CAddressIndexKey(1, hash, 0, 0, uint256(), 0, false);
+    size_t pages = 0;
+    while (next) {
+        const size_t size_before = paged.size();
+        BOOST_REQUIRE(addressindex.ReadAddressIndex(*next, 0, 7, paged, next));
+        BOOST_CHECK_LE(paged.size() - size_before, 7U);
+        pages++;
+    }
+    BOOST_CHECK_EQUAL(pages, 15U);
+    BOOST_REQUIRE_EQUAL(paged.size(), all.size());
+    for (size_t i = 0; i < all.size(); i++) {
+        BOOST_CHECK(paged[i].first.txhash == all[i].first.txhash);
+        BOOST_CHECK_EQUAL(paged[i].second, all[i].second);
+    }
+
+    // Paging stops at the end height
+    paged.clear();
+    BOOST_REQUIRE(addressindex.ReadAddressIndex(CAddressIndexKey(1, hash, 10, 0, uint256(), 0, false), 20, 5, paged, next));
+    BOOST_CHECK_EQUAL(paged.size(), 5U);
+    BOOST_REQUIRE(next);
+    BOOST_CHECK_EQUAL(next->blockHeight, 15);
+    paged.clear();
+    BOOST_REQUIRE(addressindex.ReadAddressIndex(*next, 20, 10, paged, next));
+    BOOST_CHECK_EQUAL(paged.size(), 6U);
+    BOOST_CHECK(!next);
+
+    addressindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+//! Call getaddressdeltas for the given addresses, limited to a page of `limit` deltas starting at `cursor`
+static UniValue GetAddressDeltasPage(NodeContext& node, const std::vector<CKeyID>& keyids, int limit, const std::string& cursor)
+{
+    UniValue addresses(UniValue::VARR);
+    for (const auto& keyid : keyids) {
+        addresses.push_back(EncodeDestination(keyid));
+    }
+    UniValue params(UniValue::VOBJ);
+    params.pushKV("addresses", addresses);
+    params.pushKV("limit", limit);
+    if (!cursor.empty()) {
+        params.pushKV("cursor", cursor);
+    }
+
+    CoreContext context{node};
+    JSONRPCRequest request(context);
+    request.strMethod = "getaddressdeltas";
+    request.params = UniValue(UniValue::VARR);
+    request.params.push_back(params);
+    if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+    try {
+        return tableRPC.execute(request);
+    } catch (const UniValue& objError) {
+        throw std::runtime_error(find_value(objError, "message").get_str());
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(addressindex_rpc_pages, TestChain100Setup)
+{
+    g_addressindex = std::make_unique<AddressIndex>(1 << 20, true);
+    g_addressindex->Start();
+    WaitForSync(*g_addressindex);
+
+    const CScript coinbase_script = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CKey other_key, empty_key;
+    other_key.MakeNewKey(true);
+    empty_key.MakeNewKey(true);
+
+    // Give the other address exactly one delta
+    CMutableTransaction spend;
+    spend.vin.resize(1);
+    spend.vin[0].prevout = COutPoint(m_coinbase_txns[0]->GetHash(), 0);
+    spend.vout.resize(1);
+    spend.vout[0].nValue = m_coinbase_txns[0]->vout[0].nValue / 2;
+    spend.vout[0].scriptPubKey = GetScriptForDestination(other_key.GetPubKey().GetID());
+    std::vector<unsigned char> sig;
+    const uint256 sighash = SignatureHash(coinbase_script, spend, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+    BOOST_REQUIRE(coinbaseKey.Sign(sighash, sig));
+    sig.push_back((unsigned char)SIGHASH_ALL);
+    spend.vin[0].scriptSig << sig;
+    CreateAndProcessBlock({spend}, coinbase_script);
+    BOOST_REQUIRE(g_addressindex->BlockUntilSyncedToCurrentChain());
+
+    const std::vector<CKeyID> keyids{other_key.GetPubKey().GetID(), empty_key.GetPubKey().GetID(), coinbaseKey.GetPubKey().GetID()};
+
+    // The first page ends exactly at the end of the first address, the next one starts at the (empty) second
+    // address and must still continue with the deltas of the third one
+    UniValue page = GetAddressDeltasPage(m_node, keyids, 1, "");
+    BOOST_REQUIRE_EQUAL(page["deltas"].size(), 1U);
+    BOOST_CHECK_EQUAL(page["deltas"][0]["txid"].get_str(), spend.GetHash().GetHex());
+    BOOST_REQUIRE(page["cursor"].isStr());
+    page = GetAddressDeltasPage(m_node, keyids, 1, page["cursor"].get_str());
+    BOOST_REQUIRE_EQUAL(page["deltas"].size(), 1U);
+    BOOST_CHECK_EQUAL(page["deltas"][0]["address"].get_str(), EncodeDestination(keyids[2]));
+    BOOST_CHECK_EQUAL(page["deltas"][0]["height"].get_int(), 1);
+
+    // Paging through all addresses returns every delta exactly once
+    size_t total = 0;
+    std::string cursor;
+    do {
+        page = GetAddressDeltasPage(m_node, keyids, 7, cursor);
+        BOOST_CHECK_LE(page["deltas"].size(), 7U);
+        total += page["deltas"].size();
+        cursor = page["cursor"].isStr() ? page["cursor"].get_str() : "";
+    } while (!cursor.empty());
+    // one delta of the other address, 101 coinbases and the spent input of the coinbase address
+    BOOST_CHECK_EQUAL(total, 103U);
+
+    g_addressindex->Stop();
+    g_addressindex.reset();
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
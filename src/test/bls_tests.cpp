@@ -4,7 +4,9 @@
 
 #include <bls/bls.h>
 #include <bls/bls_batchverifier.h>
+#include <bls/bls_worker.h>
 #include <random.h>
+#include <util/irange.h>
 #include <test/util/setup_common.h>
 
 #include <boost/test/unit_test.hpp>
@@ -247,6 +249,48 @@ void FuncDHExchange(const bool legacy_scheme)
     BOOST_CHECK(pke1 == pke2);
 }
 
+void FuncThresholdRecover(const bool legacy_scheme)
+{
+    bls::bls_legacy_scheme.store(legacy_scheme);
+
+    const size_t threshold = 3;
+    std::vector<CBLSSecretKey> msk(threshold);
+    for (auto& sk : msk) {
+        sk.MakeNewKey();
+    }
+    const CBLSPublicKey quorumPubKey = msk[0].GetPublicKey();
+
+    std::vector<CBLSId> ids;
+    std::vector<CBLSSecretKey> skShares;
+    for (const auto i : irange::range(5)) {
+        ids.emplace_back(uint256(std::vector<unsigned char>(32, (unsigned char)(i + 1))));
+        skShares.emplace_back();
+        BOOST_CHECK(skShares.back().SecretKeyShare(msk, ids.back()));
+    }
+
+    // recover two different messages from the same members, reusing the coefficients
+    const std::vector<CBLSId> recoveryIds{ids[0], ids[2], ids[4]};
+    CBLSLagrangeCoefficients coefficients;
+    BOOST_CHECK(coefficients.Compute(recoveryIds));
+    BOOST_CHECK_EQUAL(coefficients.size(), threshold);
+
+    for (const auto& hash : {uint256::ONE, uint256::TWO}) {
+        const std::vector<CBLSSignature> sigShares{skShares[0].Sign(hash), skShares[2].Sign(hash), skShares[4].Sign(hash)};
+
+        CBLSSignature recoveredById, recoveredByCoefficients;
+        BOOST_CHECK(recoveredById.Recover(sigShares, recoveryIds));
+        BOOST_CHECK(recoveredByCoefficients.Recover(sigShares, coefficients));
+        BOOST_CHECK(recoveredByCoefficients == recoveredById);
+        BOOST_CHECK(recoveredByCoefficients.VerifyInsecure(quorumPubKey, hash));
+    }
+
+    // sizes must match and duplicate ids can't be used
+    CBLSSignature sig;
+    BOOST_CHECK(!sig.Recover({skShares[0].Sign(uint256::ONE)}, coefficients));
+    BOOST_CHECK(!coefficients.Compute({ids[0], ids[0]}));
+    BOOST_CHECK(!coefficients.IsValid());
+}
+
 struct Message
 {
     uint32_t sourceId;
@@ -278,9 +322,9 @@ static void AddMessage(std::vector<Message>& vec, uint32_t sourceId, uint32_t ms
     vec.emplace_back(m);
 }
 
-static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback)
+static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback, CBLSWorker* blsWorker = nullptr)
 {
-    CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(secureVerification, perMessageFallback);
+    CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(secureVerification, perMessageFallback, 0, blsWorker);
 
     std::set<uint32_t> expectedBadMessages;
     std::set<uint32_t> expectedBadSources;
@@ -304,12 +348,12 @@ static void Verify(std::vector<Message>& vec, bool secureVerification, bool perM
     }
 }
 
-static void Verify(std::vector<Message>& vec)
+static void Verify(std::vector<Message>& vec, CBLSWorker* blsWorker = nullptr)
 {
-    Verify(vec, false, false);
-    Verify(vec, true, false);
-    Verify(vec, false, true);
-    Verify(vec, true, true);
+    Verify(vec, false, false, blsWorker);
+    Verify(vec, true, false, blsWorker);
+    Verify(vec, false, true, blsWorker);
+    Verify(vec, true, true, blsWorker);
 }
 
 void FuncBatchVerifier(const bool legacy_scheme)
@@ -355,6 +399,43 @@ void FuncBatchVerifier(const bool legacy_scheme)
     // last message invalid from one source
     AddMessage(msgs, 1, 7, 1, false);
     Verify(msgs);
+
+    // enough messages to be split into parallel sub-batches, with bad messages spread over multiple sources
+    CBLSWorker blsWorker;
+    blsWorker.Start();
+    msgs.clear();
+    for (uint32_t i = 0; i < 100; i++) {
+        AddMessage(msgs, i % 20, i, i % 50, i % 37 != 5);
+    }
+    Verify(msgs);
+    Verify(msgs, &blsWorker);
+
+    // verifying from within the pool itself (one job per pool thread) must not wait for jobs queued behind it
+    std::set<uint32_t> expectedBadSources;
+    for (const auto& m : msgs) {
+        if (!m.valid) {
+            expectedBadSources.emplace(m.sourceId);
+        }
+    }
+    std::vector<std::future<bool>> futures;
+    for (size_t i = 0; i < blsWorker.GetWorkerCount(); i++) {
+        futures.emplace_back(blsWorker.AsyncVerifyBatch([&]() {
+            CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(false, false, 0, &blsWorker);
+            for (const auto& m : msgs) {
+                batchVerifier.PushMessage(m.sourceId, m.msgId, m.msgHash, m.sig, m.pk);
+            }
+            batchVerifier.Verify();
+            return batchVerifier.badSources == expectedBadSources;
+        }));
+    }
+    for (auto& f : futures) {
+        BOOST_CHECK(f.get());
+    }
+
+    // all messages valid
+    msgs.erase(std::remove_if(msgs.begin(), msgs.end(), [](const auto& m) { return !m.valid; }), msgs.end());
+    Verify(msgs, &blsWorker);
+    blsWorker.Stop();
 }
 
 BOOST_AUTO_TEST_CASE(bls_sethexstr_tests)
@@ -405,6 +486,12 @@ BOOST_AUTO_TEST_CASE(bls_dh_exchange_tests)
     FuncDHExchange(false);
 }
 
+BOOST_AUTO_TEST_CASE(bls_threshold_recover_tests)
+{
+    FuncThresholdRecover(true);
+    FuncThresholdRecover(false);
+}
+
 BOOST_AUTO_TEST_CASE(batch_verifier_tests)
 {
     FuncBatchVerifier(true);
@@ -6,6 +6,7 @@
 #include <uint256.h>
 #include <test/util/setup_common.h>
 
+#include <map>
 #include <memory>
 
 #include <boost/test/unit_test.hpp>
@@ -411,5 +412,102 @@ BOOST_AUTO_TEST_CASE(unicodepath)
     BOOST_CHECK(fs::exists(lockPath));
 }
 
+BOOST_AUTO_TEST_CASE(dbtransaction)
+{
+    // Same layering as CEvoDB
+    using RootTransaction = CDBTransaction<CDBWrapper, CDBBatch>;
+    using CurTransaction = CDBTransaction<RootTransaction, RootTransaction>;
+
+    fs::path ph = GetDataDir() / "dbtransaction";
+    // no obfuscation, its key would show up when iterating
+    CDBWrapper dbw(ph, (1 << 20), true, false, false);
+    CDBBatch batch(dbw);
+    RootTransaction root(dbw, batch);
+    CurTransaction cur(root, root);
+
+    // short keys are stored inline, long ones in the arena
+    const auto makeKey = [](uint32_t i) {
+        return std::make_pair(std::string(i % 3 == 0 ? 60 : 1, 'k'), i);
+    };
+    const auto serializedKey = [](const std::pair<std::string, uint32_t>& key) {
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss << key;
+        return std::vector<unsigned char>(UCharCast(ss.data()), UCharCast(ss.data() + ss.size()));
+    };
+
+    std::map<std::vector<unsigned char>, std::pair<std::pair<std::string, uint32_t>, uint256>> expected;
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        const uint256 value = InsecureRand256();
+        BOOST_CHECK(dbw.Write(makeKey(i), value));
+        expected[serializedKey(makeKey(i))] = {makeKey(i), value};
+    }
+
+    // enough writes in random order to merge the unsorted entries several times
+    for (int j = 0; j < 3000; j++) {
+        const uint32_t i = InsecureRandRange(1000);
+        const auto key = makeKey(i);
+        if (InsecureRandBool()) {
+            const uint256 value = InsecureRand256();
+            cur.Write(key, value);
+            expected[serializedKey(key)] = {key, value};
+        } else {
+            cur.Erase(key);
+            expected.erase(serializedKey(key));
+        }
+    }
+
+    const auto check = [&](auto& tx) {
+        for (uint32_t i = 0; i < 1000; i++) {
+            const auto key = makeKey(i);
+            auto it = expected.find(serializedKey(key));
+            uint256 value;
+            BOOST_CHECK_EQUAL(tx.Exists(key), it != expected.end());
+            BOOST_CHECK_EQUAL(tx.Read(key, value), it != expected.end());
+            if (it != expected.end()) {
+                BOOST_CHECK(value == it->second.second);
+            }
+        }
+
+        auto dbIt = tx.NewIteratorUniquePtr();
+        dbIt->SeekToFirst();
+        for (const auto& [_, p] : expected) {
+            std::pair<std::string, uint32_t> key;
+            uint256 value;
+            BOOST_REQUIRE(dbIt->Valid());
+            BOOST_CHECK(dbIt->GetKey(key) && key == p.first);
+            BOOST_CHECK(dbIt->GetValue(value) && value == p.second);
+            dbIt->Next();
+        }
+        BOOST_CHECK(!dbIt->Valid());
+
+        std::pair<std::string, uint32_t> key;
+        dbIt->Seek(makeKey(500));
+        BOOST_REQUIRE(dbIt->Valid());
+        BOOST_CHECK(dbIt->GetKey(key) && key == expected.lower_bound(serializedKey(makeKey(500)))->second.first);
+    };
+
+    check(cur);
+    BOOST_CHECK(!cur.IsClean());
+    BOOST_CHECK(cur.GetMemoryUsage() > 0);
+
+    cur.Commit();
+    BOOST_CHECK(cur.IsClean());
+    check(cur);
+    check(root);
+
+    root.Commit();
+    BOOST_CHECK(root.IsClean());
+    BOOST_CHECK(dbw.WriteBatch(batch));
+    check(cur);
+
+    // Reading with a different type than the one that was written behaves like reading from the database
+    cur.Write(makeKey(1), uint32_t{42});
+    cur.Write(makeKey(2), uint32_t{43});
+    uint64_t wrongType;
+    BOOST_CHECK(!cur.Read(makeKey(1), wrongType));
+    cur.Clear();
+    BOOST_CHECK(cur.IsClean());
+    BOOST_CHECK_EQUAL(cur.GetMemoryUsage(), 0U);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -262,6 +262,21 @@ void FuncDIP3Activation(TestChainSetup& setup)
     BOOST_CHECK_EQUAL(::ChainActive().Height(), nHeight + 2);
     BOOST_CHECK_EQUAL(block->GetHash(), ::ChainActive().Tip()->GetBlockHash());
     BOOST_ASSERT(deterministicMNManager->GetListAtChainTip().HasMN(tx.GetHash()));
+
+    // The list of the tip is looked up without taking the lock
+    auto stats = deterministicMNManager->GetLookupStats();
+    BOOST_ASSERT(deterministicMNManager->GetListForBlock(::ChainActive().Tip()).HasMN(tx.GetHash()));
+    BOOST_CHECK_GT(deterministicMNManager->GetLookupStats().lockFree, stats.lockFree);
+    BOOST_ASSERT(!deterministicMNManager->GetListForBlock(::ChainActive().Tip()->pprev).HasMN(tx.GetHash()));
+
+    // Repeated lookups of older lists are served from memory instead of replaying diffs again
+    const CBlockIndex* pindexOld = ::ChainActive()[::ChainActive().Height() - 13];
+    auto oldList = deterministicMNManager->GetListForBlock(pindexOld);
+    auto cacheStats = deterministicMNManager->GetCacheStats();
+    BOOST_CHECK_GT(cacheStats.maxSnapshots, 0U);
+    BOOST_CHECK(deterministicMNManager->GetListForBlock(pindexOld).GetBlockHash() == oldList.GetBlockHash());
+    BOOST_CHECK_EQUAL(deterministicMNManager->GetCacheStats().misses, cacheStats.misses);
+    BOOST_CHECK_GT(deterministicMNManager->GetCacheStats().hits, cacheStats.hits);
 };
 
 void FuncDIP3Protx(TestChainSetup& setup)
@@ -445,6 +460,14 @@ void FuncDIP3Protx(TestChainSetup& setup)
     }
     BOOST_ASSERT(foundRevived);
 
+    // Lists of connected blocks are kept in memory at fixed intervals, so no lookup has to replay more diffs than that
+    const size_t nMaxReplayedDiffs = CDeterministicMNManager::MEM_SNAPSHOT_PERIODS.back() - 1;
+    for (int h = Params().GetConsensus().DIP0003Height; h <= ::ChainActive().Height(); h++) {
+        BOOST_CHECK_EQUAL(deterministicMNManager->GetListForBlock(::ChainActive()[h]).GetHeight(), h);
+        BOOST_CHECK_LE(deterministicMNManager->GetCacheStats().maxReplayedDiffs, nMaxReplayedDiffs);
+    }
+    BOOST_CHECK_GT(deterministicMNManager->GetCacheStats().maxReplayedDiffs, 0U);
+
     const_cast<Consensus::Params&>(Params().GetConsensus()).DIP0003EnforcementHeight = DIP0003EnforcementHeightBackup;
 }
 
@@ -5,6 +5,7 @@
 #include <test/util/setup_common.h>
 
 #include <llmq/instantsend.h>
+#include <util/irange.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -37,4 +38,141 @@ BOOST_AUTO_TEST_CASE(instantsend_CInstantSendLock_tests)
     }
 }
 
+static llmq::CInstantSendLockPtr MakeLock(bool deterministic, const uint256& txid)
+{
+    auto islock = std::make_shared<llmq::CInstantSendLock>(deterministic ? llmq::CInstantSendLock::isdlock_version : llmq::CInstantSendLock::islock_version);
+    islock->txid = txid;
+    islock->inputs.emplace_back(InsecureRand256(), 0);
+    islock->cycleHash = InsecureRand256();
+    return islock;
+}
+
+static void AddPending(llmq::PendingInstantSendLocks& pending, const llmq::CInstantSendLockPtr& islock)
+{
+    pending.emplace(::SerializeHash(*islock), std::make_pair(NodeId{1}, islock));
+}
+
+BOOST_AUTO_TEST_CASE(instantsend_select_pending_batches)
+{
+    llmq::PendingInstantSendLocks pending;
+    for (int i = 0; i < 40; i++) {
+        AddPending(pending, MakeLock(false, InsecureRand256()));
+    }
+
+    // batches are limited, the rest is left for the next run
+    llmq::PendingInstantSendLocks batch;
+    BOOST_CHECK(llmq::SelectPendingInstantSendLocks(pending, batch, 32, true));
+    BOOST_CHECK_EQUAL(batch.size(), 32U);
+    BOOST_CHECK_EQUAL(pending.size(), 8U);
+    for (const auto& [hash, _] : batch) {
+        BOOST_CHECK(!pending.count(hash));
+    }
+
+    batch.clear();
+    BOOST_CHECK(!llmq::SelectPendingInstantSendLocks(pending, batch, 32, true));
+    BOOST_CHECK_EQUAL(batch.size(), 8U);
+    BOOST_CHECK(pending.empty());
+}
+
+BOOST_AUTO_TEST_CASE(instantsend_select_pending_same_tx)
+{
+    // a non-deterministic and a deterministic lock for the same TX, plus a lock of another TX
+    const uint256 txid = InsecureRand256();
+    llmq::PendingInstantSendLocks pending;
+    AddPending(pending, MakeLock(false, txid));
+    AddPending(pending, MakeLock(true, txid));
+    AddPending(pending, MakeLock(false, InsecureRand256()));
+
+    // only one lock per TX goes into a batch, the other one can be processed in the next batch
+    llmq::PendingInstantSendLocks batch;
+    BOOST_CHECK(llmq::SelectPendingInstantSendLocks(pending, batch, 32, true));
+    BOOST_CHECK_EQUAL(batch.size(), 2U);
+    BOOST_CHECK_EQUAL(pending.size(), 1U);
+    BOOST_CHECK(pending.begin()->second.second->txid == txid);
+
+    // also when the batch already has a lock for the TX
+    BOOST_CHECK(llmq::SelectPendingInstantSendLocks(pending, batch, 32, true));
+    BOOST_CHECK_EQUAL(batch.size(), 2U);
+    BOOST_CHECK_EQUAL(pending.size(), 1U);
+
+    batch.clear();
+    BOOST_CHECK(!llmq::SelectPendingInstantSendLocks(pending, batch, 32, true));
+    BOOST_CHECK_EQUAL(batch.size(), 1U);
+    BOOST_CHECK(pending.empty());
+}
+
+BOOST_AUTO_TEST_CASE(instantsend_select_pending_both_types)
+{
+    llmq::PendingInstantSendLocks pending;
+    for (const auto i : irange::range(4)) {
+        AddPending(pending, MakeLock(i % 2 == 0, InsecureRand256()));
+    }
+
+    // deterministic locks wait until they can be verified, this is not more work for now
+    llmq::PendingInstantSendLocks batch;
+    BOOST_CHECK(!llmq::SelectPendingInstantSendLocks(pending, batch, 32, false));
+    BOOST_CHECK_EQUAL(batch.size(), 2U);
+    BOOST_CHECK_EQUAL(pending.size(), 2U);
+    for (const auto& [_, p] : batch) {
+        BOOST_CHECK(!p.second->IsDeterministic());
+    }
+
+    // once active, locks of both kinds share a batch
+    AddPending(pending, MakeLock(false, InsecureRand256()));
+    batch.clear();
+    BOOST_CHECK(!llmq::SelectPendingInstantSendLocks(pending, batch, 32, true));
+    BOOST_CHECK_EQUAL(batch.size(), 3U);
+    BOOST_CHECK(pending.empty());
+    const auto deterministicCount = std::count_if(batch.begin(), batch.end(), [](const auto& p) { return p.second.second->IsDeterministic(); });
+    BOOST_CHECK_EQUAL(deterministicCount, 2);
+}
+
+BOOST_AUTO_TEST_CASE(instantsend_retry_pending_limits)
+{
+    llmq::RetriedInstantSendLocks retried;
+    const uint256 hash1 = InsecureRand256();
+    const uint256 hash2 = InsecureRand256();
+
+    // a lock is retried a limited number of times
+    for (const auto i : irange::range(3)) {
+        BOOST_CHECK(llmq::RetryPendingInstantSendLock(retried, hash1, 3, 2));
+        BOOST_CHECK_EQUAL(retried.at(hash1), i + 1);
+    }
+    BOOST_CHECK(!llmq::RetryPendingInstantSendLock(retried, hash1, 3, 2));
+
+    // only a limited number of locks are retried at the same time
+    BOOST_CHECK(llmq::RetryPendingInstantSendLock(retried, hash2, 3, 2));
+    BOOST_CHECK(!llmq::RetryPendingInstantSendLock(retried, InsecureRand256(), 3, 2));
+    BOOST_CHECK_EQUAL(retried.size(), 2U);
+
+    retried.erase(hash1);
+    BOOST_CHECK(llmq::RetryPendingInstantSendLock(retried, InsecureRand256(), 3, 2));
+}
+
+BOOST_AUTO_TEST_CASE(instantsend_db_write_batch)
+{
+    llmq::CInstantSendDb db(true, true);
+
+    const auto lock1 = MakeLock(false, InsecureRand256());
+    const auto lock2 = MakeLock(true, InsecureRand256());
+    const uint256 hash1 = ::SerializeHash(*lock1);
+    const uint256 hash2 = ::SerializeHash(*lock2);
+    db.WriteNewInstantSendLocks({{hash1, lock1, -1}, {hash2, lock2, 100}});
+
+    for (const auto& [hash, islock] : {std::make_pair(hash1, lock1), std::make_pair(hash2, lock2)}) {
+        BOOST_CHECK(db.KnownInstantSendLock(hash));
+        BOOST_CHECK(db.GetInstantSendLockHashByTxid(islock->txid) == hash);
+        const auto byInput = db.GetInstantSendLockByInput(islock->inputs[0]);
+        BOOST_REQUIRE(byInput != nullptr);
+        BOOST_CHECK(::SerializeHash(*byInput) == hash);
+    }
+    BOOST_CHECK_EQUAL(db.GetInstantSendLockCount(), 2U);
+
+    // only the mined lock is removed once its block is confirmed
+    const auto removed = db.RemoveConfirmedInstantSendLocks(100);
+    BOOST_CHECK_EQUAL(removed.size(), 1U);
+    BOOST_CHECK(removed.count(hash2));
+    BOOST_CHECK(db.GetInstantSendLockByHash(hash1) != nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include <test/util/setup_common.h>
 
 #include <bls/bls.h>
+#include <evo/deterministicmns.h>
 #include <evo/simplifiedmns.h>
 #include <netbase.h>
 
@@ -69,4 +70,213 @@ BOOST_AUTO_TEST_CASE(simplifiedmns_merkleroots)
 
     BOOST_CHECK(expectedMerkleRoot == calculatedMerkleRoot);
 }
+
+static CDeterministicMNCPtr MakeTestMN(uint64_t internalId)
+{
+    auto dmn = std::make_shared<CDeterministicMN>(internalId);
+    dmn->proTxHash = InsecureRand256();
+    dmn->collateralOutpoint = COutPoint(InsecureRand256(), 0);
+    auto state = std::make_shared<CDeterministicMNState>();
+    state->confirmedHash = InsecureRand256();
+    state->keyIDOwner = CKeyID(uint160(g_insecure_rand_ctx.randbytes(20)));
+    state->keyIDVoting = CKeyID(uint160(g_insecure_rand_ctx.randbytes(20)));
+    CBLSSecretKey sk;
+    sk.MakeNewKey();
+    state->pubKeyOperator.Set(sk.GetPublicKey());
+    Lookup(strprintf("1.%d.%d.%d", (internalId >> 16) & 0xff, (internalId >> 8) & 0xff, internalId & 0xff).c_str(), state->addr, 9999, false);
+    dmn->pdmnState = state;
+    return dmn;
+}
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_merkletree)
+{
+    bls::bls_legacy_scheme.store(true);
+
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    uint64_t nextId{0};
+    for (; nextId < 25; nextId++) {
+        mnList.AddMN(MakeTestMN(nextId));
+    }
+
+    CSimplifiedMNListMerkleTree tree;
+    auto checkRoot = [&](const CDeterministicMNList& list) {
+        tree.Update(list, false);
+        BOOST_CHECK_EQUAL(tree.size(), list.GetAllMNsCount());
+        BOOST_CHECK(tree.GetMerkleRoot() == CSimplifiedMNList(list, false).CalcMerkleRoot());
+    };
+    checkRoot(mnList);
+
+    std::vector<CDeterministicMNList> history{mnList};
+    for (int round = 0; round < 40; round++) {
+        auto newList = mnList;
+        std::vector<uint256> proTxHashes;
+        newList.ForEachMN(false, [&](const auto& dmn) { proTxHashes.emplace_back(dmn.proTxHash); });
+
+        switch (InsecureRandRange(4)) {
+        case 0:
+            newList.AddMN(MakeTestMN(nextId++));
+            break;
+        case 1:
+            if (!proTxHashes.empty()) newList.RemoveMN(proTxHashes[InsecureRandRange(proTxHashes.size())]);
+            break;
+        case 2: {
+            // SML-relevant change
+            if (proTxHashes.empty()) break;
+            auto dmn = newList.GetMN(proTxHashes[InsecureRandRange(proTxHashes.size())]);
+            auto newState = std::make_shared<CDeterministicMNState>(*dmn->pdmnState);
+            newState->BanIfNotBanned(round);
+            newState->confirmedHash = InsecureRand256();
+            newList.UpdateMN(*dmn, newState);
+            break;
+        }
+        case 3: {
+            // change which does not affect the SML
+            if (proTxHashes.empty()) break;
+            auto dmn = newList.GetMN(proTxHashes[InsecureRandRange(proTxHashes.size())]);
+            auto newState = std::make_shared<CDeterministicMNState>(*dmn->pdmnState);
+            newState->nLastPaidHeight = round;
+            newList.UpdateMN(*dmn, newState);
+            break;
+        }
+        }
+        mnList = newList;
+        history.emplace_back(mnList);
+        checkRoot(mnList);
+    }
+
+    // reorg back through the whole history, applying undo diffs
+    for (auto it = history.rbegin(); it != history.rend(); ++it) {
+        checkRoot(*it);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_merkletree_failure)
+{
+    bls::bls_legacy_scheme.store(true);
+
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    for (uint64_t id = 0; id < 10; id++) {
+        mnList.AddMN(MakeTestMN(id));
+    }
+    const uint256 expectedRoot = CSimplifiedMNList(mnList, false).CalcMerkleRoot();
+
+    CSimplifiedMNListMerkleTree tree;
+    tree.Update(mnList, false);
+
+    // a diff which does not match the tree throws and makes the next update rebuild the tree from scratch
+    CDeterministicMNListDiff badDiff;
+    badDiff.removedMns.emplace(1000);
+    BOOST_CHECK_THROW(tree.ApplyDiff(mnList, badDiff), std::runtime_error);
+    tree.Update(mnList, false);
+    BOOST_CHECK(tree.GetMerkleRoot() == expectedRoot);
+
+    // the manager's tree follows the lists passed to it
+    LOCK(deterministicMNManager->cs);
+    bool mutated{true};
+    BOOST_CHECK(deterministicMNManager->CalcSMLMerkleRoot(mnList, false, &mutated) == expectedRoot);
+    BOOST_CHECK(!mutated);
+    auto newList = mnList;
+    newList.AddMN(MakeTestMN(10));
+    BOOST_CHECK(deterministicMNManager->CalcSMLMerkleRoot(newList, false, &mutated) == CSimplifiedMNList(newList, false).CalcMerkleRoot());
+    BOOST_CHECK(deterministicMNManager->CalcSMLMerkleRoot(mnList, false, nullptr) == expectedRoot);
+}
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_entryhash_memo)
+{
+    bls::bls_legacy_scheme.store(true);
+
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    auto dmn = MakeTestMN(0);
+    mnList.AddMN(dmn);
+
+    auto calcHash = [](const CDeterministicMN& dmn, uint16_t nVersion) {
+        CSimplifiedMNListEntry sme(dmn);
+        sme.nVersion = nVersion;
+        return sme.CalcHash();
+    };
+    const uint256 hash = dmn->GetSmlEntryHash(CSimplifiedMNListEntry::LEGACY_BLS_VERSION);
+    BOOST_CHECK(hash == calcHash(*dmn, CSimplifiedMNListEntry::LEGACY_BLS_VERSION));
+    BOOST_CHECK(dmn->GetSmlEntryHash(CSimplifiedMNListEntry::BASIC_BLS_VERSION) == calcHash(*dmn, CSimplifiedMNListEntry::BASIC_BLS_VERSION));
+
+    // non-SML change keeps the memoized hash
+    uint256 memo;
+    CDeterministicMNStateDiff nonSmlDiff;
+    nonSmlDiff.fields = CDeterministicMNStateDiff::Field_nLastPaidHeight;
+    nonSmlDiff.state.nLastPaidHeight = 10;
+    mnList.UpdateMN(*dmn, nonSmlDiff);
+    auto dmn2 = mnList.GetMN(dmn->proTxHash);
+    BOOST_CHECK(dmn2->pdmnState != dmn->pdmnState);
+    BOOST_CHECK(dmn2->pdmnState->smlEntryHash.Get(CSimplifiedMNListEntry::BASIC_BLS_VERSION, memo));
+    BOOST_CHECK(dmn2->GetSmlEntryHash(CSimplifiedMNListEntry::BASIC_BLS_VERSION) == calcHash(*dmn2, CSimplifiedMNListEntry::BASIC_BLS_VERSION));
+
+    // SML change drops it
+    auto newState = std::make_shared<CDeterministicMNState>(*dmn2->pdmnState);
+    newState->confirmedHash = InsecureRand256();
+    mnList.UpdateMN(*dmn2, newState);
+    auto dmn3 = mnList.GetMN(dmn->proTxHash);
+    BOOST_CHECK(!dmn3->pdmnState->smlEntryHash.Get(CSimplifiedMNListEntry::BASIC_BLS_VERSION, memo));
+    BOOST_CHECK(dmn3->GetSmlEntryHash(CSimplifiedMNListEntry::BASIC_BLS_VERSION) == calcHash(*dmn3, CSimplifiedMNListEntry::BASIC_BLS_VERSION));
+    BOOST_CHECK(dmn3->GetSmlEntryHash(CSimplifiedMNListEntry::BASIC_BLS_VERSION) != dmn2->GetSmlEntryHash(CSimplifiedMNListEntry::BASIC_BLS_VERSION));
+
+    // entries built from the list use the memoized hashes and match freshly calculated ones
+    CSimplifiedMNList sml(mnList, true);
+    BOOST_CHECK(sml.mnList[0]->CalcHash() == calcHash(*dmn3, CSimplifiedMNListEntry::BASIC_BLS_VERSION));
+}
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_response_cache)
+{
+    CSerializedResponseCache cache(4, 100);
+    const auto makeBuffer = [](size_t size) {
+        return std::make_shared<const std::vector<unsigned char>>(size, (unsigned char)size);
+    };
+
+    // hits hand out the buffer that was inserted, without copying it
+    const auto buffer1 = makeBuffer(40);
+    cache.Insert(uint256::ONE, buffer1);
+    BOOST_CHECK(cache.Get(uint256::ONE) == buffer1);
+    BOOST_CHECK(cache.Get(uint256::TWO) == nullptr);
+    BOOST_CHECK_EQUAL(cache.GetStats().hits, 1U);
+    BOOST_CHECK_EQUAL(cache.GetStats().misses, 1U);
+    BOOST_CHECK_EQUAL(cache.GetBytes(), 40U);
+
+    // replacing an entry doesn't count it twice
+    cache.Insert(uint256::ONE, makeBuffer(30));
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+    BOOST_CHECK_EQUAL(cache.GetBytes(), 30U);
+
+    // the cache is bounded by bytes, the least recently used entries are evicted first
+    const uint256 key3 = uint256S("03");
+    cache.Insert(uint256::TWO, makeBuffer(30));
+    BOOST_CHECK(cache.Get(uint256::ONE) != nullptr);
+    cache.Insert(key3, makeBuffer(60));
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+    BOOST_CHECK_EQUAL(cache.GetBytes(), 90U);
+    BOOST_CHECK(cache.Get(uint256::TWO) == nullptr);
+    BOOST_CHECK(cache.Get(uint256::ONE) != nullptr);
+    BOOST_CHECK_EQUAL(cache.GetStats().evictions, 1U);
+
+    // buffers bigger than the whole cache are not kept and don't evict anything
+    cache.Insert(uint256::TWO, makeBuffer(101));
+    BOOST_CHECK(cache.Get(uint256::TWO) == nullptr);
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+
+    // evicted and cleared buffers stay valid for whoever still holds them
+    const auto held = cache.Get(key3);
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+    BOOST_CHECK_EQUAL(cache.GetBytes(), 0U);
+    BOOST_CHECK(cache.Get(key3) == nullptr);
+    BOOST_REQUIRE(held != nullptr);
+    BOOST_CHECK_EQUAL(held->size(), 60U);
+
+    // the number of entries is bounded as well
+    for (const auto& key : {uint256::ONE, uint256::TWO, key3, uint256S("04"), uint256S("05")}) {
+        cache.Insert(key, makeBuffer(10));
+    }
+    BOOST_CHECK_EQUAL(cache.Size(), 4U);
+    BOOST_CHECK_EQUAL(cache.GetBytes(), 40U);
+    BOOST_CHECK(cache.Get(uint256::ONE) == nullptr);
+    BOOST_CHECK_EQUAL(cache.GetStats().evictions, 2U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
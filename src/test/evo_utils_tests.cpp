@@ -4,10 +4,12 @@
 
 #include <test/util/setup_common.h>
 
+#include <evo/deterministicmns.h>
 #include <llmq/context.h>
 #include <llmq/utils.h>
 #include <llmq/params.h>
 #include <llmq/quorums.h>
+#include <llmq/snapshot.h>
 
 #include <chainparams.h>
 
@@ -51,4 +53,43 @@ BOOST_FIXTURE_TEST_CASE(utils_IsQuorumTypeEnabled_tests_mainnet, TestingSetup)
     Test(*m_node.llmq_ctx->qman);
 }
 
+BOOST_FIXTURE_TEST_CASE(utils_persisted_quorum_members, RegTestingSetup)
+{
+    const auto& llmqParams = Params().GetConsensus().llmqs.front();
+
+    uint256 blockHash = InsecureRand256();
+    CBlockIndex index;
+    index.nHeight = llmqParams.dkgInterval;
+    index.phashBlock = &blockHash;
+
+    auto dmn = std::make_shared<CDeterministicMN>(1);
+    dmn->proTxHash = InsecureRand256();
+    dmn->pdmnState = std::make_shared<CDeterministicMNState>();
+
+    auto& manager = *llmq::quorumSnapshotManager;
+    BOOST_CHECK(!manager.GetQuorumMembers(llmqParams.type, &index, 0).has_value());
+    manager.StoreQuorumMembers(llmqParams.type, &index, {{dmn}, {}});
+
+    auto members = manager.GetQuorumMembers(llmqParams.type, &index, 0);
+    BOOST_REQUIRE(members.has_value());
+    BOOST_REQUIRE_EQUAL(members->size(), 1U);
+    BOOST_CHECK((*members)[0]->proTxHash == dmn->proTxHash);
+    BOOST_CHECK_EQUAL((*members)[0]->GetInternalId(), 1U);
+    BOOST_CHECK(manager.GetQuorumMembers(llmqParams.type, &index, 1).has_value());
+    BOOST_CHECK(!manager.GetQuorumMembers(llmqParams.type, &index, 2).has_value());
+
+    // still in use
+    manager.CleanupOldQuorumMembers(index.nHeight + 1);
+    BOOST_CHECK(manager.GetQuorumMembers(llmqParams.type, &index, 0).has_value());
+
+    // too old
+    manager.CleanupOldQuorumMembers(index.nHeight + 2 * llmqParams.signingActiveQuorumCount * llmqParams.dkgInterval + 1);
+    BOOST_CHECK(!manager.GetQuorumMembers(llmqParams.type, &index, 0).has_value());
+    BOOST_CHECK(!manager.GetQuorumMembers(llmqParams.type, &index, 1).has_value());
+
+    manager.StoreQuorumMembers(llmqParams.type, &index, {{dmn}});
+    manager.EraseQuorumMembers(llmqParams.type, &index);
+    BOOST_CHECK(!manager.GetQuorumMembers(llmqParams.type, &index, 0).has_value());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
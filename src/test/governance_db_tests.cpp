@@ -0,0 +1,123 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <evo/deterministicmns.h>
+#include <governance/governancedb.h>
+#include <util/strencodings.h>
+
+#include <test/util/governance.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(governance_db_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(governance_db_objects_and_votes)
+{
+    CGovernanceDb db(true, true);
+
+    const uint256 nCollateralHash = InsecureRand256();
+    const std::string strData = HexStr(std::string("{\"name\":\"test\"}"));
+    CGovernanceObject govobj(uint256(), 1, 1000, nCollateralHash, strData);
+    const uint256 nHash = govobj.GetHash();
+
+    const COutPoint mn1(InsecureRand256(), 0);
+    const COutPoint mn2(InsecureRand256(), 1);
+    const std::vector<CGovernanceVote> votes1{MakeGovernanceVote(mn1, nHash, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES, 1100)};
+    const std::vector<CGovernanceVote> votes2{MakeGovernanceVote(mn2, nHash, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_NO, 1200),
+                                              MakeGovernanceVote(mn2, nHash, VOTE_SIGNAL_DELETE, VOTE_OUTCOME_YES, 1300)};
+    govobj.LoadMasternodeVotes(mn1, MakeGovernanceVoteRecord(votes1), votes1);
+    govobj.LoadMasternodeVotes(mn2, MakeGovernanceVoteRecord(votes2), votes2);
+
+    db.WriteObject(govobj);
+    db.WriteMasternodeVotes(govobj, mn1);
+    db.WriteMasternodeVotes(govobj, mn2);
+
+    CGovernanceObject otherObj(uint256(), 1, 2000, InsecureRand256(), strData);
+    const std::vector<CGovernanceVote> otherVotes{MakeGovernanceVote(mn1, otherObj.GetHash(), VOTE_SIGNAL_VALID, VOTE_OUTCOME_YES, 2100)};
+    otherObj.LoadMasternodeVotes(mn1, MakeGovernanceVoteRecord(otherVotes), otherVotes);
+    db.WriteObjectWithVotes(otherObj);
+
+    std::map<uint256, CGovernanceObject> mapObjects;
+    BOOST_CHECK_EQUAL(db.ReadObjects(mapObjects), 4U);
+    BOOST_CHECK_EQUAL(mapObjects.size(), 2U);
+    BOOST_REQUIRE(mapObjects.count(nHash));
+    {
+        const auto& loadedObj = mapObjects.at(nHash);
+        BOOST_CHECK(loadedObj.GetCollateralHash() == nCollateralHash);
+        BOOST_CHECK_EQUAL(loadedObj.GetVoteFile().GetVoteCount(), 3);
+        for (const auto& vote : votes2) {
+            BOOST_CHECK(loadedObj.GetVoteFile().HasVote(vote.GetHash()));
+        }
+        vote_rec_t voteRecord;
+        BOOST_CHECK(loadedObj.GetCurrentMNVotes(mn2, voteRecord));
+        BOOST_CHECK_EQUAL(voteRecord.mapInstances.size(), 2U);
+        BOOST_CHECK_EQUAL(voteRecord.mapInstances.at(VOTE_SIGNAL_DELETE).nCreationTime, 1300);
+        BOOST_CHECK_EQUAL(loadedObj.GetAbsoluteYesCount(VOTE_SIGNAL_FUNDING), 0);
+    }
+
+    // a masternode without votes left on the object is erased
+    CGovernanceObject withoutMn1(uint256(), 1, 1000, nCollateralHash, strData);
+    BOOST_REQUIRE(withoutMn1.GetHash() == nHash);
+    withoutMn1.LoadMasternodeVotes(mn2, MakeGovernanceVoteRecord(votes2), votes2);
+    db.WriteMasternodeVotes(withoutMn1, mn1);
+
+    mapObjects.clear();
+    BOOST_CHECK_EQUAL(db.ReadObjects(mapObjects), 3U);
+    vote_rec_t voteRecord;
+    BOOST_CHECK(!mapObjects.at(nHash).GetCurrentMNVotes(mn1, voteRecord));
+    BOOST_CHECK_EQUAL(mapObjects.at(nHash).GetVoteFile().GetVoteCount(), 2);
+
+    // erasing an object erases its votes but not the ones of other objects
+    db.EraseObject(nHash, 3000);
+    mapObjects.clear();
+    BOOST_CHECK_EQUAL(db.ReadObjects(mapObjects), 1U);
+    BOOST_CHECK_EQUAL(mapObjects.size(), 1U);
+    BOOST_CHECK(mapObjects.count(otherObj.GetHash()));
+
+    std::map<uint256, int64_t> mapErased;
+    db.ReadErasedObjects(mapErased);
+    BOOST_CHECK_EQUAL(mapErased.size(), 1U);
+    BOOST_CHECK_EQUAL(mapErased.at(nHash), 3000);
+}
+
+BOOST_AUTO_TEST_CASE(governance_db_erased_and_orphans)
+{
+    CGovernanceDb db(true, true);
+
+    const uint256 nErasedHash = InsecureRand256();
+    db.EraseObject(nErasedHash, 5000);
+    std::map<uint256, int64_t> mapErased;
+    db.ReadErasedObjects(mapErased);
+    BOOST_CHECK_EQUAL(mapErased.size(), 1U);
+    BOOST_CHECK_EQUAL(mapErased.at(nErasedHash), 5000);
+    db.ForgetErasedObjects({nErasedHash});
+    mapErased.clear();
+    db.ReadErasedObjects(mapErased);
+    BOOST_CHECK(mapErased.empty());
+
+    const COutPoint mn(InsecureRand256(), 0);
+    const uint256 nParentHash = InsecureRand256();
+    const vote_time_pair_t orphan1(MakeGovernanceVote(mn, nParentHash, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES, 1000), 2000);
+    const vote_time_pair_t orphan2(MakeGovernanceVote(mn, nParentHash, VOTE_SIGNAL_DELETE, VOTE_OUTCOME_NO, 1000), 2000);
+    db.WriteOrphanVote(orphan1);
+    db.WriteOrphanVote(orphan2);
+    std::vector<vote_time_pair_t> vecOrphans;
+    db.ReadOrphanVotes(vecOrphans);
+    BOOST_CHECK_EQUAL(vecOrphans.size(), 2U);
+    db.EraseOrphanVotes({orphan1});
+    vecOrphans.clear();
+    db.ReadOrphanVotes(vecOrphans);
+    BOOST_REQUIRE_EQUAL(vecOrphans.size(), 1U);
+    BOOST_CHECK(vecOrphans[0].first.GetHash() == orphan2.first.GetHash());
+    BOOST_CHECK_EQUAL(vecOrphans[0].second, 2000);
+
+    CDeterministicMNList mnList;
+    BOOST_CHECK(!db.ReadMNList(mnList));
+    db.WriteInvalidatedVotes({}, CDeterministicMNList(InsecureRand256(), 10, 0));
+    BOOST_CHECK(db.ReadMNList(mnList));
+    BOOST_CHECK_EQUAL(mnList.GetHeight(), 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
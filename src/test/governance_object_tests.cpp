@@ -0,0 +1,75 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governance/object.h>
+#include <streams.h>
+#include <util/strencodings.h>
+#include <version.h>
+
+#include <test/util/governance.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(governance_object_tests, BasicTestingSetup)
+
+static void LoadVotes(CGovernanceObject& govobj, const COutPoint& mnOutpoint, const std::vector<CGovernanceVote>& votes)
+{
+    govobj.LoadMasternodeVotes(mnOutpoint, MakeGovernanceVoteRecord(votes), votes);
+}
+
+static void CheckFundingCounts(const CGovernanceObject& govobj, int nYes, int nNo, int nAbstain)
+{
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_FUNDING), nYes);
+    BOOST_CHECK_EQUAL(govobj.GetNoCount(VOTE_SIGNAL_FUNDING), nNo);
+    BOOST_CHECK_EQUAL(govobj.GetAbstainCount(VOTE_SIGNAL_FUNDING), nAbstain);
+    BOOST_CHECK_EQUAL(govobj.GetAbsoluteYesCount(VOTE_SIGNAL_FUNDING), nYes - nNo);
+}
+
+BOOST_AUTO_TEST_CASE(governance_object_vote_counts)
+{
+    CGovernanceObject govobj(uint256(), 1, 1000, InsecureRand256(), HexStr(std::string("{\"name\":\"test\"}")));
+    const uint256 nHash = govobj.GetHash();
+
+    const COutPoint mn1(InsecureRand256(), 0);
+    const COutPoint mn2(InsecureRand256(), 0);
+    const COutPoint mn3(InsecureRand256(), 0);
+    LoadVotes(govobj, mn1, {MakeGovernanceVote(mn1, nHash, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES, 1100),
+                            MakeGovernanceVote(mn1, nHash, VOTE_SIGNAL_DELETE, VOTE_OUTCOME_YES, 1100)});
+    LoadVotes(govobj, mn2, {MakeGovernanceVote(mn2, nHash, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_NO, 1200)});
+    LoadVotes(govobj, mn3, {MakeGovernanceVote(mn3, nHash, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES, 1300)});
+    CheckFundingCounts(govobj, 2, 1, 0);
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_DELETE), 1);
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_VALID), 0);
+    BOOST_CHECK_EQUAL(govobj.GetVoteFile().GetVotesFromMasternode(mn1).size(), 2U);
+
+    // a newer vote replaces the previous one of the same masternode and signal
+    LoadVotes(govobj, mn3, {MakeGovernanceVote(mn3, nHash, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_ABSTAIN, 1400)});
+    CheckFundingCounts(govobj, 1, 1, 1);
+    BOOST_CHECK_EQUAL(govobj.GetVoteFile().GetVotesFromMasternode(mn3).size(), 1U);
+    BOOST_CHECK_EQUAL(govobj.GetVoteFile().GetVoteCount(), 4);
+
+    // counts survive copies and the disk format
+    CGovernanceObject copy(govobj);
+    CheckFundingCounts(copy, 1, 1, 1);
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << govobj;
+    CGovernanceObject loaded;
+    ss >> loaded;
+    CheckFundingCounts(loaded, 1, 1, 1);
+    BOOST_CHECK_EQUAL(loaded.GetYesCount(VOTE_SIGNAL_DELETE), 1);
+
+    // none of these masternodes is in the (empty) list, so their votes are invalid now
+    BOOST_CHECK_EQUAL(govobj.RemoveInvalidVotes(mn2).size(), 1U);
+    CheckFundingCounts(govobj, 1, 0, 1);
+    BOOST_CHECK(govobj.GetVoteFile().GetVotesFromMasternode(mn2).empty());
+
+    BOOST_CHECK_EQUAL(govobj.ClearMasternodeVotes().size(), 2U);
+    CheckFundingCounts(govobj, 0, 0, 0);
+    BOOST_CHECK_EQUAL(govobj.GetYesCount(VOTE_SIGNAL_DELETE), 0);
+    BOOST_CHECK_EQUAL(govobj.GetVoteFile().GetVoteCount(), 0);
+    BOOST_CHECK(govobj.GetVoteFile().GetVotes().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
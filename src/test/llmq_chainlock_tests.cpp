@@ -0,0 +1,73 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <llmq/chainlocks.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace llmq;
+
+static constexpr int64_t START_TIME{1600000000};
+static constexpr int64_t TIMEOUT{CChainLocksHandler::WAIT_FOR_ISLOCK_TIMEOUT};
+
+BOOST_FIXTURE_TEST_SUITE(llmq_chainlock_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(blocktxs_counters)
+{
+    CChainLocksHandler::BlockTxsState state;
+    BOOST_CHECK(!state.HasUnsafeTxs(START_TIME));
+
+    // two TXs seen at the same time share a counter
+    state.AddUnlockedTx(START_TIME);
+    state.AddUnlockedTx(START_TIME);
+    state.AddUnlockedTx(START_TIME + 100);
+    BOOST_CHECK_EQUAL(state.unlockedTxs.size(), 2U);
+    BOOST_CHECK_EQUAL(state.unlockedTxs.at(START_TIME), 2U);
+    BOOST_CHECK(state.HasUnsafeTxs(START_TIME + 100));
+
+    // only the newest TXs decide whether the block is safe
+    BOOST_CHECK(state.HasUnsafeTxs(START_TIME + TIMEOUT));
+    BOOST_CHECK(!state.HasUnsafeTxs(START_TIME + 100 + TIMEOUT));
+
+    // islocks remove the TXs again, a counter is gone once all of its TXs are locked
+    state.RemoveUnlockedTx(START_TIME + 100);
+    BOOST_CHECK_EQUAL(state.unlockedTxs.size(), 1U);
+    BOOST_CHECK(state.HasUnsafeTxs(START_TIME + TIMEOUT - 1));
+    BOOST_CHECK(!state.HasUnsafeTxs(START_TIME + TIMEOUT));
+    state.RemoveUnlockedTx(START_TIME);
+    BOOST_CHECK_EQUAL(state.unlockedTxs.at(START_TIME), 1U);
+    state.RemoveUnlockedTx(START_TIME);
+    BOOST_CHECK(state.unlockedTxs.empty());
+    BOOST_CHECK(!state.HasUnsafeTxs(START_TIME));
+
+    // removing a TX that isn't counted (anymore) does nothing
+    state.RemoveUnlockedTx(START_TIME);
+    BOOST_CHECK(state.unlockedTxs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(blocktxs_expire)
+{
+    CChainLocksHandler::BlockTxsState state;
+    state.AddUnlockedTx(START_TIME);
+    state.AddUnlockedTx(START_TIME + 10);
+    state.AddUnlockedTx(START_TIME + 20);
+
+    // TXs are dropped as soon as they are old enough to be safe without an islock
+    state.ExpireUnlockedTxs(START_TIME + TIMEOUT - 1);
+    BOOST_CHECK_EQUAL(state.unlockedTxs.size(), 3U);
+    state.ExpireUnlockedTxs(START_TIME + TIMEOUT + 10);
+    BOOST_CHECK_EQUAL(state.unlockedTxs.size(), 1U);
+    BOOST_CHECK(state.HasUnsafeTxs(START_TIME + TIMEOUT + 10));
+
+    // a late islock for an expired TX does not touch the remaining counter
+    state.RemoveUnlockedTx(START_TIME);
+    BOOST_CHECK_EQUAL(state.unlockedTxs.at(START_TIME + 20), 1U);
+
+    state.ExpireUnlockedTxs(START_TIME + TIMEOUT + 20);
+    BOOST_CHECK(state.unlockedTxs.empty());
+    BOOST_CHECK(!state.HasUnsafeTxs(START_TIME + TIMEOUT + 20));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
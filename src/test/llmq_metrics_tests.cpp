@@ -0,0 +1,38 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <llmq/metrics.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(llmq_metrics_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(counters_and_timings)
+{
+    llmq::CLLMQMetrics metrics;
+
+    BOOST_CHECK_EQUAL(metrics.GetCounter("test.counter"), 0);
+    metrics.Inc("test.counter");
+    metrics.Inc("test.counter", 4);
+    metrics.Inc("test.counter", 0);
+    BOOST_CHECK_EQUAL(metrics.GetCounter("test.counter"), 5);
+
+    BOOST_CHECK_EQUAL(metrics.GetTiming("test.timing").count, 0U);
+    metrics.Timing("test.timing", 30);
+    metrics.Timing("test.timing", 10);
+    const auto t = metrics.GetTiming("test.timing");
+    BOOST_CHECK_EQUAL(t.count, 2U);
+    BOOST_CHECK_EQUAL(t.total, 40);
+    BOOST_CHECK_EQUAL(t.max, 30);
+    BOOST_CHECK_EQUAL(t.last, 10);
+
+    const UniValue json = metrics.ToJson();
+    BOOST_CHECK_EQUAL(json["counters"]["test.counter"].get_int64(), 5);
+    BOOST_CHECK_EQUAL(json["timings"]["test.timing"]["count"].get_int64(), 2);
+    BOOST_CHECK_EQUAL(json["timings"]["test.timing"]["avg"].get_int64(), 20);
+    BOOST_CHECK_EQUAL(json["timings"]["test.timing"]["max"].get_int64(), 30);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bls/bls_worker.h>
+#include <chainparams.h>
+#include <evo/deterministicmns.h>
+#include <llmq/commitment.h>
+#include <llmq/context.h>
+#include <llmq/quorums.h>
+#include <llmq/signing.h>
+#include <llmq/signing_shares.h>
+#include <test/util/setup_common.h>
+#include <util/irange.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace llmq {
+struct CSigSharesManagerTest {
+    static void ProcessSigShare(CSigSharesManager& shareman, const CSigShare& sigShare, const CQuorumCPtr& quorum)
+    {
+        shareman.ProcessSigShare(sigShare, shareman.connman, quorum);
+    }
+    static bool AddSigShare(CSigSharesManager& shareman, const CSigShare& sigShare)
+    {
+        size_t sigShareCount;
+        return shareman.AddSigShare(sigShare, sigShareCount);
+    }
+    static size_t CountSigShares(CSigSharesManager& shareman, const uint256& signHash)
+    {
+        auto& shard = shareman.GetSessionShard(signHash);
+        LOCK(shard.cs);
+        return shard.sigShares.CountForSignHash(signHash);
+    }
+    static bool HasSession(CSigSharesManager& shareman, const uint256& signHash)
+    {
+        auto& shard = shareman.GetSessionShard(signHash);
+        LOCK(shard.cs);
+        return shard.timeSeenForSessions.count(signHash) != 0;
+    }
+    static size_t CountQueuedToAnnounce(CSigSharesManager& shareman, const uint256& signHash)
+    {
+        LOCK(shareman.cs);
+        return shareman.sigSharesQueuedToAnnounce.CountForSignHash(signHash);
+    }
+    static CCriticalSection& GetCs(CSigSharesManager& shareman)
+    {
+        return shareman.cs;
+    }
+    static void Cleanup(CSigSharesManager& shareman)
+    {
+        shareman.Cleanup();
+    }
+};
+} // namespace llmq
+
+using namespace llmq;
+
+static constexpr size_t MEMBER_COUNT{10};
+
+static Consensus::LLMQParams MakeParams()
+{
+    auto params = Params().GetConsensus().llmqs.front();
+    // never reach the threshold, the shares in these tests can't be recovered
+    params.size = MEMBER_COUNT;
+    params.threshold = MEMBER_COUNT + 1;
+    return params;
+}
+
+static CQuorumCPtr MakeQuorum(const Consensus::LLMQParams& params, CBLSWorker& blsWorker)
+{
+    auto quorum = std::make_shared<CQuorum>(params, blsWorker);
+    std::vector<CDeterministicMNCPtr> members;
+    for (const auto i : irange::range(MEMBER_COUNT)) {
+        auto dmn = std::make_shared<CDeterministicMN>(i);
+        dmn->proTxHash = uint256(std::vector<unsigned char>(32, (unsigned char)(i + 1)));
+        members.emplace_back(dmn);
+    }
+    quorum->Init(nullptr, nullptr, uint256(), members);
+    return quorum;
+}
+
+static std::vector<CSigShare> MakeSession(const CQuorumCPtr& quorum, const uint256& quorumHash)
+{
+    const uint256 id = GetRandHash();
+    const uint256 msgHash = GetRandHash();
+    std::vector<CSigShare> sigShares;
+    for (const auto i : irange::range(MEMBER_COUNT)) {
+        CSigShare sigShare(quorum->params.type, quorumHash, id, msgHash, uint16_t(i), CBLSLazySignature());
+        sigShare.UpdateKey();
+        sigShares.emplace_back(sigShare);
+    }
+    return sigShares;
+}
+
+static CRecoveredSig MakeRecoveredSig(const CSigShare& sigShare)
+{
+    return CRecoveredSig(sigShare.getLlmqType(), sigShare.getQuorumHash(), sigShare.getId(), sigShare.getMsgHash(), CBLSLazySignature());
+}
+
+BOOST_FIXTURE_TEST_SUITE(llmq_signing_shares_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(sigshares_concurrent_process)
+{
+    const auto params = MakeParams();
+    auto& llmq_ctx = *m_node.llmq_ctx;
+    CSigSharesManager shareman(*m_node.connman, *llmq_ctx.bls_worker, *llmq_ctx.qman, *llmq_ctx.sigman);
+    const auto quorum = MakeQuorum(params, *llmq_ctx.bls_worker);
+    const uint256 quorumHash = GetRandHash();
+
+    std::vector<std::vector<CSigShare>> sessions;
+    for (int i = 0; i < 32; ++i) {
+        sessions.emplace_back(MakeSession(quorum, quorumHash));
+    }
+
+    // every thread processes all shares, starting at a different member, while another thread keeps removing every
+    // fourth session as if it was recovered
+    std::atomic<bool> done{false};
+    std::thread remover([&] {
+        while (!done) {
+            for (size_t i = 0; i < sessions.size(); i += 4) {
+                shareman.HandleNewRecoveredSig(MakeRecoveredSig(sessions[i].front()));
+            }
+        }
+    });
+    std::vector<std::thread> threads;
+    for (const auto t : irange::range(4)) {
+        threads.emplace_back([&, t] {
+            for (const auto i : irange::range(MEMBER_COUNT)) {
+                for (const auto& session : sessions) {
+                    CSigSharesManagerTest::ProcessSigShare(shareman, session[(i + t * 3) % MEMBER_COUNT], quorum);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done = true;
+    remover.join();
+
+    // shares added after the last removal of the loop above are left, they are removed with the next recovered sig
+    for (size_t i = 0; i < sessions.size(); i += 4) {
+        shareman.HandleNewRecoveredSig(MakeRecoveredSig(sessions[i].front()));
+    }
+    for (const auto i : irange::range(sessions.size())) {
+        const auto& signHash = sessions[i].front().GetSignHash();
+        if (i % 4 == 0) {
+            BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, signHash), 0U);
+            BOOST_CHECK(!CSigSharesManagerTest::HasSession(shareman, signHash));
+            BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountQueuedToAnnounce(shareman, signHash), 0U);
+        } else {
+            BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, signHash), MEMBER_COUNT);
+            BOOST_CHECK(CSigSharesManagerTest::HasSession(shareman, signHash));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sigshares_add_without_cs)
+{
+    const auto params = MakeParams();
+    auto& llmq_ctx = *m_node.llmq_ctx;
+    CSigSharesManager shareman(*m_node.connman, *llmq_ctx.bls_worker, *llmq_ctx.qman, *llmq_ctx.sigman);
+    const auto quorum = MakeQuorum(params, *llmq_ctx.bls_worker);
+    const auto session = MakeSession(quorum, GetRandHash());
+
+    // storing shares only takes the shard lock, so it must not block on cs
+    LOCK(CSigSharesManagerTest::GetCs(shareman));
+    std::vector<std::thread> threads;
+    std::atomic<size_t> added{0};
+    for (const auto t : irange::range(4)) {
+        threads.emplace_back([&, t] {
+            for (const auto i : irange::range(MEMBER_COUNT)) {
+                if (CSigSharesManagerTest::AddSigShare(shareman, session[(i + t) % MEMBER_COUNT])) {
+                    ++added;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(added.load(), MEMBER_COUNT);
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, session.front().GetSignHash()), MEMBER_COUNT);
+}
+
+BOOST_AUTO_TEST_CASE(sigshares_session_cleanup)
+{
+    const auto params = MakeParams();
+    auto& llmq_ctx = *m_node.llmq_ctx;
+    CSigSharesManager shareman(*m_node.connman, *llmq_ctx.bls_worker, *llmq_ctx.qman, *llmq_ctx.sigman);
+    const auto quorum = MakeQuorum(params, *llmq_ctx.bls_worker);
+    const uint256 quorumHash = GetRandHash();
+
+    const auto session1 = MakeSession(quorum, quorumHash);
+    const auto session2 = MakeSession(quorum, quorumHash);
+    for (const auto& sigShare : session1) {
+        CSigSharesManagerTest::ProcessSigShare(shareman, sigShare, quorum);
+    }
+    for (const auto& sigShare : session2) {
+        CSigSharesManagerTest::ProcessSigShare(shareman, sigShare, quorum);
+    }
+    const auto& signHash1 = session1.front().GetSignHash();
+    const auto& signHash2 = session2.front().GetSignHash();
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, signHash1), MEMBER_COUNT);
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, signHash2), MEMBER_COUNT);
+
+    // a recovered sig removes its own session only
+    shareman.HandleNewRecoveredSig(MakeRecoveredSig(session1.front()));
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, signHash1), 0U);
+    BOOST_CHECK(!CSigSharesManagerTest::HasSession(shareman, signHash1));
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountQueuedToAnnounce(shareman, signHash1), 0U);
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, signHash2), MEMBER_COUNT);
+
+    // the quorum is not known to the quorum manager and thus inactive, so the cleanup removes its sessions
+    CSigSharesManagerTest::Cleanup(shareman);
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountSigShares(shareman, signHash2), 0U);
+    BOOST_CHECK(!CSigSharesManagerTest::HasSession(shareman, signHash2));
+    BOOST_CHECK_EQUAL(CSigSharesManagerTest::CountQueuedToAnnounce(shareman, signHash2), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
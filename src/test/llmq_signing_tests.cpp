@@ -0,0 +1,240 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bls/bls_worker.h>
+#include <chainparams.h>
+#include <evo/deterministicmns.h>
+#include <llmq/commitment.h>
+#include <llmq/quorums.h>
+#include <llmq/signing.h>
+#include <test/util/setup_common.h>
+#include <util/irange.h>
+#include <util/time.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace llmq;
+
+static constexpr int64_t START_TIME{1600000000};
+static constexpr auto LLMQ_TYPE{Consensus::LLMQType::LLMQ_TEST};
+
+static CRecoveredSig MakeRecoveredSig(const uint256& id)
+{
+    CBLSSecretKey sk;
+    sk.MakeNewKey();
+    const uint256 msgHash = GetRandHash();
+    return CRecoveredSig(LLMQ_TYPE, GetRandHash(), id, msgHash, sk.Sign(msgHash));
+}
+
+BOOST_FIXTURE_TEST_SUITE(llmq_signing_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(recsigdb_write_and_truncate)
+{
+    SetMockTime(START_TIME);
+    CRecoveredSigsDb db(true, true);
+
+    const auto recSig = MakeRecoveredSig(GetRandHash());
+    BOOST_CHECK(!db.HasRecoveredSigForId(LLMQ_TYPE, recSig.getId()));
+    db.WriteRecoveredSig(recSig);
+
+    BOOST_CHECK(db.HasRecoveredSigForId(LLMQ_TYPE, recSig.getId()));
+    BOOST_CHECK(db.HasRecoveredSig(LLMQ_TYPE, recSig.getId(), recSig.getMsgHash()));
+    BOOST_CHECK(!db.HasRecoveredSig(LLMQ_TYPE, recSig.getId(), GetRandHash()));
+    BOOST_CHECK(db.HasRecoveredSigForSession(recSig.buildSignHash()));
+    BOOST_CHECK(db.HasRecoveredSigForHash(recSig.GetHash()));
+    BOOST_CHECK(!db.HasRecoveredSigForId(LLMQ_TYPE, GetRandHash()));
+    BOOST_CHECK(!db.HasRecoveredSigForHash(GetRandHash()));
+
+    CRecoveredSig ret;
+    BOOST_CHECK(db.GetRecoveredSigByHash(recSig.GetHash(), ret));
+    BOOST_CHECK(ret.GetHash() == recSig.GetHash());
+    BOOST_CHECK(db.GetRecoveredSigById(LLMQ_TYPE, recSig.getId(), ret));
+    BOOST_CHECK(ret.GetHash() == recSig.GetHash());
+
+    // truncation keeps the hash so that we don't request the recovered sig again
+    db.TruncateRecoveredSig(LLMQ_TYPE, recSig.getId());
+    BOOST_CHECK(!db.HasRecoveredSigForId(LLMQ_TYPE, recSig.getId()));
+    BOOST_CHECK(!db.HasRecoveredSigForSession(recSig.buildSignHash()));
+    BOOST_CHECK(db.HasRecoveredSigForHash(recSig.GetHash()));
+    BOOST_CHECK(!db.GetRecoveredSigByHash(recSig.GetHash(), ret));
+
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(recsigdb_expire_buckets)
+{
+    SetMockTime(START_TIME);
+    CRecoveredSigsDb db(true, true);
+
+    const auto oldRecSig = MakeRecoveredSig(GetRandHash());
+    const uint256 oldVoteId = GetRandHash();
+    db.WriteRecoveredSig(oldRecSig);
+    db.WriteVoteForId(LLMQ_TYPE, oldVoteId, oldRecSig.getMsgHash());
+
+    SetMockTime(START_TIME + 2 * CRecoveredSigsDb::BUCKET_DURATION);
+    const auto newRecSig = MakeRecoveredSig(GetRandHash());
+    const uint256 newVoteId = GetRandHash();
+    db.WriteRecoveredSig(newRecSig);
+    db.WriteVoteForId(LLMQ_TYPE, newVoteId, newRecSig.getMsgHash());
+
+    // nothing is older than a full bucket yet
+    BOOST_CHECK(db.HasRecoveredSigForId(LLMQ_TYPE, newRecSig.getId()));
+    db.CleanupOldRecoveredSigs(3 * CRecoveredSigsDb::BUCKET_DURATION);
+    db.CleanupOldVotes(3 * CRecoveredSigsDb::BUCKET_DURATION);
+    BOOST_CHECK(db.HasRecoveredSigForId(LLMQ_TYPE, oldRecSig.getId()));
+    BOOST_CHECK(db.HasVotedOnId(LLMQ_TYPE, oldVoteId));
+
+    db.CleanupOldRecoveredSigs(CRecoveredSigsDb::BUCKET_DURATION);
+    db.CleanupOldVotes(CRecoveredSigsDb::BUCKET_DURATION);
+    BOOST_CHECK(!db.HasRecoveredSigForId(LLMQ_TYPE, oldRecSig.getId()));
+    BOOST_CHECK(!db.HasRecoveredSigForSession(oldRecSig.buildSignHash()));
+    BOOST_CHECK(!db.HasRecoveredSigForHash(oldRecSig.GetHash()));
+    BOOST_CHECK(!db.HasVotedOnId(LLMQ_TYPE, oldVoteId));
+
+    // only the cached entries of the dropped bucket are forgotten
+    const auto hits = db.GetCacheStats().at("hasSigForId").hits;
+    BOOST_CHECK(db.HasRecoveredSigForId(LLMQ_TYPE, newRecSig.getId()));
+    BOOST_CHECK_EQUAL(db.GetCacheStats().at("hasSigForId").hits, hits + 1);
+    BOOST_CHECK(db.HasRecoveredSigForHash(newRecSig.GetHash()));
+    uint256 msgHash;
+    BOOST_CHECK(db.GetVoteForId(LLMQ_TYPE, newVoteId, msgHash));
+    BOOST_CHECK(msgHash == newRecSig.getMsgHash());
+
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(recsigdb_bucket_filter_rollover)
+{
+    // a busy bucket gets additional filters instead of saturating the first one
+    CRecoveredSigsDb::BucketFilter filter;
+    std::vector<std::vector<unsigned char>> keys;
+    for (unsigned int i = 0; i < 2 * CRecoveredSigsDb::BUCKET_BLOOM_ELEMENTS + 1; i++) {
+        const uint256 hash = InsecureRand256();
+        keys.emplace_back(hash.begin(), hash.end());
+        filter.insert(keys.back());
+    }
+    BOOST_CHECK_EQUAL(filter.GetFilterCount(), 3U);
+    BOOST_CHECK(std::all_of(keys.begin(), keys.end(), [&filter](const auto& key) { return filter.contains(key); }));
+
+    // each filter stays at its false positive rate, so expect ~30 false positives here
+    int falsePositives{0};
+    for (int i = 0; i < 10000; i++) {
+        const uint256 hash = InsecureRand256();
+        falsePositives += filter.contains(std::vector<unsigned char>(hash.begin(), hash.end()));
+    }
+    BOOST_CHECK_LT(falsePositives, 100);
+}
+
+BOOST_AUTO_TEST_CASE(recsigdb_reload_buckets)
+{
+    SetMockTime(START_TIME);
+    const auto recSig = MakeRecoveredSig(GetRandHash());
+    const uint256 voteId = GetRandHash();
+    {
+        CRecoveredSigsDb db(false, true);
+        db.WriteRecoveredSig(recSig);
+        db.WriteVoteForId(LLMQ_TYPE, voteId, recSig.getMsgHash());
+    }
+
+    // the bloom filters are rebuilt from the db on startup
+    CRecoveredSigsDb db(false, false);
+    BOOST_CHECK(db.HasRecoveredSigForId(LLMQ_TYPE, recSig.getId()));
+    BOOST_CHECK(db.HasRecoveredSigForSession(recSig.buildSignHash()));
+    BOOST_CHECK(db.HasRecoveredSigForHash(recSig.GetHash()));
+    BOOST_CHECK(db.HasVotedOnId(LLMQ_TYPE, voteId));
+    BOOST_CHECK(!db.HasVotedOnId(LLMQ_TYPE, GetRandHash()));
+
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(recsigdb_migrate_to_buckets)
+{
+    SetMockTime(START_TIME);
+    const auto recSig = MakeRecoveredSig(GetRandHash());
+    const auto truncatedRecSig = MakeRecoveredSig(GetRandHash());
+    const uint256 voteId = GetRandHash();
+    {
+        // the layout used by previous versions
+        CDBWrapper oldDb(GetDataDir() / "llmq/recsigdb", 1 << 20, false, true);
+        CDBBatch batch(oldDb);
+        batch.Write(std::make_tuple(std::string("rs_r"), LLMQ_TYPE, recSig.getId()), recSig);
+        batch.Write(std::make_tuple(std::string("rs_r"), LLMQ_TYPE, recSig.getId(), recSig.getMsgHash()), (uint32_t)START_TIME);
+        batch.Write(std::make_tuple(std::string("rs_h"), recSig.GetHash()), std::make_pair(LLMQ_TYPE, recSig.getId()));
+        batch.Write(std::make_tuple(std::string("rs_s"), recSig.buildSignHash()), (uint8_t)1);
+        batch.Write(std::make_tuple(std::string("rs_t"), (uint32_t)htobe32(START_TIME), LLMQ_TYPE, recSig.getId()), (uint8_t)1);
+        batch.Write(std::make_tuple(std::string("rs_h"), truncatedRecSig.GetHash()), std::make_pair(LLMQ_TYPE, truncatedRecSig.getId()));
+        batch.Write(std::make_tuple(std::string("rs_v"), LLMQ_TYPE, voteId), recSig.getMsgHash());
+        batch.Write(std::make_tuple(std::string("rs_vt"), (uint32_t)htobe32(START_TIME), LLMQ_TYPE, voteId), (uint8_t)1);
+        oldDb.WriteBatch(batch);
+    }
+
+    CRecoveredSigsDb db(false, false);
+    BOOST_CHECK(db.HasRecoveredSig(LLMQ_TYPE, recSig.getId(), recSig.getMsgHash()));
+    BOOST_CHECK(db.HasRecoveredSigForSession(recSig.buildSignHash()));
+    BOOST_CHECK(db.HasRecoveredSigForHash(recSig.GetHash()));
+    BOOST_CHECK(db.HasRecoveredSigForHash(truncatedRecSig.GetHash()));
+    BOOST_CHECK(!db.HasRecoveredSigForId(LLMQ_TYPE, truncatedRecSig.getId()));
+    uint256 msgHash;
+    BOOST_CHECK(db.GetVoteForId(LLMQ_TYPE, voteId, msgHash));
+    BOOST_CHECK(msgHash == recSig.getMsgHash());
+
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(quorum_lagrange_coefficients_cache)
+{
+    CBLSWorker blsWorker;
+    CQuorum quorum(Params().GetConsensus().llmqs.front(), blsWorker);
+    std::vector<CDeterministicMNCPtr> members;
+    for (const auto i : irange::range(5)) {
+        auto dmn = std::make_shared<CDeterministicMN>(i);
+        dmn->proTxHash = uint256(std::vector<unsigned char>(32, (unsigned char)(i + 1)));
+        members.emplace_back(dmn);
+    }
+    quorum.Init(nullptr, nullptr, uint256(), members);
+
+    const size_t threshold = 3;
+    std::vector<CBLSSecretKey> msk(threshold);
+    for (auto& sk : msk) {
+        sk.MakeNewKey();
+    }
+    std::vector<CBLSSecretKey> skShares(members.size());
+    for (const auto i : irange::range(members.size())) {
+        BOOST_CHECK(skShares[i].SecretKeyShare(msk, quorum.GetMemberId(i)));
+    }
+
+    const std::vector<uint16_t> memberIndexes{0, 2, 4};
+    const std::vector<CBLSId> ids{quorum.GetMemberId(0), quorum.GetMemberId(2), quorum.GetMemberId(4)};
+    const auto coefficients = quorum.GetLagrangeCoefficients(memberIndexes);
+    BOOST_REQUIRE(coefficients != nullptr);
+    BOOST_CHECK_EQUAL(quorum.GetLagrangeCoefficientsCacheStats().misses, 1U);
+    BOOST_CHECK_EQUAL(quorum.GetLagrangeCoefficientsCacheStats().hits, 0U);
+
+    for (const auto& hash : {uint256::ONE, uint256::TWO}) {
+        // the second and later sessions of the same members are served from the cache
+        const auto cached = quorum.GetLagrangeCoefficients(memberIndexes);
+        BOOST_REQUIRE(cached != nullptr);
+        BOOST_CHECK(cached == coefficients);
+
+        const std::vector<CBLSSignature> sigShares{skShares[0].Sign(hash), skShares[2].Sign(hash), skShares[4].Sign(hash)};
+        CBLSSignature recoveredById, recoveredByCoefficients;
+        BOOST_CHECK(recoveredById.Recover(sigShares, ids));
+        BOOST_CHECK(recoveredByCoefficients.Recover(sigShares, *cached));
+        BOOST_CHECK(recoveredByCoefficients == recoveredById);
+        BOOST_CHECK(recoveredByCoefficients.VerifyInsecure(msk[0].GetPublicKey(), hash));
+    }
+    BOOST_CHECK_EQUAL(quorum.GetLagrangeCoefficientsCacheStats().hits, 2U);
+
+    // another set of members gets its own entry, invalid indexes are not cached
+    const auto other = quorum.GetLagrangeCoefficients({1, 2, 3});
+    BOOST_REQUIRE(other != nullptr);
+    BOOST_CHECK(other != coefficients);
+    BOOST_CHECK(quorum.GetLagrangeCoefficients({0, 5}) == nullptr);
+    BOOST_CHECK(quorum.GetLagrangeCoefficients({0, 0}) == nullptr);
+    size_t memoryUsage;
+    BOOST_CHECK_EQUAL(quorum.GetLagrangeCoefficientsCacheSize(memoryUsage), 2U);
+    BOOST_CHECK(memoryUsage > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -788,4 +788,38 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTests)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolInstantSendStateTest)
+{
+    CTxMemPool pool;
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig = CScript() << OP_11;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    tx.vout[0].nValue = 10 * COIN;
+    pool.addUnchecked(entry.Time(1000).FromTx(tx));
+
+    auto it = pool.mapTx.find(tx.GetHash());
+    BOOST_CHECK(!it->m_instantsend_locked);
+    BOOST_CHECK_EQUAL(it->m_first_seen_time, 1000);
+
+    pool.SetInstantSendLocked(tx.GetHash());
+    BOOST_CHECK(it->m_instantsend_locked);
+
+    // the first seen time only moves back
+    pool.UpdateFirstSeenTime(tx.GetHash(), 2000);
+    BOOST_CHECK_EQUAL(it->m_first_seen_time, 1000);
+    pool.UpdateFirstSeenTime(tx.GetHash(), 500);
+    BOOST_CHECK_EQUAL(it->m_first_seen_time, 500);
+    BOOST_CHECK_EQUAL(count_seconds(it->GetTime()), 1000);
+
+    // unknown TXs are ignored
+    pool.SetInstantSendLocked(uint256::ONE);
+    pool.UpdateFirstSeenTime(uint256::ONE, 0);
+    BOOST_CHECK_EQUAL(pool.size(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
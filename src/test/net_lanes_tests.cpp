@@ -0,0 +1,89 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net_lanes.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <future>
+#include <map>
+
+BOOST_FIXTURE_TEST_SUITE(net_lanes_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(lanes_per_peer_order)
+{
+    CPeerMessageLanes lanes(2, {});
+    BOOST_CHECK_EQUAL(lanes.GetLaneCount(), 2U);
+
+    Mutex cs;
+    std::map<NodeId, std::vector<int>> processed;
+    for (int i = 0; i < 400; i++) {
+        const NodeId nodeId = i % 4;
+        BOOST_CHECK(lanes.Push(nodeId, 1, [&cs, &processed, nodeId, i] {
+            LOCK(cs);
+            processed[nodeId].emplace_back(i);
+        }));
+    }
+
+    // a peer always stays on the same lane, so these are processed after everything above
+    std::vector<std::future<void>> done;
+    for (NodeId nodeId = 0; nodeId < 4; nodeId++) {
+        auto p = std::make_shared<std::promise<void>>();
+        done.emplace_back(p->get_future());
+        lanes.Push(nodeId, 1, [p] { p->set_value(); });
+    }
+    for (auto& f : done) {
+        f.wait();
+    }
+
+    LOCK(cs);
+    BOOST_CHECK_EQUAL(processed.size(), 4U);
+    for (const auto& [nodeId, v] : processed) {
+        BOOST_CHECK_EQUAL(v.size(), 100U);
+        for (size_t i = 0; i < v.size(); i++) {
+            BOOST_CHECK_EQUAL(v[i], int(i * 4 + nodeId));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lanes_queued_bytes)
+{
+    std::promise<void> drained;
+    CPeerMessageLanes lanes(1, [&drained] { drained.set_value(); });
+
+    // block the only lane until the test releases it
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    BOOST_CHECK(lanes.Push(1, 10, [releaseFuture] { releaseFuture.wait(); }));
+    BOOST_CHECK(lanes.Push(1, CPeerMessageLanes::MAX_PEER_QUEUED_BYTES, [] {}));
+    BOOST_CHECK(lanes.Push(2, 20, [] {}));
+
+    BOOST_CHECK_EQUAL(lanes.GetQueuedBytes(1), CPeerMessageLanes::MAX_PEER_QUEUED_BYTES + 10);
+    BOOST_CHECK_EQUAL(lanes.GetQueuedBytes(2), 20U);
+    BOOST_CHECK_EQUAL(lanes.GetQueuedBytes(3), 0U);
+    BOOST_CHECK(lanes.IsFull(1));
+    BOOST_CHECK(!lanes.IsFull(2));
+
+    release.set_value();
+    drained.get_future().wait();
+    BOOST_CHECK(!lanes.IsFull(1));
+}
+
+BOOST_AUTO_TEST_CASE(lanes_stop)
+{
+    CPeerMessageLanes disabled(0, {});
+    BOOST_CHECK_EQUAL(disabled.GetLaneCount(), 0U);
+    BOOST_CHECK(!disabled.Push(1, 1, [] {}));
+
+    CPeerMessageLanes lanes(1, {});
+    std::atomic<bool> called{false};
+    lanes.Stop();
+    BOOST_CHECK(!lanes.Push(1, 1, [&called] { called = true; }));
+    BOOST_CHECK_EQUAL(lanes.GetQueuedBytes(1), 0U);
+    BOOST_CHECK(!called);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
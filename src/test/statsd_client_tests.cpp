@@ -0,0 +1,155 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <compat.h>
+#include <netbase.h>
+#include <statsd_client.h>
+#include <test/util/setup_common.h>
+#include <util/sock.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// A UDP socket bound to an ephemeral port on localhost which collects everything sent to it
+struct StatsdListener
+{
+    Sock sock;
+    int port{0};
+
+    StatsdListener() : sock(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP))
+    {
+        BOOST_REQUIRE(sock.Get() != INVALID_SOCKET);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        BOOST_REQUIRE(bind(sock.Get(), (struct sockaddr*)&addr, sizeof(addr)) == 0);
+        socklen_t len = sizeof(addr);
+        BOOST_REQUIRE(getsockname(sock.Get(), (struct sockaddr*)&addr, &len) == 0);
+        port = ntohs(addr.sin_port);
+        BOOST_REQUIRE(SetSocketNonBlocking(sock.Get(), true));
+    }
+
+    // The client sends synchronously on Stop(), so everything has arrived by the time this is called
+    std::vector<std::string> ReceiveDatagrams()
+    {
+        std::vector<std::string> ret;
+        char buf[65536];
+        while (sock.Wait(1s, Sock::RECV)) {
+            const ssize_t n = sock.Recv(buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            ret.emplace_back(buf, n);
+        }
+        return ret;
+    }
+};
+
+std::vector<std::string> SplitLines(const std::vector<std::string>& datagrams)
+{
+    std::vector<std::string> ret;
+    for (const auto& datagram : datagrams) {
+        std::istringstream stream(datagram);
+        std::string line;
+        while (std::getline(stream, line)) {
+            ret.emplace_back(line);
+        }
+    }
+    return ret;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(statsd_client_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(statsd_not_started)
+{
+    statsd::StatsdClient client;
+    BOOST_CHECK_EQUAL(client.inc("test"), -3);
+    BOOST_CHECK_EQUAL(client.send("test:1|c"), -3);
+}
+
+BOOST_AUTO_TEST_CASE(statsd_aggregation)
+{
+    StatsdListener listener;
+    statsd::StatsdClient client("127.0.0.1", listener.port, "ns.");
+    BOOST_REQUIRE(client.Start(60 * 1000));
+
+    for (int i = 0; i < 10; i++) {
+        BOOST_CHECK_EQUAL(client.inc("counter"), 0);
+    }
+    client.dec("counter");
+    client.count("counter", 5);
+    client.gauge("gauge", 1);
+    client.gauge("gauge", 2);
+    client.gaugeDouble("gauge.double", 1.5);
+    client.timing("timing", 10);
+    client.timing("timing", 20);
+    client.send("raw:1|c");
+    client.Stop();
+
+    const auto datagrams = listener.ReceiveDatagrams();
+    BOOST_CHECK_EQUAL(datagrams.size(), 1U);
+    const auto lines = SplitLines(datagrams);
+    const std::set<std::string> expected{
+        "ns.counter:14|c",
+        "ns.gauge:2|g",
+        "ns.gauge.double:1.500000|g",
+        "ns.timing:10|ms",
+        "ns.timing:20|ms",
+        "raw:1|c",
+    };
+    BOOST_CHECK_EQUAL(lines.size(), expected.size());
+    BOOST_CHECK(std::set<std::string>(lines.begin(), lines.end()) == expected);
+
+    // stopped clients don't accept new metrics
+    BOOST_CHECK_EQUAL(client.inc("counter"), -3);
+}
+
+BOOST_AUTO_TEST_CASE(statsd_percentiles)
+{
+    StatsdListener listener;
+    statsd::StatsdClient client("127.0.0.1", listener.port);
+    BOOST_REQUIRE(client.Start(60 * 1000, /*percentiles=*/true));
+    for (int i = 100; i >= 1; i--) {
+        client.timing("timing", i);
+    }
+    client.Stop();
+
+    const auto lines = SplitLines(listener.ReceiveDatagrams());
+    const std::set<std::string> expected{
+        "timing.count:100|c",
+        "timing.p50:50|g",
+        "timing.p90:90|g",
+        "timing.p99:99|g",
+        "timing.max:100|g",
+    };
+    BOOST_CHECK(std::set<std::string>(lines.begin(), lines.end()) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(statsd_datagram_size)
+{
+    StatsdListener listener;
+    statsd::StatsdClient client("127.0.0.1", listener.port);
+    BOOST_REQUIRE(client.Start(60 * 1000));
+    for (int i = 0; i < 500; i++) {
+        client.gauge(strprintf("gauge.%d", i), i);
+    }
+    client.Stop();
+
+    const auto datagrams = listener.ReceiveDatagrams();
+    BOOST_CHECK_GT(datagrams.size(), 1U);
+    for (const auto& datagram : datagrams) {
+        BOOST_CHECK_LE(datagram.size(), MAX_STATSD_DATAGRAM_SIZE);
+    }
+    BOOST_CHECK_EQUAL(SplitLines(datagrams).size(), 500U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
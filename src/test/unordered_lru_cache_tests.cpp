@@ -0,0 +1,143 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <unordered_lru_cache.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+struct IntHasher
+{
+    size_t operator()(int v) const { return std::hash<int>{}(v); }
+};
+
+using IntCache = unordered_lru_cache<int, int, IntHasher>;
+
+BOOST_FIXTURE_TEST_SUITE(unordered_lru_cache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(lru_eviction_order)
+{
+    IntCache cache(3);
+    cache.insert(1, 10);
+    cache.insert(2, 20);
+    cache.insert(3, 30);
+
+    // touch 1 so that 2 becomes the least recently used entry
+    int v;
+    BOOST_CHECK(cache.get(1, v) && v == 10);
+
+    cache.insert(4, 40);
+    BOOST_CHECK_EQUAL(cache.size(), 3U);
+    BOOST_CHECK(!cache.exists(2));
+    BOOST_CHECK(cache.exists(1));
+    BOOST_CHECK(cache.exists(3));
+    BOOST_CHECK(cache.exists(4));
+
+    // overwriting an entry refreshes it and does not grow the cache
+    cache.insert(1, 11);
+    cache.insert(5, 50);
+    BOOST_CHECK_EQUAL(cache.size(), 3U);
+    BOOST_CHECK(!cache.exists(3));
+    BOOST_CHECK(cache.get(1, v) && v == 11);
+
+    cache.erase(1);
+    BOOST_CHECK(!cache.exists(1));
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(lru_hard_bound)
+{
+    IntCache cache(100);
+    for (int i = 0; i < 1000; i++) {
+        cache.insert(i, i);
+        BOOST_CHECK_LE(cache.size(), 100U);
+    }
+    for (int i = 900; i < 1000; i++) {
+        BOOST_CHECK(cache.exists(i));
+    }
+    BOOST_CHECK_EQUAL(cache.stats().evictions, 900U);
+}
+
+BOOST_AUTO_TEST_CASE(lru_stats)
+{
+    IntCache cache(2);
+    int v;
+    BOOST_CHECK(!cache.get(1, v));
+    cache.insert(1, 1);
+    BOOST_CHECK(cache.get(1, v));
+    BOOST_CHECK(cache.exists(1));
+    BOOST_CHECK(!cache.exists(2));
+    cache.insert(2, 2);
+    cache.insert(3, 3);
+
+    BOOST_CHECK_EQUAL(cache.stats().hits, 2U);
+    BOOST_CHECK_EQUAL(cache.stats().misses, 2U);
+    BOOST_CHECK_EQUAL(cache.stats().evictions, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(lru_copy)
+{
+    IntCache cache(2);
+    cache.insert(1, 1);
+    cache.insert(2, 2);
+
+    IntCache copied(cache);
+    cache.clear();
+    copied.insert(3, 3);
+    BOOST_CHECK(!copied.exists(1));
+    BOOST_CHECK(copied.exists(2));
+    BOOST_CHECK(copied.exists(3));
+
+    cache = copied;
+    copied.clear();
+    BOOST_CHECK(cache.exists(2));
+    BOOST_CHECK(cache.exists(3));
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(lru_for_each)
+{
+    IntCache cache(3);
+    cache.insert(1, 10);
+    cache.insert(2, 20);
+    cache.insert(3, 30);
+    BOOST_CHECK(cache.exists(1));
+
+    std::vector<std::pair<int, int>> entries;
+    cache.for_each([&entries](int k, int v) { entries.emplace_back(k, v); });
+    const std::vector<std::pair<int, int>> expected{{1, 10}, {3, 30}, {2, 20}};
+    BOOST_CHECK(entries == expected);
+
+    // iterating does not touch the entries, so 2 is still the first one to be evicted
+    cache.insert(4, 40);
+    BOOST_CHECK(!cache.exists(2));
+    BOOST_CHECK_EQUAL(cache.stats().hits, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(lru_erase_if)
+{
+    IntCache cache(4);
+    for (int i = 1; i <= 4; i++) {
+        cache.insert(i, i * 10);
+    }
+    BOOST_CHECK_EQUAL(cache.erase_if([](int, int v) { return v > 20; }), 2U);
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+    BOOST_CHECK(cache.exists(1));
+    BOOST_CHECK(cache.exists(2));
+    BOOST_CHECK(!cache.exists(3));
+
+    // the list and the index stay in sync, so new entries are still evicted in LRU order
+    cache.insert(5, 50);
+    cache.insert(6, 60);
+    cache.insert(7, 70);
+    BOOST_CHECK_EQUAL(cache.size(), 4U);
+    BOOST_CHECK(!cache.exists(1));
+    BOOST_CHECK_EQUAL(cache.erase_if([](int, int) { return false; }), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
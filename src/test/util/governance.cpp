@@ -0,0 +1,21 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/governance.h>
+
+CGovernanceVote MakeGovernanceVote(const COutPoint& mnOutpoint, const uint256& nParentHash, vote_signal_enum_t eSignal, vote_outcome_enum_t eOutcome, int64_t nTime)
+{
+    CGovernanceVote vote(mnOutpoint, nParentHash, eSignal, eOutcome);
+    vote.SetTime(nTime);
+    return vote;
+}
+
+vote_rec_t MakeGovernanceVoteRecord(const std::vector<CGovernanceVote>& votes)
+{
+    vote_rec_t voteRecord;
+    for (const auto& vote : votes) {
+        voteRecord.mapInstances[int(vote.GetSignal())] = vote_instance_t(vote.GetOutcome(), vote.GetTimestamp(), vote.GetTimestamp());
+    }
+    return voteRecord;
+}
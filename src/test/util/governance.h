@@ -0,0 +1,19 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_TEST_UTIL_GOVERNANCE_H
+#define BITCOIN_TEST_UTIL_GOVERNANCE_H
+
+#include <governance/object.h>
+#include <governance/vote.h>
+
+#include <vector>
+
+// create an unsigned vote with the given creation time
+CGovernanceVote MakeGovernanceVote(const COutPoint& mnOutpoint, const uint256& nParentHash, vote_signal_enum_t eSignal, vote_outcome_enum_t eOutcome, int64_t nTime);
+
+// create the vote record which matches the given votes of a single masternode
+vote_rec_t MakeGovernanceVoteRecord(const std::vector<CGovernanceVote>& votes);
+
+#endif // BITCOIN_TEST_UTIL_GOVERNANCE_H
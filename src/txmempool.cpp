@@ -30,7 +30,7 @@ CTxMemPoolEntry::CTxMemPoolEntry(const CTransactionRef& _tx, const CAmount& _nFe
                                  int64_t _nTime, unsigned int _entryHeight,
                                  bool _spendsCoinbase, unsigned int _sigOps, LockPoints lp)
     : tx(_tx), nFee(_nFee), nTxSize(tx->GetTotalSize()), nUsageSize(RecursiveDynamicUsage(tx)), nTime(_nTime), entryHeight(_entryHeight),
-    spendsCoinbase(_spendsCoinbase), sigOpCount(_sigOps), lockPoints(lp), m_epoch(0)
+    spendsCoinbase(_spendsCoinbase), sigOpCount(_sigOps), lockPoints(lp), m_epoch(0), m_first_seen_time(_nTime)
 {
     nCountWithDescendants = 1;
     nSizeWithDescendants = GetTxSize();
@@ -1371,6 +1371,24 @@ void CTxMemPool::ClearPrioritisation(const uint256 hash)
     mapDeltas.erase(hash);
 }
 
+void CTxMemPool::SetInstantSendLocked(const uint256& hash)
+{
+    AssertLockHeld(cs);
+    auto it = mapTx.find(hash);
+    if (it != mapTx.end()) {
+        it->m_instantsend_locked = true;
+    }
+}
+
+void CTxMemPool::UpdateFirstSeenTime(const uint256& hash, int64_t nTime)
+{
+    AssertLockHeld(cs);
+    auto it = mapTx.find(hash);
+    if (it != mapTx.end() && nTime < it->m_first_seen_time) {
+        it->m_first_seen_time = nTime;
+    }
+}
+
 const CTransaction* CTxMemPool::GetConflictTx(const COutPoint& prevout) const
 {
     const auto it = mapNextTx.find(prevout);
@@ -139,6 +139,11 @@ public:
     mutable uint256 validForProTxKey;
     mutable bool isKeyChangeProTx{false};
     mutable uint64_t m_epoch; //!< epoch when last touched, useful for graph algorithms
+
+    // Kept up to date by CInstantSendManager and CChainLocksHandler, so that block assembly can decide whether the TX is
+    // safe to be mined without looking into their state. Only accessed with the mempool lock held
+    mutable bool m_instantsend_locked{false};
+    mutable int64_t m_first_seen_time; //!< Local time when the TX was first seen, in a block or when entering the mempool
 };
 
 // Helpers for modifying CTxMemPool::mapTx, which is a boost multi_index.
@@ -641,6 +646,11 @@ public:
     void ApplyDelta(const uint256 hash, CAmount &nFeeDelta) const;
     void ClearPrioritisation(const uint256 hash);
 
+    /** Mark a transaction as InstantSend locked, does nothing if it's not in the pool */
+    void SetInstantSendLocked(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    /** Move the first seen time of a transaction back to nTime if it was seen earlier already, e.g. in a disconnected block */
+    void UpdateFirstSeenTime(const uint256& hash, int64_t nTime) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     /** Get the transaction in the pool that spends the same prevout */
     const CTransaction* GetConflictTx(const COutPoint& prevout) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
@@ -5,44 +5,81 @@
 #ifndef BITCOIN_UNORDERED_LRU_CACHE_H
 #define BITCOIN_UNORDERED_LRU_CACHE_H
 
-#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <list>
 #include <unordered_map>
-#include <vector>
+#include <utility>
 
+struct unordered_lru_cache_stats
+{
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+};
+
+// A LRU cache with a hard upper bound on the number of entries. Entries are kept in a doubly linked list ordered by
+// last access (most recently used first) and indexed by a hash map, so lookups, insertions and evictions are all O(1).
+// TruncateThreshold is accepted for source compatibility only; entries are now evicted as soon as maxSize is exceeded.
 template<typename Key, typename Value, typename Hasher, size_t MaxSize = 0, size_t TruncateThreshold = 0>
 class unordered_lru_cache
 {
 private:
-    typedef std::unordered_map<Key, std::pair<Value, int64_t>, Hasher> MapType;
+    typedef std::list<std::pair<Key, Value>> ListType;
+    typedef std::unordered_map<Key, typename ListType::iterator, Hasher> MapType;
 
+    ListType accessList;
     MapType cacheMap;
     size_t maxSize;
-    size_t truncateThreshold;
-    int64_t accessCounter{0};
+    unordered_lru_cache_stats cacheStats;
 
 public:
     explicit unordered_lru_cache(size_t _maxSize = MaxSize, size_t _truncateThreshold = TruncateThreshold) :
-        maxSize(_maxSize),
-        truncateThreshold(_truncateThreshold == 0 ? _maxSize * 2 : _truncateThreshold)
+        maxSize(_maxSize)
     {
         // either specify maxSize through template arguments or the constructor and fail otherwise
         assert(_maxSize != 0);
     }
 
+    // The map holds iterators into the list, so copies have to re-index. Moves keep the iterators valid.
+    unordered_lru_cache(const unordered_lru_cache& other) :
+        accessList(other.accessList),
+        maxSize(other.maxSize),
+        cacheStats(other.cacheStats)
+    {
+        reindex();
+    }
+
+    unordered_lru_cache& operator=(const unordered_lru_cache& other)
+    {
+        if (this != &other) {
+            accessList = other.accessList;
+            maxSize = other.maxSize;
+            cacheStats = other.cacheStats;
+            reindex();
+        }
+        return *this;
+    }
+
+    unordered_lru_cache(unordered_lru_cache&&) = default;
+    unordered_lru_cache& operator=(unordered_lru_cache&&) = default;
+
     size_t max_size() const { return maxSize; }
+    size_t size() const { return cacheMap.size(); }
+    const unordered_lru_cache_stats& stats() const { return cacheStats; }
 
     template<typename Value2>
     void _emplace(const Key& key, Value2&& v)
     {
-        truncate_if_needed();
         auto it = cacheMap.find(key);
         if (it == cacheMap.end()) {
-            cacheMap.emplace(key, std::make_pair(std::forward<Value2>(v), accessCounter++));
+            accessList.emplace_front(key, std::forward<Value2>(v));
+            cacheMap.emplace(key, accessList.begin());
+            truncate_if_needed();
         } else {
-            it->second.first = std::forward<Value2>(v);
-            it->second.second = accessCounter++;
+            it->second->second = std::forward<Value2>(v);
+            touch(it->second);
         }
     }
 
@@ -60,10 +97,12 @@ public:
     {
         auto it = cacheMap.find(key);
         if (it != cacheMap.end()) {
-            it->second.second = accessCounter++;
-            value = it->second.first;
+            touch(it->second);
+            value = it->second->second;
+            cacheStats.hits++;
             return true;
         }
+        cacheStats.misses++;
         return false;
     }
 
@@ -71,43 +110,76 @@ public:
     {
         auto it = cacheMap.find(key);
         if (it != cacheMap.end()) {
-            it->second.second = accessCounter++;
+            touch(it->second);
+            cacheStats.hits++;
             return true;
         }
+        cacheStats.misses++;
         return false;
     }
 
     void erase(const Key& key)
     {
-        cacheMap.erase(key);
+        auto it = cacheMap.find(key);
+        if (it != cacheMap.end()) {
+            accessList.erase(it->second);
+            cacheMap.erase(it);
+        }
+    }
+
+    // Calls f(key, value) for all entries, most recently used first. Does not count as an access
+    template<typename Callback>
+    void for_each(Callback&& f) const
+    {
+        for (const auto& p : accessList) {
+            f(p.first, p.second);
+        }
+    }
+
+    // Removes all entries for which pred(key, value) returns true. Does not count as an access
+    template<typename Predicate>
+    size_t erase_if(Predicate&& pred)
+    {
+        size_t cnt{0};
+        for (auto it = accessList.begin(); it != accessList.end(); ) {
+            if (pred(it->first, it->second)) {
+                cacheMap.erase(it->first);
+                it = accessList.erase(it);
+                cnt++;
+            } else {
+                ++it;
+            }
+        }
+        return cnt;
     }
 
     void clear()
     {
         cacheMap.clear();
+        accessList.clear();
     }
 
 private:
-    void truncate_if_needed()
+    void touch(typename ListType::iterator listIt)
     {
-        typedef typename MapType::iterator Iterator;
-
-        if (cacheMap.size() <= truncateThreshold) {
-            return;
-        }
+        accessList.splice(accessList.begin(), accessList, listIt);
+    }
 
-        std::vector<Iterator> vec;
-        vec.reserve(cacheMap.size());
-        for (auto it = cacheMap.begin(); it != cacheMap.end(); ++it) {
-            vec.emplace_back(it);
+    void truncate_if_needed()
+    {
+        while (cacheMap.size() > maxSize) {
+            cacheMap.erase(accessList.back().first);
+            accessList.pop_back();
+            cacheStats.evictions++;
         }
-        // sort by last access time (descending order)
-        std::sort(vec.begin(), vec.end(), [](const Iterator& it1, const Iterator& it2) {
-            return it1->second.second > it2->second.second;
-        });
+    }
 
-        for (size_t i = maxSize; i < vec.size(); i++) {
-            cacheMap.erase(vec[i]);
+    void reindex()
+    {
+        cacheMap.clear();
+        cacheMap.reserve(accessList.size());
+        for (auto it = accessList.begin(); it != accessList.end(); ++it) {
+            cacheMap.emplace(it->first, it);
         }
     }
 };
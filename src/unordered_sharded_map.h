@@ -0,0 +1,101 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UNORDERED_SHARDED_MAP_H
+#define BITCOIN_UNORDERED_SHARDED_MAP_H
+
+#include <sync.h>
+
+#include <array>
+#include <unordered_map>
+
+// A thread-safe unordered map which is split into multiple shards, each with its own lock. Concurrent accesses only
+// contend with each other if they hit the same shard. Values are copied in and out, so they should be cheap to copy
+template<typename Key, typename Value, typename Hasher, size_t ShardCount = 16>
+class unordered_sharded_map
+{
+private:
+    struct Shard {
+        mutable Mutex cs;
+        std::unordered_map<Key, Value, Hasher> map GUARDED_BY(cs);
+    };
+
+    std::array<Shard, ShardCount> shards;
+    Hasher hasher;
+
+    Shard& get_shard(const Key& key) { return shards[hasher(key) % ShardCount]; }
+    const Shard& get_shard(const Key& key) const { return shards[hasher(key) % ShardCount]; }
+
+public:
+    // Does not overwrite an existing value, same as std::unordered_map::emplace
+    void emplace(const Key& key, const Value& v)
+    {
+        auto& shard = get_shard(key);
+        LOCK(shard.cs);
+        shard.map.emplace(key, v);
+    }
+
+    bool get(const Key& key, Value& value) const
+    {
+        const auto& shard = get_shard(key);
+        LOCK(shard.cs);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    bool exists(const Key& key) const
+    {
+        const auto& shard = get_shard(key);
+        LOCK(shard.cs);
+        return shard.map.count(key) != 0;
+    }
+
+    void erase(const Key& key)
+    {
+        auto& shard = get_shard(key);
+        LOCK(shard.cs);
+        shard.map.erase(key);
+    }
+
+    // Erases all entries for which pred(key, value) returns true. Shards are locked one after the other, so this is
+    // not atomic with respect to concurrent insertions
+    template<typename Predicate>
+    void erase_if(Predicate&& pred)
+    {
+        for (auto& shard : shards) {
+            LOCK(shard.cs);
+            for (auto it = shard.map.begin(); it != shard.map.end(); ) {
+                if (pred(it->first, it->second)) {
+                    it = shard.map.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        size_t ret = 0;
+        for (const auto& shard : shards) {
+            LOCK(shard.cs);
+            ret += shard.map.size();
+        }
+        return ret;
+    }
+
+    void clear()
+    {
+        for (auto& shard : shards) {
+            LOCK(shard.cs);
+            shard.map.clear();
+        }
+    }
+};
+
+#endif // BITCOIN_UNORDERED_SHARDED_MAP_H
@@ -10,11 +10,11 @@
 import binascii
 from decimal import Decimal
 
+from test_framework.authproxy import JSONRPCException
 from test_framework.messages import COIN, COutPoint, CTransaction, CTxIn, CTxOut
 from test_framework.script import CScript, OP_CHECKSIG, OP_DUP, OP_EQUALVERIFY, OP_HASH160
-from test_framework.test_node import ErrorMatch
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_equal
+from test_framework.util import assert_equal, wait_until
 
 
 class SpentIndexTest(BitcoinTestFramework):
@@ -40,18 +40,26 @@ class SpentIndexTest(BitcoinTestFramework):
         self.sync_all()
         self.import_deterministic_coinbase_privkeys()
 
+    def spentindex_synced(self, node):
+        try:
+            node.getspentinfo({"txid": "00" * 32, "index": 0})
+        except JSONRPCException as e:
+            # an unknown output is reported as such once the index is synced
+            return "still in the process of being indexed" not in e.error["message"]
+        return True
+
     def run_test(self):
-        self.log.info("Test that settings can't be changed without -reindex...")
+        self.log.info("Test that settings can be changed without -reindex...")
         self.stop_node(1)
-        self.nodes[1].assert_start_raises_init_error(["-spentindex=0"], "You need to rebuild the database using -reindex to change -spentindex", match=ErrorMatch.PARTIAL_REGEX)
-        self.start_node(1, ["-spentindex=0", "-reindex"])
+        self.start_node(1, ["-spentindex=0"])
         self.connect_nodes(0, 1)
         self.sync_all()
         self.stop_node(1)
-        self.nodes[1].assert_start_raises_init_error(["-spentindex"], "You need to rebuild the database using -reindex to change -spentindex", match=ErrorMatch.PARTIAL_REGEX)
-        self.start_node(1, ["-spentindex", "-reindex"])
+        self.start_node(1, ["-spentindex"])
         self.connect_nodes(0, 1)
         self.sync_all()
+        # the index catches up with the chain in the background, its RPCs fail until then
+        wait_until(lambda: self.spentindex_synced(self.nodes[1]), timeout=30)
 
         self.log.info("Mining blocks...")
         self.nodes[0].generate(105)
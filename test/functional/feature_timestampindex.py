@@ -8,8 +8,7 @@
 #
 
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.test_node import ErrorMatch
-from test_framework.util import assert_equal
+from test_framework.util import assert_equal, try_rpc, wait_until
 
 
 class TimestampIndexTest(BitcoinTestFramework):
@@ -33,17 +32,17 @@ class TimestampIndexTest(BitcoinTestFramework):
         self.sync_all()
 
     def run_test(self):
-        self.log.info("Test that settings can't be changed without -reindex...")
+        self.log.info("Test that settings can be changed without -reindex...")
         self.stop_node(1)
-        self.nodes[1].assert_start_raises_init_error(["-timestampindex=0"], "You need to rebuild the database using -reindex to change -timestampindex", match=ErrorMatch.PARTIAL_REGEX)
-        self.start_node(1, ["-timestampindex=0", "-reindex"])
+        self.start_node(1, ["-timestampindex=0"])
         self.connect_nodes(0, 1)
         self.sync_all()
         self.stop_node(1)
-        self.nodes[1].assert_start_raises_init_error(["-timestampindex"], "You need to rebuild the database using -reindex to change -timestampindex", match=ErrorMatch.PARTIAL_REGEX)
-        self.start_node(1, ["-timestampindex", "-reindex"])
+        self.start_node(1, ["-timestampindex"])
         self.connect_nodes(0, 1)
         self.sync_all()
+        # the index catches up with the chain in the background, its RPCs fail until then
+        wait_until(lambda: not try_rpc(-1, "still in the process of being indexed", self.nodes[1].getblockhashes, 2000000000, 0), timeout=30)
 
         self.log.info("Mining 5 blocks...")
         blockhashes = self.nodes[0].generate(5)